@@ -589,8 +589,16 @@ typedef struct
     uint16_t port;      /**< socket port */
 } CASocket_t;
 
+/**
+ * Size of the request history.
+ * @deprecated duplicate requests are detected by cadeduplication, this is no longer used.
+ */
 #define HISTORYSIZE (4)
 
+/**
+ * Request history item.
+ * @deprecated no longer used.
+ */
 typedef struct
 {
     CATransportFlags_t flags;        /**< Transport flags */
@@ -600,12 +608,30 @@ typedef struct
     uint32_t ifindex;                /**< Index of interface */
 } CAHistoryItem_t;
 
+/**
+ * Request history.
+ * @deprecated no longer used.
+ */
 typedef struct
 {
     int nextIndex;                       /**< Next item index */
     CAHistoryItem_t items[HISTORYSIZE];  /**< History items */
 } CAHistory_t;
 
+/**
+ * Counters of CON data pacing and retransmission.
+ */
+typedef struct
+{
+    uint32_t sent;              /**< CON data sent for the first time */
+    uint32_t held;              /**< CON data that had to wait for NSTART */
+    uint32_t retransmitted;     /**< retransmissions */
+    uint32_t acknowledged;      /**< CON data answered by ACK or RST */
+    uint32_t timedOut;          /**< CON data given up after the last retransmission */
+    uint32_t strongRttSamples;  /**< RTT samples of data that was not retransmitted */
+    uint32_t weakRttSamples;    /**< RTT samples of data retransmitted once or twice */
+} CARetransmissionStatistics_t;
+
 /**
  * Hold interface index for keeping track of comings and goings.
  */
@@ -665,6 +691,9 @@ typedef struct
         int netlinkFd;              /**< netlink */
         int shutdownFds[2];         /**< fds used to signal threads to stop */
         CASocketFd_t maxfd;         /**< highest fd (for select) */
+#if defined(HAVE_SYS_EPOLL_H)
+        int epollFd;                /**< epoll instance, or -1 to fall back to select */
+#endif
 #endif
         int selectTimeout;          /**< in seconds */
         bool started;               /**< the IP adapter has started */
@@ -684,6 +713,10 @@ typedef struct
         } nm;
     } ip;
 
+    /**
+     * Kept so the layout of caglobals does not change.
+     * @deprecated no longer written or read.
+     */
     struct calayer
     {
         CAHistory_t requestHistory;  /**< filter IP family in requests */
@@ -708,6 +741,9 @@ typedef struct
         int shutdownFds[2];     /**< shutdown pipe */
         int connectionFds[2];   /**< connection pipe */
         CASocketFd_t maxfd;     /**< highest fd (for select) */
+#if defined(HAVE_SYS_EPOLL_H)
+        int epollFd;            /**< epoll instance, or -1 to fall back to select */
+#endif
 #endif
         bool started;           /**< the TCP adapter has started */
         volatile bool terminate;/**< the TCP adapter needs to stop */
@@ -766,6 +802,25 @@ typedef CAResult_t (*CAHandshakeErrorCallback)(const CAEndpoint_t *object,
  */
 typedef void (*CANetworkMonitorCallback)(const CAEndpoint_t *info, CANetworkStatus_t status);
 
+/**
+ * Callback function type for the payload of each received block of a
+ * block-wise transfer, delivered as the blocks arrive. Blocks of one transfer
+ * come in order; the transfer restarts at offset 0 if a block was lost.
+ * @param[out]   endpoint       remote device sending the blocks.
+ * @param[out]   token          token of the transfer.
+ * @param[out]   tokenLength    length of the token.
+ * @param[out]   offset         offset of the block within the payload.
+ * @param[out]   data           payload of the block.
+ * @param[out]   dataLength     length of the block payload.
+ * @return  true to consume the payload of this transfer: it is then not
+ *          reassembled and the final request or response is delivered without
+ *          payload. Only the answer for the first block of a transfer counts.
+ */
+typedef bool (*CABlockWiseStreamCallback)(const CAEndpoint_t *endpoint,
+                                          const CAToken_t token, uint8_t tokenLength,
+                                          size_t offset, const uint8_t *data,
+                                          size_t dataLength);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -132,6 +132,16 @@ CAResult_t CAStartDiscoveryServer(void);
 void CARegisterHandler(CARequestCallback ReqHandler, CAResponseCallback RespHandler,
                        CAErrorCallback ErrorHandler);
 
+/**
+ * Register a handler receiving the payload of block-wise transfers block by
+ * block as it arrives, instead of only after reassembly. The handler is called
+ * on the thread receiving the network data.
+ * @param[in]   StreamHandler   Block payload callback, NULL to reassemble all
+ *                              payloads again.
+ * @see     CABlockWiseStreamCallback
+ */
+void CARegisterBlockWiseStreamHandler(CABlockWiseStreamCallback StreamHandler);
+
 /**
  * Create an endpoint description.
  * @param[in]   flags                 how the adapter should be used.
@@ -231,6 +241,50 @@ CATransportAdapter_t CAGetSelectedNetwork(void);
  */
 CAResult_t CAHandleRequestResponse(void);
 
+/**
+ * Block until CAHandleRequestResponse() has received data to handle,
+ * CAWakeUpRequestResponse() is called or the timeout expires.
+ * Does not touch any state used by CAHandleRequestResponse(), so it may be
+ * called from a thread that does not hold the lock the caller uses for it.
+ * @param[in]   timeoutMs    maximum time to wait in milliseconds, 0 to wait
+ *                           without limit.
+ * @param[in,out] wakeUps    wake-up count this caller saw when its previous
+ *                           wait returned, 0 before the first one. The call
+ *                           returns at once if CAWakeUpRequestResponse() was
+ *                           called since, and stores the current count. NULL
+ *                           to only return for wake-ups made during the call.
+ * @return   ::CA_STATUS_OK if data is pending, ::CA_REQUEST_TIMEOUT if the
+ *           timeout expired or the wait was woken up, ::CA_STATUS_NOT_INITIALIZED.
+ */
+CAResult_t CAWaitForRequestResponse(uint32_t timeoutMs, uint32_t *wakeUps);
+
+/**
+ * Make all callers of CAWaitForRequestResponse() return, as well as the next
+ * call of each caller whose wake-up count predates this call.
+ */
+void CAWakeUpRequestResponse(void);
+
+/**
+ * Set how many CON messages may be outstanding to one endpoint (CoAP NSTART).
+ * Later CON messages to that endpoint wait until an earlier one is acknowledged,
+ * reset or given up. The default is 0, which doesn't limit them. This may be
+ * called before CAInitialize() and holds until it is called again.
+ *
+ * @param[in]   nstart            outstanding CON messages per endpoint, 0 is unlimited.
+ *
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASetRetransmissionNstart(uint8_t nstart);
+
+/**
+ * Get the counters of CON message pacing and retransmission.
+ *
+ * @param[out]  statistics        counters since CAInitialize().
+ *
+ * @return  ::CA_STATUS_OK, ::CA_STATUS_INVALID_PARAM or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CAGetRetransmissionStatistics(CARetransmissionStatistics_t *statistics);
+
 #ifdef RA_ADAPTER
 /**
  * Set Remote Access information for XMPP Client.
@@ -219,6 +219,42 @@ typedef void (*CAgetPkixInfoHandler)(PkiInfo_t * inf);
  */
 CAResult_t CAregisterPkixInfoHandler(CAgetPkixInfoHandler getPkixInfoHandler);
 
+/**
+ * Tell the stack that the info returned by the PKIX info callback has changed.
+ * The certificates, key and CRL are parsed once and reused by the following
+ * handshakes until this is called.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAnotifyPkixInfoChanged(void);
+
+/**
+ * Tell the stack that credentials or the state of the device have changed, so
+ * sessions cached for resumption must not be resumed any more.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAinvalidateSslSessionCache(void);
+
+/**
+ * Enable or disable resuming TLS sessions. Sessions of ownership transfer are
+ * authenticated by a PIN, a manufacturer certificate or not at all, so the
+ * cache has to be disabled while it runs.
+ *
+ * @param[in] enable  TRUE/FALSE enables/disables the session cache. The cached
+ *                    sessions are dropped either way.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAEnableSslSessionCache(const bool enable);
+
+/**
+ * Enable or disable resuming TLS sessions with one peer, e.g. a device whose
+ * ownership is being transferred. Sessions with other peers are not affected.
+ *
+ * @param[in] endpoint  peer, with the port of its secure session.
+ * @param[in] enable    TRUE/FALSE enables/disables the session cache of the peer.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAEnableSslSessionCacheForPeer(const CAEndpoint_t *endpoint, const bool enable);
+
 /**
  * Select the cipher suite for dtls handshake.
  *
@@ -54,8 +54,10 @@ typedef struct ca_thread_pool
 
 /**
  * This function creates a newly allocated thread pool.
+ * Worker threads are started on demand and reused; at most num_of_threads
+ * tasks run at the same time, further tasks wait until a worker is free.
  *
- * @param num_of_threads The number of worker thread used in this pool.
+ * @param num_of_threads The maximum number of worker threads used in this pool.
  * @param thread_pool_handle Handle to newly create thread pool.
  * @return Error code, CA_STATUS_OK if success, else error number.
  */
@@ -63,6 +65,7 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
 
 /**
  * This function adds a routine to be executed by the thread pool at some future time.
+ * When every worker is busy, the routine waits until one of them returns.
  *
  * @param thread_pool The thread pool structure.
  * @param method The routine to be executed.
@@ -74,6 +77,21 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
 CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func method,
                     void *data);
 
+/**
+ * This function runs a routine on a thread of its own instead of a pool worker.
+ * It must be used for routines that only return when CA stops, e.g. receive or
+ * queueing loops, which would otherwise hold a worker and starve queued tasks.
+ *
+ * @param thread_pool The thread pool structure.
+ * @param method The routine to be executed.
+ * @param data The data to be passed to the routine.
+ *
+ * @return CA_STATUS_OK on success.
+ * @return Error on failure.
+ */
+CAResult_t ca_thread_pool_add_dedicated_task(ca_thread_pool_t thread_pool,
+                                             ca_thread_func method, void *data);
+
 /**
  * This function stops all the worker threads (stop & exit). And frees all the allocated memory.
  * Function will return only after joining all threads executing the currently scheduled tasks.
@@ -0,0 +1,94 @@
+/* ****************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for a multi-producer/single-consumer queue.
+ *
+ * Messages are kept in a bounded ring which producers enter with a single
+ * compare-and-swap and the consumer leaves without any lock. When the ring
+ * is full, messages spill into a mutex protected u_queue_t so that adding
+ * never fails for lack of ring space. Only one thread may ever remove
+ * messages from the queue.
+ */
+
+#ifndef U_MPSC_QUEUE_H_
+#define U_MPSC_QUEUE_H_
+
+#include "cacommon.h"
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * Multi-producer/single-consumer queue. Opaque.
+ */
+typedef struct u_mpsc_queue_t u_mpsc_queue_t;
+
+/**
+ * API to create the queue.
+ * @param capacity number of ring slots, rounded up to a power of two.
+ * @return  u_mpsc_queue_t pointer if Success, NULL otherwise.
+ */
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity);
+
+/**
+ * Deletes the queue. Messages still in the queue are not freed; the caller
+ * must drain them with u_mpsc_queue_get_element() first.
+ * @param queue queue pointer.
+ */
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue);
+
+/**
+ * Adds message at the end of the queue. May be called from any thread.
+ * @param queue pointer to queue.
+ * @param msg pointer to message.
+ * @param size message size.
+ * @return ::CA_STATUS_OK if Success, ::CA_MEMORY_ALLOC_FAILED if the ring is
+ *         full and the overflow element could not be allocated.
+ */
+CAResult_t u_mpsc_queue_add_element(u_mpsc_queue_t *queue, void *msg, uint32_t size);
+
+/**
+ * Removes the first message from the queue. Must only be called from the
+ * consumer thread.
+ * @param queue pointer to queue.
+ * @param message filled with the removed message.
+ * @return true if a message was removed, false if the queue is empty.
+ */
+bool u_mpsc_queue_get_element(u_mpsc_queue_t *queue, u_queue_message_t *message);
+
+/**
+ * Check whether the queue is empty. Exact from the consumer thread, a hint
+ * from any other thread.
+ * @param queue pointer to queue.
+ * @return true if the queue holds no message.
+ */
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MPSC_QUEUE_H_ */
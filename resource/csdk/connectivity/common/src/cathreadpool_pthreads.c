@@ -35,51 +35,233 @@
 #include "cathreadpool.h"
 #include "experimental/logger.h"
 #include "oic_malloc.h"
-#include "uarraylist.h"
 #include "octhread.h"
+#include "ocatomic.h"
 #include "platform_features.h"
 
 #define TAG PCF("OIC_CA_UTHREADPOOL")
 
 /**
- * empty struct to represent the details.  This implementation has no data
- * that it needs to keep track of, so it only uses NULL for the internal value.
+ * Initial number of task slots in each worker deque.
  */
-typedef struct ca_thread_pool_details_t
+#define CA_THREAD_POOL_DEQUE_INITIAL_SIZE 8
+
+/**
+ * A task waiting in a worker deque.
+ */
+typedef struct ca_thread_pool_task_t
 {
-    u_arraylist_t* threads_list;
-    oc_mutex list_lock;
-} ca_thread_pool_details_t;
+    ca_thread_func func;
+    void* data;
+} ca_thread_pool_task_t;
+
+struct ca_thread_pool_details_t;
 
 /**
- * struct to wrap the pthreads callback properly.  The function pointer for
- * pthreads requires a void* return value, however u_thread_func is a void.
+ * Thread running a single task from ca_thread_pool_add_dedicated_task().
  */
-typedef struct ca_thread_pool_callback_info_t
+typedef struct ca_thread_pool_dedicated_t
 {
+    oc_thread thread;
     ca_thread_func func;
     void* data;
-} ca_thread_pool_callback_info_t;
+    struct ca_thread_pool_dedicated_t* next;
+} ca_thread_pool_dedicated_t;
 
-typedef struct ca_thread_pool_thread_info_t
+/**
+ * Worker thread and the deque of tasks handed to it.  The owner takes tasks
+ * from the head, idle workers steal from the tail.
+ */
+typedef struct ca_thread_pool_worker_t
 {
     oc_thread thread;
-} ca_thread_pool_thread_info_t;
+    oc_mutex lock;
+    ca_thread_pool_task_t* tasks;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    struct ca_thread_pool_details_t* pool;
+} ca_thread_pool_worker_t;
+
+/**
+ * Bounded pool of worker threads.  Workers are started on demand, up to
+ * max_workers, and then reused for all following tasks.
+ */
+typedef struct ca_thread_pool_details_t
+{
+    ca_thread_pool_worker_t* workers;
+    int32_t max_workers;
+    int32_t num_workers;
+    int32_t idle_workers;       /**< workers waiting on cond */
+    int32_t wakeups;            /**< idle workers signalled but not yet awake */
+    volatile int32_t pending;   /**< tasks sitting in the deques */
+    int32_t next_worker;        /**< round-robin submission index */
+    ca_thread_pool_dedicated_t* dedicated;  /**< threads of dedicated tasks, joined on free */
+    bool stop;
+    oc_mutex lock;
+    oc_cond cond;
+} ca_thread_pool_details_t;
+
+static bool ca_thread_pool_push(ca_thread_pool_worker_t* worker, ca_thread_func method,
+                                void* data)
+{
+    bool result = true;
+    oc_mutex_lock(worker->lock);
+
+    if (worker->count == worker->capacity)
+    {
+        size_t capacity = worker->capacity ? worker->capacity * 2 :
+                          CA_THREAD_POOL_DEQUE_INITIAL_SIZE;
+        ca_thread_pool_task_t* tasks = OICMalloc(capacity * sizeof(ca_thread_pool_task_t));
+        if (!tasks)
+        {
+            result = false;
+            goto exit;
+        }
+
+        // unwrap the ring into the new buffer
+        for (size_t i = 0; i < worker->count; ++i)
+        {
+            tasks[i] = worker->tasks[(worker->head + i) % worker->capacity];
+        }
+        OICFree(worker->tasks);
+        worker->tasks = tasks;
+        worker->capacity = capacity;
+        worker->head = 0;
+    }
 
-// passthrough function to convert the pthreads call to a u_thread_func call
-void* ca_thread_pool_pthreads_delegate(void* data)
+    ca_thread_pool_task_t* task = &worker->tasks[(worker->head + worker->count) % worker->capacity];
+    task->func = method;
+    task->data = data;
+    worker->count++;
+    oc_atomic_increment(&worker->pool->pending);
+
+exit:
+    oc_mutex_unlock(worker->lock);
+    return result;
+}
+
+static bool ca_thread_pool_pop(ca_thread_pool_worker_t* worker, bool steal,
+                               ca_thread_pool_task_t* task)
 {
-    ca_thread_pool_callback_info_t* info = (ca_thread_pool_callback_info_t*)data;
-    info->func(info->data);
-    OICFree(info);
+    bool result = false;
+    oc_mutex_lock(worker->lock);
+
+    if (worker->count)
+    {
+        if (steal)
+        {
+            *task = worker->tasks[(worker->head + worker->count - 1) % worker->capacity];
+        }
+        else
+        {
+            *task = worker->tasks[worker->head];
+            worker->head = (worker->head + 1) % worker->capacity;
+        }
+        worker->count--;
+        oc_atomic_decrement(&worker->pool->pending);
+        result = true;
+    }
+
+    oc_mutex_unlock(worker->lock);
+    return result;
+}
+
+static bool ca_thread_pool_next_task(ca_thread_pool_worker_t* self, ca_thread_pool_task_t* task)
+{
+    if (ca_thread_pool_pop(self, false, task))
+    {
+        return true;
+    }
+
+    ca_thread_pool_details_t* pool = self->pool;
+    for (int32_t i = 0; i < pool->max_workers; ++i)
+    {
+        ca_thread_pool_worker_t* victim = &pool->workers[i];
+        if (victim != self && ca_thread_pool_pop(victim, true, task))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// worker loop: run own tasks, steal from the others, sleep when there is nothing left
+static void* ca_thread_pool_worker_routine(void* data)
+{
+    ca_thread_pool_worker_t* self = (ca_thread_pool_worker_t*)data;
+    ca_thread_pool_details_t* pool = self->pool;
+
+    while (true)
+    {
+        ca_thread_pool_task_t task;
+        if (ca_thread_pool_next_task(self, &task))
+        {
+            task.func(task.data);
+            continue;
+        }
+
+        oc_mutex_lock(pool->lock);
+        if (oc_atomic_add(&pool->pending, 0) > 0)
+        {
+            // a task was queued while the deques were being scanned
+            oc_mutex_unlock(pool->lock);
+            continue;
+        }
+        if (pool->stop)
+        {
+            oc_mutex_unlock(pool->lock);
+            break;
+        }
+
+        pool->idle_workers++;
+        while (0 == pool->wakeups && !pool->stop)
+        {
+            oc_cond_wait(pool->cond, pool->lock);
+        }
+        if (pool->wakeups > 0)
+        {
+            pool->wakeups--;
+        }
+        pool->idle_workers--;
+        oc_mutex_unlock(pool->lock);
+    }
+
     return NULL;
 }
 
-// this implementation doesn't do a thread pool, so this function is essentially
-// a no-op besides creating a valid ca_thread_pool_t object.  It was determined after
-// reading through the existing implementation that the thread-pooling was unnecessary
-// for the posix platforms.  Behavior shouldn't be changed since previously num_of_threads
-// was greater than the number of requested threads.
+static void* ca_thread_pool_dedicated_routine(void* data)
+{
+    ca_thread_pool_dedicated_t* dedicated = (ca_thread_pool_dedicated_t*)data;
+    dedicated->func(dedicated->data);
+    return NULL;
+}
+
+static void ca_thread_pool_free_details(ca_thread_pool_details_t* details)
+{
+    if (details->workers)
+    {
+        for (int32_t i = 0; i < details->max_workers; ++i)
+        {
+            if (details->workers[i].lock)
+            {
+                oc_mutex_free(details->workers[i].lock);
+            }
+            OICFree(details->workers[i].tasks);
+        }
+        OICFree(details->workers);
+    }
+    if (details->cond)
+    {
+        oc_cond_free(details->cond);
+    }
+    if (details->lock)
+    {
+        oc_mutex_free(details->lock);
+    }
+    OICFree(details);
+}
+
 CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_pool)
 {
     OIC_LOG(DEBUG, TAG, "IN");
@@ -104,40 +286,48 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    (*thread_pool)->details = OICMalloc(sizeof(struct ca_thread_pool_details_t));
-    if(!(*thread_pool)->details)
+    ca_thread_pool_details_t* details = OICCalloc(1, sizeof(ca_thread_pool_details_t));
+    if(!details)
     {
         OIC_LOG(ERROR, TAG, "Failed to allocate for thread-pool details");
         OICFree(*thread_pool);
         *thread_pool=NULL;
         return CA_MEMORY_ALLOC_FAILED;
     }
+    (*thread_pool)->details = details;
+    details->max_workers = num_of_threads;
 
-    (*thread_pool)->details->list_lock = oc_mutex_new();
-
-    if(!(*thread_pool)->details->list_lock)
+    details->lock = oc_mutex_new();
+    details->cond = oc_cond_new();
+    if(!details->lock || !details->cond)
     {
         OIC_LOG(ERROR, TAG, "Failed to create thread-pool mutex");
         goto exit;
     }
 
-    (*thread_pool)->details->threads_list = u_arraylist_create();
+    details->workers = OICCalloc(num_of_threads, sizeof(ca_thread_pool_worker_t));
+    if(!details->workers)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to create thread-pool workers");
+        goto exit;
+    }
 
-    if(!(*thread_pool)->details->threads_list)
+    for (int32_t i = 0; i < num_of_threads; ++i)
     {
-        OIC_LOG(ERROR, TAG, "Failed to create thread-pool list");
-        if(!oc_mutex_free((*thread_pool)->details->list_lock))
+        details->workers[i].pool = details;
+        details->workers[i].lock = oc_mutex_new();
+        if (!details->workers[i].lock)
         {
-            OIC_LOG(ERROR, TAG, "Failed to free thread-pool mutex");
+            OIC_LOG(ERROR, TAG, "Failed to create worker mutex");
+            goto exit;
         }
-        goto exit;
     }
 
     OIC_LOG(DEBUG, TAG, "OUT");
     return CA_STATUS_OK;
 
 exit:
-    OICFree((*thread_pool)->details);
+    ca_thread_pool_free_details(details);
     OICFree(*thread_pool);
     *thread_pool = NULL;
     return CA_STATUS_FAILED;
@@ -154,54 +344,121 @@ CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func
         return CA_STATUS_INVALID_PARAM;
     }
 
-    ca_thread_pool_callback_info_t* info = OICMalloc(sizeof(ca_thread_pool_callback_info_t));
-    if(!info)
+    ca_thread_pool_details_t* pool = thread_pool->details;
+    CAResult_t result = CA_STATUS_OK;
+
+    oc_mutex_lock(pool->lock);
+    if (pool->stop)
     {
-        OIC_LOG(ERROR, TAG, "Failed to allocate for memory wrapper");
-        return CA_MEMORY_ALLOC_FAILED;
+        OIC_LOG(ERROR, TAG, "Thread pool is being freed");
+        result = CA_STATUS_FAILED;
+        goto exit;
+    }
+
+    // Start a new worker if no idle one is left to take the task.
+    bool wakeIdle = (pool->idle_workers > pool->wakeups);
+    ca_thread_pool_worker_t* worker = NULL;
+    if (!wakeIdle && pool->num_workers == pool->max_workers)
+    {
+        // Queued tasks only run once a worker returns; routines that do not return
+        // must use ca_thread_pool_add_dedicated_task().
+        OIC_LOG_V(WARNING, TAG, "All %d workers are busy, task waits for a free worker",
+                  pool->max_workers);
+    }
+    else if (!wakeIdle)
+    {
+        worker = &pool->workers[pool->num_workers];
+        int thrRet = oc_thread_new(&worker->thread, ca_thread_pool_worker_routine, worker);
+        if (thrRet != 0)
+        {
+            OIC_LOG_V(ERROR, TAG, "Thread start failed with error %d", thrRet);
+            worker->thread = NULL;
+            if (0 == pool->num_workers)
+            {
+                result = CA_STATUS_FAILED;
+                goto exit;
+            }
+            worker = NULL;
+        }
+        else
+        {
+            pool->num_workers++;
+        }
+    }
+
+    if (!worker)
+    {
+        worker = &pool->workers[pool->next_worker % pool->num_workers];
+        pool->next_worker = (pool->next_worker + 1) % pool->num_workers;
+    }
+
+    if (!ca_thread_pool_push(worker, method, data))
+    {
+        OIC_LOG(ERROR, TAG, "Failed to allocate for task");
+        result = CA_MEMORY_ALLOC_FAILED;
+        goto exit;
     }
 
-    info->func = method;
-    info->data = data;
+    if (wakeIdle)
+    {
+        pool->wakeups++;
+        oc_cond_signal(pool->cond);
+    }
+
+exit:
+    oc_mutex_unlock(pool->lock);
+    OIC_LOG(DEBUG, TAG, "OUT");
+    return result;
+}
+
+CAResult_t ca_thread_pool_add_dedicated_task(ca_thread_pool_t thread_pool,
+                                             ca_thread_func method, void *data)
+{
+    OIC_LOG(DEBUG, TAG, "IN");
 
-    ca_thread_pool_thread_info_t *threadInfo =
-            (ca_thread_pool_thread_info_t *) OICCalloc(1, sizeof(ca_thread_pool_thread_info_t));
-    if (!threadInfo)
+    if(NULL == thread_pool || NULL == method)
     {
-        OIC_LOG(ERROR, TAG, "Memory allocation failed");
-        OICFree(info);
-        return CA_STATUS_FAILED;
+        OIC_LOG(ERROR, TAG, "thread_pool or method was NULL");
+        return CA_STATUS_INVALID_PARAM;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    bool addResult = u_arraylist_add(thread_pool->details->threads_list, (void*) threadInfo);
-    if (!addResult)
+    ca_thread_pool_dedicated_t* dedicated = OICCalloc(1, sizeof(ca_thread_pool_dedicated_t));
+    if (!dedicated)
     {
-        // Note that this is considered non-fatal.
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        OIC_LOG(ERROR, TAG, "Arraylist add failed");
-        OICFree(info);
-        OICFree(threadInfo);
-        return CA_STATUS_FAILED;
+        OIC_LOG(ERROR, TAG, "Failed to allocate for dedicated task");
+        return CA_MEMORY_ALLOC_FAILED;
     }
+    dedicated->func = method;
+    dedicated->data = data;
 
-    int thrRet = oc_thread_new(&threadInfo->thread, ca_thread_pool_pthreads_delegate, info);
+    ca_thread_pool_details_t* pool = thread_pool->details;
+    CAResult_t result = CA_STATUS_OK;
+
+    oc_mutex_lock(pool->lock);
+    if (pool->stop)
+    {
+        OIC_LOG(ERROR, TAG, "Thread pool is being freed");
+        result = CA_STATUS_FAILED;
+        goto exit;
+    }
+
+    int thrRet = oc_thread_new(&dedicated->thread, ca_thread_pool_dedicated_routine, dedicated);
     if (thrRet != 0)
     {
-        size_t index = 0;
-        if (u_arraylist_get_index(thread_pool->details->threads_list, threadInfo, &index))
-        {
-            u_arraylist_remove(thread_pool->details->threads_list, index);
-        }
-        oc_mutex_unlock(thread_pool->details->list_lock);
         OIC_LOG_V(ERROR, TAG, "Thread start failed with error %d", thrRet);
-        OICFree(info);
-        return CA_STATUS_FAILED;
+        result = CA_STATUS_FAILED;
+        goto exit;
     }
-    oc_mutex_unlock(thread_pool->details->list_lock);
 
+    dedicated->next = pool->dedicated;
+    pool->dedicated = dedicated;
+    dedicated = NULL;
+
+exit:
+    oc_mutex_unlock(pool->lock);
+    OICFree(dedicated);
     OIC_LOG(DEBUG, TAG, "OUT");
-    return CA_STATUS_OK;
+    return result;
 }
 
 void ca_thread_pool_free(ca_thread_pool_t thread_pool)
@@ -214,29 +471,39 @@ void ca_thread_pool_free(ca_thread_pool_t thread_pool)
         return;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
+    ca_thread_pool_details_t* pool = thread_pool->details;
 
-    for (size_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
+    // Workers finish the queued tasks before they exit.
+    oc_mutex_lock(pool->lock);
+    pool->stop = true;
+    oc_cond_broadcast(pool->cond);
+    int32_t num_workers = pool->num_workers;
+    oc_mutex_unlock(pool->lock);
+
+    for (int32_t i = 0; i < num_workers; ++i)
     {
-        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
-        if (threadInfo)
+        ca_thread_pool_worker_t* worker = &pool->workers[i];
+        if (worker->thread)
         {
-            if (threadInfo->thread)
-            {
-                oc_thread_wait(threadInfo->thread);
-                oc_thread_free(threadInfo->thread);
-            }
-            OICFree(threadInfo);
+            oc_thread_wait(worker->thread);
+            oc_thread_free(worker->thread);
+            worker->thread = NULL;
         }
     }
 
-    u_arraylist_free(&(thread_pool->details->threads_list));
-
-    oc_mutex_unlock(thread_pool->details->list_lock);
-    oc_mutex_free(thread_pool->details->list_lock);
+    // No dedicated task can be added once stop is set.
+    ca_thread_pool_dedicated_t* dedicated = pool->dedicated;
+    pool->dedicated = NULL;
+    while (dedicated)
+    {
+        ca_thread_pool_dedicated_t* next = dedicated->next;
+        oc_thread_wait(dedicated->thread);
+        oc_thread_free(dedicated->thread);
+        OICFree(dedicated);
+        dedicated = next;
+    }
 
-    OICFree(thread_pool->details);
+    ca_thread_pool_free_details(pool);
     OICFree(thread_pool);
 
     OIC_LOG(DEBUG, TAG, "OUT");
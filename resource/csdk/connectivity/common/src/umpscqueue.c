@@ -0,0 +1,264 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+#include "umpscqueue.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "experimental/logger.h"
+#include "oic_malloc.h"
+#include "ocatomic.h"
+#include "octhread.h"
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "OIC_UMPSCQUEUE"
+
+/**
+ * Ring slot. The sequence tells which lap of the ring the slot belongs to:
+ * equal to the position when free for a producer, position + 1 once the
+ * message has been published for the consumer.
+ */
+typedef struct
+{
+    volatile int32_t sequence;
+    void *msg;
+    uint32_t size;
+} u_mpsc_queue_cell_t;
+
+struct u_mpsc_queue_t
+{
+    /** Ring slots. */
+    u_mpsc_queue_cell_t *cells;
+    /** Number of ring slots minus one. */
+    uint32_t mask;
+    /** Next position to be claimed by a producer. */
+    volatile int32_t enqueuePos;
+    /** Next position to be read by the consumer. */
+    volatile int32_t dequeuePos;
+    /** Number of messages in the overflow queue. */
+    volatile int32_t overflowCount;
+    /** Protects the overflow queue. */
+    oc_mutex overflowMutex;
+    /** Messages added while the ring was full. */
+    u_queue_t *overflow;
+};
+
+static int32_t u_mpsc_queue_load(volatile int32_t *value)
+{
+    return oc_atomic_add(value, 0);
+}
+
+static bool u_mpsc_queue_ring_add(u_mpsc_queue_t *queue, void *msg, uint32_t size)
+{
+    uint32_t pos = (uint32_t) u_mpsc_queue_load(&queue->enqueuePos);
+    for (;;)
+    {
+        u_mpsc_queue_cell_t *cell = &queue->cells[pos & queue->mask];
+        int32_t diff = (int32_t) ((uint32_t) u_mpsc_queue_load(&cell->sequence) - pos);
+        if (0 == diff)
+        {
+            if (oc_atomic_cmpxchg(&queue->enqueuePos, (int32_t) pos, (int32_t) (pos + 1)))
+            {
+                cell->msg = msg;
+                cell->size = size;
+                // publish, full barrier orders the stores above
+                oc_atomic_increment(&cell->sequence);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // slot still holds a message from the previous lap: ring is full
+            return false;
+        }
+        pos = (uint32_t) u_mpsc_queue_load(&queue->enqueuePos);
+    }
+}
+
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity)
+{
+    uint32_t slots = 2;
+    while (slots < capacity && slots < 0x40000000)
+    {
+        slots <<= 1;
+    }
+
+    u_mpsc_queue_t *queue = (u_mpsc_queue_t *) OICCalloc(1, sizeof(u_mpsc_queue_t));
+    if (NULL == queue)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueCreate FAIL");
+        return NULL;
+    }
+
+    queue->cells = (u_mpsc_queue_cell_t *) OICCalloc(slots, sizeof(u_mpsc_queue_cell_t));
+    queue->overflow = u_queue_create();
+    queue->overflowMutex = oc_mutex_new();
+    if (NULL == queue->cells || NULL == queue->overflow || NULL == queue->overflowMutex)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueCreate FAIL, memory allocation failed");
+        u_mpsc_queue_delete(queue);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < slots; i++)
+    {
+        queue->cells[i].sequence = (int32_t) i;
+    }
+    queue->mask = slots - 1;
+
+    return queue;
+}
+
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        return;
+    }
+
+    if (queue->overflow)
+    {
+        u_queue_delete(queue->overflow);
+    }
+    if (queue->overflowMutex)
+    {
+        oc_mutex_free(queue->overflowMutex);
+    }
+    OICFree(queue->cells);
+    OICFree(queue);
+}
+
+CAResult_t u_mpsc_queue_add_element(u_mpsc_queue_t *queue, void *msg, uint32_t size)
+{
+    if (NULL == queue)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueAddElement FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    // Once anything has spilled into the overflow queue, keep appending there
+    // until the consumer has drained it so each producer stays in FIFO order.
+    if (0 == u_mpsc_queue_load(&queue->overflowCount)
+        && u_mpsc_queue_ring_add(queue, msg, size))
+    {
+        return CA_STATUS_OK;
+    }
+
+    CAResult_t res = CA_STATUS_OK;
+    oc_mutex_lock(queue->overflowMutex);
+    if (0 == u_mpsc_queue_load(&queue->overflowCount)
+        && u_mpsc_queue_ring_add(queue, msg, size))
+    {
+        oc_mutex_unlock(queue->overflowMutex);
+        return CA_STATUS_OK;
+    }
+
+    u_queue_message_t *message = (u_queue_message_t *) OICMalloc(sizeof(u_queue_message_t));
+    if (NULL == message)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueAddElement FAIL, memory allocation failed");
+        res = CA_MEMORY_ALLOC_FAILED;
+    }
+    else
+    {
+        message->msg = msg;
+        message->size = size;
+        res = u_queue_add_element(queue->overflow, message);
+        if (CA_STATUS_OK == res)
+        {
+            oc_atomic_increment(&queue->overflowCount);
+        }
+        else
+        {
+            OICFree(message);
+        }
+    }
+    oc_mutex_unlock(queue->overflowMutex);
+
+    return res;
+}
+
+bool u_mpsc_queue_get_element(u_mpsc_queue_t *queue, u_queue_message_t *message)
+{
+    if (NULL == queue || NULL == message)
+    {
+        return false;
+    }
+
+    uint32_t pos = (uint32_t) queue->dequeuePos;
+    u_mpsc_queue_cell_t *cell = &queue->cells[pos & queue->mask];
+
+    // A producer may have claimed the head slot without having published it
+    // yet. Wait for it rather than skipping ahead to the overflow queue, which
+    // could hand out that producer's later messages first.
+    while ((int32_t) ((uint32_t) u_mpsc_queue_load(&cell->sequence) - (pos + 1)) != 0)
+    {
+        // Sample the overflow before the ring: whatever was spilled then was
+        // added before anything a producer may claim once the ring is seen empty.
+        int32_t overflowCount = u_mpsc_queue_load(&queue->overflowCount);
+        if ((uint32_t) u_mpsc_queue_load(&queue->enqueuePos) != pos)
+        {
+            continue;
+        }
+
+        // ring is empty
+        if (0 == overflowCount)
+        {
+            return false;
+        }
+
+        oc_mutex_lock(queue->overflowMutex);
+        u_queue_message_t *element = u_queue_get_element(queue->overflow);
+        if (NULL != element)
+        {
+            oc_atomic_decrement(&queue->overflowCount);
+        }
+        oc_mutex_unlock(queue->overflowMutex);
+
+        if (NULL == element)
+        {
+            return false;
+        }
+        *message = *element;
+        OICFree(element);
+        return true;
+    }
+
+    message->msg = cell->msg;
+    message->size = cell->size;
+    queue->dequeuePos = (int32_t) (pos + 1);
+
+    // hand the slot to the producers of the next lap
+    oc_atomic_add(&cell->sequence, (int32_t) queue->mask);
+    return true;
+}
+
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        return true;
+    }
+
+    return u_mpsc_queue_load(&queue->enqueuePos) == queue->dequeuePos
+           && 0 == u_mpsc_queue_load(&queue->overflowCount);
+}
@@ -39,6 +39,18 @@ typedef void (*CAPacketReceivedCallback)(const CASecureEndpoint_t *sep,
 typedef ssize_t (*CAPacketSendCallback)(CAEndpoint_t *endpoint,
                                         const void *data, size_t dataLength);
 
+/**
+ * Counters of the session cache.
+ * A hit is a handshake that resumed a cached session, a miss one that had to run in full.
+ */
+typedef struct
+{
+    uint32_t clientHits;        /**< handshakes initiated by us that were resumed */
+    uint32_t clientMisses;      /**< full handshakes initiated by us */
+    uint32_t serverHits;        /**< handshakes of remote clients that were resumed */
+    uint32_t serverMisses;      /**< full handshakes of remote clients */
+} CASslSessionCacheStatistics_t;
+
 /**
  * Select the cipher suite for dtls handshake
  *
@@ -77,6 +89,39 @@ void CAsetSslAdapterCallbacks(CAPacketReceivedCallback recvCallback,
  * @param[in]   credTypesCallback    callback to get credential types.
  */
 void CAsetCredentialTypesCallback(CAgetCredentialTypesHandler credTypesCallback);
+
+/**
+ * Drops the parsed PKIX info, it is retrieved from the PKIX info callback again before
+ * the next handshake that uses certificates. The cached sessions are invalidated too.
+ */
+void CAsslNotifyPkixInfoChanged(void);
+
+/**
+ * Stops the cached sessions from being resumed, so that every peer runs a full
+ * handshake with the current credentials again. Does not lock, so it may be called
+ * from the callbacks of the adapter.
+ */
+void CAsslInvalidateSessionCache(void);
+
+/**
+ * Enables or disables caching and resuming sessions. Either way the cached sessions
+ * are invalidated, and handshakes already under way are not cached.
+ * @param[in]  enable    false while sessions must not be resumed later, e.g. during
+ *                       ownership transfer
+ */
+void CAsslEnableSessionCache(bool enable);
+
+/**
+ * Enables or disables caching and resuming the sessions with one peer. Unlike
+ * CAsslEnableSessionCache() it leaves the sessions with other peers alone, so the
+ * ownership of several devices can be transferred at the same time.
+ * @param[in]  endpoint  remote address, with the port of the secure session
+ * @param[in]  enable    false while sessions with the peer must not be resumed later
+ *
+ * @return  ::CA_STATUS_OK or appropriate error code
+ */
+CAResult_t CAsslEnableSessionCacheForPeer(const CAEndpoint_t *endpoint, bool enable);
+
 /**
  * Register callback to get credential types.
  * @param[in]  typesCallback    callback to get credential types.
@@ -212,6 +257,13 @@ bool SetCASecureEndpointAttribute(const CAEndpoint_t* peer, uint32_t newAttribut
  */
 bool GetCASecureEndpointAttributes(const CAEndpoint_t* peer, uint32_t* allAttributes);
 
+/**
+ * Gets the session cache counters.
+ *
+ * @param[out] stats   counters accumulated since the adapter was initialized.
+ */
+void CAsslGetSessionCacheStatistics(CASslSessionCacheStatistics_t *stats);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
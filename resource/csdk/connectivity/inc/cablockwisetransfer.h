@@ -53,6 +53,23 @@ typedef void (*CASendThreadFunc)(CAData_t *data);
  */
 typedef void (*CAReceiveThreadFunc)(CAData_t *data);
 
+struct CABlockData;
+
+/**
+ * Initial number of buckets of the block data index. Must be a power of two.
+ */
+#ifndef CA_BLOCK_INDEX_INITIAL_SIZE
+#define CA_BLOCK_INDEX_INITIAL_SIZE 16
+#endif
+
+/**
+ * Minimum size of a chunk of a received payload. Consecutive blocks are
+ * appended to the same chunk until it is full.
+ */
+#ifndef CA_BLOCK_CHUNK_SIZE
+#define CA_BLOCK_CHUNK_SIZE 4096
+#endif
+
 /**
  * context of blockwise transfer.
  */
@@ -78,6 +95,15 @@ typedef struct
 
     /** mulitcast data list mutex for synchronization. **/
     oc_mutex multicastDataListMutex;
+
+    /** block data of dataList hashed on their ID, guarded by blockDataListMutex. **/
+    struct CABlockData **blockDataIndex;
+
+    /** number of buckets of blockDataIndex. **/
+    size_t blockDataIndexSize;
+
+    /** optional callback receiving the payload of each block as it arrives. **/
+    CABlockWiseStreamCallback streamCallback;
 } CABlockWiseContext_t;
 
 /**
@@ -89,19 +115,33 @@ typedef struct
     size_t idLength;                   /**< length of blockData ID. */
 } CABlockDataID_t;
 
+/**
+ * Part of a received payload.
+ */
+typedef struct CABlockChunk
+{
+    struct CABlockChunk *next;          /**< next chunk. */
+    uint8_t *data;                      /**< chunk data, allocated with the chunk. */
+    size_t length;                      /**< bytes used in data. */
+    size_t capacity;                    /**< bytes allocated for data. */
+} CABlockChunk_t;
+
 /**
  * Block Data Set.
  */
-typedef struct
+typedef struct CABlockData
 {
     coap_block_t block1;                /**< block1 option. */
     coap_block_t block2;                /**< block2 option. */
     uint16_t type;                      /**< block option type. */
     CABlockDataID_t* blockDataId;       /**< ID set of CABlockData. */
     CAData_t *sentData;                 /**< sent request or response data information. */
-    CAPayload_t payload;                /**< payload buffer. */
+    CABlockChunk_t *payloadHead;        /**< received payload, in arrival order. */
+    CABlockChunk_t *payloadTail;        /**< last chunk of the received payload. */
     size_t payloadLength;               /**< the total payload length to be received. */
     size_t receivedPayloadLen;          /**< currently received payload length. */
+    bool isStreamed;                    /**< payload goes to the stream callback only. */
+    struct CABlockData *indexNext;      /**< next block data in the same index bucket. */
 } CABlockData_t;
 
 /**
@@ -158,6 +198,12 @@ CAResult_t CAInitBlockWiseMutexVariables(void);
  */
 void CATerminateBlockWiseMutexVariables(void);
 
+/**
+ * Set the callback receiving the payload of each block as it arrives.
+ * @param[in]   callback    stream callback, NULL to always reassemble the payload.
+ */
+void CASetBlockWiseStreamCallback(CABlockWiseStreamCallback callback);
+
 /**
  * Pass the bulk data. if block-wise transfer process need,
  *          bulk data will be sent to block messages.
@@ -553,7 +599,8 @@ coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID,
                                uint16_t blockType);
 
 /**
- * Get the full payload from block-wise list.
+ * Get the full payload from block-wise list. The received blocks are merged
+ * into one buffer, which stays owned by the block data.
  * @param[in]   blockID     ID set of CABlockData.
  * @param[out]  fullPayloadLen  received full payload length.
  * @return payload.
@@ -0,0 +1,116 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ * This file contains the duplicate detection of received CoAP messages
+ * (RFC 7252, section 4.5).
+ */
+
+#ifndef CA_DEDUPLICATION_H_
+#define CA_DEDUPLICATION_H_
+
+#include <stdint.h>
+
+#include "cacommon.h"
+
+/** Number of received messages remembered. Older ones are forgotten first. **/
+#ifndef CA_DEDUP_HISTORY_SIZE
+#define CA_DEDUP_HISTORY_SIZE       256
+#endif
+
+/** Buckets of the message ID index. Must be a power of two. **/
+#ifndef CA_DEDUP_BUCKETS
+#define CA_DEDUP_BUCKETS            64
+#endif
+
+/** How long a confirmable message is remembered (EXCHANGE_LIFETIME). **/
+#ifndef CA_EXCHANGE_LIFETIME_MSEC
+#define CA_EXCHANGE_LIFETIME_MSEC   247000
+#endif
+
+/** How long a non-confirmable message is remembered (NON_LIFETIME). **/
+#ifndef CA_NON_LIFETIME_MSEC
+#define CA_NON_LIFETIME_MSEC        145000
+#endif
+
+/** What to do with a received request. **/
+typedef enum
+{
+    CA_DEDUP_NEW = 0,       /**< first copy, process it */
+    CA_DEDUP_DUPLICATE,     /**< duplicate, drop it */
+    CA_DEDUP_REPLAY         /**< duplicate that has been answered, resend the response */
+} CADedupResult_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Initializes the history of received messages.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CADedupInitialize(void);
+
+/**
+ * Forgets all received messages and frees the history.
+ */
+void CADedupTerminate(void);
+
+/**
+ * Checks a received request against the history and remembers it if it is new.
+ *
+ * Requests are the same when they come from the same endpoint with the same
+ * message ID. A multicast request that arrives over IPv4 and IPv6 from the
+ * same interface is also recognized by its message ID and token.
+ *
+ * @param[in]   endpoint          source of the request.
+ * @param[in]   type              message type of the request.
+ * @param[in]   messageId         message ID of the request.
+ * @param[in]   token             token of the request.
+ * @param[in]   tokenLength       length of the token.
+ * @param[out]  response          for ::CA_DEDUP_REPLAY, copy of the response sent for
+ *                                the request. Must be freed by the caller.
+ * @param[out]  responseLength    length of the response.
+ * @return  ::CADedupResult_t.
+ */
+CADedupResult_t CADedupReceivedRequest(const CAEndpoint_t *endpoint, CAMessageType_t type,
+                                       uint16_t messageId, const uint8_t *token,
+                                       uint8_t tokenLength, void **response,
+                                       size_t *responseLength);
+
+/**
+ * Remembers the piggybacked response or empty ACK sent for a request, so that it
+ * can be resent when the request is received again.
+ *
+ * @param[in]   endpoint     destination of the response.
+ * @param[in]   messageId    message ID of the response, the same as the request's.
+ * @param[in]   pdu          response pdu binary data.
+ * @param[in]   size         response pdu binary data size.
+ */
+void CADedupSentResponse(const CAEndpoint_t *endpoint, uint16_t messageId,
+                         const void *pdu, size_t size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  /* CA_DEDUPLICATION_H_ */
@@ -47,6 +47,17 @@ typedef enum
     CA_SECURED_UNICAST_SERVER   /**< Secured Unicast Server */
 } CAAdapterServerType_t;
 
+/**
+ * Counters of the IP adapter send path.
+ * Comparing syscalls with messages shows how well sends are being batched.
+ */
+typedef struct
+{
+    uint32_t messages;      /**< datagrams handed to the kernel */
+    uint32_t syscalls;      /**< send system calls issued for them */
+    uint32_t failures;      /**< datagrams the kernel refused */
+} CAIPSendStatistics_t;
+
 /**
  * Callback to be notified on reception of any data from remote OIC devices.
  *
@@ -89,6 +100,8 @@ void CADeInitializeIPGlobals(void);
 
 /**
  * Stop IP server.
+ * Datagrams still queued by CAIPQueueSendData() are sent first, so the IP
+ * send thread must have been stopped.
  */
 void CAIPStopServer(void);
 
@@ -136,6 +149,38 @@ void CAIPSendData(CAEndpoint_t *endpoint,
                   size_t dataLength,
                   bool isMulticast);
 
+/**
+ * API to queue UDP data in the send batch.
+ *
+ * Datagrams are copied into the batch and handed to the kernel together
+ * by CAIPFlushSendData(). A multicast datagram is expanded into one copy
+ * per interface in the same batch. Where batching is not available the
+ * data is sent immediately.
+ * This must only be called from the IP send thread.
+ *
+ * @param[in]  endpoint          complete network address to send to.
+ * @param[in]  data              Data to be send.
+ * @param[in]  dataLength        Length of data in bytes.
+ * @param[in]  isMulticast       Whether data needs to be sent to multicast ip.
+ */
+void CAIPQueueSendData(CAEndpoint_t *endpoint,
+                       const void *data,
+                       size_t dataLength,
+                       bool isMulticast);
+
+/**
+ * Send all datagrams queued by CAIPQueueSendData().
+ * This must only be called from the IP send thread, or once it has stopped.
+ */
+void CAIPFlushSendData(void);
+
+/**
+ * Get the send path counters.
+ *
+ * @param[out] stats   counters accumulated since the process started.
+ */
+void CAIPGetSendStatistics(CAIPSendStatistics_t *stats);
+
 /**
  * Get IP adapter connection state.
  *
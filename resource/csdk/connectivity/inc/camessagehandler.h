@@ -27,6 +27,7 @@
 #define CA_MESSAGE_HANDLER_H_
 
 #include "cacommon.h"
+#include "caretransmission.h"
 #include <coap/coap.h>
 
 #define CA_MEMORY_ALLOC_CHECK(arg) { if (NULL == arg) {OIC_LOG(ERROR, TAG, "Out of memory"); \
@@ -92,12 +93,43 @@ void CATerminateMessageHandler(void);
  */
 void CAHandleRequestResponseCallbacks(void);
 
+/**
+ * Wait until CAHandleRequestResponseCallbacks() has received data to handle,
+ * CAWakeUpRequestResponseCallbacks() is called or the timeout expires.
+ * @param[in] timeoutUs    maximum time to wait in microseconds, 0 to wait
+ *                         without limit.
+ * @param[in,out] wakeUps  wake-up count of the caller, see
+ *                         CAQueueingThreadWaitForData().
+ * @return  true if received data is pending.
+ */
+bool CAWaitForRequestResponseCallbacks(uint64_t timeoutUs, uint32_t *wakeUps);
+
+/**
+ * Make all callers of CAWaitForRequestResponseCallbacks() return.
+ */
+void CAWakeUpRequestResponseCallbacks(void);
+
 /**
  * Setting the Callback funtion for network state change callback.
  * @param[in] nwMonitorHandler    callback for network state change.
  */
 void CASetNetworkMonitorCallback(CANetworkMonitorCallback nwMonitorHandler);
 
+/**
+ * Set the number of outstanding CON data per endpoint, also for the next
+ * CAInitializeMessageHandler().
+ * @param[in] nstart    outstanding CON data per endpoint, 0 is unlimited.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASetMessageHandlerNstart(uint8_t nstart);
+
+/**
+ * Get the counters of CON data pacing and retransmission.
+ * @param[out] statistics    counters.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAGetMessageHandlerStatistics(CARetransmissionStatistics_t *statistics);
+
 #if defined(WITH_BWT) || defined(TCP_ADAPTER)
 /**
  * Add the data to the send queue thread.
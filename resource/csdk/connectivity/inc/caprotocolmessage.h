@@ -215,6 +215,22 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
 coap_pdu_t *CAParsePDU(const char *data, size_t length, uint32_t *outCode,
                        const CAEndpoint_t *endpoint);
 
+/**
+ * set up a pdu that refers to received CoAP over UDP data, without copying it.
+ * The data must not change while the pdu is used. The pdu must not be modified
+ * or passed to coap_delete_pdu().
+ * @param[in]   data                received data.
+ * @param[in]   length              length of the data received.
+ * @param[out]  pdu                 pdu referring to the data.
+ * @param[out]  outCode             code received.
+ * @param[in]   endpoint            endpoint information.
+ * @return  ::CA_STATUS_OK, ::CA_NOT_SUPPORTED if the data has to be parsed with
+ *          CAParsePDU() (CoAP over TCP or data not aligned for coap_hdr_t),
+ *          or another error code if the data is not a valid message.
+ */
+CAResult_t CAParsePDUInPlace(const char *data, size_t length, coap_pdu_t *pdu,
+                             uint32_t *outCode, const CAEndpoint_t *endpoint);
+
 /**
  * get Token from received data(pdu).
  * @param[in]    pdu_hdr             header of received pdu.
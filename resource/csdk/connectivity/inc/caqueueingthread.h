@@ -32,15 +32,29 @@
 #include "cathreadpool.h"
 #include "octhread.h"
 #include "uqueue.h"
+#include "umpscqueue.h"
 #include "cacommon.h"
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/** Maximum number of data taken off the queue per wakeup. **/
+#ifndef CA_QUEUEING_THREAD_BATCH_SIZE
+#define CA_QUEUEING_THREAD_BATCH_SIZE 32
+#endif
+
+/** Number of ring slots of a lock-free queue. **/
+#ifndef CA_QUEUEING_THREAD_RING_SIZE
+#define CA_QUEUEING_THREAD_RING_SIZE 256
+#endif
+
 /** Thread function to be invoked. **/
 typedef void (*CAThreadTask)(void *threadData);
 
+/** Thread function to be invoked with a batch of data. **/
+typedef void (*CAThreadBatchTask)(void **threadData, uint32_t count);
+
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
@@ -60,6 +74,14 @@ typedef struct
     bool isStop;
     /** Que on which the thread is operating. **/
     u_queue_t *dataQueue;
+    /** Lock-free queue used instead of dataQueue, if created. **/
+    u_mpsc_queue_t *mpscQueue;
+    /** Function invoked for each batch of data, used instead of threadTask if set. **/
+    CAThreadBatchTask batchTask;
+    /** Number of threads waiting for data. **/
+    volatile int32_t parked;
+    /** Number of CAQueueingThreadWakeUp() calls, compared by each waiter. **/
+    uint32_t wakeUps;
 } CAQueueingThread_t;
 
 /**
@@ -73,6 +95,31 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Initializes the queuing thread on a lock-free queue.
+ * Any thread may add data, but data must only be taken off the queue by the
+ * queuing thread or by CAQueueingThreadGetData(). The dataQueue member is
+ * not used and stays NULL.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadInitializeLockFree(CAQueueingThread_t *thread,
+                                              ca_thread_pool_t handle,
+                                              CAThreadTask task,
+                                              CADataDestroyFunction destroy);
+
+/**
+ * Set a function to be called with all data taken off the queue in one
+ * wakeup, up to ::CA_QUEUEING_THREAD_BATCH_SIZE, instead of the per data task.
+ * Must be called before the queuing thread is started.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   task         function to be called for each batch of data.
+ */
+void CAQueueingThreadSetBatchTask(CAQueueingThread_t *thread, CAThreadBatchTask task);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -89,6 +136,51 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Check whether the queuing thread has no pending data.
+ * Thread tasks can use this to defer work until the queue has been drained.
+ * @param[in]   thread       thread data for each thread.
+ * @return  true if no data is waiting to be processed, otherwise false.
+ */
+bool CAQueueingThreadIsEmpty(CAQueueingThread_t *thread);
+
+/**
+ * Take the oldest data off the queue without invoking the thread task.
+ * Used to drain a queue whose queuing thread has not been started.
+ * The caller owns the data and must release it.
+ * @param[in]   thread       thread data for each thread.
+ * @param[out]  data         data taken off the queue.
+ * @param[out]  size         length of the data.
+ * @return  true if data was taken off the queue, false if it is empty.
+ */
+bool CAQueueingThreadGetData(CAQueueingThread_t *thread, void **data, uint32_t *size);
+
+/**
+ * Wait until data is queued, CAQueueingThreadWakeUp() is called or the timeout
+ * expires. Used together with CAQueueingThreadGetData() on a queue whose
+ * queuing thread has not been started.
+ * Every waiter keeps its own wake-up count, so a wake-up meant for one waiter
+ * can not be consumed by another one waiting on the same queue.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   timeoutUs    maximum time to wait in microseconds, 0 to wait
+ *                           without limit.
+ * @param[in,out] wakeUps    wake-up count the caller saw when its previous
+ *                           wait returned. The wait returns at once if
+ *                           CAQueueingThreadWakeUp() was called since, and the
+ *                           current count is stored on return. NULL to only
+ *                           return for wake-ups made during this call.
+ * @return  true if the queue holds data.
+ */
+bool CAQueueingThreadWaitForData(CAQueueingThread_t *thread, uint64_t timeoutUs,
+                                 uint32_t *wakeUps);
+
+/**
+ * Make all callers of CAQueueingThreadWaitForData() return, including those
+ * that are about to wait with an older wake-up count.
+ * @param[in]   thread       thread data for each thread.
+ */
+void CAQueueingThreadWakeUp(CAQueueingThread_t *thread);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
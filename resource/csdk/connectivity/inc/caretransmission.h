@@ -44,8 +44,25 @@
 /** default max retransmission trying count is 4(CoAP). **/
 #define DEFAULT_RETRANSMISSION_COUNT      4
 
-/** check period is 1 sec. **/
-#define RETRANSMISSION_CHECK_PERIOD_SEC     1
+/** resolution of the retransmission timer wheel is 100 msec. **/
+#ifndef RETRANSMISSION_TICK_MSEC
+#define RETRANSMISSION_TICK_MSEC    100
+#endif
+
+/** default number of outstanding CON data per endpoint is unlimited, 1 is CoAP NSTART. **/
+#ifndef DEFAULT_NSTART
+#define DEFAULT_NSTART              0
+#endif
+
+/** upper limit of the estimated retransmission timeout (CoCoA). **/
+#ifndef MAX_RTO_MSEC
+#define MAX_RTO_MSEC                32000
+#endif
+
+/** endpoints whose RTO estimate is kept while nothing is outstanding. **/
+#ifndef RETRANSMISSION_PEER_CACHE_SIZE
+#define RETRANSMISSION_PEER_CACHE_SIZE  256
+#endif
 
 /** retransmission data send method type. **/
 typedef CAResult_t (*CADataSendMethod_t)(const CAEndpoint_t *endpoint,
@@ -66,8 +83,14 @@ typedef struct
     /** retransmission trying count. **/
     uint8_t tryingCount;
 
+    /** outstanding CON data per endpoint, later data waits. 0 is unlimited. **/
+    uint8_t nstart;
+
 } CARetransmissionConfig_t;
 
+/** pending CON data indexed by deadline and by message id. **/
+typedef struct CARetransmissionQueue CARetransmissionQueue_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -91,8 +114,11 @@ typedef struct
     /** Variable to inform the thread to stop. **/
     bool isStop;
 
-    /** array list on which the thread is operating. **/
-    u_arraylist_t *dataList;
+    /** retransmission data on which the thread is operating. **/
+    CARetransmissionQueue_t *pending;
+
+    /** counters, protected by threadMutex. **/
+    CARetransmissionStatistics_t statistics;
 
 } CARetransmission_t;
 
@@ -125,16 +151,20 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
 CAResult_t CARetransmissionStart(CARetransmission_t *context);
 
 /**
- * Pass the sent pdu data. if retransmission process need, internal thread will wake up and
- * process the retransmission data.
+ * Send CON pdu data with the send method and retransmit it until it is acknowledged.
+ * When nstart is configured and that many CON data to the endpoint are outstanding,
+ * the data waits and is sent when one of them is acknowledged or times out.
+ * Retransmission timeouts follow an RTT estimate of the endpoint (CoCoA).
  * @param[in]   context      context for retransmission.
  * @param[in]   endpoint     endpoint information.
  * @param[in]   dataType     Data type which is REQUEST or RESPONSE.
- * @param[in]   pdu          sent pdu binary data.
- * @param[in]   size         sent pdu binary data size.
- * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ * @param[in]   pdu          pdu binary data to send.
+ * @param[in]   size         pdu binary data size.
+ * @return  ::CA_STATUS_OK when the data was sent or waits to be sent,
+ *          ::CA_NOT_SUPPORTED when the caller has to send it without retransmission,
+ *          or ERROR CODES (::CAResult_t error codes in cacommon.h).
  */
-CAResult_t CARetransmissionSentData(CARetransmission_t *context,
+CAResult_t CARetransmissionSendData(CARetransmission_t *context,
                                     const CAEndpoint_t *endpoint,
                                     CADataType_t dataType,
                                     const void *pdu, uint32_t size);
@@ -167,6 +197,24 @@ CAResult_t CARetransmissionStop(CARetransmission_t *context);
  */
 CAResult_t CARetransmissionDestroy(CARetransmission_t *context);
 
+/**
+ * Change the number of outstanding CON data per endpoint. Data that already waits
+ * is sent as outstanding data to its endpoint is answered.
+ * @param[in]   context         context for retransmission.
+ * @param[in]   nstart          outstanding CON data per endpoint, 0 is unlimited.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CARetransmissionSetNstart(CARetransmission_t *context, uint8_t nstart);
+
+/**
+ * Get the counters of the retransmission context.
+ * @param[in]   context         context for retransmission.
+ * @param[out]  statistics      counters.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CARetransmissionGetStatistics(CARetransmission_t *context,
+                                         CARetransmissionStatistics_t *statistics);
+
 /**
  * Invoke Retransmission according to TimedAction Response.
  * @param[in]   threadValue     context for retransmission.
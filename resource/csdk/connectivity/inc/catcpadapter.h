@@ -74,9 +74,12 @@ typedef struct CATCPSessionInfo_t
 {
     CASecureEndpoint_t sep;             /**< secure endpoint information */
     CASocketFd_t fd;                    /**< file descriptor info */
-    unsigned char* data;                /**< received data from remote device */
-    size_t len;                         /**< received data length */
-    size_t totalLen;                    /**< total coap data length required to receive */
+    unsigned char *recvBuffer;          /**< ring of received CoAP data not parsed yet */
+    size_t recvCapacity;                /**< ring size, a power of two */
+    size_t recvStart;                   /**< ring offset of the first unparsed byte */
+    size_t recvLen;                     /**< number of unparsed bytes in the ring */
+    unsigned char *frameBuffer;         /**< copy of a frame wrapping around the ring */
+    size_t frameCapacity;               /**< frame buffer size */
     unsigned char tlsdata[18437];       /**< tls data(rfc5246: TLSCiphertext max (2^14+2048+5)) */
     size_t tlsLen;                      /**< received tls data length */
     CAProtocol_t protocol;              /**< application-level protocol */
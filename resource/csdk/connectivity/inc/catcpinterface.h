@@ -221,18 +221,32 @@ void CATCPCloseInProgressConnections();
 size_t CACheckPayloadLengthFromHeader(const void *data, size_t dlen);
 
 /**
- * Construct CoAP header and payload from buffer
+ * Append received data to the receive ring of a session.
  *
- * @param[in] svritem - used socket, buffer, current received message length and protocol
- * @param[in,out]  data  - data buffer, this value is updated as data is copied to svritem
- * @param[in,out]  dataLength  - length of data, this value decreased as data is copied to svritem
- * @return             - CA_STATUS_OK or appropriate error code
+ * @param[in,out] svritem     session the data was received on.
+ * @param[in]     data        received data.
+ * @param[in]     dataLength  length of data.
+ * @return  ::CA_STATUS_OK or appropriate error code.
  */
-CAResult_t CAConstructCoAP(CATCPSessionInfo_t *svritem, unsigned char **data,
-                          size_t *dataLength);
+CAResult_t CAAppendReceivedData(CATCPSessionInfo_t *svritem, const unsigned char *data,
+                                size_t dataLength);
 
 /**
- * Clean socket state data
+ * Take the next complete CoAP over TCP message out of the receive ring of a
+ * session. The message is not copied unless it wraps around the end of the
+ * ring, so it is only valid until more data is received on the session.
+ *
+ * @param[in,out] svritem      session to parse.
+ * @param[out]    frame        message, or NULL if it is not complete yet.
+ * @param[out]    frameLength  message length.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAGetNextCoAPFrame(CATCPSessionInfo_t *svritem, const unsigned char **frame,
+                              size_t *frameLength);
+
+/**
+ * Clean socket state data. Drops data received but not parsed yet and
+ * releases the receive buffers.
  *
  * @param[in,out] svritem - socket state data
  */
@@ -39,6 +39,8 @@
 #include "experimental/byte_array.h"
 #include "octhread.h"
 #include "octimer.h"
+#include "ocatomic.h"
+#include "oic_time.h"
 
 // headers required for mbed TLS
 #include "mbedtls/platform.h"
@@ -180,6 +182,31 @@
  */
 #define RETRANSMISSION_TIME 1
 
+/**
+ * @def SSL_PEER_INDEX_INITIAL_SIZE
+ * @brief Initial number of buckets of the peer index, doubled as peers are added.
+ */
+#ifndef SSL_PEER_INDEX_INITIAL_SIZE
+#define SSL_PEER_INDEX_INITIAL_SIZE (64)
+#endif
+
+/**
+ * @def SSL_SESSION_CACHE_SIZE
+ * @brief Number of sessions kept for resumption, each for client and for server sessions.
+ */
+#ifndef SSL_SESSION_CACHE_SIZE
+#define SSL_SESSION_CACHE_SIZE (32)
+#endif
+
+/**
+ * @def SSL_SESSION_CACHE_TIMEOUT
+ * @brief Seconds a session can be resumed for after its full handshake. Kept short as
+ * resuming skips the credential lookup that a full handshake makes.
+ */
+#ifndef SSL_SESSION_CACHE_TIMEOUT
+#define SSL_SESSION_CACHE_TIMEOUT (600)
+#endif
+
 /**@def SSL_CLOSE_NOTIFY(peer, ret)
  *
  * Notifies of existing \a peer about closing TLS connection.
@@ -357,6 +384,21 @@ typedef struct TlsCallBacks
     CAErrorHandleCallback errorCallback;    /**< Callback used to pass error to upper layer. */
 } SslCallbacks_t;
 
+/**
+ * Session kept for resumption, with the peer data an abbreviated handshake does not carry.
+ */
+typedef struct SslCachedSession
+{
+    bool used;
+    CAEndpoint_t endpoint;          /**< peer of a client session, which is looked up by it */
+    mbedtls_ssl_session session;    /**< a server session is looked up by its id */
+    CARemoteId_t identity;
+    CARemoteId_t userId;
+    uint8_t random[2*RANDOM_LEN];   /**< randoms of the full handshake */
+    uint64_t created;               /**< time of the full handshake in milliseconds */
+    int32_t version;                /**< g_sessionCacheVersion of the full handshake */
+} SslCachedSession_t;
+
 /**
  * Data structure for holding the mbedTLS interface related info.
  */
@@ -364,6 +406,8 @@ typedef struct SslContext
 {
     u_arraylist_t *peerList;         /**< peer list which holds the mapping between
                                               peer id, it's n/w address and mbedTLS context. */
+    struct SslEndPoint **peerIndex;  /**< hash buckets over peerList, created on first use */
+    size_t peerIndexSize;            /**< number of buckets in peerIndex */
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context rnd;
     mbedtls_x509_crt ca;
@@ -381,6 +425,20 @@ typedef struct SslContext
     bool cipherFlag[2];
     int selectedCipher;
 
+    bool pkixLoaded;                            /**< ca, crt, pkey and crl hold the PKIX info */
+    int32_t pkixVersion;                        /**< g_pkixInfoVersion it was loaded at */
+    CAgetPkixInfoHandler pkixInfoCallback;      /**< callback it was loaded from */
+    bool ownCertLoaded;                         /**< crt and pkey can be used */
+    bool caLoaded;                              /**< ca can be used */
+    bool crlLoaded;                             /**< crl can be used */
+    bool pkixConfigured[2];                     /**< TLS and DTLS configs use the loaded info */
+
+    SslCachedSession_t clientSessions[SSL_SESSION_CACHE_SIZE];
+    SslCachedSession_t serverSessions[SSL_SESSION_CACHE_SIZE];
+    CASslSessionCacheStatistics_t sessionStats;
+    u_arraylist_t *uncachedPeers;    /**< peers whose sessions are not cached, created on
+                                          first use, see CAsslEnableSessionCacheForPeer() */
+
 #ifdef __WITH_DTLS__
     mbedtls_ssl_cookie_ctx cookieCtx;
     int timerId;
@@ -410,6 +468,24 @@ static CAgetCredentialTypesHandler g_getCredentialTypesCallback = NULL;
  * @brief callback to get X.509-based Public Key Infrastructure
  */
 static CAgetPkixInfoHandler g_getPkixInfoCallback = NULL;
+/**
+ * @var g_pkixInfoVersion
+ *
+ * @brief incremented whenever the information provided by g_getPkixInfoCallback changes
+ */
+static volatile int32_t g_pkixInfoVersion = 0;
+/**
+ * @var g_sessionCacheVersion
+ *
+ * @brief incremented whenever the cached sessions must no longer be resumed
+ */
+static volatile int32_t g_sessionCacheVersion = 0;
+/**
+ * @var g_sessionCacheEnabled
+ *
+ * @brief whether sessions are cached and resumed, see CAsslEnableSessionCache()
+ */
+static volatile bool g_sessionCacheEnabled = true;
 /**
  * @var g_getIdentityCallback
  *
@@ -420,9 +496,19 @@ static CAgetIdentityHandler g_getIdentityCallback = NULL;
 /**
  * @var g_dtlsContextMutex
  * @brief Mutex to synchronize access to g_caSslContext and g_sslCallback.
+ *
+ * It also serializes the handshakes, which reconfigure the shared mbedTLS configs. Records
+ * of established sessions are only protected by the mutex of their peer, which is always
+ * taken after this one.
  */
 static oc_mutex g_sslContextMutex = NULL;
 
+/**
+ * @var g_sslRngMutex
+ * @brief Mutex to synchronize access to the random generator shared by all sessions.
+ */
+static oc_mutex g_sslRngMutex = NULL;
+
 /**
  * @var g_sslCallback
  * @brief callback to deliver the TLS handshake result
@@ -460,12 +546,23 @@ typedef struct SslEndPoint
 #ifdef __WITH_DTLS__
     mbedtls_timing_delay_context timer;
 #endif // __WITH_DTLS__
+    bool resumed;                   /**< the handshake resumed a cached session */
+    bool cacheable;                 /**< the session cache was enabled at the start */
+    int32_t cacheVersion;           /**< g_sessionCacheVersion at the start */
+    oc_mutex mutex;                 /**< protects ssl and recBuf */
+    volatile int32_t refCount;      /**< one reference is held by the peer list */
+    struct SslEndPoint * indexNext; /**< next peer in the same peerIndex bucket */
 } SslEndPoint_t;
 
 void CAsetPskCredentialsCallback(CAgetPskCredentialsHandler credCallback)
 {
     // TODO Does this method needs protection of tlsContextMutex?
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    if (credCallback != g_getCredentialsCallback)
+    {
+        // ownership transfer swaps in a callback that derives the PSK from a PIN
+        CAsslInvalidateSessionCache();
+    }
     g_getCredentialsCallback = credCallback;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
@@ -473,13 +570,41 @@ void CAsetPskCredentialsCallback(CAgetPskCredentialsHandler credCallback)
 void CAsetPkixInfoCallback(CAgetPkixInfoHandler infoCallback)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    if (infoCallback != g_getPkixInfoCallback)
+    {
+        // sessions authenticated by other certificates must not be resumed
+        CAsslInvalidateSessionCache();
+    }
     g_getPkixInfoCallback = infoCallback;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
 
+void CAsslNotifyPkixInfoChanged(void)
+{
+    oc_atomic_increment(&g_pkixInfoVersion);
+    // the certificate or CRL of a cached session may be gone
+    CAsslInvalidateSessionCache();
+}
+
+void CAsslInvalidateSessionCache(void)
+{
+    oc_atomic_increment(&g_sessionCacheVersion);
+}
+
+void CAsslEnableSessionCache(bool enable)
+{
+    g_sessionCacheEnabled = enable;
+    // a handshake already started must not be cached after a change either way
+    CAsslInvalidateSessionCache();
+}
+
 void CAsetIdentityCallback(CAgetIdentityHandler identityCallback)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    if (identityCallback != g_getIdentityCallback)
+    {
+        CAsslInvalidateSessionCache();
+    }
     g_getIdentityCallback = identityCallback;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
@@ -725,11 +850,12 @@ static void DeInitPkixInfo(PkiInfo_t * inf)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
 
-//Loads PKIX related information from SRM
-static int InitPKIX(CATransportAdapter_t adapter)
+/**
+ * Retrieves the PKIX related information from SRM and parses it into the context.
+ */
+static void LoadPkixInfo(void)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
-    VERIFY_NON_NULL_RET(g_getPkixInfoCallback, NET_SSL_TAG, "PKIX info callback is NULL", -1);
     // load pk key, cert, trust chain and crl
     PkiInfo_t pkiInfo = {
         BYTE_ARRAY_INITIALIZER,
@@ -738,12 +864,7 @@ static int InitPKIX(CATransportAdapter_t adapter)
         BYTE_ARRAY_INITIALIZER
     };
 
-    if (g_getPkixInfoCallback)
-    {
-        g_getPkixInfoCallback(&pkiInfo);
-    }
-
-    VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", -1);
+    g_getPkixInfoCallback(&pkiInfo);
 
     mbedtls_x509_crt_free(&g_caSslContext->ca);
     mbedtls_x509_crt_free(&g_caSslContext->crt);
@@ -755,12 +876,10 @@ static int InitPKIX(CATransportAdapter_t adapter)
     mbedtls_pk_init(&g_caSslContext->pkey);
     mbedtls_x509_crl_init(&g_caSslContext->crl);
 
-    mbedtls_ssl_config * serverConf = (adapter == CA_ADAPTER_IP ||
-                                   adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
-    mbedtls_ssl_config * clientConf = (adapter == CA_ADAPTER_IP ||
-                                   adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->clientDtlsConf : &g_caSslContext->clientTlsConf);
+    g_caSslContext->ownCertLoaded = false;
+    g_caSslContext->caLoaded = false;
+    g_caSslContext->crlLoaded = false;
+
     // optional
     int ret;
     int errNum;
@@ -795,44 +914,16 @@ static int InitPKIX(CATransportAdapter_t adapter)
         OIC_LOG(WARNING, NET_SSL_TAG, "Key parsing error");
         goto required;
     }
-
-    ret = mbedtls_ssl_conf_own_cert(serverConf, &g_caSslContext->crt, &g_caSslContext->pkey);
-    if (0 != ret)
-    {
-        OIC_LOG(WARNING, NET_SSL_TAG, "Own certificate parsing error");
-        goto required;
-    }
-    ret = mbedtls_ssl_conf_own_cert(clientConf, &g_caSslContext->crt, &g_caSslContext->pkey);
-    if(0 != ret)
-    {
-        OIC_LOG(WARNING, NET_SSL_TAG, "Own certificate configuration error");
-        goto required;
-    }
-
-    /* If we get here, certificates could be used, so configure OCF EKUs. */
-    ret = mbedtls_ssl_conf_ekus(serverConf, (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY),
-        (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY));
-    if (0 == ret)
-    {
-        ret = mbedtls_ssl_conf_ekus(clientConf, (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY),
-            (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY));
-    }
-    if (0 != ret)
-    {
-        /* Cert-based ciphersuites will fail, but if PSK ciphersuites are in
-         * the list they might work, so don't return error.
-         */
-        OIC_LOG(WARNING, NET_SSL_TAG, "EKU configuration error");
-    }
+    g_caSslContext->ownCertLoaded = true;
 
     required:
     count = ParseChain(&g_caSslContext->ca, pkiInfo.ca.data, pkiInfo.ca.len, &errNum);
     if(0 >= count)
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "CA chain parsing error");
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         DeInitPkixInfo(&pkiInfo);
-        return -1;
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return;
     }
     if(0 != errNum)
     {
@@ -844,33 +935,120 @@ static int InitPKIX(CATransportAdapter_t adapter)
         if (CP_INVALID_CERT_LIST == ret)
         {
             OIC_LOG(ERROR, NET_SSL_TAG, "Invalid own CA cert chain");
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             DeInitPkixInfo(&pkiInfo);
-            return -1;
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            return;
         }
         else if (0 < ret )
         {
             OIC_LOG_V(ERROR, NET_SSL_TAG, "%d certificate(s) in own CA cert chain violate OCF Root CA cert profile requirements", ret);
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             DeInitPkixInfo(&pkiInfo);
-            return -1;
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            return;
         }
     }
+    g_caSslContext->caLoaded = true;
 
     ret = mbedtls_x509_crl_parse_der(&g_caSslContext->crl, pkiInfo.crl.data, pkiInfo.crl.len);
     if(0 != ret)
     {
         OIC_LOG(WARNING, NET_SSL_TAG, "CRL parsing error");
-        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain, &g_caSslContext->ca, NULL);
     }
     else
     {
-        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain,
-                 &g_caSslContext->ca, &g_caSslContext->crl);
+        g_caSslContext->crlLoaded = true;
     }
 
     DeInitPkixInfo(&pkiInfo);
 
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+}
+
+/**
+ * Sets up the configs of an adapter with the PKIX related information from SRM.
+ * The information is retrieved and parsed again only when it has changed, see
+ * CAsslNotifyPkixInfoChanged(), or when another callback provides it.
+ *
+ * @param[in]  adapter    transport adapter of the configs
+ *
+ * @return  0 on success, -1 if no CA chain is available
+ */
+static int InitPKIX(CATransportAdapter_t adapter)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(g_getPkixInfoCallback, NET_SSL_TAG, "PKIX info callback is NULL", -1);
+    VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", -1);
+
+    int32_t version = g_pkixInfoVersion;
+    if (!g_caSslContext->pkixLoaded || version != g_caSslContext->pkixVersion
+        || g_getPkixInfoCallback != g_caSslContext->pkixInfoCallback)
+    {
+        LoadPkixInfo();
+        g_caSslContext->pkixLoaded = true;
+        g_caSslContext->pkixVersion = version;
+        g_caSslContext->pkixInfoCallback = g_getPkixInfoCallback;
+        g_caSslContext->pkixConfigured[0] = false;
+        g_caSslContext->pkixConfigured[1] = false;
+    }
+
+    bool isDtls = (adapter == CA_ADAPTER_IP || adapter == CA_ADAPTER_GATT_BTLE);
+    // mbedtls_ssl_conf_own_cert() adds to a list, so the configs are only set up once per load
+    if (g_caSslContext->pkixConfigured[isDtls])
+    {
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return g_caSslContext->caLoaded ? 0 : -1;
+    }
+    g_caSslContext->pkixConfigured[isDtls] = true;
+
+    mbedtls_ssl_config * serverConf = (isDtls ?
+                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
+    mbedtls_ssl_config * clientConf = (isDtls ?
+                                   &g_caSslContext->clientDtlsConf : &g_caSslContext->clientTlsConf);
+    int ret;
+    if (!g_caSslContext->ownCertLoaded)
+    {
+        goto required;
+    }
+
+    ret = mbedtls_ssl_conf_own_cert(serverConf, &g_caSslContext->crt, &g_caSslContext->pkey);
+    if (0 != ret)
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Own certificate parsing error");
+        goto required;
+    }
+    ret = mbedtls_ssl_conf_own_cert(clientConf, &g_caSslContext->crt, &g_caSslContext->pkey);
+    if(0 != ret)
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Own certificate configuration error");
+        goto required;
+    }
+
+    /* If we get here, certificates could be used, so configure OCF EKUs. */
+    ret = mbedtls_ssl_conf_ekus(serverConf, (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY),
+        (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY));
+    if (0 == ret)
+    {
+        ret = mbedtls_ssl_conf_ekus(clientConf, (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY),
+            (const char*)EKU_IDENTITY, sizeof(EKU_IDENTITY));
+    }
+    if (0 != ret)
+    {
+        /* Cert-based ciphersuites will fail, but if PSK ciphersuites are in
+         * the list they might work, so don't return error.
+         */
+        OIC_LOG(WARNING, NET_SSL_TAG, "EKU configuration error");
+    }
+
+    required:
+    if (!g_caSslContext->caLoaded)
+    {
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return -1;
+    }
+
+    CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain, &g_caSslContext->ca,
+             g_caSslContext->crlLoaded ? &g_caSslContext->crl : NULL);
+
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return 0;
 }
@@ -916,6 +1094,45 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
     OIC_LOG_V(WARNING, NET_SSL_TAG, "Out %s", __func__);
     return -1;
 }
+/**
+ * Hashes the fields GetSslPeer() matches peers on.
+ *
+ * @param[in]  endpoint    remote address
+ *
+ * @return  hash of the adapter, the address and, except for BLE, the port
+ */
+static size_t HashSslPeer(const CAEndpoint_t *endpoint)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t)endpoint->adapter) * 16777619u;
+    for (size_t i = 0; i < MAX_ADDR_STR_SIZE_CA && '\0' != endpoint->addr[i]; i++)
+    {
+        hash = (hash ^ (uint8_t)endpoint->addr[i]) * 16777619u;
+    }
+    // BLE peers are matched on the address alone
+    if (CA_ADAPTER_GATT_BTLE != endpoint->adapter)
+    {
+        hash = (hash ^ endpoint->port) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Compares the fields of two remote addresses that identify a TLS peer.
+ *
+ * @param[in]  a    remote address
+ * @param[in]  b    remote address
+ *
+ * @return  true if both addresses belong to the same peer
+ */
+static bool IsSameSslPeer(const CAEndpoint_t *a, const CAEndpoint_t *b)
+{
+    return (a->adapter == b->adapter)
+            && (0 == strncmp(a->addr, b->addr, MAX_ADDR_STR_SIZE_CA))
+            && (a->port == b->port || CA_ADAPTER_GATT_BTLE == a->adapter);
+}
+
 /**
  * Gets session corresponding for endpoint.
  *
@@ -925,39 +1142,24 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
  */
 static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
 {
-    size_t listIndex = 0;
-    size_t listLength = 0;
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
-
     oc_mutex_assert_owner(g_sslContextMutex, true);
 
     VERIFY_NON_NULL_RET(peer, NET_SSL_TAG, "TLS peer is NULL", NULL);
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", NULL);
 
-    SslEndPoint_t *tep = NULL;
-    listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (listIndex = 0; listIndex < listLength; listIndex++)
+    if (NULL == g_caSslContext->peerIndex)
     {
-        tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Compare [%s:%d] and [%s:%d] for %d adapter",
-                  peer->addr, peer->port, tep->sep.endpoint.addr, tep->sep.endpoint.port,
-                  peer->adapter);
+        return NULL;
+    }
 
-        if((peer->adapter == tep->sep.endpoint.adapter)
-                && (0 == strncmp(peer->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA))
-                && (peer->port == tep->sep.endpoint.port || CA_ADAPTER_GATT_BTLE == peer->adapter))
+    size_t bucket = HashSslPeer(peer) & (g_caSslContext->peerIndexSize - 1);
+    for (SslEndPoint_t *tep = g_caSslContext->peerIndex[bucket]; tep; tep = tep->indexNext)
+    {
+        if (IsSameSslPeer(peer, &tep->sep.endpoint))
         {
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return tep;
         }
     }
-    OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return NULL;
 }
 
@@ -1150,42 +1352,532 @@ static void DeleteSslEndPoint(SslEndPoint_t * tep)
 
     mbedtls_ssl_free(&tep->ssl);
     DeleteCacheList(tep->cacheList);
+    oc_mutex_free(tep->mutex);
     OICFree(tep);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
+
+/**
+ * Takes a reference to an endpoint, which keeps it alive after it is removed from the list.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void RefSslEndPoint(SslEndPoint_t * tep)
+{
+    oc_atomic_increment(&tep->refCount);
+}
+
+/**
+ * Drops a reference to an endpoint and deletes it with the last one.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void UnrefSslEndPoint(SslEndPoint_t * tep)
+{
+    if (0 == oc_atomic_decrement(&tep->refCount))
+    {
+        DeleteSslEndPoint(tep);
+    }
+}
+
+/**
+ * Rehashes the peer index into @p newSize buckets.
+ *
+ * @param[in]  newSize    new number of buckets, a power of two
+ *
+ * @return  true on success, false if out of memory
+ */
+static bool ResizePeerIndex(size_t newSize)
+{
+    SslEndPoint_t **newIndex = (SslEndPoint_t **)OICCalloc(newSize, sizeof(*newIndex));
+    if (NULL == newIndex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "peer index allocation failed!");
+        return false;
+    }
+
+    for (size_t i = 0; i < g_caSslContext->peerIndexSize; i++)
+    {
+        SslEndPoint_t *tep = g_caSslContext->peerIndex[i];
+        while (tep)
+        {
+            SslEndPoint_t *next = tep->indexNext;
+            size_t bucket = HashSslPeer(&tep->sep.endpoint) & (newSize - 1);
+            tep->indexNext = newIndex[bucket];
+            newIndex[bucket] = tep;
+            tep = next;
+        }
+    }
+
+    OICFree(g_caSslContext->peerIndex);
+    g_caSslContext->peerIndex = newIndex;
+    g_caSslContext->peerIndexSize = newSize;
+    return true;
+}
+
+/**
+ * Adds endpoint session to list. The list takes over the reference of the caller.
+ *
+ * @param[in]  tep    endpoint with session info
+ *
+ * @return  true on success, false otherwise
+ */
+static bool AddPeerToList(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    size_t count = u_arraylist_length(g_caSslContext->peerList) + 1;
+    if (count > g_caSslContext->peerIndexSize)
+    {
+        size_t newSize = g_caSslContext->peerIndexSize ?
+                         g_caSslContext->peerIndexSize * 2 : SSL_PEER_INDEX_INITIAL_SIZE;
+        while (newSize < count)
+        {
+            newSize *= 2;
+        }
+        if (!ResizePeerIndex(newSize))
+        {
+            return false;
+        }
+    }
+
+    if (!u_arraylist_add(g_caSslContext->peerList, (void *) tep))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+        return false;
+    }
+
+    size_t bucket = HashSslPeer(&tep->sep.endpoint) & (g_caSslContext->peerIndexSize - 1);
+    tep->indexNext = g_caSslContext->peerIndex[bucket];
+    g_caSslContext->peerIndex[bucket] = tep;
+    return true;
+}
+
+/**
+ * Removes endpoint session from list and drops the reference of the list. Does nothing if
+ * the session has been removed already.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void RemoveSslPeer(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
+    VERIFY_NON_NULL_VOID(tep, NET_SSL_TAG, "tep");
+
+    if (NULL == g_caSslContext->peerIndex)
+    {
+        return;
+    }
+
+    size_t bucket = HashSslPeer(&tep->sep.endpoint) & (g_caSslContext->peerIndexSize - 1);
+    SslEndPoint_t **link = &g_caSslContext->peerIndex[bucket];
+    while (*link && *link != tep)
+    {
+        link = &(*link)->indexNext;
+    }
+    if (NULL == *link)
+    {
+        return;
+    }
+    *link = tep->indexNext;
+    tep->indexNext = NULL;
+
+    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        if (tep == u_arraylist_get(g_caSslContext->peerList, listIndex))
+        {
+            u_arraylist_remove(g_caSslContext->peerList, listIndex);
+            break;
+        }
+    }
+    UnrefSslEndPoint(tep);
+}
+
+/**
+ * Removes endpoint session from list.
+ *
+ * @param[in]  endpoint    remote address
+ */
+static void RemovePeerFromList(CAEndpoint_t * endpoint)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
+    VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
+
+    SslEndPoint_t * tep = GetSslPeer(endpoint);
+    if (NULL != tep)
+    {
+        RemoveSslPeer(tep);
+    }
+}
+
+/**
+ * Copies a session along with the certificate of the peer.
+ *
+ * @param[out] dst    session to fill in, left untouched on failure
+ * @param[in]  src    session to copy
+ *
+ * @return  0 on success, mbedTLS error code otherwise
+ */
+static int CopySslSession(mbedtls_ssl_session *dst, const mbedtls_ssl_session *src)
+{
+    mbedtls_x509_crt *peerCert = NULL;
+    if (NULL != src->peer_cert)
+    {
+        peerCert = (mbedtls_x509_crt *)mbedtls_calloc(1, sizeof(mbedtls_x509_crt));
+        if (NULL == peerCert)
+        {
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+        mbedtls_x509_crt_init(peerCert);
+        int ret = mbedtls_x509_crt_parse_der(peerCert, src->peer_cert->raw.p,
+                                             src->peer_cert->raw.len);
+        if (0 != ret)
+        {
+            mbedtls_x509_crt_free(peerCert);
+            mbedtls_free(peerCert);
+            return ret;
+        }
+    }
+
+    memcpy(dst, src, sizeof(*dst));
+    dst->peer_cert = peerCert;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    // Sessions are resumed by id only
+    dst->ticket = NULL;
+    dst->ticket_len = 0;
+#endif
+    return 0;
+}
+
+/**
+ * Drops a cached session, wiping its keys.
+ *
+ * @param[in]  cached    cache slot
+ */
+static void ClearCachedSession(SslCachedSession_t *cached)
+{
+    if (cached->used)
+    {
+        mbedtls_ssl_session_free(&cached->session);
+        memset(cached, 0, sizeof(*cached));
+    }
+}
+
+/**
+ * Checks whether sessions with a peer must be neither cached nor resumed.
+ *
+ * @param[in]  endpoint    remote address
+ *
+ * @return  true if the cache is disabled for the peer
+ */
+static bool IsSessionCacheDisabledForPeer(const CAEndpoint_t *endpoint)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    if (NULL == g_caSslContext->uncachedPeers)
+    {
+        return false;
+    }
+    size_t listLength = u_arraylist_length(g_caSslContext->uncachedPeers);
+    for (size_t i = 0; i < listLength; i++)
+    {
+        const CAEndpoint_t *peer =
+            (const CAEndpoint_t *) u_arraylist_get(g_caSslContext->uncachedPeers, i);
+        if (NULL != peer && IsSameSslPeer(endpoint, peer))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+CAResult_t CAsslEnableSessionCacheForPeer(const CAEndpoint_t *endpoint, bool enable)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(endpoint, NET_SSL_TAG, "endpoint is NULL", CA_STATUS_INVALID_PARAM);
+    VERIFY_NON_NULL_RET(g_sslContextMutex, NET_SSL_TAG, "context mutex is NULL",
+                        CA_STATUS_NOT_INITIALIZED);
+
+    CAResult_t res = CA_STATUS_OK;
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    u_arraylist_t *list = g_caSslContext->uncachedPeers;
+    size_t listLength = (NULL != list) ? u_arraylist_length(list) : 0;
+    size_t i = 0;
+    for (; i < listLength; i++)
+    {
+        const CAEndpoint_t *peer = (const CAEndpoint_t *) u_arraylist_get(list, i);
+        if (NULL != peer && IsSameSslPeer(endpoint, peer))
+        {
+            break;
+        }
+    }
+
+    if (enable && i < listLength)
+    {
+        OICFree(u_arraylist_remove(list, i));
+    }
+    else if (!enable && i == listLength)
+    {
+        if (NULL == list)
+        {
+            list = u_arraylist_create();
+            g_caSslContext->uncachedPeers = list;
+        }
+        CAEndpoint_t *peer = (CAEndpoint_t *) OICMalloc(sizeof(CAEndpoint_t));
+        if (NULL != peer)
+        {
+            *peer = *endpoint;
+        }
+        if (NULL == list || NULL == peer || !u_arraylist_add(list, peer))
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Failed to disable the session cache of the peer");
+            OICFree(peer);
+            res = CA_MEMORY_ALLOC_FAILED;
+        }
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return res;
+}
+
+/**
+ * Deletes the list of peers whose sessions are not cached.
+ */
+static void DeleteUncachedPeerList(void)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    size_t listLength = u_arraylist_length(g_caSslContext->uncachedPeers);
+    for (size_t i = 0; i < listLength; i++)
+    {
+        OICFree(u_arraylist_get(g_caSslContext->uncachedPeers, i));
+    }
+    u_arraylist_free(&g_caSslContext->uncachedPeers);
+}
+
+/**
+ * Drops all cached sessions, so that every peer has to run a full handshake again.
+ */
+static void FlushSslSessionCache(void)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        ClearCachedSession(&g_caSslContext->clientSessions[i]);
+        ClearCachedSession(&g_caSslContext->serverSessions[i]);
+    }
+}
+
+/**
+ * Checks whether a cached session can still be resumed, and drops it if it can't.
+ *
+ * @param[in]  cached    cache slot
+ * @param[in]  now       current time in milliseconds
+ *
+ * @return  true if the slot holds a session that can be resumed
+ */
+static bool IsCachedSessionValid(SslCachedSession_t *cached, uint64_t now)
+{
+    if (!cached->used)
+    {
+        return false;
+    }
+    if (!g_sessionCacheEnabled || cached->version != g_sessionCacheVersion
+        || now - cached->created > (uint64_t)SSL_SESSION_CACHE_TIMEOUT * 1000
+        || IsSessionCacheDisabledForPeer(&cached->endpoint))
+    {
+        ClearCachedSession(cached);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Gets the cached session of a server we connected to.
+ *
+ * @param[in]  endpoint    remote address
+ *
+ * @return  cached session or NULL
+ */
+static SslCachedSession_t *GetCachedClientSession(const CAEndpoint_t *endpoint)
+{
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        SslCachedSession_t *cached = &g_caSslContext->clientSessions[i];
+        if (IsCachedSessionValid(cached, now) && IsSameSslPeer(endpoint, &cached->endpoint))
+        {
+            return cached;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Gets a cached session of a client that connected to us.
+ *
+ * @param[in]  id       session id
+ * @param[in]  idLen    length of @p id
+ *
+ * @return  cached session or NULL
+ */
+static SslCachedSession_t *GetCachedServerSession(const unsigned char *id, size_t idLen)
+{
+    if (0 == idLen)
+    {
+        return NULL;
+    }
+
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        SslCachedSession_t *cached = &g_caSslContext->serverSessions[i];
+        if (IsCachedSessionValid(cached, now) && idLen == cached->session.id_len
+                && 0 == memcmp(id, cached->session.id, idLen))
+        {
+            return cached;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Looks up the session a client asks to resume. Called by mbedTLS while the
+ * ServerHello is written.
+ *
+ * @param[in]     data       not used
+ * @param[in,out] session    session being negotiated, filled in if it can be resumed
+ *
+ * @return  0 if the session is resumed, 1 otherwise
+ */
+static int GetCachedSslSessionCallback(void *data, mbedtls_ssl_session *session)
+{
+    (void) data;
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    SslCachedSession_t *cached = GetCachedServerSession(session->id, session->id_len);
+    if (NULL == cached
+            || cached->session.ciphersuite != session->ciphersuite
+            || cached->session.compression != session->compression)
+    {
+        return 1;
+    }
+    return (0 == CopySslSession(session, &cached->session)) ? 0 : 1;
+}
+
+/**
+ * Keeps the session of a completed full handshake, with the identity of the peer.
+ *
+ * @param[in]  peer    peer whose handshake is over
+ */
+static void CacheSslSession(const SslEndPoint_t *peer)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    const mbedtls_ssl_session *session = peer->ssl.session;
+    // anonymous sessions only serve to transfer ownership and must not outlive it, nor
+    // must any session that started while ownership transfer disabled the cache or
+    // before the credentials changed, nor any session with a peer being onboarded
+    if (NULL == session || 0 == session->id_len ||
+        MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256 == session->ciphersuite ||
+        !peer->cacheable || !g_sessionCacheEnabled || peer->cacheVersion != g_sessionCacheVersion ||
+        IsSessionCacheDisabledForPeer(&peer->sep.endpoint))
+    {
+        return;
+    }
+
+    SslCachedSession_t *cache = g_caSslContext->serverSessions;
+    if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
+    {
+        cache = g_caSslContext->clientSessions;
+        SslCachedSession_t *previous = GetCachedClientSession(&peer->sep.endpoint);
+        if (NULL != previous)
+        {
+            ClearCachedSession(previous);
+        }
+    }
+
+    // take a free slot, or the one of the oldest session
+    SslCachedSession_t *cached = &cache[0];
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE && cached->used; i++)
+    {
+        if (!cache[i].used || cache[i].created < cached->created)
+        {
+            cached = &cache[i];
+        }
+    }
+    ClearCachedSession(cached);
+
+    if (0 != CopySslSession(&cached->session, session))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Failed to cache the session");
+        return;
+    }
+    cached->used = true;
+    cached->endpoint = peer->sep.endpoint;
+    cached->identity = peer->sep.identity;
+    cached->userId = peer->sep.userId;
+    memcpy(cached->random, peer->random, sizeof(cached->random));
+    cached->created = OICGetCurrentTime(TIME_IN_MS);
+    cached->version = peer->cacheVersion;
+}
+
+/**
+ * Restores what an abbreviated handshake does not carry from the cached session.
+ *
+ * @param[in,out]  peer    peer whose handshake resumed a session
+ */
+static void RestoreSslSession(SslEndPoint_t *peer)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    const mbedtls_ssl_session *session = peer->ssl.session;
+    SslCachedSession_t *cached = (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint) ?
+                                 GetCachedClientSession(&peer->sep.endpoint) :
+                                 GetCachedServerSession(session->id, session->id_len);
+    if (NULL == cached)
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Resumed session is no longer cached");
+        return;
+    }
+    peer->sep.identity = cached->identity;
+    peer->sep.userId = cached->userId;
+    memcpy(peer->random, cached->random, sizeof(peer->random));
+}
+
 /**
- * Removes endpoint session from list.
+ * Offers the cached session of a server for resumption.
  *
- * @param[in]  endpoint    remote address
+ * @param[in]  tep    peer about to start the handshake
  */
-static void RemovePeerFromList(CAEndpoint_t * endpoint)
+static void ResumeSslSession(SslEndPoint_t *tep)
 {
     oc_mutex_assert_owner(g_sslContextMutex, true);
 
-    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
-    VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
-
-    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    SslCachedSession_t *cached = GetCachedClientSession(&tep->sep.endpoint);
+    if (NULL != cached && 0 != mbedtls_ssl_set_session(&tep->ssl, &cached->session))
     {
-        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-        if(0 == strncmp(endpoint->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA)
-                && (endpoint->port == tep->sep.endpoint.port))
-        {
-            u_arraylist_remove(g_caSslContext->peerList, listIndex);
-            DeleteSslEndPoint(tep);
-            return;
-        }
+        OIC_LOG(WARNING, NET_SSL_TAG, "Failed to offer the cached session");
     }
 }
 
  /**
   * Checks handshake result. Removes peer from list and sends alert
-  * if handshake failed.
+  * if handshake failed. The caller holds a reference to the peer.
   *
   * @param[in] peer Remote peer's endpoint.
   * @param[in] ret  Error code.
@@ -1237,10 +1929,6 @@ static bool checkSslOperation(SslEndPoint_t*  peer,
             OIC_LOG_V(ERROR, NET_SSL_TAG, "%s: -0x%x", (str), -ret);
         }
 
-        // Make a copy of the endpoint, because the callback might
-        // free the peer object, during notifySubscriber() below.
-        CAEndpoint_t removedEndpoint = (peer)->sep.endpoint;
-
         oc_mutex_lock(g_sslContextMutex);
 
         if (MBEDTLS_ERR_SSL_BAD_HS_CLIENT_HELLO != ret)
@@ -1259,7 +1947,9 @@ static bool checkSslOperation(SslEndPoint_t*  peer,
             }
         }
 
-        RemovePeerFromList(&removedEndpoint);
+        // The callback might have closed the session already, the reference of the
+        // caller keeps the peer object alive in that case.
+        RemoveSslPeer(peer);
 
         oc_mutex_unlock(g_sslContextMutex);
         return false;
@@ -1285,6 +1975,7 @@ static void DeletePeerList(void)
         {
             continue;
         }
+        oc_mutex_lock(tep->mutex);
         if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
         {
             int ret = 0;
@@ -1294,9 +1985,13 @@ static void DeletePeerList(void)
             }
             while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
         }
-        DeleteSslEndPoint(tep);
+        oc_mutex_unlock(tep->mutex);
+        UnrefSslEndPoint(tep);
     }
     u_arraylist_free(&g_caSslContext->peerList);
+    OICFree(g_caSslContext->peerIndex);
+    g_caSslContext->peerIndex = NULL;
+    g_caSslContext->peerIndexSize = 0;
 }
 
 CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
@@ -1320,14 +2015,18 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
     }
     /* No error checking, the connection might be closed already */
     int ret = 0;
+    RefSslEndPoint(tep);
+    oc_mutex_lock(tep->mutex);
     do
     {
         ret = mbedtls_ssl_close_notify(&tep->ssl);
     }
     while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
+    oc_mutex_unlock(tep->mutex);
 
-    RemovePeerFromList(&tep->sep.endpoint);
+    RemoveSslPeer(tep);
     oc_mutex_unlock(g_sslContextMutex);
+    UnrefSslEndPoint(tep);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return CA_STATUS_OK;
@@ -1373,8 +2072,7 @@ void CAcloseSslConnectionAll(CATransportAdapter_t transportType)
         while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);*/
 
         // delete from list
-        u_arraylist_remove(g_caSslContext->peerList, i - 1);
-        DeleteSslEndPoint(tep);
+        RemoveSslPeer(tep);
     }
     oc_mutex_unlock(g_sslContextMutex);
 
@@ -1467,6 +2165,19 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
 
     tep->sep.endpoint = *endpoint;
     tep->sep.endpoint.flags = (CATransportFlags_t)(tep->sep.endpoint.flags | CA_SECURE);
+    tep->refCount = 1;
+    // version first, CAsslEnableSessionCache() sets the flag before it increments it
+    tep->cacheVersion = g_sessionCacheVersion;
+    tep->cacheable = g_sessionCacheEnabled;
+
+    // recursive, the handshake callbacks may close the session of the peer being processed
+    tep->mutex = oc_mutex_new_recursive();
+    if (NULL == tep->mutex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Mutex creation failed!");
+        OICFree(tep);
+        return NULL;
+    }
 
     if (g_getIdentityCallback != NULL)
     {
@@ -1475,6 +2186,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
     if(0 != mbedtls_ssl_setup(&tep->ssl, config))
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "Setup failed");
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1492,6 +2204,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
             {
                 OIC_LOG(ERROR, NET_SSL_TAG, "Transport id setup failed!");
                 mbedtls_ssl_free(&tep->ssl);
+                oc_mutex_free(tep->mutex);
                 OICFree(tep);
                 OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                 return NULL;
@@ -1503,6 +2216,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "cacheList initialization failed!");
         mbedtls_ssl_free(&tep->ssl);
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1679,15 +2393,17 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
     }
 
     oc_mutex_lock(g_sslContextMutex);
-    ret = u_arraylist_add(g_caSslContext->peerList, (void *) tep);
-    if (!ret)
+    if (!AddPeerToList(tep))
     {
         oc_mutex_unlock(g_sslContextMutex);
-        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
         DeleteSslEndPoint(tep);
         return NULL;
     }
+    ResumeSslSession(tep);
 
+    bool failed = false;
+    RefSslEndPoint(tep);
+    oc_mutex_lock(tep->mutex);
     while (MBEDTLS_SSL_HANDSHAKE_OVER > tep->ssl.state)
     {
         ret = mbedtls_ssl_handshake_step(&tep->ssl);
@@ -1698,25 +2414,26 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
         else if (-1 == ret)
         {
             OIC_LOG(ERROR, NET_SSL_TAG, "Handshake failed due to socket error");
-            RemovePeerFromList(&tep->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return NULL;
+            RemoveSslPeer(tep);
+            failed = true;
+            break;
         }
         if (!checkSslOperation(tep,
                                ret,
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
-            oc_mutex_unlock(g_sslContextMutex);
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeleteSslEndPoint(tep);
-            return NULL;
+            failed = true;
+            break;
         }
     }
+    oc_mutex_unlock(tep->mutex);
+    // deletes the peer if it has been removed from the list
+    UnrefSslEndPoint(tep);
 
     oc_mutex_unlock(g_sslContextMutex);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return tep;
+    return failed ? NULL : tep;
 }
 #ifdef __WITH_DTLS__
 /**
@@ -1743,6 +2460,8 @@ void CAdeinitSslAdapter(void)
 
     // Clear all lists
     DeletePeerList();
+    FlushSslSessionCache();
+    DeleteUncachedPeerList();
 
     // De-initialize mbedTLS
     mbedtls_x509_crt_free(&g_caSslContext->crt);
@@ -1769,10 +2488,30 @@ void CAdeinitSslAdapter(void)
     oc_mutex_unlock(g_sslContextMutex);
     oc_mutex_free(g_sslContextMutex);
     g_sslContextMutex = NULL;
+    oc_mutex_free(g_sslRngMutex);
+    g_sslRngMutex = NULL;
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s ", __func__);
 }
 
+/**
+ * Random generator of the mbedTLS configs. Records of different peers are encrypted in
+ * parallel, and the DRBG they share is not thread safe by itself.
+ *
+ * @param[in]  ctx       DRBG context
+ * @param[out] output    buffer to fill
+ * @param[in]  len       number of bytes to generate
+ *
+ * @return  0 on success, mbedTLS error code otherwise
+ */
+static int SslRandom(void * ctx, unsigned char * output, size_t len)
+{
+    oc_mutex_lock(g_sslRngMutex);
+    int ret = mbedtls_ctr_drbg_random(ctx, output, len);
+    oc_mutex_unlock(g_sslRngMutex);
+    return ret;
+}
+
 static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
@@ -1790,7 +2529,12 @@ static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
      * time, see extlibs/mbedtls/config-iotivity.h
      */
     mbedtls_ssl_conf_psk_cb(conf, GetPskCredentialsCallback, NULL);
-    mbedtls_ssl_conf_rng(conf, mbedtls_ctr_drbg_random, &g_caSslContext->rnd);
+    mbedtls_ssl_conf_rng(conf, SslRandom, &g_caSslContext->rnd);
+    if (MBEDTLS_SSL_IS_SERVER == mode)
+    {
+        // Sessions are stored by CacheSslSession() once the identity of the peer is known
+        mbedtls_ssl_conf_session_cache(conf, NULL, GetCachedSslSessionCallback, NULL);
+    }
     mbedtls_ssl_conf_curves(conf, curve[ADAPTER_CURVE_SECP256R1]);
     mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
 
@@ -1849,6 +2593,8 @@ static void StartRetransmit(void *ctx)
             {
                 continue;
             }
+            RefSslEndPoint(tep);
+            oc_mutex_lock(tep->mutex);
             int ret = mbedtls_ssl_handshake_step(&tep->ssl);
 
             if (MBEDTLS_ERR_SSL_CONN_EOF != ret)
@@ -1861,10 +2607,14 @@ static void StartRetransmit(void *ctx)
                                        "Retransmission",
                                        MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
                 {
+                    oc_mutex_unlock(tep->mutex);
+                    UnrefSslEndPoint(tep);
                     oc_mutex_unlock(g_sslContextMutex);
                     return;
                 }
             }
+            oc_mutex_unlock(tep->mutex);
+            UnrefSslEndPoint(tep);
         }
     }
     //start new timer
@@ -1882,6 +2632,14 @@ CAResult_t CAinitSslAdapter(void)
         g_sslContextMutex = oc_mutex_new_recursive();
         VERIFY_NON_NULL_RET(g_sslContextMutex, NET_SSL_TAG, "oc_mutex_new_recursive failed",
             CA_MEMORY_ALLOC_FAILED);
+        g_sslRngMutex = oc_mutex_new();
+        if (NULL == g_sslRngMutex)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "oc_mutex_new failed");
+            oc_mutex_free(g_sslContextMutex);
+            g_sslContextMutex = NULL;
+            return CA_MEMORY_ALLOC_FAILED;
+        }
     }
     else
     {
@@ -1899,6 +2657,8 @@ CAResult_t CAinitSslAdapter(void)
         oc_mutex_unlock(g_sslContextMutex);
         oc_mutex_free(g_sslContextMutex);
         g_sslContextMutex = NULL;
+        oc_mutex_free(g_sslRngMutex);
+        g_sslRngMutex = NULL;
         return CA_MEMORY_ALLOC_FAILED;
     }
 
@@ -1913,6 +2673,8 @@ CAResult_t CAinitSslAdapter(void)
         oc_mutex_unlock(g_sslContextMutex);
         oc_mutex_free(g_sslContextMutex);
         g_sslContextMutex = NULL;
+        oc_mutex_free(g_sslRngMutex);
+        g_sslRngMutex = NULL;
         return CA_STATUS_FAILED;
     }
 
@@ -2093,33 +2855,7 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
         return CA_STATUS_FAILED;
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
-    {
-        unsigned char *dataBuf = (unsigned char *)data;
-        size_t written = 0;
-
-        do
-        {
-            ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
-            if (ret < 0)
-            {
-                if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
-                {
-                    OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
-                    RemovePeerFromList(&tep->sep.endpoint);
-                    oc_mutex_unlock(g_sslContextMutex);
-                    return CA_STATUS_FAILED;
-                }
-                continue;
-            }
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
-
-            dataBuf += ret;
-            written += ret;
-        } while (dataLen > written);
-
-    }
-    else
+    if (MBEDTLS_SSL_HANDSHAKE_OVER != tep->ssl.state)
     {
         SslCacheMessage_t * msg = NewCacheMessage((uint8_t*) data, dataLen);
         if (NULL == msg || !u_arraylist_add(tep->cacheList, (void *) msg))
@@ -2128,12 +2864,50 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
+        oc_mutex_unlock(g_sslContextMutex);
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return CA_STATUS_OK;
     }
 
+    // The session is established, only the peer needs to stay locked while encrypting.
+    RefSslEndPoint(tep);
     oc_mutex_unlock(g_sslContextMutex);
 
+    CAResult_t res = CA_STATUS_OK;
+    unsigned char *dataBuf = (unsigned char *)data;
+    size_t written = 0;
+
+    oc_mutex_lock(tep->mutex);
+    do
+    {
+        ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
+        if (ret < 0)
+        {
+            if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+            {
+                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
+                res = CA_STATUS_FAILED;
+                break;
+            }
+            continue;
+        }
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
+
+        dataBuf += ret;
+        written += ret;
+    } while (dataLen > written);
+    oc_mutex_unlock(tep->mutex);
+
+    if (CA_STATUS_OK != res)
+    {
+        oc_mutex_lock(g_sslContextMutex);
+        RemoveSslPeer(tep);
+        oc_mutex_unlock(g_sslContextMutex);
+    }
+    UnrefSslEndPoint(tep);
+
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return res;
 }
 /**
  * Sends cached messages via TLS connection.
@@ -2144,7 +2918,7 @@ static void SendCacheMessages(SslEndPoint_t * tep, CAResult_t errorCode)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
 
-    // The mutex protects the access to tep.
+    // The context mutex protects the cache list, the caller also holds the mutex of tep.
     oc_mutex_assert_owner(g_sslContextMutex, true);
 
     VERIFY_NON_NULL_VOID(tep, NET_SSL_TAG, "Param tep is NULL");
@@ -2229,58 +3003,19 @@ void CAsetSslHandshakeCallback(CAHandshakeErrorCallback tlsHandshakeCallback)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s(%p)", __func__, tlsHandshakeCallback);
 }
 
-/* Read data from TLS connection
+/**
+ * Feeds the data in the receive buffer of a peer to its handshake.
+ *
+ * The caller holds the context mutex, the mutex of the peer and a reference to it.
+ *
+ * @param[in]  peer    remote peer
+ * @param[in]  sep     remote address the data has been received from
+ *
+ * @return  CA_STATUS_OK unless the handshake failed
  */
-CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
+static CAResult_t ProcessSslHandshake(SslEndPoint_t *peer, const CASecureEndpoint_t *sep)
 {
     int ret = 0;
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
-    VERIFY_NON_NULL_RET(sep, NET_SSL_TAG, "endpoint is NULL" , CA_STATUS_INVALID_PARAM);
-    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "Param data is NULL" , CA_STATUS_INVALID_PARAM);
-
-    oc_mutex_lock(g_sslContextMutex);
-    if (NULL == g_caSslContext)
-    {
-        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
-        oc_mutex_unlock(g_sslContextMutex);
-        return CA_STATUS_FAILED;
-    }
-
-    SslEndPoint_t * peer = GetSslPeer(&sep->endpoint);
-    if (NULL == peer)
-    {
-        mbedtls_ssl_config * config = (sep->endpoint.adapter == CA_ADAPTER_IP ||
-                                   sep->endpoint.adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
-        peer = NewSslEndPoint(&sep->endpoint, config);
-        if (NULL == peer)
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-        //Load allowed TLS suites from SVR DB
-        if(!SetupCipher(config, sep->endpoint.adapter, NULL))
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Failed to set up cipher");
-            DeleteSslEndPoint(peer);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-
-        ret = u_arraylist_add(g_caSslContext->peerList, (void *) peer);
-        if (!ret)
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
-            DeleteSslEndPoint(peer);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-    }
-
-    peer->recBuf.buff = data;
-    peer->recBuf.len = dataLen;
-    peer->recBuf.loaded = 0;
 
     while (MBEDTLS_SSL_HANDSHAKE_OVER != peer->ssl.state)
     {
@@ -2299,6 +3034,11 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                                  sizeof(sep->endpoint.addr));
             ret = mbedtls_ssl_handshake_step(&peer->ssl);
         }
+        // settled by the hello messages, mbedTLS frees the handshake data at the end
+        if (NULL != peer->ssl.handshake)
+        {
+            peer->resumed = (0 != peer->ssl.handshake->resume);
+        }
         uint32_t flags = mbedtls_ssl_get_verify_result(&peer->ssl);
         if (0 != flags)
         {
@@ -2322,7 +3062,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                    "Cert verification failed",
                                    GetAlertCode(flags)))
             {
-                oc_mutex_unlock(g_sslContextMutex);
                 OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                 return CA_STATUS_FAILED;
             }
@@ -2332,7 +3071,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
-            oc_mutex_unlock(g_sslContextMutex);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return CA_STATUS_FAILED;
         }
@@ -2345,14 +3083,12 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 ret = ValidateAuthCertChainProfiles(peerCert);
                 if (CP_INVALID_CERT_CHAIN == ret)
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG(ERROR, NET_SSL_TAG, "Invalid peer cert chain");
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
                 else if (0 != ret)
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(ERROR, NET_SSL_TAG, "%d certificate(s) in peer cert chain do not satisfy OCF profile requirements", ret);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
@@ -2361,7 +3097,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 ret = PeerCertExtractCN(peerCert);
                 if (CA_STATUS_OK != ret)
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(ERROR, NET_SSL_TAG, "ProcessPeerCert failed with %d", ret);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
@@ -2381,9 +3116,33 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
 
         if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
         {
+            bool isClient = (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint);
+            CASslSessionCacheStatistics_t *stats = &g_caSslContext->sessionStats;
+            if (peer->resumed)
+            {
+                OIC_LOG(DEBUG, NET_SSL_TAG, "(D)TLS Session is resumed");
+                RestoreSslSession(peer);
+                if (isClient)
+                {
+                    stats->clientHits++;
+                }
+                else
+                {
+                    stats->serverHits++;
+                }
+            }
+            else if (isClient)
+            {
+                stats->clientMisses++;
+            }
+            else
+            {
+                stats->serverMisses++;
+            }
+
             CAResult_t result = notifySubscriber(peer, CA_STATUS_OK);
 
-            if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
+            if (isClient)
             {
                 SendCacheMessages(peer, result);
             }
@@ -2402,7 +3161,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                        "Failed to retrieve cert",
                                        MBEDTLS_SSL_ALERT_MSG_NO_CERT))
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2415,7 +3173,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 if (ret <= 0)
                 {
                     OIC_LOG_V(ERROR, NET_SSL_TAG, "Failed to copy public key of remote peer: -0x%x", ret);
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2423,7 +3180,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 {
                     assert(!"publicKey field of CASecureEndpoint_t is too small for the public key!");
                     OIC_LOG(ERROR, NET_SSL_TAG, "Public key of remote peer was too large");
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2470,7 +3226,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                                "Failed to convert subject",
                                                MBEDTLS_SSL_ALERT_MSG_UNSUPPORTED_CERT))
                         {
-                            oc_mutex_unlock(g_sslContextMutex);
                             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                             return CA_STATUS_FAILED;
                         }
@@ -2495,7 +3250,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                                "Failed to convert subject alt name",
                                                MBEDTLS_SSL_ALERT_MSG_UNSUPPORTED_CERT))
                         {
-                            oc_mutex_unlock(g_sslContextMutex);
                             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                             return CA_STATUS_FAILED;
                         }
@@ -2513,60 +3267,142 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 peer->sep.publicKeyLength = 0;
             }
 
-            oc_mutex_unlock(g_sslContextMutex);
+            if (!peer->resumed)
+            {
+                CacheSslSession(peer);
+            }
+
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return CA_STATUS_OK;
         }
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
+
+    return CA_STATUS_OK;
+}
+
+/* Read data from TLS connection
+ */
+CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
+{
+    int ret = 0;
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(sep, NET_SSL_TAG, "endpoint is NULL" , CA_STATUS_INVALID_PARAM);
+    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "Param data is NULL" , CA_STATUS_INVALID_PARAM);
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
     {
-        uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
-        do
-        {
-            ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
-        } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
+        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_FAILED;
+    }
 
-        if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
-            // TinyDTLS sends fatal close_notify alert
-            (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
-             MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
-             MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
+    SslEndPoint_t * peer = GetSslPeer(&sep->endpoint);
+    if (NULL == peer)
+    {
+        mbedtls_ssl_config * config = (sep->endpoint.adapter == CA_ADAPTER_IP ||
+                                   sep->endpoint.adapter == CA_ADAPTER_GATT_BTLE ?
+                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
+        peer = NewSslEndPoint(&sep->endpoint, config);
+        if (NULL == peer)
         {
-            OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
-            RemovePeerFromList(&peer->sep.endpoint);
+            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
             oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_OK;
+            return CA_STATUS_FAILED;
         }
-
-        int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
-        if (adapterIndex >= 0)
+        //Load allowed TLS suites from SVR DB
+        if(!SetupCipher(config, sep->endpoint.adapter, NULL))
         {
-            if (0 > ret)
-            {
-                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
-                g_caSslContext->adapterCallbacks[adapterIndex].errorCallback(&peer->sep.endpoint, peer->recBuf.buff, peer->recBuf.len, CA_STATUS_FAILED);
-                RemovePeerFromList(&peer->sep.endpoint);
-                oc_mutex_unlock(g_sslContextMutex);
-                return CA_STATUS_FAILED;
-            }
-            else if (0 < ret)
-            {
-                g_caSslContext->adapterCallbacks[adapterIndex].recvCallback(&peer->sep, decryptBuffer, ret);
-            }
+            OIC_LOG(ERROR, NET_SSL_TAG, "Failed to set up cipher");
+            DeleteSslEndPoint(peer);
+            oc_mutex_unlock(g_sslContextMutex);
+            return CA_STATUS_FAILED;
         }
-        else
+
+        if (!AddPeerToList(peer))
         {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
-            RemovePeerFromList(&peer->sep.endpoint);
+            DeleteSslEndPoint(peer);
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
     }
 
+    RefSslEndPoint(peer);
+    if (MBEDTLS_SSL_HANDSHAKE_OVER != peer->ssl.state)
+    {
+        oc_mutex_lock(peer->mutex);
+        peer->recBuf.buff = data;
+        peer->recBuf.len = dataLen;
+        peer->recBuf.loaded = 0;
+        CAResult_t res = ProcessSslHandshake(peer, sep);
+        oc_mutex_unlock(peer->mutex);
+
+        oc_mutex_unlock(g_sslContextMutex);
+        UnrefSslEndPoint(peer);
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return res;
+    }
+
+    int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
+    if (0 > adapterIndex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        UnrefSslEndPoint(peer);
+        return CA_STATUS_FAILED;
+    }
+    SslCallbacks_t callbacks = g_caSslContext->adapterCallbacks[adapterIndex];
+    // the attributes of the endpoint are protected by the context mutex
+    CASecureEndpoint_t peerSep = peer->sep;
+
+    // The session is established, only the peer needs to stay locked while decrypting.
     oc_mutex_unlock(g_sslContextMutex);
+
+    uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
+    oc_mutex_lock(peer->mutex);
+    peer->recBuf.buff = data;
+    peer->recBuf.len = dataLen;
+    peer->recBuf.loaded = 0;
+    do
+    {
+        ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
+    } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
+
+    bool closed = (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
+                   // TinyDTLS sends fatal close_notify alert
+                   (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
+                    MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
+                    MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]));
+    oc_mutex_unlock(peer->mutex);
+
+    CAResult_t res = CA_STATUS_OK;
+    if (closed)
+    {
+        OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
+    }
+    else if (0 > ret)
+    {
+        OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
+        callbacks.errorCallback(&peerSep.endpoint, data, dataLen, CA_STATUS_FAILED);
+        res = CA_STATUS_FAILED;
+    }
+    else if (0 < ret)
+    {
+        callbacks.recvCallback(&peerSep, decryptBuffer, ret);
+    }
+
+    if (closed || CA_STATUS_OK != res)
+    {
+        oc_mutex_lock(g_sslContextMutex);
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+    }
+    UnrefSslEndPoint(peer);
+
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return res;
 }
 
 void CAsetSslAdapterCallbacks(CAPacketReceivedCallback recvCallback,
@@ -2690,6 +3526,11 @@ CAResult_t CAsetTlsCipherSuite(const uint32_t cipher)
 #endif
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Selected cipher: 0x%x", cipher);
     }
+    if (index != g_caSslContext->cipher)
+    {
+        // The cached sessions were negotiated for the suites allowed before
+        FlushSslSessionCache();
+    }
     g_caSslContext->cipher = index;
 
     oc_mutex_unlock(g_sslContextMutex);
@@ -2697,6 +3538,19 @@ CAResult_t CAsetTlsCipherSuite(const uint32_t cipher)
     return CA_STATUS_OK;
 }
 
+void CAsslGetSessionCacheStatistics(CASslSessionCacheStatistics_t *stats)
+{
+    VERIFY_NON_NULL_VOID(stats, NET_SSL_TAG, "Param stats is NULL");
+    memset(stats, 0, sizeof(*stats));
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL != g_caSslContext)
+    {
+        *stats = g_caSslContext->sessionStats;
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+}
+
 CAResult_t CAinitiateSslHandshake(const CAEndpoint_t *endpoint)
 {
     CAResult_t res = CA_STATUS_OK;
@@ -534,7 +534,7 @@ CAResult_t CAInitializeLS(ca_thread_pool_t handle)
 
     CATriggerCreateLSServiceName();
 
-    result = ca_thread_pool_add_task(handle, CAStartLSMainLoop, NULL);
+    result = ca_thread_pool_add_dedicated_task(handle, CAStartLSMainLoop, NULL);
     if (CA_STATUS_OK != result)
     {
         OIC_LOG(ERROR, CA_ADAPTER_UTILS_TAG, "LS thread_pool_add_task failed");
@@ -305,8 +305,8 @@ CAResult_t CALEClientStartScanWithInterval()
     g_scanIntervalTime = g_scanIntervalTimePrev;
     g_nextScanningStep = BLE_SCAN_ENABLE;
 
-    if (CA_STATUS_OK != ca_thread_pool_add_task(g_threadPoolHandle,
-                                                CALEScanThread, NULL))
+    if (CA_STATUS_OK != ca_thread_pool_add_dedicated_task(g_threadPoolHandle,
+                                                          CALEScanThread, NULL))
     {
         OIC_LOG(ERROR, TAG, "Failed to create read thread!");
         g_isWorkingScanThread = false;
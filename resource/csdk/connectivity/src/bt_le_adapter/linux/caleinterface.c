@@ -820,9 +820,9 @@ CAResult_t CAStartLEAdapter(void)
      *       the @c CAGetLEInterfaceInformation() function below for
      *       further details.
      */
-    result = ca_thread_pool_add_task(g_context.client_thread_pool,
-                                     CALEStartEventLoop,
-                                     &g_context);
+    result = ca_thread_pool_add_dedicated_task(g_context.client_thread_pool,
+                                               CALEStartEventLoop,
+                                               &g_context);
 
     /*
       Wait for the GLib event loop to actually run before returning.
@@ -615,8 +615,8 @@ CAResult_t CAStartLEGattClient(void)
         return CA_STATUS_FAILED;
     }
 
-    result = ca_thread_pool_add_task(g_LEClientThreadPool, CAStartTimerThread,
-                                     NULL);
+    result = ca_thread_pool_add_dedicated_task(g_LEClientThreadPool, CAStartTimerThread,
+                                               NULL);
     if (CA_STATUS_OK != result)
     {
         OIC_LOG(ERROR, TAG, "ca_thread_pool_add_task failed");
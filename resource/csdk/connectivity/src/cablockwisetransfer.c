@@ -60,6 +60,243 @@ static CABlockWiseContext_t g_context = { .sendThreadFunc = NULL,
                                           .dataList = NULL,
                                           .multicastDataList = NULL };
 
+static size_t CAHashBlockDataID(const CABlockDataID_t *blockID)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < blockID->idLength; i++)
+    {
+        hash ^= blockID->id[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Rehash the block data index into @p size buckets. Keeps the current table if
+ * the allocation fails. Called with blockDataListMutex held.
+ */
+static bool CAResizeBlockDataIndex(size_t size)
+{
+    CABlockData_t **index = (CABlockData_t **) OICCalloc(size, sizeof(CABlockData_t *));
+    if (!index)
+    {
+        OIC_LOG(ERROR, TAG, "memory alloc has failed");
+        return false;
+    }
+
+    for (size_t i = 0; i < g_context.blockDataIndexSize; i++)
+    {
+        CABlockData_t *data = g_context.blockDataIndex[i];
+        while (data)
+        {
+            CABlockData_t *next = data->indexNext;
+            size_t bucket = CAHashBlockDataID(data->blockDataId) & (size - 1);
+            data->indexNext = index[bucket];
+            index[bucket] = data;
+            data = next;
+        }
+    }
+
+    OICFree(g_context.blockDataIndex);
+    g_context.blockDataIndex = index;
+    g_context.blockDataIndexSize = size;
+    return true;
+}
+
+/**
+ * Add block data to the index. Called with blockDataListMutex held.
+ */
+static bool CAIndexBlockData(CABlockData_t *data)
+{
+    if (u_arraylist_length(g_context.dataList) > g_context.blockDataIndexSize)
+    {
+        size_t size = g_context.blockDataIndexSize ?
+                      g_context.blockDataIndexSize * 2 : CA_BLOCK_INDEX_INITIAL_SIZE;
+        // a crowded table still works, only an absent one doesn't
+        if (!CAResizeBlockDataIndex(size) && !g_context.blockDataIndex)
+        {
+            return false;
+        }
+    }
+
+    size_t bucket = CAHashBlockDataID(data->blockDataId) & (g_context.blockDataIndexSize - 1);
+    data->indexNext = g_context.blockDataIndex[bucket];
+    g_context.blockDataIndex[bucket] = data;
+    return true;
+}
+
+/**
+ * Remove block data from the index. Called with blockDataListMutex held.
+ */
+static void CAUnindexBlockData(CABlockData_t *data)
+{
+    if (!g_context.blockDataIndex || !data->blockDataId)
+    {
+        return;
+    }
+
+    size_t bucket = CAHashBlockDataID(data->blockDataId) & (g_context.blockDataIndexSize - 1);
+    for (CABlockData_t **link = &g_context.blockDataIndex[bucket]; *link;
+         link = &(*link)->indexNext)
+    {
+        if (*link == data)
+        {
+            *link = data->indexNext;
+            break;
+        }
+    }
+    data->indexNext = NULL;
+}
+
+/**
+ * Look up block data by ID. Called with blockDataListMutex held.
+ */
+static CABlockData_t *CAFindBlockData(const CABlockDataID_t *blockID)
+{
+    if (!g_context.blockDataIndex || !blockID->id)
+    {
+        return NULL;
+    }
+
+    size_t bucket = CAHashBlockDataID(blockID) & (g_context.blockDataIndexSize - 1);
+    for (CABlockData_t *data = g_context.blockDataIndex[bucket]; data; data = data->indexNext)
+    {
+        if (CABlockidMatches(data, blockID))
+        {
+            return data;
+        }
+    }
+    return NULL;
+}
+
+static void CAFreeBlockPayload(CABlockData_t *data)
+{
+    CABlockChunk_t *chunk = data->payloadHead;
+    while (chunk)
+    {
+        CABlockChunk_t *next = chunk->next;
+        OICFree(chunk);
+        chunk = next;
+    }
+    data->payloadHead = NULL;
+    data->payloadTail = NULL;
+}
+
+static CABlockChunk_t *CACreateBlockChunk(size_t capacity)
+{
+    // the data follows the chunk header in the same allocation
+    CABlockChunk_t *chunk = (CABlockChunk_t *) OICMalloc(sizeof(CABlockChunk_t) + capacity);
+    if (!chunk)
+    {
+        OIC_LOG(ERROR, TAG, "out of memory");
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->data = (uint8_t *) (chunk + 1);
+    chunk->length = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+/**
+ * Append a received block to the payload of @p data. Fills the last chunk
+ * first, so nothing that was stored already is copied again.
+ * @param[in]   expectedLength    total payload length announced by the peer, or 0.
+ */
+static CAResult_t CAAppendBlockPayload(CABlockData_t *data, const uint8_t *payload,
+                                       size_t length, size_t expectedLength)
+{
+    CABlockChunk_t *tail = data->payloadTail;
+    size_t copied = 0;
+    if (tail)
+    {
+        copied = tail->capacity - tail->length;
+        if (copied > length)
+        {
+            copied = length;
+        }
+        memcpy(tail->data + tail->length, payload, copied);
+        tail->length += copied;
+    }
+
+    size_t rest = length - copied;
+    if (0 == rest)
+    {
+        return CA_STATUS_OK;
+    }
+
+    // make room for everything still to come if the peer told how much that is
+    size_t capacity = (rest > CA_BLOCK_CHUNK_SIZE) ? rest : CA_BLOCK_CHUNK_SIZE;
+    size_t stored = data->receivedPayloadLen + copied;
+    if (expectedLength > stored && expectedLength - stored > rest)
+    {
+        capacity = expectedLength - stored;
+    }
+
+    CABlockChunk_t *chunk = CACreateBlockChunk(capacity);
+    if (!chunk)
+    {
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    memcpy(chunk->data, payload + copied, rest);
+    chunk->length = rest;
+
+    if (tail)
+    {
+        tail->next = chunk;
+    }
+    else
+    {
+        data->payloadHead = chunk;
+    }
+    data->payloadTail = chunk;
+    return CA_STATUS_OK;
+}
+
+/**
+ * Merge the payload chunks of @p data into one, so it can be handed out as a
+ * single buffer. Called with blockDataListMutex held.
+ */
+static CAPayload_t CAGetContiguousBlockPayload(CABlockData_t *data, size_t *length)
+{
+    CABlockChunk_t *head = data->payloadHead;
+    if (!head)
+    {
+        *length = 0;
+        return NULL;
+    }
+
+    size_t total = 0;
+    for (CABlockChunk_t *chunk = head; chunk; chunk = chunk->next)
+    {
+        total += chunk->length;
+    }
+    *length = total;
+
+    if (!head->next)
+    {
+        return head->data;
+    }
+
+    CABlockChunk_t *merged = CACreateBlockChunk(total);
+    if (!merged)
+    {
+        *length = 0;
+        return NULL;
+    }
+    for (CABlockChunk_t *chunk = head; chunk; chunk = chunk->next)
+    {
+        memcpy(merged->data + merged->length, chunk->data, chunk->length);
+        merged->length += chunk->length;
+    }
+
+    CAFreeBlockPayload(data);
+    data->payloadHead = merged;
+    data->payloadTail = merged;
+    return merged->data;
+}
+
 static bool CACheckPayloadLength(const CAData_t *sendData)
 {
     size_t payloadLen = 0;
@@ -126,6 +363,10 @@ CAResult_t CATerminateBlockWiseTransfer(void)
         u_arraylist_free(&g_context.dataList);
     }
 
+    OICFree(g_context.blockDataIndex);
+    g_context.blockDataIndex = NULL;
+    g_context.blockDataIndexSize = 0;
+
     if (g_context.multicastDataList)
     {
         CARemoveAllBlockMulticastDataFromList();
@@ -194,6 +435,11 @@ void CATerminateBlockWiseMutexVariables(void)
     }
 }
 
+void CASetBlockWiseStreamCallback(CABlockWiseStreamCallback callback)
+{
+    g_context.streamCallback = callback;
+}
+
 CAResult_t CASendBlockWiseData(const CAData_t *sendData)
 {
     VERIFY_NON_NULL(sendData, TAG, "sendData");
@@ -819,8 +1065,7 @@ CAResult_t CASendErrorMessage(const coap_pdu_t *pdu, uint8_t status,
     // if error code is 4.08, remove the stored payload and initialize block number
     if (CA_BLOCK_INCOMPLETE == status)
     {
-        OICFree(data->payload);
-        data->payload = NULL;
+        CAFreeBlockPayload(data);
         data->payloadLength = 0;
         data->receivedPayloadLen = 0;
         data->block1.num = 0;
@@ -843,10 +1088,27 @@ CAResult_t CAReceiveLastBlock(const CABlockDataID_t *blockID, const CAData_t *re
         return CA_MEMORY_ALLOC_FAILED;
     }
 
+    oc_mutex_lock(g_context.blockDataListMutex);
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    bool isStreamed = currData && currData->isStreamed;
+    oc_mutex_unlock(g_context.blockDataListMutex);
+
     // update payload
     size_t fullPayloadLen = 0;
     CAPayload_t fullPayload = CAGetPayloadFromBlockDataList(blockID, &fullPayloadLen);
-    if (fullPayload)
+    if (isStreamed)
+    {
+        // the application already has every block; only the completion is notified
+        CAInfo_t *info = cloneData->requestInfo ? &cloneData->requestInfo->info
+                       : cloneData->responseInfo ? &cloneData->responseInfo->info : NULL;
+        if (info)
+        {
+            OICFree(info->payload);
+            info->payload = NULL;
+            info->payloadSize = 0;
+        }
+    }
+    else if (fullPayload)
     {
         CAResult_t res = CAUpdatePayloadToCAData(cloneData, fullPayload, fullPayloadLen);
         if (CA_STATUS_OK != res)
@@ -2055,55 +2317,42 @@ CAResult_t CAUpdatePayloadData(CABlockData_t *currData, const CAData_t *received
                 BLOCK_SIZE(currData->block2.szx) : BLOCK_SIZE(currData->block1.szx);
     }
 
-    // memory allocation for the received block payload
     size_t prePayloadLen = currData->receivedPayloadLen;
     if (blockPayload)
     {
-        if (currData->payloadLength)
-        {
-            // in case the block message has the size option
-            // allocate the memory for the total payload
-            if (isSizeOption)
+        CABlockWiseStreamCallback streamCallback = g_context.streamCallback;
+        if (streamCallback && (0 == prePayloadLen || currData->isStreamed)
+            && currData->sentData && currData->sentData->remoteEndpoint
+            && (currData->sentData->requestInfo || currData->sentData->responseInfo))
+        {
+            const CAInfo_t *info = currData->sentData->requestInfo ?
+                                   &currData->sentData->requestInfo->info :
+                                   &currData->sentData->responseInfo->info;
+            bool consumed = streamCallback(currData->sentData->remoteEndpoint,
+                                           info->token, info->tokenLength, prePayloadLen,
+                                           (const uint8_t *) blockPayload, blockPayloadLen);
+            if (0 == prePayloadLen)
             {
-                CAPayload_t prePayload = currData->payload;
-
-                OIC_LOG(DEBUG, TAG, "allocate memory for the total payload");
-                currData->payload = (CAPayload_t) OICCalloc(1, currData->payloadLength);
-                if (NULL == currData->payload)
-                {
-                    OIC_LOG(ERROR, TAG, "out of memory");
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy(currData->payload, prePayload, prePayloadLen);
-                OICFree(prePayload);
+                currData->isStreamed = consumed;
             }
-
-            // update the total payload
-            memcpy(currData->payload + prePayloadLen, blockPayload, blockPayloadLen);
         }
-        else
-        {
-            OIC_LOG(DEBUG, TAG, "allocate memory for the received block payload");
 
-            size_t totalPayloadLen = prePayloadLen + blockPayloadLen;
-            CAPayload_t newPayload = OICRealloc(currData->payload, totalPayloadLen);
-            if (NULL == newPayload)
+        if (!currData->isStreamed)
+        {
+            // store the block, sized for the whole payload if the message has the size option
+            CAResult_t res = CAAppendBlockPayload(currData, (const uint8_t *) blockPayload,
+                                                  blockPayloadLen,
+                                                  isSizeOption ? currData->payloadLength : 0);
+            if (CA_STATUS_OK != res)
             {
-                OIC_LOG(ERROR, TAG, "out of memory");
-                return CA_MEMORY_ALLOC_FAILED;
+                return res;
             }
-
-            // update the total payload
-            memset(newPayload + prePayloadLen, 0, blockPayloadLen);
-            currData->payload = newPayload;
-            memcpy(currData->payload + prePayloadLen, blockPayload, blockPayloadLen);
         }
 
         // update received payload length
         currData->receivedPayloadLen += blockPayloadLen;
 
-        OIC_LOG_V(DEBUG, TAG, "updated payload: @ %p, len: %" PRIuPTR, currData->payload,
-                  currData->receivedPayloadLen);
+        OIC_LOG_V(DEBUG, TAG, "updated payload: len: %" PRIuPTR, currData->receivedPayloadLen);
     }
 
     OIC_LOG(DEBUG, TAG, "OUT-UpdatePayloadData");
@@ -2356,17 +2605,13 @@ CAResult_t CAUpdateBlockOptionType(const CABlockDataID_t *blockID, uint16_t bloc
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            currData->type = blockType;
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
-            return CA_STATUS_OK;
-        }
+        currData->type = blockType;
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
+        return CA_STATUS_OK;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2381,16 +2626,13 @@ uint16_t CAGetBlockOptionType(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
-            return currData->type;
-        }
+        uint16_t type = currData->type;
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
+        return type;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2404,19 +2646,12 @@ CAData_t *CAGetDataSetFromBlockDataList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
-    {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData->sentData;
-        }
-    }
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    CAData_t *sentData = currData ? currData->sentData : NULL;
+
     oc_mutex_unlock(g_context.blockDataListMutex);
 
-    return NULL;
+    return sentData;
 }
 
 CABlockData_t *CAUpdateDataSetFromBlockDataList(const CABlockDataID_t *blockID,
@@ -2427,21 +2662,15 @@ CABlockData_t *CAUpdateDataSetFromBlockDataList(const CABlockDataID_t *blockID,
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            CADestroyDataSet(currData->sentData);
-            currData->sentData = CACloneCAData(sendData);
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData;
-        }
+        CADestroyDataSet(currData->sentData);
+        currData->sentData = CACloneCAData(sendData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
-    return NULL;
+    return currData;
 }
 
 CAResult_t CAGetTokenFromBlockDataList(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
@@ -2534,19 +2763,11 @@ CABlockData_t *CAGetBlockDataFromBlockDataList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
-    {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            return currData;
-        }
-    }
+    CABlockData_t *currData = CAFindBlockData(blockID);
+
     oc_mutex_unlock(g_context.blockDataListMutex);
 
-    return NULL;
+    return currData;
 }
 
 coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID, uint16_t blockType)
@@ -2556,23 +2777,20 @@ coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID, uint16_t blockTyp
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
+        if (COAP_OPTION_BLOCK2 == blockType)
         {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
-            if (COAP_OPTION_BLOCK2 == blockType)
-            {
-                return &currData->block2;
-            }
-            else if (COAP_OPTION_BLOCK1 == blockType)
-            {
-                return &currData->block1;
-            }
+            return &currData->block2;
         }
+        else if (COAP_OPTION_BLOCK1 == blockType)
+        {
+            return &currData->block1;
+        }
+        return NULL;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2589,17 +2807,13 @@ CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            oc_mutex_unlock(g_context.blockDataListMutex);
-            *fullPayloadLen = currData->receivedPayloadLen;
-            OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
-            return currData->payload;
-        }
+        CAPayload_t payload = CAGetContiguousBlockPayload(currData, fullPayloadLen);
+        oc_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
+        return payload;
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2668,6 +2882,11 @@ CABlockData_t *CACreateNewBlockData(const CAData_t *sendData)
     oc_mutex_lock(g_context.blockDataListMutex);
 
     bool res = u_arraylist_add(g_context.dataList, (void *) data);
+    if (res && !CAIndexBlockData(data))
+    {
+        u_arraylist_remove(g_context.dataList, u_arraylist_length(g_context.dataList) - 1);
+        res = false;
+    }
     if (!res)
     {
         OIC_LOG(ERROR, TAG, "add has failed");
@@ -2690,28 +2909,24 @@ CAResult_t CARemoveBlockDataFromList(const CABlockDataID_t *blockID)
 
     oc_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    size_t i = 0;
+    if (currData && u_arraylist_get_index(g_context.dataList, currData, &i))
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
+        CABlockData_t *removedData = u_arraylist_remove(g_context.dataList, i);
+        if (!removedData)
         {
-            CABlockData_t *removedData = u_arraylist_remove(g_context.dataList, i);
-            if (!removedData)
-            {
-                OIC_LOG(ERROR, TAG, "data is NULL");
-                oc_mutex_unlock(g_context.blockDataListMutex);
-                return CA_STATUS_FAILED;
-            }
-
-            // destroy memory
-            CADestroyDataSet(removedData->sentData);
-            CADestroyBlockID(removedData->blockDataId);
-            OICFree(removedData->payload);
-            OICFree(removedData);
+            OIC_LOG(ERROR, TAG, "data is NULL");
             oc_mutex_unlock(g_context.blockDataListMutex);
-            return CA_STATUS_OK;
+            return CA_STATUS_FAILED;
         }
+        CAUnindexBlockData(removedData);
+
+        // destroy memory
+        CADestroyDataSet(removedData->sentData);
+        CADestroyBlockID(removedData->blockDataId);
+        CAFreeBlockPayload(removedData);
+        OICFree(removedData);
     }
     oc_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2735,8 +2950,9 @@ CAResult_t CARemoveAllBlockDataFromList(void)
             {
                 CADestroyDataSet(removedData->sentData);
             }
+            CAUnindexBlockData(removedData);
             CADestroyBlockID(removedData->blockDataId);
-            OICFree(removedData->payload);
+            CAFreeBlockPayload(removedData);
             OICFree(removedData);
         }
     }
@@ -40,6 +40,10 @@
 #include "catcpadapter.h"
 #endif
 
+#ifdef WITH_BWT
+#include "cablockwisetransfer.h"
+#endif
+
 CAGlobals_t caglobals = { .clientFlags = 0,
                           .serverFlags = 0, };
 
@@ -138,6 +142,17 @@ void CARegisterHandler(CARequestCallback ReqHandler, CAResponseCallback RespHand
     CASetInterfaceCallbacks(ReqHandler, RespHandler, ErrorHandler);
 }
 
+void CARegisterBlockWiseStreamHandler(CABlockWiseStreamCallback StreamHandler)
+{
+    OIC_LOG(DEBUG, TAG, "CARegisterBlockWiseStreamHandler");
+
+#ifdef WITH_BWT
+    CASetBlockWiseStreamCallback(StreamHandler);
+#else
+    (void)StreamHandler;
+#endif
+}
+
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
 
 CAResult_t CAGetSecureEndpointData(const CAEndpoint_t *peer, CASecureEndpoint_t *sep)
@@ -229,6 +244,58 @@ CAResult_t CAregisterPkixInfoHandler(CAgetPkixInfoHandler getPkixInfoHandler)
     return CA_STATUS_OK;
 }
 
+CAResult_t CAnotifyPkixInfoChanged(void)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+
+    if (!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    CAsslNotifyPkixInfoChanged();
+    OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAinvalidateSslSessionCache(void)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+
+    if (!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    CAsslInvalidateSessionCache();
+    OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAEnableSslSessionCache(const bool enable)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+
+    if (!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    CAsslEnableSessionCache(enable);
+    OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAEnableSslSessionCacheForPeer(const CAEndpoint_t *endpoint, const bool enable)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+
+    if (!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    CAResult_t res = CAsslEnableSessionCacheForPeer(endpoint, enable);
+    OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+    return res;
+}
+
 CAResult_t CAregisterGetCredentialTypesHandler(CAgetCredentialTypesHandler getCredTypesHandler)
 {
     OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
@@ -516,6 +583,44 @@ CAResult_t CAHandleRequestResponse(void)
     return CA_STATUS_OK;
 }
 
+CAResult_t CAWaitForRequestResponse(uint32_t timeoutMs, uint32_t *wakeUps)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    return CAWaitForRequestResponseCallbacks((uint64_t) timeoutMs * 1000, wakeUps) ?
+           CA_STATUS_OK : CA_REQUEST_TIMEOUT;
+}
+
+void CAWakeUpRequestResponse(void)
+{
+    if (g_isInitialized)
+    {
+        CAWakeUpRequestResponseCallbacks();
+    }
+}
+
+CAResult_t CASetRetransmissionNstart(uint8_t nstart)
+{
+    OIC_LOG_V(DEBUG, TAG, "CASetRetransmissionNstart %d", nstart);
+
+    return CASetMessageHandlerNstart(nstart);
+}
+
+CAResult_t CAGetRetransmissionStatistics(CARetransmissionStatistics_t *statistics)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    return CAGetMessageHandlerStatistics(statistics);
+}
+
 CAResult_t CASelectCipherSuite(const uint16_t cipher, CATransportAdapter_t adapter)
 {
     (void)(adapter); // prevent unused-parameter warning when building release variant
@@ -0,0 +1,291 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+
+#include "cadeduplication.h"
+#include "caadapterutils.h"
+#include "octhread.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "oic_time.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_CA_DEDUP"
+
+typedef struct CADedupEntry CADedupEntry_t;
+
+struct CADedupEntry
+{
+    CADedupEntry_t *next;               /**< next entry with the same bucket */
+    bool used;                          /**< entry is linked in its bucket */
+    uint64_t expires;                   /**< end of the lifetime. milliseconds */
+    CATransportAdapter_t adapter;       /**< source of the request */
+    CATransportFlags_t flags;
+    uint32_t ifindex;
+    uint16_t port;
+    char addr[MAX_ADDR_STR_SIZE_CA];
+    uint16_t messageId;                 /**< message ID of the request */
+    uint8_t tokenLength;                /**< token of the request */
+    uint8_t token[CA_MAX_TOKEN_LEN];
+    uint8_t *response;                  /**< response sent for the request, if any */
+    size_t responseLength;
+};
+
+/**
+ * Mutex to synchronize the history between the adapter threads and the send thread.
+ */
+static oc_mutex g_dedupMutex = NULL;
+
+/**
+ * Received messages, reused in the order they were received.
+ */
+static CADedupEntry_t *g_dedupEntries = NULL;
+
+/**
+ * Index of the oldest entry, which is reused next.
+ */
+static size_t g_dedupNext = 0;
+
+/**
+ * Entries by message ID.
+ */
+static CADedupEntry_t *g_dedupBuckets[CA_DEDUP_BUCKETS];
+
+static CADedupEntry_t **CADedupBucket(uint16_t messageId)
+{
+    return &g_dedupBuckets[messageId & (CA_DEDUP_BUCKETS - 1)];
+}
+
+static void CADedupRemoveEntry(CADedupEntry_t *entry)
+{
+    for (CADedupEntry_t **link = CADedupBucket(entry->messageId); *link; link = &(*link)->next)
+    {
+        if (*link == entry)
+        {
+            *link = entry->next;
+            break;
+        }
+    }
+
+    OICFree(entry->response);
+    entry->response = NULL;
+    entry->responseLength = 0;
+    entry->next = NULL;
+    entry->used = false;
+}
+
+static bool CADedupSameEndpoint(const CADedupEntry_t *entry, const CAEndpoint_t *endpoint)
+{
+    return entry->port == endpoint->port
+        && (entry->flags & CA_IPFAMILY_MASK) == (endpoint->flags & CA_IPFAMILY_MASK)
+        && 0 == strncmp(entry->addr, endpoint->addr, sizeof(entry->addr));
+}
+
+/**
+ * Finds the live entry of a message, dropping the expired entries on the way.
+ * With @p otherFamily, a request received over the other IP family of the same
+ * interface also matches when it has the same token.
+ */
+static CADedupEntry_t *CADedupFindEntry(const CAEndpoint_t *endpoint, uint16_t messageId,
+                                        bool otherFamily, const uint8_t *token,
+                                        uint8_t tokenLength, uint64_t now)
+{
+    CADedupEntry_t *entry = *CADedupBucket(messageId);
+    while (entry)
+    {
+        CADedupEntry_t *next = entry->next;
+        if (entry->expires <= now)
+        {
+            CADedupRemoveEntry(entry);
+        }
+        else if (entry->messageId == messageId && entry->adapter == endpoint->adapter)
+        {
+            if (CADedupSameEndpoint(entry, endpoint))
+            {
+                return entry;
+            }
+            if (otherFamily && CA_ADAPTER_IP == endpoint->adapter
+                && entry->ifindex == endpoint->ifindex
+                && (entry->flags & CA_IPFAMILY_MASK) != (endpoint->flags & CA_IPFAMILY_MASK)
+                && entry->tokenLength == tokenLength
+                && (0 == tokenLength || 0 == memcmp(entry->token, token, tokenLength)))
+            {
+                OIC_LOG_V(INFO, TAG, "IPv%c copy of message %u ignored",
+                          (endpoint->flags & CA_IPV6) ? '6' : '4', messageId);
+                return entry;
+            }
+        }
+        entry = next;
+    }
+    return NULL;
+}
+
+CAResult_t CADedupInitialize(void)
+{
+    if (g_dedupEntries)
+    {
+        return CA_STATUS_OK;
+    }
+
+    g_dedupMutex = oc_mutex_new();
+    if (!g_dedupMutex)
+    {
+        OIC_LOG(ERROR, TAG, "oc_mutex_new has failed");
+        return CA_STATUS_FAILED;
+    }
+
+    g_dedupEntries = (CADedupEntry_t *) OICCalloc(CA_DEDUP_HISTORY_SIZE, sizeof(CADedupEntry_t));
+    if (!g_dedupEntries)
+    {
+        OIC_LOG(ERROR, TAG, "memory allocation failed");
+        oc_mutex_free(g_dedupMutex);
+        g_dedupMutex = NULL;
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    memset(g_dedupBuckets, 0, sizeof(g_dedupBuckets));
+    g_dedupNext = 0;
+    return CA_STATUS_OK;
+}
+
+void CADedupTerminate(void)
+{
+    if (!g_dedupEntries)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < CA_DEDUP_HISTORY_SIZE; i++)
+    {
+        OICFree(g_dedupEntries[i].response);
+    }
+    OICFree(g_dedupEntries);
+    g_dedupEntries = NULL;
+    memset(g_dedupBuckets, 0, sizeof(g_dedupBuckets));
+
+    oc_mutex_free(g_dedupMutex);
+    g_dedupMutex = NULL;
+}
+
+CADedupResult_t CADedupReceivedRequest(const CAEndpoint_t *endpoint, CAMessageType_t type,
+                                       uint16_t messageId, const uint8_t *token,
+                                       uint8_t tokenLength, void **response,
+                                       size_t *responseLength)
+{
+    VERIFY_NON_NULL_RET(endpoint, TAG, "endpoint", CA_DEDUP_DUPLICATE);
+    VERIFY_NON_NULL_RET(response, TAG, "response", CA_DEDUP_DUPLICATE);
+    VERIFY_NON_NULL_RET(responseLength, TAG, "responseLength", CA_DEDUP_DUPLICATE);
+
+    *response = NULL;
+    *responseLength = 0;
+
+    if (!g_dedupEntries)
+    {
+        return CA_DEDUP_NEW;
+    }
+
+    if (!token)
+    {
+        tokenLength = 0;
+    }
+    else if (tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        // compare the first CA_MAX_TOKEN_LEN bytes only.
+        tokenLength = CA_MAX_TOKEN_LEN;
+    }
+
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+    CADedupResult_t result = CA_DEDUP_DUPLICATE;
+
+    oc_mutex_lock(g_dedupMutex);
+    CADedupEntry_t *entry = CADedupFindEntry(endpoint, messageId, true, token, tokenLength, now);
+    if (entry)
+    {
+        if (CA_MSG_CONFIRM == type && entry->response)
+        {
+            *response = OICMalloc(entry->responseLength);
+            if (*response)
+            {
+                memcpy(*response, entry->response, entry->responseLength);
+                *responseLength = entry->responseLength;
+                result = CA_DEDUP_REPLAY;
+            }
+        }
+        oc_mutex_unlock(g_dedupMutex);
+        return result;
+    }
+
+    entry = &g_dedupEntries[g_dedupNext];
+    if (entry->used)
+    {
+        CADedupRemoveEntry(entry);
+    }
+    g_dedupNext = (g_dedupNext + 1) % CA_DEDUP_HISTORY_SIZE;
+
+    entry->expires = now + ((CA_MSG_CONFIRM == type) ? CA_EXCHANGE_LIFETIME_MSEC
+                                                       : CA_NON_LIFETIME_MSEC);
+    entry->adapter = endpoint->adapter;
+    entry->flags = endpoint->flags;
+    entry->ifindex = endpoint->ifindex;
+    entry->port = endpoint->port;
+    OICStrcpy(entry->addr, sizeof(entry->addr), endpoint->addr);
+    entry->messageId = messageId;
+    entry->tokenLength = tokenLength;
+    if (tokenLength)
+    {
+        memcpy(entry->token, token, tokenLength);
+    }
+
+    CADedupEntry_t **bucket = CADedupBucket(messageId);
+    entry->next = *bucket;
+    *bucket = entry;
+    entry->used = true;
+    oc_mutex_unlock(g_dedupMutex);
+
+    return CA_DEDUP_NEW;
+}
+
+void CADedupSentResponse(const CAEndpoint_t *endpoint, uint16_t messageId,
+                         const void *pdu, size_t size)
+{
+    VERIFY_NON_NULL_VOID(endpoint, TAG, "endpoint");
+    VERIFY_NON_NULL_VOID(pdu, TAG, "pdu");
+
+    if (!g_dedupEntries)
+    {
+        return;
+    }
+
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+
+    oc_mutex_lock(g_dedupMutex);
+    CADedupEntry_t *entry = CADedupFindEntry(endpoint, messageId, false, NULL, 0, now);
+    if (entry && !entry->response)
+    {
+        entry->response = (uint8_t *) OICMalloc(size);
+        if (entry->response)
+        {
+            memcpy(entry->response, pdu, size);
+            entry->responseLength = size;
+        }
+    }
+    oc_mutex_unlock(g_dedupMutex);
+}
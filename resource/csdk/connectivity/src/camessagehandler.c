@@ -38,6 +38,7 @@
 #include "caadapterutils.h"
 #include "cainterfacecontroller.h"
 #include "caretransmission.h"
+#include "cadeduplication.h"
 #include "oic_string.h"
 #include "caping.h"
 
@@ -57,7 +58,9 @@
 #include "caconnectionmanager.h"
 #endif
 #define SINGLE_HANDLE
+#ifndef MAX_THREAD_POOL_SIZE
 #define MAX_THREAD_POOL_SIZE    20
+#endif
 
 // thread pool handle
 static ca_thread_pool_t g_threadPoolHandle = NULL;
@@ -70,6 +73,8 @@ static CAQueueingThread_t g_receiveThread;
 #define TAG "OIC_CA_MSG_HANDLE"
 
 static CARetransmission_t g_retransmissionContext;
+// outstanding CON data per endpoint, see CASetRetransmissionNstart()
+static uint8_t g_retransmissionNstart = DEFAULT_NSTART;
 
 // handler field
 static CARequestCallback g_requestHandler = NULL;
@@ -90,8 +95,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
 
 static void CADestroyData(void *data, uint32_t size);
 static void CALogPayloadInfo(CAInfo_t *info);
-static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *endpoint, uint16_t id,
-                                CAToken_t token, uint8_t tokenLength);
+static bool CADropDuplicateRequest(const CAEndpoint_t *endpoint, const coap_pdu_t *pdu);
 
 /**
  * print send / receive message of CoAP.
@@ -197,15 +201,6 @@ static CAData_t* CAGenerateHandlerData(const CAEndpoint_t *endpoint,
             goto exit;
         }
 
-        if ((reqInfo->info.type != CA_MSG_CONFIRM) &&
-            CADropSecondMessage(&caglobals.ca.requestHistory, endpoint, reqInfo->info.messageId,
-                                reqInfo->info.token, reqInfo->info.tokenLength))
-        {
-            OIC_LOG(INFO, TAG, "Second Request with same Token, Drop it");
-            CADestroyRequestInfoInternal(reqInfo);
-            goto exit;
-        }
-
         cadata->requestInfo = reqInfo;
         info = &reqInfo->info;
         if (identity)
@@ -583,16 +578,7 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
             CALogPDUInfo(data, pdu);
 
             OIC_LOG_V(INFO, TAG, "CASendUnicastData type : %d", data->dataType);
-            res = CASendUnicastData(data->remoteEndpoint, pdu->transport_hdr, pdu->length, data->dataType);
-            if (CA_STATUS_OK != res)
-            {
-                OIC_LOG_V(ERROR, TAG, "send failed:%d", res);
-                CAErrorHandler(data->remoteEndpoint, pdu->transport_hdr, pdu->length, res);
-                coap_delete_list(options);
-                coap_delete_pdu(pdu);
-                return res;
-            }
-
+            res = CA_NOT_SUPPORTED;
 #ifdef WITH_TCP
             if (CAIsSupportedCoAPOverTCP(data->remoteEndpoint->adapter))
             {
@@ -604,19 +590,37 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
             if (!skipRetransmission)
 #endif
             {
-                // for retransmission
-                res = CARetransmissionSentData(&g_retransmissionContext,
+                // CON data is paced per endpoint and retransmitted
+                res = CARetransmissionSendData(&g_retransmissionContext,
                                                data->remoteEndpoint,
                                                data->dataType,
                                                pdu->transport_hdr, pdu->length);
-                if ((CA_STATUS_OK != res) && (CA_NOT_SUPPORTED != res))
-                {
-                    //when retransmission not supported this will return CA_NOT_SUPPORTED, ignore
-                    OIC_LOG_V(INFO, TAG, "retransmission is not enabled due to error, res : %d", res);
-                    coap_delete_list(options);
-                    coap_delete_pdu(pdu);
-                    return res;
-                }
+            }
+            if (CA_NOT_SUPPORTED == res)
+            {
+                res = CASendUnicastData(data->remoteEndpoint, pdu->transport_hdr, pdu->length,
+                                        data->dataType);
+            }
+            if (CA_STATUS_OK != res)
+            {
+                OIC_LOG_V(ERROR, TAG, "send failed:%d", res);
+                CAErrorHandler(data->remoteEndpoint, pdu->transport_hdr, pdu->length, res);
+                coap_delete_list(options);
+                coap_delete_pdu(pdu);
+                return res;
+            }
+
+            if (NULL != data->responseInfo && CA_MSG_ACKNOWLEDGE == info->type
+#ifdef WITH_TCP
+                && !CAIsSupportedCoAPOverTCP(data->remoteEndpoint->adapter)
+#endif
+               )
+            {
+                // resent when the request is received again
+                CADedupSentResponse(data->remoteEndpoint,
+                                    CAGetMessageIdFromPduBinaryData(pdu->transport_hdr,
+                                                                    pdu->length),
+                                    pdu->transport_hdr, pdu->length);
             }
 
             coap_delete_list(options);
@@ -676,61 +680,60 @@ static void CASendThreadProcess(void *threadData)
 }
 
 /*
- * If a second message arrives with the same message ID, token and the other address
- * family, drop it.  Typically, IPv6 beats IPv4, so the IPv4 message is dropped.
+ * Drop a request that has already been received, typically a retransmission or the
+ * IPv4 copy of a multicast request that also arrived over IPv6. A confirmable request
+ * that has already been answered gets the same response again instead.
  */
-static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *ep, uint16_t id,
-                                CAToken_t token, uint8_t tokenLength)
+static bool CADropDuplicateRequest(const CAEndpoint_t *ep, const coap_pdu_t *pdu)
 {
-    if (!ep)
-    {
-        return true;
-    }
-    if (ep->adapter != CA_ADAPTER_IP)
+#ifdef WITH_TCP
+    if (CAIsSupportedCoAPOverTCP(ep->adapter))
     {
+        // reliable transports have no message ID
         return false;
     }
+#endif
+
+    const coap_hdr_t *hdr = (const coap_hdr_t *) pdu->transport_hdr;
+    uint16_t messageId = CAGetMessageIdFromPduBinaryData(pdu->transport_hdr, pdu->length);
+    void *response = NULL;
+    size_t responseLength = 0;
 
-    if (tokenLength > CA_MAX_TOKEN_LEN)
+    CADedupResult_t result = CADedupReceivedRequest(ep, (CAMessageType_t) hdr->type, messageId,
+                                                    hdr->token, hdr->token_length,
+                                                    &response, &responseLength);
+    if (CA_DEDUP_NEW == result)
     {
-        /*
-         * If token length is more than CA_MAX_TOKEN_LEN,
-         * we compare the first CA_MAX_TOKEN_LEN bytes only.
-         */
-        tokenLength = CA_MAX_TOKEN_LEN;
+        return false;
     }
 
-    bool ret = false;
-    CATransportFlags_t familyFlags = ep->flags & CA_IPFAMILY_MASK;
-
-    for (size_t i = 0; i < sizeof(history->items) / sizeof(history->items[0]); i++)
+    if (CA_DEDUP_REPLAY == result)
     {
-        CAHistoryItem_t *item = &(history->items[i]);
-        if (id == item->messageId && tokenLength == item->tokenLength
-            && ep->ifindex == item->ifindex && memcmp(item->token, token, tokenLength) == 0)
+        OIC_LOG_V(INFO, TAG, "Duplicate request %u, resending its response", messageId);
+        CAResult_t res = CASendUnicastData(ep, response, (uint32_t) responseLength,
+                                           CA_RESPONSE_DATA);
+        if (CA_STATUS_OK != res)
         {
-            OIC_LOG_V(INFO, TAG, "IPv%c duplicate message ignored",
-                      familyFlags & CA_IPV6 ? '6' : '4');
-            ret = true;
-            break;
+            OIC_LOG_V(ERROR, TAG, "resending the response failed:%d", res);
         }
+        OICFree(response);
     }
-
-    history->items[history->nextIndex].flags = familyFlags;
-    history->items[history->nextIndex].messageId = id;
-    history->items[history->nextIndex].ifindex = ep->ifindex;
-    if (token && tokenLength)
+    else
     {
-        memcpy(history->items[history->nextIndex].token, token, tokenLength);
-        history->items[history->nextIndex].tokenLength = tokenLength;
+        OIC_LOG_V(INFO, TAG, "Duplicate request %u, drop it", messageId);
     }
+    return true;
+}
 
-    if (++history->nextIndex >= HISTORYSIZE)
+/*
+ * Free a pdu made by CAReceivedPacketCallback, unless it refers to the received data.
+ */
+static void CADeleteReceivedPDU(coap_pdu_t *pdu, const coap_pdu_t *inPlacePdu)
+{
+    if (pdu != inPlacePdu)
     {
-        history->nextIndex = 0;
+        coap_delete_pdu(pdu);
     }
-
-    return ret;
 }
 
 static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
@@ -749,9 +752,21 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
 
     uint32_t code = CA_NOT_FOUND;
     CAData_t *cadata = NULL;
+    coap_pdu_t *pdu = NULL;
 
-    coap_pdu_t *pdu = (coap_pdu_t *) CAParsePDU((const char *) data, dataLen, &code,
-                                                &(sep->endpoint));
+    // The pdu does not outlive this function and what is kept of it is copied out,
+    // so a datagram is used where the adapter received it.
+    coap_pdu_t inPlacePdu;
+    CAResult_t parsed = CAParsePDUInPlace((const char *) data, dataLen, &inPlacePdu, &code,
+                                          &(sep->endpoint));
+    if (CA_STATUS_OK == parsed)
+    {
+        pdu = &inPlacePdu;
+    }
+    else if (CA_NOT_SUPPORTED == parsed)
+    {
+        pdu = CAParsePDU((const char *) data, dataLen, &code, &(sep->endpoint));
+    }
     if (NULL == pdu)
     {
         OIC_LOG(ERROR, TAG, "Parse PDU failed");
@@ -774,11 +789,17 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
 
     if (CA_GET == code || CA_POST == code || CA_PUT == code || CA_DELETE == code)
     {
+        if (CADropDuplicateRequest(&(sep->endpoint), pdu))
+        {
+            CADeleteReceivedPDU(pdu, &inPlacePdu);
+            goto exit;
+        }
+
         cadata = CAGenerateHandlerData(&(sep->endpoint), &(sep->identity), pdu, CA_REQUEST_DATA);
         if (!cadata)
         {
             OIC_LOG(ERROR, TAG, "CAReceivedPacketCallback, CAGenerateHandlerData failed!");
-            coap_delete_pdu(pdu);
+            CADeleteReceivedPDU(pdu, &inPlacePdu);
             goto exit;
         }
     }
@@ -795,7 +816,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
             if (!cadata)
             {
                 OIC_LOG(ERROR, TAG, "CAReceivedPacketCallback, CAGenerateHandlerData failed!");
-                coap_delete_pdu(pdu);
+                CADeleteReceivedPDU(pdu, &inPlacePdu);
                 return;
             }
 
@@ -833,7 +854,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
         if (!cadata)
         {
             OIC_LOG(ERROR, TAG, "CAReceivedPacketCallback, CAGenerateHandlerData failed!");
-            coap_delete_pdu(pdu);
+            CADeleteReceivedPDU(pdu, &inPlacePdu);
             goto exit;
         }
 
@@ -894,7 +915,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
         CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
     }
 
-    coap_delete_pdu(pdu);
+    CADeleteReceivedPDU(pdu, &inPlacePdu);
 
 exit:
     OIC_LOG(DEBUG, TAG, "received pdu data :");
@@ -910,19 +931,16 @@ void CAHandleRequestResponseCallbacks(void)
     // #1 parse the data
     // #2 get endpoint
 
-    oc_mutex_lock(g_receiveThread.threadMutex);
-
-    u_queue_message_t *item = u_queue_get_element(g_receiveThread.dataQueue);
-
-    oc_mutex_unlock(g_receiveThread.threadMutex);
+    void *msg = NULL;
+    uint32_t size = 0;
 
-    if (NULL == item || NULL == item->msg)
+    if (!CAQueueingThreadGetData(&g_receiveThread, &msg, &size) || NULL == msg)
     {
         return;
     }
 
     // get endpoint
-    CAData_t *td = (CAData_t *) item->msg;
+    CAData_t *td = (CAData_t *) msg;
 
     if (td->requestInfo && g_requestHandler)
     {
@@ -940,9 +958,26 @@ void CAHandleRequestResponseCallbacks(void)
         g_errorHandler(td->remoteEndpoint, td->errorInfo);
     }
 
-    CADestroyData(item->msg, sizeof(CAData_t));
-    OICFree(item);
+    CADestroyData(msg, size);
+
+#endif // SINGLE_HANDLE
+}
+
+bool CAWaitForRequestResponseCallbacks(uint64_t timeoutUs, uint32_t *wakeUps)
+{
+#ifdef SINGLE_HANDLE
+    return CAQueueingThreadWaitForData(&g_receiveThread, timeoutUs, wakeUps);
+#else
+    (void)timeoutUs;
+    (void)wakeUps;
+    return false;
+#endif // SINGLE_HANDLE
+}
 
+void CAWakeUpRequestResponseCallbacks(void)
+{
+#ifdef SINGLE_HANDLE
+    CAQueueingThreadWakeUp(&g_receiveThread);
 #endif // SINGLE_HANDLE
 }
 
@@ -1128,6 +1163,22 @@ void CASetNetworkMonitorCallback(CANetworkMonitorCallback nwMonitorHandler)
     g_nwMonitorHandler = nwMonitorHandler;
 }
 
+CAResult_t CASetMessageHandlerNstart(uint8_t nstart)
+{
+    g_retransmissionNstart = nstart;
+    if (NULL == g_retransmissionContext.threadMutex)
+    {
+        // applied by the next CAInitializeMessageHandler()
+        return CA_STATUS_OK;
+    }
+    return CARetransmissionSetNstart(&g_retransmissionContext, nstart);
+}
+
+CAResult_t CAGetMessageHandlerStatistics(CARetransmissionStatistics_t *statistics)
+{
+    return CARetransmissionGetStatistics(&g_retransmissionContext, statistics);
+}
+
 CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
 {
     CASetPacketReceivedCallback(CAReceivedPacketCallback);
@@ -1142,8 +1193,8 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     }
 
     // send thread initialize
-    res = CAQueueingThreadInitialize(&g_sendThread, g_threadPoolHandle,
-                                     CASendThreadProcess, CADestroyData);
+    res = CAQueueingThreadInitializeLockFree(&g_sendThread, g_threadPoolHandle,
+                                             CASendThreadProcess, CADestroyData);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize send queue thread");
@@ -1159,8 +1210,8 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     }
 
     // receive thread initialize
-    res = CAQueueingThreadInitialize(&g_receiveThread, g_threadPoolHandle,
-                                     CAReceiveThreadProcess, CADestroyData);
+    res = CAQueueingThreadInitializeLockFree(&g_receiveThread, g_threadPoolHandle,
+                                             CAReceiveThreadProcess, CADestroyData);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize receive queue thread");
@@ -1178,14 +1229,26 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
 #endif // SINGLE_HANDLE
 
     // retransmission initialize
+    CARetransmissionConfig_t retransmissionConfig = { .supportType = DEFAULT_RETRANSMISSION_TYPE,
+                                                      .tryingCount = DEFAULT_RETRANSMISSION_COUNT,
+                                                      .nstart = g_retransmissionNstart };
     res = CARetransmissionInitialize(&g_retransmissionContext, g_threadPoolHandle,
-                                     CASendUnicastData, CATimeoutCallback, NULL);
+                                     CASendUnicastData, CATimeoutCallback,
+                                     &retransmissionConfig);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize Retransmission.");
         return res;
     }
 
+    // duplicate detection initialize
+    res = CADedupInitialize();
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to Initialize duplicate detection.");
+        return res;
+    }
+
 #ifdef WITH_BWT
     // block-wise transfer initialize
     res = CAInitializeBlockWiseTransfer(CAAddDataToSendThread, CAAddDataToReceiveThread);
@@ -1253,6 +1316,7 @@ void CATerminateMessageHandler(void)
     CATerminateBlockWiseTransfer();
 #endif
     CARetransmissionDestroy(&g_retransmissionContext);
+    CADedupTerminate();
     CAQueueingThreadDestroy(&g_sendThread);
     CAQueueingThreadDestroy(&g_receiveThread);
 
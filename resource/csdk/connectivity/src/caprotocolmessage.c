@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 #ifdef HAVE_TIME_H
 #include <time.h>
 #endif
@@ -268,6 +269,86 @@ exit:
     return NULL;
 }
 
+CAResult_t CAParsePDUInPlace(const char *data, size_t length, coap_pdu_t *pdu,
+                             uint32_t *outCode, const CAEndpoint_t *endpoint)
+{
+    VERIFY_NON_NULL(data, TAG, "data");
+    VERIFY_NON_NULL(pdu, TAG, "pdu");
+    VERIFY_NON_NULL(endpoint, TAG, "endpoint");
+
+#ifdef WITH_TCP
+    if (CAIsSupportedCoAPOverTCP(endpoint->adapter))
+    {
+        return CA_NOT_SUPPORTED;
+    }
+#endif
+    // the header is read through coap_hdr_t, which is made of unsigned shorts.
+    if (0 != (uintptr_t) data % sizeof(unsigned short))
+    {
+        return CA_NOT_SUPPORTED;
+    }
+
+    const unsigned char *bytes = (const unsigned char *) data;
+    if (length < sizeof(coap_hdr_t) || length > UINT_MAX)
+    {
+        OIC_LOG_V(ERROR, TAG, "invalid data length: %" PRIuPTR, length);
+        return CA_STATUS_FAILED;
+    }
+    if ((bytes[0] >> 6) != COAP_DEFAULT_VERSION)
+    {
+        OIC_LOG_V(ERROR, TAG, "coap version is not available : %d", bytes[0] >> 6);
+        return CA_STATUS_FAILED;
+    }
+
+    size_t tokenLength = bytes[0] & 0x0f;
+    if (tokenLength > CA_MAX_TOKEN_LEN || length < sizeof(coap_hdr_t) + tokenLength)
+    {
+        OIC_LOG_V(ERROR, TAG, "token length has been exceed : %" PRIuPTR, tokenLength);
+        return CA_STATUS_FAILED;
+    }
+    if (0 == bytes[1] && sizeof(coap_hdr_t) != length)
+    {
+        OIC_LOG(ERROR, TAG, "empty message is not empty");
+        return CA_STATUS_FAILED;
+    }
+
+    // check the options and find the payload the way coap_pdu_parse2() does.
+    const unsigned char *opt = bytes + sizeof(coap_hdr_t) + tokenLength;
+    size_t left = length - sizeof(coap_hdr_t) - tokenLength;
+    while (left && COAP_PAYLOAD_START != *opt)
+    {
+        coap_option_t option;
+        size_t optionSize = coap_opt_parse((const coap_opt_t *) opt, left, &option);
+        if (!optionSize)
+        {
+            OIC_LOG(ERROR, TAG, "pdu parse failed");
+            return CA_STATUS_FAILED;
+        }
+        opt += optionSize;
+        left -= optionSize;
+    }
+    if (1 == left)
+    {
+        OIC_LOG(ERROR, TAG, "message ending in payload start marker");
+        return CA_STATUS_FAILED;
+    }
+
+    memset(pdu, 0, sizeof(*pdu));
+    pdu->max_size = length;
+    pdu->transport_hdr = (coap_hdr_transport_t *) data;
+    pdu->length = (unsigned int) length;
+    if (left)
+    {
+        pdu->data = (unsigned char *) opt + 1;
+    }
+
+    if (outCode)
+    {
+        (*outCode) = (uint32_t) CA_RESPONSE_CODE(coap_get_code(pdu, COAP_UDP));
+    }
+    return CA_STATUS_OK;
+}
+
 coap_pdu_t *CAGeneratePDUImpl(code_t code, const CAInfo_t *info,
                               const CAEndpoint_t *endpoint, coap_list_t *options,
                               coap_transport_t *transport)
@@ -1350,7 +1431,7 @@ bool CAIsSupportedCoAPOverTCP(CATransportAdapter_t adapter)
     {
         return true;
     }
-    OIC_LOG_V(INFO, TAG, "adapter value of CoAP/TCP is %d", adapter);
+    OIC_LOG_V(DEBUG, TAG, "adapter value of CoAP/TCP is %d", adapter);
     return false;
 }
 #endif
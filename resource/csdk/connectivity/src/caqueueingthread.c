@@ -31,10 +31,62 @@
 
 #include "caqueueingthread.h"
 #include "oic_malloc.h"
+#include "ocatomic.h"
 #include "experimental/logger.h"
 
 #define TAG PCF("OIC_CA_QING")
 
+static void CAQueueingThreadDestroyData(CAQueueingThread_t *thread, void *data, uint32_t size)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(data, size);
+    }
+    else
+    {
+        OICFree(data);
+    }
+}
+
+static uint32_t CAQueueingThreadGetBatch(CAQueueingThread_t *thread, u_queue_message_t *batch)
+{
+    uint32_t count = 0;
+
+    if (NULL != thread->mpscQueue)
+    {
+        while (count < CA_QUEUEING_THREAD_BATCH_SIZE
+               && u_mpsc_queue_get_element(thread->mpscQueue, &batch[count]))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    while (count < CA_QUEUEING_THREAD_BATCH_SIZE)
+    {
+        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        if (NULL == message)
+        {
+            break;
+        }
+        batch[count++] = *message;
+        OICFree(message);
+    }
+    oc_mutex_unlock(thread->threadMutex);
+
+    return count;
+}
+
+static bool CAQueueingThreadHasData(CAQueueingThread_t *thread)
+{
+    if (NULL != thread->mpscQueue)
+    {
+        return !u_mpsc_queue_is_empty(thread->mpscQueue);
+    }
+    return u_queue_get_size(thread->dataQueue) > 0;
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     OIC_LOG(DEBUG, TAG, "message handler main thread start..");
@@ -47,53 +99,58 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
         return;
     }
 
+    u_queue_message_t batch[CA_QUEUEING_THREAD_BATCH_SIZE];
+    void *batchData[CA_QUEUEING_THREAD_BATCH_SIZE];
+
     while (!thread->isStop)
     {
-        // mutex lock
-        oc_mutex_lock(thread->threadMutex);
-
-        // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        uint32_t count = CAQueueingThreadGetBatch(thread, batch);
+        if (0 == count)
         {
-            OIC_LOG(DEBUG, TAG, "wait..");
+            oc_mutex_lock(thread->threadMutex);
 
-            // wait
-            oc_cond_wait(thread->threadCond, thread->threadMutex);
+            // Producers only signal a parked thread. Announce it before
+            // looking at the queue again so no data can slip in unnoticed.
+            oc_atomic_increment(&thread->parked);
 
-            OIC_LOG(DEBUG, TAG, "wake up..");
-        }
+            // if queue is empty, thread will wait
+            if (!thread->isStop && !CAQueueingThreadHasData(thread))
+            {
+                OIC_LOG(DEBUG, TAG, "wait..");
 
-        // check stop flag
-        if (thread->isStop)
-        {
-            // mutex unlock
-            oc_mutex_unlock(thread->threadMutex);
-            continue;
-        }
+                // wait
+                oc_cond_wait(thread->threadCond, thread->threadMutex);
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-        // mutex unlock
-        oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
-        {
+                OIC_LOG(DEBUG, TAG, "wake up..");
+            }
+
+            oc_atomic_decrement(&thread->parked);
+            oc_mutex_unlock(thread->threadMutex);
             continue;
         }
 
         // process data
-        thread->threadTask(message->msg);
-
-        // free
-        if (NULL != thread->destroy)
+        if (NULL != thread->batchTask)
         {
-            thread->destroy(message->msg, message->size);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                batchData[i] = batch[i].msg;
+            }
+            thread->batchTask(batchData, count);
         }
         else
         {
-            OICFree(message->msg);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                thread->threadTask(batch[i].msg);
+            }
         }
 
-        OICFree(message);
+        // free
+        for (uint32_t i = 0; i < count; i++)
+        {
+            CAQueueingThreadDestroyData(thread, batch[i].msg, batch[i].size);
+        }
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -103,8 +160,11 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
     OIC_LOG(DEBUG, TAG, "message handler main thread end..");
 }
 
-CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
-                                      CAThreadTask task, CADataDestroyFunction destroy)
+static CAResult_t CAQueueingThreadInitializeInternal(CAQueueingThread_t *thread,
+                                                     ca_thread_pool_t handle,
+                                                     CAThreadTask task,
+                                                     CADataDestroyFunction destroy,
+                                                     bool lockFree)
 {
     if (NULL == thread)
     {
@@ -122,13 +182,26 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
 
     // set send thread data
     thread->threadPool = handle;
-    thread->dataQueue = u_queue_create();
+    thread->dataQueue = NULL;
+    thread->mpscQueue = NULL;
+    if (lockFree)
+    {
+        thread->mpscQueue = u_mpsc_queue_create(CA_QUEUEING_THREAD_RING_SIZE);
+    }
+    else
+    {
+        thread->dataQueue = u_queue_create();
+    }
     thread->threadMutex = oc_mutex_new();
     thread->threadCond = oc_cond_new();
     thread->isStop = true;
     thread->threadTask = task;
+    thread->batchTask = NULL;
+    thread->parked = 0;
+    thread->wakeUps = 0;
     thread->destroy = destroy;
-    if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
+    if ((NULL == thread->dataQueue && NULL == thread->mpscQueue)
+        || NULL == thread->threadMutex || NULL == thread->threadCond)
     {
         goto ERROR_MEM_FAILURE;
     }
@@ -141,6 +214,11 @@ ERROR_MEM_FAILURE:
         u_queue_delete(thread->dataQueue);
         thread->dataQueue = NULL;
     }
+    if (thread->mpscQueue)
+    {
+        u_mpsc_queue_delete(thread->mpscQueue);
+        thread->mpscQueue = NULL;
+    }
     if (thread->threadMutex)
     {
         oc_mutex_free(thread->threadMutex);
@@ -154,6 +232,31 @@ ERROR_MEM_FAILURE:
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                      CAThreadTask task, CADataDestroyFunction destroy)
+{
+    return CAQueueingThreadInitializeInternal(thread, handle, task, destroy, false);
+}
+
+CAResult_t CAQueueingThreadInitializeLockFree(CAQueueingThread_t *thread,
+                                              ca_thread_pool_t handle,
+                                              CAThreadTask task,
+                                              CADataDestroyFunction destroy)
+{
+    return CAQueueingThreadInitializeInternal(thread, handle, task, destroy, true);
+}
+
+void CAQueueingThreadSetBatchTask(CAQueueingThread_t *thread, CAThreadBatchTask task)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return;
+    }
+
+    thread->batchTask = task;
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -180,8 +283,8 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
 
-    CAResult_t res = ca_thread_pool_add_task(thread->threadPool, CAQueueingThreadBaseRoutine,
-                                             thread);
+    CAResult_t res = ca_thread_pool_add_dedicated_task(thread->threadPool,
+                                                       CAQueueingThreadBaseRoutine, thread);
     if (res != CA_STATUS_OK)
     {
         // update thread status.
@@ -209,6 +312,25 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
         return CA_STATUS_INVALID_PARAM;
     }
 
+    if (NULL != thread->mpscQueue)
+    {
+        CAResult_t res = u_mpsc_queue_add_element(thread->mpscQueue, data, size);
+        if (CA_STATUS_OK != res)
+        {
+            OIC_LOG(ERROR, TAG, "memory error!!");
+            return res;
+        }
+
+        // notify only if a thread is waiting for data
+        if (oc_atomic_add(&thread->parked, 0))
+        {
+            oc_mutex_lock(thread->threadMutex);
+            oc_cond_broadcast(thread->threadCond);
+            oc_mutex_unlock(thread->threadMutex);
+        }
+        return CA_STATUS_OK;
+    }
+
     // create thread data
     u_queue_message_t *message = (u_queue_message_t *) OICMalloc(sizeof(u_queue_message_t));
 
@@ -227,8 +349,11 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
     // add thread data into list
     u_queue_add_element(thread->dataQueue, message);
 
-    // notity the thread
-    oc_cond_signal(thread->threadCond);
+    // notify only if a thread is waiting for data
+    if (thread->parked)
+    {
+        oc_cond_broadcast(thread->threadCond);
+    }
 
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
@@ -236,43 +361,144 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
     return CA_STATUS_OK;
 }
 
-CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
+bool CAQueueingThreadIsEmpty(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
     {
         OIC_LOG(ERROR, TAG, "thread instance is empty..");
-        return CA_STATUS_INVALID_PARAM;
+        return true;
     }
 
-    OIC_LOG(DEBUG, TAG, "thread destroy..");
+    if (NULL != thread->mpscQueue)
+    {
+        return u_mpsc_queue_is_empty(thread->mpscQueue);
+    }
 
-    // mutex lock
     oc_mutex_lock(thread->threadMutex);
+    bool isEmpty = (u_queue_get_size(thread->dataQueue) <= 0);
+    oc_mutex_unlock(thread->threadMutex);
 
-    // remove all remained list data.
-    while (u_queue_get_size(thread->dataQueue) > 0)
+    return isEmpty;
+}
+
+bool CAQueueingThreadGetData(CAQueueingThread_t *thread, void **data, uint32_t *size)
+{
+    if (NULL == thread || NULL == data || NULL == size)
     {
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        OIC_LOG(ERROR, TAG, "invalid parameter..");
+        return false;
+    }
 
-        // free
-        if (NULL != message)
+    u_queue_message_t message = { NULL, 0 };
+    bool found = false;
+
+    // The lock keeps callers on different threads from racing each other
+    // as consumers; producers of a lock-free queue never take it.
+    oc_mutex_lock(thread->threadMutex);
+    if (NULL != thread->mpscQueue)
+    {
+        found = u_mpsc_queue_get_element(thread->mpscQueue, &message);
+    }
+    else
+    {
+        u_queue_message_t *element = u_queue_get_element(thread->dataQueue);
+        if (NULL != element)
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                OICFree(message->msg);
-            }
+            message = *element;
+            OICFree(element);
+            found = true;
+        }
+    }
+    oc_mutex_unlock(thread->threadMutex);
+
+    *data = message.msg;
+    *size = message.size;
+    return found;
+}
+
+bool CAQueueingThreadWaitForData(CAQueueingThread_t *thread, uint64_t timeoutUs,
+                                 uint32_t *wakeUps)
+{
+    if (NULL == thread || NULL == thread->threadMutex)
+    {
+        OIC_LOG(ERROR, TAG, "invalid parameter..");
+        return false;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
 
-            OICFree(message);
+    // Same handshake as the queuing thread itself: announce the waiter first,
+    // then look at the queue, so a producer either sees it or we see the data.
+    oc_atomic_increment(&thread->parked);
+
+    // Wake-ups are never cleared, each waiter compares against the count it
+    // saw last, so two threads waiting on one queue don't steal each other's.
+    uint32_t seen = wakeUps ? *wakeUps : thread->wakeUps;
+    bool hasData = CAQueueingThreadHasData(thread);
+    if (!hasData && seen == thread->wakeUps)
+    {
+        oc_cond_wait_for(thread->threadCond, thread->threadMutex, timeoutUs);
+        hasData = CAQueueingThreadHasData(thread);
+    }
+    if (wakeUps)
+    {
+        *wakeUps = thread->wakeUps;
+    }
+
+    oc_atomic_decrement(&thread->parked);
+    oc_mutex_unlock(thread->threadMutex);
+
+    return hasData;
+}
+
+void CAQueueingThreadWakeUp(CAQueueingThread_t *thread)
+{
+    if (NULL == thread || NULL == thread->threadMutex)
+    {
+        OIC_LOG(ERROR, TAG, "invalid parameter..");
+        return;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    thread->wakeUps++;
+    oc_cond_broadcast(thread->threadCond);
+    oc_mutex_unlock(thread->threadMutex);
+}
+
+CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    OIC_LOG(DEBUG, TAG, "thread destroy..");
+
+    // remove all remained list data.
+    u_queue_message_t batch[CA_QUEUEING_THREAD_BATCH_SIZE];
+    uint32_t count = 0;
+    while ((count = CAQueueingThreadGetBatch(thread, batch)) > 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            CAQueueingThreadDestroyData(thread, batch[i].msg, batch[i].size);
         }
     }
 
-    u_queue_delete(thread->dataQueue);
-    thread->dataQueue = NULL;
+    // mutex lock
+    oc_mutex_lock(thread->threadMutex);
+
+    if (thread->dataQueue)
+    {
+        u_queue_delete(thread->dataQueue);
+        thread->dataQueue = NULL;
+    }
+    if (thread->mpscQueue)
+    {
+        u_mpsc_queue_delete(thread->mpscQueue);
+        thread->mpscQueue = NULL;
+    }
 
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
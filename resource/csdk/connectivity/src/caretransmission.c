@@ -67,23 +67,96 @@
 #include "caremotehandler.h"
 #include "caprotocolmessage.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "oic_time.h"
 #include "experimental/ocrandom.h"
 #include "experimental/logger.h"
 
 #define TAG "OIC_CA_RETRANS"
 
-typedef struct
+typedef struct CARetransmissionData CARetransmissionData_t;
+typedef struct CARetransmissionPeer CARetransmissionPeer_t;
+
+struct CARetransmissionData
 {
     uint64_t timeStamp;                 /**< last sent time. microseconds */
-    uint64_t timeout;                   /**< timeout value. microseconds */
+    uint64_t firstTimeStamp;            /**< first sent time. microseconds */
+    uint64_t timeout;                   /**< timeout of the last send. microseconds */
+    uint8_t backoff;                    /**< timeout factor per retransmission, in halves */
     uint8_t triedCount;                 /**< retransmission count */
     uint16_t messageId;                 /**< coap PDU message id */
     CADataType_t dataType;              /**< data Type (Request/Response) */
     CAEndpoint_t *endpoint;             /**< remote endpoint */
     void *pdu;                          /**< coap PDU */
     uint32_t size;                      /**< coap PDU size */
-} CARetransmissionData_t;
+    uint64_t expires;                   /**< wheel tick of the next retransmission */
+    CARetransmissionData_t *next;       /**< next data in the same wheel slot, or waiting */
+    CARetransmissionData_t **pprev;     /**< link pointing at this data in the wheel */
+    CARetransmissionData_t *hashNext;   /**< next data in the same index bucket */
+    CARetransmissionPeer_t *peer;       /**< congestion state of the endpoint */
+};
+
+/**
+ * Congestion state of one endpoint: its outstanding and waiting CON data and its
+ * RTT estimate, following CoCoA (draft-ietf-core-cocoa).
+ */
+struct CARetransmissionPeer
+{
+    CATransportAdapter_t adapter;       /**< endpoint */
+    uint16_t port;
+    char addr[MAX_ADDR_STR_SIZE_CA];
+    uint8_t outstanding;                /**< CON data sent and not answered yet */
+    CARetransmissionData_t *held;       /**< CON data waiting for NSTART, oldest first */
+    CARetransmissionData_t **heldTail;
+    uint64_t rto;                       /**< overall RTO estimate. microseconds */
+    uint64_t rtoUpdated;                /**< time of the last RTO update. microseconds */
+    uint64_t strongSrtt;                /**< estimator of data that was not retransmitted */
+    uint64_t strongRttvar;
+    uint64_t weakSrtt;                  /**< estimator of data retransmitted once or twice */
+    uint64_t weakRttvar;
+    CARetransmissionPeer_t *hashNext;   /**< next peer in the same bucket */
+    CARetransmissionPeer_t *idlePrev;   /**< idle peers, least recently used first */
+    CARetransmissionPeer_t *idleNext;
+    bool idle;                          /**< nothing outstanding or waiting */
+};
+
+/** number of slots of each wheel level, as a power of two. */
+#define WHEEL_BITS      6
+#define WHEEL_SLOTS     (1 << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+
+/**
+ * number of wheel levels. Level n slots span WHEEL_SLOTS^n ticks, so three
+ * levels cover WHEEL_SLOTS^3 ticks ahead; later deadlines are parked in the
+ * last slot reachable and placed again when it cascades.
+ */
+#define WHEEL_LEVELS    3
+
+/** initial number of message id index buckets, as a power of two. */
+#define INDEX_INITIAL_BUCKETS   64
+
+/** initial number of endpoint buckets, as a power of two. */
+#define PEER_INITIAL_BUCKETS    64
+
+/**
+ * Pending CON data. Every data sits in exactly one wheel slot keyed by its
+ * next deadline, and in one index bucket keyed by its message id, so both
+ * expiry and ACK matching cost O(1) regardless of how much is pending.
+ */
+struct CARetransmissionQueue
+{
+    CARetransmissionData_t *wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t currentTick;               /**< last tick the wheel was advanced to */
+    uint64_t wakeupTick;                /**< tick the thread is sleeping until */
+    CARetransmissionData_t **buckets;
+    size_t bucketCount;
+    size_t count;
+    CARetransmissionPeer_t **peerBuckets;
+    size_t peerBucketCount;
+    size_t peerCount;
+    CARetransmissionPeer_t *idleHead;   /**< evicted first when there are too many peers */
+    CARetransmissionPeer_t *idleTail;
+};
 
 static const uint64_t USECS_PER_SEC = 1000000;
 static const uint64_t USECS_PER_MSEC = 1000;
@@ -91,12 +164,12 @@ static const uint64_t MSECS_PER_SEC = 1000;
 
 /**
  * @brief   timeout value is
- *          between DEFAULT_ACK_TIMEOUT_SEC and
- *          (DEFAULT_ACK_TIMEOUT_SEC * DEFAULT_RANDOM_FACTOR) second.
+ *          between rto and (rto * DEFAULT_RANDOM_FACTOR).
  *          DEFAULT_RANDOM_FACTOR       1.5 (CoAP)
+ * @param[in] rto       RTO estimate of the endpoint. microseconds
  * @return  microseconds.
  */
-static uint64_t CAGetTimeoutValue(void)
+static uint64_t CAGetTimeoutValue(uint64_t rto)
 {
     uint8_t randomValue = 0;
     if (!OCGetRandomBytes(&randomValue, sizeof(randomValue)))
@@ -104,8 +177,25 @@ static uint64_t CAGetTimeoutValue(void)
         OIC_LOG(ERROR, TAG, "OCGetRandomBytes failed");
     }
 
-    return ((DEFAULT_ACK_TIMEOUT_SEC * MSECS_PER_SEC) + ((MSECS_PER_SEC * (uint64_t)randomValue) >> 8)) *
-             MSECS_PER_SEC;
+    return rto + (((rto / 2) * (uint64_t)randomValue) >> 8);
+}
+
+/**
+ * @brief   variable backoff factor of CoCoA: fast endpoints back off more,
+ *          slow ones less than the usual doubling
+ * @return  factor in halves
+ */
+static uint8_t CAGetBackoffFactor(uint64_t rto)
+{
+    if (rto < USECS_PER_SEC)
+    {
+        return 6;
+    }
+    if (rto > 3 * USECS_PER_SEC)
+    {
+        return 3;
+    }
+    return 4;
 }
 
 CAResult_t CARetransmissionStart(CARetransmission_t *context)
@@ -122,8 +212,8 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
         return CA_STATUS_INVALID_PARAM;
     }
 
-    CAResult_t res = ca_thread_pool_add_task(context->threadPool, CARetransmissionBaseRoutine,
-                                             context);
+    CAResult_t res = ca_thread_pool_add_dedicated_task(context->threadPool,
+                                                       CARetransmissionBaseRoutine, context);
 
     if (CA_STATUS_OK != res)
     {
@@ -134,97 +224,652 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
     return res;
 }
 
+static uint64_t CAGetCurrentTick(void)
+{
+    return OICGetCurrentTime(TIME_IN_MS) / RETRANSMISSION_TICK_MSEC;
+}
+
 /**
- * @brief   check timeout routine
- * @param[in] currentTime  microseconds
+ * @brief   next retransmission time of the data
  * @param[in] retData      retransmission data
- * @return  true if the timeout period has elapsed, false otherwise
+ * @return  microseconds
  */
-static bool CACheckTimeout(uint64_t currentTime, CARetransmissionData_t *retData)
+static uint64_t CAGetNextRetransmissionTime(const CARetransmissionData_t *retData)
 {
-    // #1. calculate timeout
-    uint64_t milliTimeoutValue = retData->timeout / USECS_PER_MSEC;
-    uint64_t timeout = (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
+    return retData->timeStamp + retData->timeout;
+}
 
-    if (currentTime >= retData->timeStamp + timeout)
+static CARetransmissionQueue_t *CACreateRetransmissionQueue(void)
+{
+    CARetransmissionQueue_t *queue = (CARetransmissionQueue_t *) OICCalloc(
+                                         1, sizeof(CARetransmissionQueue_t));
+    if (NULL == queue)
     {
-        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
-                  timeout, retData->triedCount);
-        return true;
+        return NULL;
+    }
+
+    queue->buckets = (CARetransmissionData_t **) OICCalloc(INDEX_INITIAL_BUCKETS,
+                                                           sizeof(CARetransmissionData_t *));
+    if (NULL == queue->buckets)
+    {
+        OICFree(queue);
+        return NULL;
     }
-    return false;
+    queue->bucketCount = INDEX_INITIAL_BUCKETS;
+
+    queue->peerBuckets = (CARetransmissionPeer_t **) OICCalloc(PEER_INITIAL_BUCKETS,
+                                                              sizeof(CARetransmissionPeer_t *));
+    if (NULL == queue->peerBuckets)
+    {
+        OICFree(queue->buckets);
+        OICFree(queue);
+        return NULL;
+    }
+    queue->peerBucketCount = PEER_INITIAL_BUCKETS;
+    queue->currentTick = CAGetCurrentTick();
+    queue->wakeupTick = UINT64_MAX;
+
+    return queue;
 }
 
-static void CACheckRetransmissionList(CARetransmission_t *context)
+static size_t CAGetIndexBucket(const CARetransmissionQueue_t *queue, uint16_t messageId,
+                               CATransportAdapter_t adapter)
 {
-    if (NULL == context)
+    // message ids are handed out sequentially, so they spread well on their own
+    return ((size_t) messageId ^ ((size_t) adapter << 7)) & (queue->bucketCount - 1);
+}
+
+/**
+ * @brief   find the link pointing at the data of the message id in the index
+ * @return  link, which points at NULL if there is no such data
+ */
+static CARetransmissionData_t **CAFindIndexLink(CARetransmissionQueue_t *queue,
+                                                uint16_t messageId,
+                                                CATransportAdapter_t adapter)
+{
+    CARetransmissionData_t **link =
+        &queue->buckets[CAGetIndexBucket(queue, messageId, adapter)];
+
+    while (NULL != *link)
     {
-        OIC_LOG(ERROR, TAG, "context is null");
+        CARetransmissionData_t *data = *link;
+        if (NULL != data->endpoint && data->messageId == messageId
+            && data->endpoint->adapter == adapter)
+        {
+            break;
+        }
+        link = &data->hashNext;
+    }
+    return link;
+}
+
+static void CAGrowIndex(CARetransmissionQueue_t *queue)
+{
+    size_t bucketCount = queue->bucketCount * 2;
+    CARetransmissionData_t **buckets = (CARetransmissionData_t **) OICCalloc(
+                                           bucketCount, sizeof(CARetransmissionData_t *));
+    if (NULL == buckets)
+    {
+        // keep going with longer chains
         return;
     }
 
-    // mutex lock
-    oc_mutex_lock(context->threadMutex);
+    CARetransmissionData_t **oldBuckets = queue->buckets;
+    size_t oldBucketCount = queue->bucketCount;
+    queue->buckets = buckets;
+    queue->bucketCount = bucketCount;
 
-    size_t len = u_arraylist_length(context->dataList);
+    for (size_t i = 0; i < oldBucketCount; i++)
+    {
+        CARetransmissionData_t *data = oldBuckets[i];
+        while (NULL != data)
+        {
+            CARetransmissionData_t *next = data->hashNext;
+            size_t bucket = CAGetIndexBucket(queue, data->messageId, data->endpoint->adapter);
+            data->hashNext = buckets[bucket];
+            buckets[bucket] = data;
+            data = next;
+        }
+    }
+    OICFree(oldBuckets);
+}
 
-    for (size_t i = 0; i < len; i++)
+static void CAWheelInsert(CARetransmissionQueue_t *queue, CARetransmissionData_t *data)
+{
+    // the wheel hands out ticks after currentTick, so late data goes to the next one
+    uint64_t expires = data->expires;
+    if (expires <= queue->currentTick)
     {
-        CARetransmissionData_t *retData = u_arraylist_get(context->dataList, i);
+        expires = queue->currentTick + 1;
+    }
 
-        if (NULL == retData)
+    uint64_t delta = expires - queue->currentTick;
+    size_t level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= ((uint64_t) 1 << (WHEEL_BITS * (level + 1))))
+    {
+        level++;
+    }
+
+    uint64_t span = (uint64_t) 1 << (WHEEL_BITS * (level + 1));
+    if (delta >= span)
+    {
+        // beyond the last level: park it, it is placed again on cascade
+        expires = queue->currentTick + span - 1;
+    }
+
+    size_t slot = (size_t) (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    CARetransmissionData_t **head = &queue->wheel[level][slot];
+
+    data->next = *head;
+    if (NULL != data->next)
+    {
+        data->next->pprev = &data->next;
+    }
+    data->pprev = head;
+    *head = data;
+}
+
+static void CAWheelRemove(CARetransmissionData_t *data)
+{
+    if (NULL == data->pprev)
+    {
+        return;
+    }
+
+    *data->pprev = data->next;
+    if (NULL != data->next)
+    {
+        data->next->pprev = data->pprev;
+    }
+    data->next = NULL;
+    data->pprev = NULL;
+}
+
+/**
+ * @brief   take all data out of the wheel slot
+ * @return  data linked by next, no longer in the wheel
+ */
+static CARetransmissionData_t *CAWheelTakeSlot(CARetransmissionData_t **head)
+{
+    CARetransmissionData_t *list = *head;
+    *head = NULL;
+
+    for (CARetransmissionData_t *data = list; NULL != data; data = data->next)
+    {
+        data->pprev = NULL;
+    }
+    return list;
+}
+
+static void CAWheelCascade(CARetransmissionQueue_t *queue, size_t level)
+{
+    size_t slot = (size_t) (queue->currentTick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    CARetransmissionData_t *data = CAWheelTakeSlot(&queue->wheel[level][slot]);
+
+    while (NULL != data)
+    {
+        CARetransmissionData_t *next = data->next;
+        CAWheelInsert(queue, data);
+        data = next;
+    }
+}
+
+/**
+ * @brief   advance the wheel up to the tick
+ * @return  data whose deadline has passed, linked by next, no longer in the wheel
+ */
+static CARetransmissionData_t *CAWheelAdvance(CARetransmissionQueue_t *queue, uint64_t tick)
+{
+    CARetransmissionData_t *expired = NULL;
+    CARetransmissionData_t **tail = &expired;
+
+    while (queue->currentTick < tick)
+    {
+        if (0 == queue->count)
         {
-            continue;
+            queue->currentTick = tick;
+            break;
         }
 
-        uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+        queue->currentTick++;
 
-        if (CACheckTimeout(currentTime, retData))
+        // moving to a new round of a level: spread its next slot over the levels below
+        for (size_t level = 1; level < WHEEL_LEVELS; level++)
         {
-            // #2. if time's up, send the data.
-            if (NULL != context->dataSendMethod)
+            if (0 != (queue->currentTick & (((uint64_t) 1 << (WHEEL_BITS * level)) - 1)))
             {
-                OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
-                          retData->messageId);
-                context->dataSendMethod(retData->endpoint, retData->pdu,
-                                        retData->size, retData->dataType);
+                break;
             }
+            CAWheelCascade(queue, level);
+        }
+
+        size_t slot = (size_t) queue->currentTick & WHEEL_MASK;
+        *tail = CAWheelTakeSlot(&queue->wheel[0][slot]);
+        while (NULL != *tail)
+        {
+            tail = &(*tail)->next;
+        }
+    }
+
+    return expired;
+}
+
+/**
+ * @brief   tick of the next slot to look at: the next occupied slot of the
+ *          lowest level, or the start of its next round when a cascade is due
+ */
+static uint64_t CAWheelNextTick(const CARetransmissionQueue_t *queue)
+{
+    uint64_t tick = queue->currentTick + 1;
+    while (0 != (tick & WHEEL_MASK) && NULL == queue->wheel[0][tick & WHEEL_MASK])
+    {
+        tick++;
+    }
+    return tick;
+}
+
+static void CAScheduleRetransmission(CARetransmissionQueue_t *queue,
+                                     CARetransmissionData_t *retData)
+{
+    uint64_t tickUsec = RETRANSMISSION_TICK_MSEC * USECS_PER_MSEC;
+    retData->expires = (CAGetNextRetransmissionTime(retData) + tickUsec - 1) / tickUsec;
+    CAWheelInsert(queue, retData);
+}
+
+static void CAFreeRetransmissionData(CARetransmissionData_t *retData)
+{
+    CAFreeEndpoint(retData->endpoint);
+    OICFree(retData->pdu);
+    OICFree(retData);
+}
+
+static size_t CAGetPeerBucket(const CARetransmissionQueue_t *queue, const char *addr,
+                              uint16_t port, CATransportAdapter_t adapter)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char *c = addr; '\0' != *c; c++)
+    {
+        hash = (hash ^ (uint8_t) *c) * 16777619u;
+    }
+    hash = (hash ^ port) * 16777619u;
+    hash = (hash ^ (uint32_t) adapter) * 16777619u;
+    return hash & (queue->peerBucketCount - 1);
+}
+
+static void CAGrowPeerIndex(CARetransmissionQueue_t *queue)
+{
+    size_t bucketCount = queue->peerBucketCount * 2;
+    CARetransmissionPeer_t **buckets = (CARetransmissionPeer_t **) OICCalloc(
+                                           bucketCount, sizeof(CARetransmissionPeer_t *));
+    if (NULL == buckets)
+    {
+        // keep going with longer chains
+        return;
+    }
+
+    CARetransmissionPeer_t **oldBuckets = queue->peerBuckets;
+    size_t oldBucketCount = queue->peerBucketCount;
+    queue->peerBuckets = buckets;
+    queue->peerBucketCount = bucketCount;
+
+    for (size_t i = 0; i < oldBucketCount; i++)
+    {
+        CARetransmissionPeer_t *peer = oldBuckets[i];
+        while (NULL != peer)
+        {
+            CARetransmissionPeer_t *next = peer->hashNext;
+            size_t bucket = CAGetPeerBucket(queue, peer->addr, peer->port, peer->adapter);
+            peer->hashNext = buckets[bucket];
+            buckets[bucket] = peer;
+            peer = next;
+        }
+    }
+    OICFree(oldBuckets);
+}
+
+static void CAIdlePeerRemove(CARetransmissionQueue_t *queue, CARetransmissionPeer_t *peer)
+{
+    if (!peer->idle)
+    {
+        return;
+    }
+
+    if (NULL != peer->idlePrev)
+    {
+        peer->idlePrev->idleNext = peer->idleNext;
+    }
+    else
+    {
+        queue->idleHead = peer->idleNext;
+    }
+    if (NULL != peer->idleNext)
+    {
+        peer->idleNext->idlePrev = peer->idlePrev;
+    }
+    else
+    {
+        queue->idleTail = peer->idlePrev;
+    }
+    peer->idlePrev = NULL;
+    peer->idleNext = NULL;
+    peer->idle = false;
+}
 
-            // #3. increase the retransmission count and update timestamp.
-            retData->timeStamp = currentTime;
-            retData->triedCount++;
+static void CAIdlePeerAppend(CARetransmissionQueue_t *queue, CARetransmissionPeer_t *peer)
+{
+    peer->idlePrev = queue->idleTail;
+    peer->idleNext = NULL;
+    if (NULL != queue->idleTail)
+    {
+        queue->idleTail->idleNext = peer;
+    }
+    else
+    {
+        queue->idleHead = peer;
+    }
+    queue->idleTail = peer;
+    peer->idle = true;
+}
+
+static void CARemovePeer(CARetransmissionQueue_t *queue, CARetransmissionPeer_t *peer)
+{
+    CARetransmissionPeer_t **link =
+        &queue->peerBuckets[CAGetPeerBucket(queue, peer->addr, peer->port, peer->adapter)];
+    while (*link != peer)
+    {
+        link = &(*link)->hashNext;
+    }
+    *link = peer->hashNext;
+
+    CAIdlePeerRemove(queue, peer);
+    queue->peerCount--;
+    OICFree(peer);
+}
+
+/**
+ * @brief   find or create the congestion state of the endpoint. It is taken off
+ *          the idle peers, the caller puts it back when nothing is left pending.
+ * @return  peer, or NULL on allocation failure
+ */
+static CARetransmissionPeer_t *CAGetPeer(CARetransmissionQueue_t *queue,
+                                         const CAEndpoint_t *endpoint, uint64_t now)
+{
+    size_t bucket = CAGetPeerBucket(queue, endpoint->addr, endpoint->port, endpoint->adapter);
+    for (CARetransmissionPeer_t *peer = queue->peerBuckets[bucket]; NULL != peer;
+         peer = peer->hashNext)
+    {
+        if (peer->adapter == endpoint->adapter && peer->port == endpoint->port
+            && 0 == strncmp(peer->addr, endpoint->addr, sizeof(peer->addr)))
+        {
+            CAIdlePeerRemove(queue, peer);
+            return peer;
         }
+    }
+
+    if (queue->peerCount >= RETRANSMISSION_PEER_CACHE_SIZE && NULL != queue->idleHead)
+    {
+        // forget the estimate of the endpoint unused for the longest time
+        CARemovePeer(queue, queue->idleHead);
+    }
+
+    CARetransmissionPeer_t *peer = (CARetransmissionPeer_t *) OICCalloc(
+                                       1, sizeof(CARetransmissionPeer_t));
+    if (NULL == peer)
+    {
+        return NULL;
+    }
+    peer->adapter = endpoint->adapter;
+    peer->port = endpoint->port;
+    OICStrcpy(peer->addr, sizeof(peer->addr), endpoint->addr);
+    peer->heldTail = &peer->held;
+    peer->rto = DEFAULT_ACK_TIMEOUT_SEC * USECS_PER_SEC;
+    peer->rtoUpdated = now;
+
+    bucket = CAGetPeerBucket(queue, peer->addr, peer->port, peer->adapter);
+    peer->hashNext = queue->peerBuckets[bucket];
+    queue->peerBuckets[bucket] = peer;
+    queue->peerCount++;
+
+    if (queue->peerCount > queue->peerBucketCount * 2)
+    {
+        CAGrowPeerIndex(queue);
+    }
+    return peer;
+}
+
+/**
+ * @brief   RTO estimate of the endpoint. An estimate that has not been confirmed
+ *          for a while moves back towards the initial RTO.
+ * @return  microseconds
+ */
+static uint64_t CAGetPeerRto(CARetransmissionPeer_t *peer, uint64_t now)
+{
+    if (peer->rto < USECS_PER_SEC && now - peer->rtoUpdated > 16 * peer->rto)
+    {
+        peer->rto *= 2;
+        peer->rtoUpdated = now;
+    }
+    else if (peer->rto > 3 * USECS_PER_SEC && now - peer->rtoUpdated > 4 * peer->rto)
+    {
+        peer->rto = USECS_PER_SEC + peer->rto / 2;
+        peer->rtoUpdated = now;
+    }
+    return peer->rto;
+}
 
-        // #4. if tried count is max, remove the retransmission data from list.
+/**
+ * @brief   take an RTT sample of answered data. Data retransmitted more than
+ *          twice can't tell which of its transmissions was answered.
+ */
+static void CAUpdatePeerRto(CARetransmission_t *context, const CARetransmissionData_t *retData,
+                            uint64_t now)
+{
+    if (retData->triedCount > 2)
+    {
+        return;
+    }
+
+    CARetransmissionPeer_t *peer = retData->peer;
+    bool strong = (0 == retData->triedCount);
+    uint64_t *srtt = strong ? &peer->strongSrtt : &peer->weakSrtt;
+    uint64_t *rttvar = strong ? &peer->strongRttvar : &peer->weakRttvar;
+    uint64_t rtt = now - retData->firstTimeStamp;
+
+    if (0 == *srtt)
+    {
+        *srtt = rtt;
+        *rttvar = rtt / 2;
+    }
+    else
+    {
+        uint64_t delta = (*srtt > rtt) ? *srtt - rtt : rtt - *srtt;
+        *rttvar = (3 * *rttvar + delta) / 4;
+        *srtt = (7 * *srtt + rtt) / 8;
+    }
+
+    if (strong)
+    {
+        peer->rto = (*srtt + 4 * *rttvar) / 2 + peer->rto / 2;
+        context->statistics.strongRttSamples++;
+    }
+    else
+    {
+        peer->rto = (*srtt + *rttvar) / 4 + 3 * (peer->rto / 4);
+        context->statistics.weakRttSamples++;
+    }
+
+    if (peer->rto > MAX_RTO_MSEC * USECS_PER_MSEC)
+    {
+        peer->rto = MAX_RTO_MSEC * USECS_PER_MSEC;
+    }
+    peer->rtoUpdated = now;
+}
+
+/**
+ * @brief   put data that is sent now into the index and the wheel
+ * @return  false if data with the same message id is pending
+ */
+static bool CAAddRetransmissionData(CARetransmission_t *context,
+                                    CARetransmissionData_t *retData, uint64_t now)
+{
+    CARetransmissionQueue_t *queue = context->pending;
+    CARetransmissionData_t **link = CAFindIndexLink(queue, retData->messageId,
+                                                    retData->endpoint->adapter);
+    if (NULL != *link)
+    {
+        return false;
+    }
+
+    uint64_t rto = CAGetPeerRto(retData->peer, now);
+    retData->timeStamp = now;
+    retData->firstTimeStamp = now;
+    retData->timeout = CAGetTimeoutValue(rto);
+    retData->backoff = CAGetBackoffFactor(rto);
+    retData->triedCount = 0;
+
+    *link = retData;
+    queue->count++;
+    CAScheduleRetransmission(queue, retData);
+
+    if (queue->count > queue->bucketCount * 2)
+    {
+        CAGrowIndex(queue);
+    }
+
+    retData->peer->outstanding++;
+    context->statistics.sent++;
+
+    // notify the thread if it would sleep past the new deadline
+    if (retData->expires < queue->wakeupTick)
+    {
+        oc_cond_signal(context->threadCond);
+    }
+    return true;
+}
+
+/**
+ * @brief   take pending data out of the index and the wheel
+ */
+static void CATakeRetransmissionData(CARetransmissionQueue_t *queue,
+                                     CARetransmissionData_t *retData)
+{
+    CARetransmissionData_t **link = CAFindIndexLink(queue, retData->messageId,
+                                                    retData->endpoint->adapter);
+    if (*link == retData)
+    {
+        *link = retData->hashNext;
+    }
+    CAWheelRemove(retData);
+    queue->count--;
+}
+
+/**
+ * @brief   one CON data of the endpoint is answered or given up: send the data
+ *          waiting for it
+ */
+static void CAReleasePeer(CARetransmission_t *context, CARetransmissionPeer_t *peer,
+                          uint64_t now)
+{
+    uint8_t nstart = context->config.nstart;
+
+    peer->outstanding--;
+    while (NULL != peer->held && (0 == nstart || peer->outstanding < nstart))
+    {
+        CARetransmissionData_t *retData = peer->held;
+        peer->held = retData->next;
+        if (NULL == peer->held)
+        {
+            peer->heldTail = &peer->held;
+        }
+        retData->next = NULL;
+
+        if (!CAAddRetransmissionData(context, retData, now))
+        {
+            OIC_LOG_V(ERROR, TAG, "Duplicate message ID, drop waiting data, msgid=%d",
+                      retData->messageId);
+            CAFreeRetransmissionData(retData);
+            continue;
+        }
+
+        OIC_LOG_V(DEBUG, TAG, "send waiting CON data!!, msgid=%d", retData->messageId);
+        if (NULL != context->dataSendMethod)
+        {
+            context->dataSendMethod(retData->endpoint, retData->pdu,
+                                    retData->size, retData->dataType);
+        }
+    }
+
+    if (0 == peer->outstanding && NULL == peer->held)
+    {
+        CAIdlePeerAppend(context->pending, peer);
+    }
+}
+
+static void CACheckRetransmissionList(CARetransmission_t *context)
+{
+    if (NULL == context)
+    {
+        OIC_LOG(ERROR, TAG, "context is null");
+        return;
+    }
+
+    // mutex lock
+    oc_mutex_lock(context->threadMutex);
+
+    CARetransmissionQueue_t *queue = context->pending;
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+    CARetransmissionData_t *retData =
+        CAWheelAdvance(queue, currentTime / (RETRANSMISSION_TICK_MSEC * USECS_PER_MSEC));
+
+    while (NULL != retData)
+    {
+        CARetransmissionData_t *next = retData->next;
+        retData->next = NULL;
+
+        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
+                  currentTime - retData->timeStamp, retData->triedCount);
+
+        // #2. time's up, send the data.
+        if (NULL != context->dataSendMethod)
+        {
+            OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
+                      retData->messageId);
+            context->dataSendMethod(retData->endpoint, retData->pdu,
+                                    retData->size, retData->dataType);
+        }
+
+        // #3. increase the retransmission count, update timestamp and back off.
+        retData->timeStamp = currentTime;
+        retData->triedCount++;
+        retData->timeout = retData->timeout * retData->backoff / 2;
+        context->statistics.retransmitted++;
+
+        // #4. if tried count is max, remove the retransmission data.
         if (retData->triedCount >= context->config.tryingCount)
         {
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
-            {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
-                // mutex unlock
-                oc_mutex_unlock(context->threadMutex);
-                return;
-            }
+            CATakeRetransmissionData(queue, retData);
+            context->statistics.timedOut++;
+
             OIC_LOG_V(DEBUG, TAG, "max trying count, remove RTCON data,"
-                      "msgid=%d", removedData->messageId);
+                      "msgid=%d", retData->messageId);
 
             // callback for retransmit timeout
             if (NULL != context->timeoutCallback)
             {
-                context->timeoutCallback(removedData->endpoint, removedData->pdu,
-                                         removedData->size);
+                context->timeoutCallback(retData->endpoint, retData->pdu, retData->size);
             }
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-
-            OICFree(removedData);
-
-            // modify loop value.
-            len = u_arraylist_length(context->dataList);
-            --i;
+            CARetransmissionPeer_t *peer = retData->peer;
+            CAFreeRetransmissionData(retData);
+            CAReleasePeer(context, peer, currentTime);
+        }
+        else
+        {
+            CAScheduleRetransmission(queue, retData);
         }
+
+        retData = next;
     }
 
     // mutex unlock
@@ -250,25 +895,33 @@ void CARetransmissionBaseRoutine(void *threadValue)
         // mutex lock
         oc_mutex_lock(context->threadMutex);
 
-        if (!context->isStop && u_arraylist_length(context->dataList) <= 0)
+        CARetransmissionQueue_t *queue = context->pending;
+        if (!context->isStop && 0 == queue->count)
         {
             // if list is empty, thread will wait
             OIC_LOG(DEBUG, TAG, "wait..there is no retransmission data.");
 
             // wait
+            queue->wakeupTick = UINT64_MAX;
             oc_cond_wait(context->threadCond, context->threadMutex);
 
             OIC_LOG(DEBUG, TAG, "wake up..");
         }
         else if (!context->isStop)
         {
-            // check each RETRANSMISSION_CHECK_PERIOD_SEC time.
-            OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
-                      RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC);
+            // sleep until the next wheel slot that needs a look.
+            queue->wakeupTick = CAWheelNextTick(queue);
+            uint64_t wakeupTime = queue->wakeupTick * RETRANSMISSION_TICK_MSEC * USECS_PER_MSEC;
+            uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+            if (wakeupTime > currentTime)
+            {
+                OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
+                          wakeupTime - currentTime);
 
-            // wait
-            uint64_t absTime = RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC;
-            oc_cond_wait_for(context->threadCond, context->threadMutex, absTime );
+                // wait
+                oc_cond_wait_for(context->threadCond, context->threadMutex,
+                                 wakeupTime - currentTime);
+            }
         }
         else
         {
@@ -316,7 +969,8 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
     memset(context, 0, sizeof(CARetransmission_t));
 
     CARetransmissionConfig_t cfg = { .supportType = DEFAULT_RETRANSMISSION_TYPE,
-                                     .tryingCount = DEFAULT_RETRANSMISSION_COUNT };
+                                     .tryingCount = DEFAULT_RETRANSMISSION_COUNT,
+                                     .nstart = DEFAULT_NSTART };
 
     if (config)
     {
@@ -331,12 +985,21 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
     context->timeoutCallback = timeoutCallback;
     context->config = cfg;
     context->isStop = false;
-    context->dataList = u_arraylist_create();
+    context->pending = CACreateRetransmissionQueue();
+    if (NULL == context->pending)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+        oc_mutex_free(context->threadMutex);
+        context->threadMutex = NULL;
+        oc_cond_free(context->threadCond);
+        context->threadCond = NULL;
+        return CA_MEMORY_ALLOC_FAILED;
+    }
 
     return CA_STATUS_OK;
 }
 
-CAResult_t CARetransmissionSentData(CARetransmission_t *context,
+CAResult_t CARetransmissionSendData(CARetransmission_t *context,
                                     const CAEndpoint_t *endpoint,
                                     CADataType_t dataType,
                                     const void *pdu, uint32_t size)
@@ -358,7 +1021,7 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
     CAMessageType_t type = CAGetMessageTypeFromPduBinaryData(pdu, size);
     uint16_t messageId = CAGetMessageIdFromPduBinaryData(pdu, size);
 
-    OIC_LOG_V(DEBUG, TAG, "sent pdu, msgtype=%d, msgid=%d", type, messageId);
+    OIC_LOG_V(DEBUG, TAG, "send pdu, msgtype=%d, msgid=%d", type, messageId);
 
     if (CA_MSG_CONFIRM != type)
     {
@@ -396,55 +1059,81 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    // #2. add additional information. (time stamp, retransmission count...)
-    retData->timeStamp = OICGetCurrentTime(TIME_IN_US);
-    retData->timeout = CAGetTimeoutValue();
-    retData->triedCount = 0;
+    // #2. add additional information.
     retData->messageId = messageId;
     retData->endpoint = remoteEndpoint;
     retData->pdu = pduData;
     retData->size = size;
     retData->dataType = dataType;
+
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
+    CARetransmissionQueue_t *queue = context->pending;
+    CARetransmissionPeer_t *peer = CAGetPeer(queue, endpoint, currentTime);
+    if (NULL == peer)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
+
+        CAFreeRetransmissionData(retData);
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    retData->peer = peer;
 
-    // #3. add data into list
-    for (size_t i = 0; i < len; i++)
+    // #3. wait while NSTART data to the endpoint are outstanding
+    uint8_t nstart = context->config.nstart;
+    if (0 != nstart && (peer->outstanding >= nstart || NULL != peer->held))
     {
-        CARetransmissionData_t *currData = u_arraylist_get(context->dataList, i);
+        OIC_LOG_V(DEBUG, TAG, "%d CON data outstanding, msgid=%d waits",
+                  peer->outstanding, messageId);
+        *peer->heldTail = retData;
+        peer->heldTail = &retData->next;
+        context->statistics.held++;
 
-        if (NULL == currData)
-        {
-            continue;
-        }
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
+
+        return CA_STATUS_OK;
+    }
 
-        // found index
-        if (NULL != currData->endpoint && currData->messageId == messageId
-            && (currData->endpoint->adapter == endpoint->adapter))
+    // #4. add data into the index and the wheel, then send it
+    if (!CAAddRetransmissionData(context, retData, currentTime))
+    {
+        OIC_LOG(ERROR, TAG, "Duplicate message ID, sent without retransmission");
+        if (0 == peer->outstanding)
         {
-            OIC_LOG(ERROR, TAG, "Duplicate message ID");
+            CAIdlePeerAppend(queue, peer);
+        }
 
-            // mutex unlock
-            oc_mutex_unlock(context->threadMutex);
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-            OICFree(retData);
-            OICFree(pduData);
-            OICFree(remoteEndpoint);
-            return CA_STATUS_FAILED;
-        }
+        CAFreeRetransmissionData(retData);
+        return CA_NOT_SUPPORTED;
     }
 
-    u_arraylist_add(context->dataList, (void *) retData);
-
-    // notify the thread
-    oc_cond_signal(context->threadCond);
+    CAResult_t res = CA_STATUS_OK;
+    if (NULL != context->dataSendMethod)
+    {
+        res = context->dataSendMethod(endpoint, pdu, size, dataType);
+    }
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG_V(ERROR, TAG, "send failed, remove RTCON data, msgid=%d", messageId);
+        CATakeRetransmissionData(queue, retData);
+        CAFreeRetransmissionData(retData);
+        CAReleasePeer(context, peer, currentTime);
+    }
 
     // mutex unlock
     oc_mutex_unlock(context->threadMutex);
 
-    return CA_STATUS_OK;
+    return res;
 }
 
 CAResult_t CARetransmissionReceivedData(CARetransmission_t *context,
@@ -482,73 +1171,60 @@ CAResult_t CARetransmissionReceivedData(CARetransmission_t *context,
 
     // mutex lock
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
 
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionData_t **link = CAFindIndexLink(context->pending, messageId,
+                                                    endpoint->adapter);
+    CARetransmissionData_t *retData = *link;
+    if (NULL != retData)
     {
-        CARetransmissionData_t *retData = (CARetransmissionData_t *) u_arraylist_get(
-                context->dataList, i);
-
-        if (NULL == retData)
+        // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
+        // if retransmission was finish..token will be unavailable.
+        if (CA_EMPTY == code)
         {
-            continue;
-        }
+            OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
 
-        // found index
-        if (NULL != retData->endpoint && retData->messageId == messageId
-            && (retData->endpoint->adapter == endpoint->adapter))
-        {
-            // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
-            // if retransmission was finish..token will be unavailable.
-            if (CA_EMPTY == CAGetCodeFromPduBinaryData(pdu, size))
+            if (NULL == retData->pdu)
             {
-                OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
-
-                if (NULL == retData->pdu)
-                {
-                    OIC_LOG(ERROR, TAG, "retData->pdu is null");
-                    OICFree(retData);
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
+                OIC_LOG(ERROR, TAG, "retData->pdu is null");
 
-                    return CA_STATUS_FAILED;
-                }
-
-                // copy PDU data
-                (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
-                if ((*retransmissionPdu) == NULL)
-                {
-                    OICFree(retData);
-                    OIC_LOG(ERROR, TAG, "memory error");
-
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
+                // mutex unlock
+                oc_mutex_unlock(context->threadMutex);
 
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy((*retransmissionPdu), retData->pdu, retData->size);
+                return CA_STATUS_FAILED;
             }
 
-            // #2. remove data from list
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
+            // copy PDU data
+            (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
+            if ((*retransmissionPdu) == NULL)
             {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
+                OIC_LOG(ERROR, TAG, "memory error");
 
                 // mutex unlock
                 oc_mutex_unlock(context->threadMutex);
 
-                return CA_STATUS_FAILED;
+                return CA_MEMORY_ALLOC_FAILED;
             }
+            memcpy((*retransmissionPdu), retData->pdu, retData->size);
+        }
 
-            OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
+        // #2. remove data from the index and the wheel
+        *link = retData->hashNext;
+        CAWheelRemove(retData);
+        context->pending->count--;
+        context->statistics.acknowledged++;
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-            OICFree(removedData);
+        OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
 
-            break;
+        // #3. a RST may stand for a local send error, only ACKs are RTT samples
+        uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+        if (CA_MSG_ACKNOWLEDGE == type)
+        {
+            CAUpdatePeerRto(context, retData, currentTime);
         }
+
+        CARetransmissionPeer_t *peer = retData->peer;
+        CAFreeRetransmissionData(retData);
+        CAReleasePeer(context, peer, currentTime);
     }
 
     // mutex unlock
@@ -596,24 +1272,93 @@ CAResult_t CARetransmissionDestroy(CARetransmission_t *context)
     OIC_LOG(DEBUG, TAG, "retransmission context destroy..");
 
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionQueue_t *queue = context->pending;
+    if (NULL != queue)
     {
-        CARetransmissionData_t *data = u_arraylist_get(context->dataList, i);
-        if (NULL == data)
+        // every data is in exactly one index bucket
+        for (size_t i = 0; i < queue->bucketCount; i++)
         {
-            continue;
+            CARetransmissionData_t *data = queue->buckets[i];
+            while (NULL != data)
+            {
+                CARetransmissionData_t *next = data->hashNext;
+                CAFreeRetransmissionData(data);
+                data = next;
+            }
         }
-        CAFreeEndpoint(data->endpoint);
-        OICFree(data->pdu);
-        OICFree(data);
+        OICFree(queue->buckets);
+
+        // data waiting for NSTART is only linked from its peer
+        for (size_t i = 0; i < queue->peerBucketCount; i++)
+        {
+            CARetransmissionPeer_t *peer = queue->peerBuckets[i];
+            while (NULL != peer)
+            {
+                CARetransmissionPeer_t *next = peer->hashNext;
+                CARetransmissionData_t *data = peer->held;
+                while (NULL != data)
+                {
+                    CARetransmissionData_t *nextData = data->next;
+                    CAFreeRetransmissionData(data);
+                    data = nextData;
+                }
+                OICFree(peer);
+                peer = next;
+            }
+        }
+        OICFree(queue->peerBuckets);
+        OICFree(queue);
+        context->pending = NULL;
     }
     oc_mutex_unlock(context->threadMutex);
 
     oc_mutex_free(context->threadMutex);
     context->threadMutex = NULL;
     oc_cond_free(context->threadCond);
-    u_arraylist_free(&context->dataList);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CARetransmissionSetNstart(CARetransmission_t *context, uint8_t nstart)
+{
+    if (NULL == context)
+    {
+        OIC_LOG(ERROR, TAG, "invalid parameter");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL == context->threadMutex)
+    {
+        OIC_LOG(ERROR, TAG, "context is not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    oc_mutex_lock(context->threadMutex);
+    context->config.nstart = nstart;
+    oc_mutex_unlock(context->threadMutex);
+
+    OIC_LOG_V(DEBUG, TAG, "NSTART is %d", nstart);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CARetransmissionGetStatistics(CARetransmission_t *context,
+                                         CARetransmissionStatistics_t *statistics)
+{
+    if (NULL == context || NULL == statistics)
+    {
+        OIC_LOG(ERROR, TAG, "invalid parameter");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL == context->threadMutex)
+    {
+        OIC_LOG(ERROR, TAG, "context is not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    oc_mutex_lock(context->threadMutex);
+    *statistics = context->statistics;
+    oc_mutex_unlock(context->threadMutex);
 
     return CA_STATUS_OK;
 }
@@ -109,6 +109,14 @@ static void CAIPDeinitializeQueueHandles(void);
 
 static void CAIPSendDataThread(void *threadData);
 
+/**
+ * Send a batch of data taken off the send queue in one wakeup.
+ *
+ * @param threadData    IP data to send.
+ * @param count         number of IP data.
+ */
+static void CAIPSendDataBatch(void **threadData, uint32_t count);
+
 /**
  * create IP data.
  *
@@ -159,7 +167,7 @@ CAResult_t CAIPInitializeQueueHandles(void)
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    if (CA_STATUS_OK != CAQueueingThreadInitialize(g_sendQueueHandle,
+    if (CA_STATUS_OK != CAQueueingThreadInitializeLockFree(g_sendQueueHandle,
                                 (const ca_thread_pool_t)caglobals.ip.threadpool,
                                 CAIPSendDataThread, CADataDestroyer))
     {
@@ -170,6 +178,7 @@ CAResult_t CAIPInitializeQueueHandles(void)
         g_ownIpEndpointList = NULL;
         return CA_STATUS_FAILED;
     }
+    CAQueueingThreadSetBatchTask(g_sendQueueHandle, CAIPSendDataBatch);
 
     return CA_STATUS_OK;
 }
@@ -349,6 +358,9 @@ static void CAInitializeIPGlobals(void)
     caglobals.ip.m6s.port = CA_SECURE_COAP;
     caglobals.ip.m4.port  = CA_COAP;
     caglobals.ip.m4s.port = CA_SECURE_COAP;
+#if defined(HAVE_SYS_EPOLL_H)
+    caglobals.ip.epollFd = -1;
+#endif
 
     CATransportFlags_t flags = 0;
     if (caglobals.client)
@@ -574,6 +586,10 @@ void CATerminateIP(void)
 
     CAIPDeinitializeQueueHandles();
 
+    // Nothing is queued if the adapter was stopped; otherwise the send thread
+    // is gone now and must not leave datagrams behind.
+    CAIPFlushSendData();
+
 #ifdef WSA_WAIT_EVENT_0
     // Windows-specific clean-up.
     OC_VERIFY(0 == WSACleanup());
@@ -594,7 +610,7 @@ void CAIPSendDataThread(void *threadData)
     {
         //Processing for sending multicast
         OIC_LOG(DEBUG, TAG, "Send Multicast Data is called");
-        CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, true);
+        CAIPQueueSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, true);
     }
     else
     {
@@ -602,6 +618,9 @@ void CAIPSendDataThread(void *threadData)
 #ifdef __WITH_DTLS__
         if (ipData->remoteEndpoint && ipData->remoteEndpoint->flags & CA_SECURE)
         {
+            // Encrypted records are sent immediately; keep them behind earlier data.
+            CAIPFlushSendData();
+
             OIC_LOG(DEBUG, TAG, "DTLS encrypt called");
             CAResult_t result = CAencryptSsl(ipData->remoteEndpoint, ipData->data, ipData->dataLen);
             if (CA_STATUS_OK != result)
@@ -613,14 +632,28 @@ void CAIPSendDataThread(void *threadData)
         else
         {
             OIC_LOG(DEBUG, TAG, "Send Unicast Data is called");
-            CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
+            CAIPQueueSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
         }
 #else
-        CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
+        CAIPQueueSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
 #endif
     }
 }
 
+void CAIPSendDataBatch(void **threadData, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CAIPSendDataThread(threadData[i]);
+    }
+
+    // Hand the batch to the kernel once no more data is waiting.
+    if (CAQueueingThreadIsEmpty(g_sendQueueHandle))
+    {
+        CAIPFlushSendData();
+    }
+}
+
 
 CAIPData_t *CACreateIPData(const CAEndpoint_t *remoteEndpoint, const void *data,
                            uint32_t dataLength, bool isMulticast)
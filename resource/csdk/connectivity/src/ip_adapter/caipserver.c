@@ -46,6 +46,9 @@
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #ifdef HAVE_ARPA_INET_H
 #include <arpa/inet.h>
 #endif
@@ -70,6 +73,7 @@
 #include "ca_adapter_net_ssl.h"
 #endif
 #include "octhread.h"
+#include "ocatomic.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
 
@@ -90,6 +94,48 @@
 
 #define SELECT_TIMEOUT 1     // select() seconds (and termination latency)
 
+#if defined(HAVE_SYS_EPOLL_H)
+/*
+ * Maximum number of ready events fetched by a single epoll_wait()
+ */
+#define EPOLL_MAX_EVENTS 16
+
+/*
+ * Socket errors tolerated while draining an edge-triggered socket. A pending
+ * error, e.g. from an ICMP message, is reported once and may hide queued data.
+ */
+#define RECV_MAX_SOCKET_ERRORS 8
+
+#if defined(MSG_WAITFORONE)
+/*
+ * Drain edge-triggered sockets with recvmmsg() into a preallocated packet ring
+ */
+#define CA_IP_RECVMMSG
+
+/*
+ * Maximum number of datagrams received by a single recvmmsg()
+ */
+#define RECV_BATCH_SIZE 16
+#endif
+#endif
+
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+/*
+ * Coalesce queued datagrams into sendmmsg() calls
+ */
+#define CA_IP_SENDMMSG
+
+/*
+ * Maximum number of datagrams handed to a single sendmmsg()
+ */
+#define SEND_BATCH_SIZE 32
+
+/*
+ * Payload bytes a send batch can hold before it has to be flushed
+ */
+#define SEND_BATCH_BUF_LEN 32768
+#endif
+
 #define IPv4_MULTICAST     "224.0.1.187"
 static struct in_addr IPv4MulticastAddress = { 0 };
 
@@ -114,6 +160,32 @@ static struct in6_addr IPv6MulticastAddressGlb;
  */
 #define RECV_MSG_BUF_LEN 16384
 
+#if defined(CA_IP_RECVMMSG)
+/*
+ * One slot of the receive ring. Each slot owns the buffers recvmmsg()
+ * fills in. Datagrams are parsed where they are in the slot, and the packet
+ * callback copies out only what it queues, so a slot can be reused by the
+ * next batch as soon as its datagram was dispatched.
+ */
+typedef struct
+{
+    struct sockaddr_storage srcAddr;
+    union
+    {
+        struct cmsghdr cmsg;
+        unsigned char data[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+    } cmsg;
+    struct iovec iov;
+    char buffer[RECV_MSG_BUF_LEN];
+} CAIPRecvSlot_t;
+
+/*
+ * Receive ring and message headers, only touched by the receive thread
+ */
+static CAIPRecvSlot_t *g_recvRing = NULL;
+static struct mmsghdr g_recvMsgs[RECV_BATCH_SIZE];
+#endif
+
 static char *ipv6mcnames[IPv6_DOMAINS] = {
     NULL,
     IPv6_MULTICAST_INT,
@@ -149,6 +221,49 @@ static char *ipv6mcnames[IPv6_DOMAINS] = {
 #define CAIPS_GET_ERROR \
     strerror(errno)
 #endif
+#if defined(CA_IP_SENDMMSG)
+/*
+ * One datagram of a send batch. The endpoint is kept for error reporting.
+ */
+typedef struct
+{
+    CAEndpoint_t endpoint;
+    struct sockaddr_storage dest;
+    union
+    {
+        struct cmsghdr cmsg;
+        unsigned char data[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+    } cmsg;
+    struct iovec iov;
+} CAIPSendSlot_t;
+
+/*
+ * Datagrams waiting to be sent on one socket with a single sendmmsg()
+ */
+typedef struct
+{
+    CASocketFd_t fd;
+    size_t count;
+    size_t used;
+    CAIPSendSlot_t slots[SEND_BATCH_SIZE];
+    struct mmsghdr msgs[SEND_BATCH_SIZE];
+    uint8_t payload[SEND_BATCH_BUF_LEN];
+} CAIPSendBatch_t;
+
+/*
+ * Send batches per address family, only touched by the send thread
+ */
+static CAIPSendBatch_t g_sendBatch4 = { .fd = OC_INVALID_SOCKET };
+static CAIPSendBatch_t g_sendBatch6 = { .fd = OC_INVALID_SOCKET };
+#endif
+
+/*
+ * Send path counters, see CAIPGetSendStatistics()
+ */
+static volatile int32_t g_sentMessages = 0;
+static volatile int32_t g_sendSyscalls = 0;
+static volatile int32_t g_sendFailures = 0;
+
 static CAIPErrorHandleCallback g_ipErrorHandler = NULL;
 
 static CAIPPacketReceivedCallback g_packetReceivedCallback = NULL;
@@ -161,6 +276,12 @@ static void CAEventReturned(CASocketFd_t socket);
 #endif
 
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags);
+static CAResult_t CAProcessReceivedPacket(CATransportFlags_t flags, const unsigned char *pktinfo,
+                                          struct sockaddr_storage *srcAddr, int namelen,
+                                          char *data, size_t dataLen);
+#if defined(CA_IP_RECVMMSG)
+static int CAReceiveMessageBatch(CASocketFd_t fd, CATransportFlags_t flags);
+#endif
 
 static void CACloseFDs(void)
 {
@@ -170,6 +291,17 @@ static void CACloseFDs(void)
         close(caglobals.ip.shutdownFds[0]);
         caglobals.ip.shutdownFds[0] = -1;
     }
+#endif
+#if defined(HAVE_SYS_EPOLL_H)
+    if (caglobals.ip.epollFd != -1)
+    {
+        close(caglobals.ip.epollFd);
+        caglobals.ip.epollFd = -1;
+    }
+#endif
+#if defined(CA_IP_RECVMMSG)
+    OICFree(g_recvRing);
+    g_recvRing = NULL;
 #endif
     CADeInitializeIPGlobals();
 }
@@ -208,8 +340,180 @@ static void CAReceiveHandler(void *data)
     }
 
 
+static void CAHandleNetlinkEvent(void)
+{
+#if NETWORK_INTERFACE_CHANGED_LOGGING
+    OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
+#endif
+    u_arraylist_t *iflist = CAFindInterfaceChange();
+    if (iflist)
+    {
+        size_t listLength = u_arraylist_length(iflist);
+        for (size_t i = 0; i < listLength; i++)
+        {
+            CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+            if (ifitem)
+            {
+                CAProcessNewInterface(ifitem);
+            }
+        }
+        u_arraylist_destroy(iflist);
+    }
+}
+
+#if defined(HAVE_SYS_EPOLL_H)
+
+/*
+ * The epoll user data carries both the socket and its transport flags,
+ * so a ready event can be dispatched without testing every socket.
+ */
+#define EPOLL_DATA(FD, FLAGS)  (((uint64_t)(uint32_t)(FLAGS) << 32) | (uint32_t)(FD))
+#define EPOLL_DATA_FD(DATA)    ((CASocketFd_t)(uint32_t)((DATA) & 0xffffffff))
+#define EPOLL_DATA_FLAGS(DATA) ((CATransportFlags_t)((DATA) >> 32))
+
+#define EPOLL_ADD(TYPE, FLAGS) \
+    CAEpollAdd(caglobals.ip.TYPE.fd, FLAGS, EPOLLIN | EPOLLET)
+
+static void CAEpollAdd(CASocketFd_t fd, CATransportFlags_t flags, uint32_t events)
+{
+    if (OC_INVALID_SOCKET == fd)
+    {
+        return;
+    }
+
+    struct epoll_event event = { .events = events, .data.u64 = EPOLL_DATA(fd, flags) };
+    if (-1 == epoll_ctl(caglobals.ip.epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl add fd %d failed: %s", fd, strerror(errno));
+    }
+}
+
+/**
+ * Create the epoll instance and register every receive socket once.
+ * Data sockets are edge-triggered and drained until they would block;
+ * the shutdown pipe and netlink socket stay level-triggered because
+ * their handlers only consume a single message per wakeup.
+ * If epoll is not usable, the receive thread falls back to select().
+ */
+static void CAInitializeEpoll(void)
+{
+    caglobals.ip.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == caglobals.ip.epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s (using select)", strerror(errno));
+        return;
+    }
+
+    EPOLL_ADD(u6,  CA_IPV6);
+    EPOLL_ADD(u6s, CA_IPV6 | CA_SECURE);
+    EPOLL_ADD(u4,  CA_IPV4);
+    EPOLL_ADD(u4s, CA_IPV4 | CA_SECURE);
+    EPOLL_ADD(m6,  CA_MULTICAST | CA_IPV6);
+    EPOLL_ADD(m6s, CA_MULTICAST | CA_IPV6 | CA_SECURE);
+    EPOLL_ADD(m4,  CA_MULTICAST | CA_IPV4);
+    EPOLL_ADD(m4s, CA_MULTICAST | CA_IPV4 | CA_SECURE);
+
+    if (caglobals.ip.shutdownFds[0] != -1)
+    {
+        CAEpollAdd(caglobals.ip.shutdownFds[0], CA_DEFAULT_FLAGS, EPOLLIN);
+    }
+    if (caglobals.ip.netlinkFd != OC_INVALID_SOCKET)
+    {
+        CAEpollAdd(caglobals.ip.netlinkFd, CA_DEFAULT_FLAGS, EPOLLIN);
+    }
+
+#if defined(CA_IP_RECVMMSG)
+    if (!g_recvRing)
+    {
+        g_recvRing = (CAIPRecvSlot_t *)OICMalloc(RECV_BATCH_SIZE * sizeof (CAIPRecvSlot_t));
+        if (!g_recvRing)
+        {
+            OIC_LOG(ERROR, TAG, "receive ring allocation failed (using recvmsg)");
+        }
+    }
+#endif
+}
+
+static void CAEpollFindReadyMessage(void)
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    int timeout = caglobals.ip.selectTimeout == -1 ? -1 : caglobals.ip.selectTimeout * 1000;
+
+    int ret = epoll_wait(caglobals.ip.epollFd, events, EPOLL_MAX_EVENTS, timeout);
+
+    if (caglobals.ip.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (0 > ret)
+    {
+        if (EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", CAIPS_GET_ERROR);
+        }
+        return;
+    }
+
+    for (int i = 0; i < ret && !caglobals.ip.terminate; i++)
+    {
+        CASocketFd_t fd = EPOLL_DATA_FD(events[i].data.u64);
+        CATransportFlags_t flags = EPOLL_DATA_FLAGS(events[i].data.u64);
+
+        if (fd == caglobals.ip.netlinkFd)
+        {
+            CAHandleNetlinkEvent();
+        }
+        else if (fd == caglobals.ip.shutdownFds[0])
+        {
+            char buf[10] = {0};
+            ssize_t len = read(caglobals.ip.shutdownFds[0], buf, sizeof (buf));
+            (void)len;
+        }
+        else
+        {
+            // Edge-triggered: keep reading until the socket would block.
+            int errors = 0;
+#if defined(CA_IP_RECVMMSG)
+            if (g_recvRing)
+            {
+                int count = 0;
+                while (!caglobals.ip.terminate &&
+                       -1 != (count = CAReceiveMessageBatch(fd, flags)))
+                {
+                    if ((0 == count) && (++errors > RECV_MAX_SOCKET_ERRORS))
+                    {
+                        break;
+                    }
+                }
+                continue;
+            }
+#endif
+            CAResult_t res = CA_STATUS_OK;
+            while (!caglobals.ip.terminate &&
+                   CA_RECEIVE_FAILED != (res = CAReceiveMessage(fd, flags)))
+            {
+                if ((CA_SOCKET_OPERATION_FAILED == res) && (++errors > RECV_MAX_SOCKET_ERRORS))
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+#endif // HAVE_SYS_EPOLL_H
+
 static void CAFindReadyMessage(void)
 {
+#if defined(HAVE_SYS_EPOLL_H)
+    if (caglobals.ip.epollFd != -1)
+    {
+        CAEpollFindReadyMessage();
+        return;
+    }
+#endif
+
     fd_set readFds;
     struct timeval timeout;
 
@@ -277,23 +581,7 @@ static void CASelectReturned(fd_set *readFds, int ret)
         else ISSET(m4s, readFds, CA_MULTICAST | CA_IPV4 | CA_SECURE)
         else if ((caglobals.ip.netlinkFd != OC_INVALID_SOCKET) && FD_ISSET(caglobals.ip.netlinkFd, readFds))
         {
-#if NETWORK_INTERFACE_CHANGED_LOGGING
-            OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
-#endif
-            u_arraylist_t *iflist = CAFindInterfaceChange();
-            if (iflist)
-            {
-                size_t listLength = u_arraylist_length(iflist);
-                for (size_t i = 0; i < listLength; i++)
-                {
-                    CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                    if (ifitem)
-                    {
-                        CAProcessNewInterface(ifitem);
-                    }
-                }
-                u_arraylist_destroy(iflist);
-            }
+            CAHandleNetlinkEvent();
             break;
         }
         else if (FD_ISSET(caglobals.ip.shutdownFds[0], readFds))
@@ -559,6 +847,13 @@ void CADeInitializeIPGlobals(void)
     CAUnregisterForAddressChanges();
 }
 
+/**
+ * Receive a datagram from fd and dispatch it.
+ *
+ * @return ::CA_RECEIVE_FAILED when nothing is queued (EAGAIN or EWOULDBLOCK),
+ *         ::CA_SOCKET_OPERATION_FAILED on any other socket error,
+ *         or the result of dispatching the datagram.
+ */
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
 {
     char recvBuffer[RECV_MSG_BUF_LEN] = {0};
@@ -599,11 +894,23 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
                           .msg_control = &cmsg,
                           .msg_controllen = CMSG_SPACE(len) };
 
-    ssize_t recvLen = recvmsg(fd, &msg, flags);
+    int recvFlags = 0;
+#if defined(HAVE_SYS_EPOLL_H)
+    if (caglobals.ip.epollFd != -1)
+    {
+        recvFlags = MSG_DONTWAIT;
+    }
+#endif
+
+    ssize_t recvLen = recvmsg(fd, &msg, recvFlags);
     if (OC_SOCKET_ERROR == recvLen)
     {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            return CA_RECEIVE_FAILED;
+        }
         OIC_LOG_V(ERROR, TAG, "Recvfrom failed %s", strerror(errno));
-        return CA_STATUS_FAILED;
+        return CA_SOCKET_OPERATION_FAILED;
     }
 
     for (cmp = CMSG_FIRSTHDR(&msg); cmp != NULL; cmp = CMSG_NXTHDR(&msg, cmp))
@@ -661,6 +968,14 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 #endif // !defined(WSA_CMSG_DATA)
+
+    return CAProcessReceivedPacket(flags, pktinfo, &srcAddr, namelen, recvBuffer, recvLen);
+}
+
+static CAResult_t CAProcessReceivedPacket(CATransportFlags_t flags, const unsigned char *pktinfo,
+                                          struct sockaddr_storage *srcAddr, int namelen,
+                                          char *data, size_t dataLen)
+{
     if (!pktinfo)
     {
         OIC_LOG(ERROR, TAG, "pktinfo is null");
@@ -671,12 +986,12 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
 
     if (flags & CA_IPV6)
     {
-        sep.endpoint.ifindex = ((struct in6_pktinfo *)pktinfo)->ipi6_ifindex;
+        sep.endpoint.ifindex = ((const struct in6_pktinfo *)pktinfo)->ipi6_ifindex;
 
         if (flags & CA_MULTICAST)
         {
-            struct in6_addr *addr = &(((struct in6_pktinfo *)pktinfo)->ipi6_addr);
-            unsigned char topbits = ((unsigned char *)addr)[0];
+            const struct in6_addr *addr = &(((const struct in6_pktinfo *)pktinfo)->ipi6_addr);
+            unsigned char topbits = ((const unsigned char *)addr)[0];
             if (topbits != 0xff)
             {
                 sep.endpoint.flags &= ~CA_MULTICAST;
@@ -685,11 +1000,11 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
     }
     else
     {
-        sep.endpoint.ifindex = ((struct in_pktinfo *)pktinfo)->ipi_ifindex;
+        sep.endpoint.ifindex = ((const struct in_pktinfo *)pktinfo)->ipi_ifindex;
 
         if (flags & CA_MULTICAST)
         {
-            struct in_addr *addr = &((struct in_pktinfo *)pktinfo)->ipi_addr;
+            const struct in_addr *addr = &((const struct in_pktinfo *)pktinfo)->ipi_addr;
             uint32_t host = ntohl(addr->s_addr);
             unsigned char topbits = ((unsigned char *)&host)[3];
             if (topbits < 224 || topbits > 239)
@@ -699,7 +1014,7 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 
-    CAConvertAddrToName(&srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
+    CAConvertAddrToName(srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
 
     if (flags & CA_SECURE)
     {
@@ -707,7 +1022,7 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
 #ifdef TB_LOG
         int decryptResult =
 #endif
-        CAdecryptSsl(&sep, (uint8_t *)recvBuffer, recvLen);
+        CAdecryptSsl(&sep, (uint8_t *)data, dataLen);
         OIC_LOG_V(DEBUG, TAG, "CAdecryptSsl returns [%d]", decryptResult);
 #else
         OIC_LOG(ERROR, TAG, "Encrypted message but no DTLS");
@@ -717,13 +1032,93 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
     {
         if (g_packetReceivedCallback)
         {
-            g_packetReceivedCallback(&sep, recvBuffer, recvLen);
+            g_packetReceivedCallback(&sep, data, dataLen);
         }
     }
 
     return CA_STATUS_OK;
 }
 
+#if defined(CA_IP_RECVMMSG)
+static unsigned char *CAFindPktInfo(struct msghdr *msg, int level, int type)
+{
+    unsigned char *pktinfo = NULL;
+    for (struct cmsghdr *cmp = CMSG_FIRSTHDR(msg); cmp != NULL; cmp = CMSG_NXTHDR(msg, cmp))
+    {
+        if (cmp->cmsg_level == level && cmp->cmsg_type == type)
+        {
+            pktinfo = CMSG_DATA(cmp);
+        }
+    }
+    return pktinfo;
+}
+
+/**
+ * Receive up to RECV_BATCH_SIZE datagrams from fd with a single recvmmsg()
+ * into the receive ring, and dispatch each of them from its slot.
+ *
+ * @return number of datagrams received, 0 on a socket error other than EAGAIN or
+ *         EWOULDBLOCK, or -1 when nothing is queued.
+ */
+static int CAReceiveMessageBatch(CASocketFd_t fd, CATransportFlags_t flags)
+{
+    int namelen = 0;
+    int level = 0;
+    int type = 0;
+
+    if (flags & CA_IPV6)
+    {
+        namelen = sizeof (struct sockaddr_in6);
+        level = IPPROTO_IPV6;
+        type = IPV6_PKTINFO;
+    }
+    else
+    {
+        namelen = sizeof (struct sockaddr_in);
+        level = IPPROTO_IP;
+        type = IP_PKTINFO;
+    }
+
+    // The kernel updates the name and control lengths, so reset every slot.
+    for (size_t i = 0; i < RECV_BATCH_SIZE; i++)
+    {
+        CAIPRecvSlot_t *slot = &g_recvRing[i];
+        slot->iov.iov_base = slot->buffer;
+        slot->iov.iov_len = sizeof (slot->buffer);
+
+        struct msghdr *msg = &g_recvMsgs[i].msg_hdr;
+        msg->msg_name = &slot->srcAddr;
+        msg->msg_namelen = namelen;
+        msg->msg_iov = &slot->iov;
+        msg->msg_iovlen = 1;
+        msg->msg_control = &slot->cmsg;
+        msg->msg_controllen = sizeof (slot->cmsg);
+        msg->msg_flags = 0;
+        g_recvMsgs[i].msg_len = 0;
+    }
+
+    int count = recvmmsg(fd, g_recvMsgs, RECV_BATCH_SIZE, MSG_DONTWAIT, NULL);
+    if (-1 == count)
+    {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            return -1;
+        }
+        OIC_LOG_V(ERROR, TAG, "recvmmsg failed %s", strerror(errno));
+        return 0;
+    }
+
+    for (int i = 0; i < count && !caglobals.ip.terminate; i++)
+    {
+        unsigned char *pktinfo = CAFindPktInfo(&g_recvMsgs[i].msg_hdr, level, type);
+        (void)CAProcessReceivedPacket(flags, pktinfo, &g_recvRing[i].srcAddr, namelen,
+                                      g_recvRing[i].buffer, g_recvMsgs[i].msg_len);
+    }
+
+    return count;
+}
+#endif // CA_IP_RECVMMSG
+
 void CAIPPullData(void)
 {
     OIC_LOG_V(DEBUG, TAG, "IN %s", __func__);
@@ -1007,6 +1402,11 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
     // create source of network address change notifications
     CARegisterForAddressChanges();
 
+#if defined(HAVE_SYS_EPOLL_H)
+    // register all receive fds once instead of rebuilding an fd_set per wakeup
+    CAInitializeEpoll();
+#endif
+
     caglobals.ip.selectTimeout = CAGetPollingInterval(caglobals.ip.selectTimeout);
 
     res = CAIPStartListenServer();
@@ -1017,7 +1417,7 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
     }
 
     caglobals.ip.terminate = false;
-    res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
+    res = ca_thread_pool_add_dedicated_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread_pool_add_task failed");
@@ -1031,6 +1431,10 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
 
 void CAIPStopServer(void)
 {
+    // The send thread has stopped, hand what it queued to the kernel before the
+    // sockets are closed.
+    CAIPFlushSendData();
+
     caglobals.ip.terminate = true;
 
 #if !defined(WSA_WAIT_EVENT_0)
@@ -1343,8 +1747,10 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
 #endif
 #if !defined(_WIN32)
     ssize_t len = sendto(fd, data, dlen, 0, (struct sockaddr *)&sock, socklen);
+    oc_atomic_increment(&g_sendSyscalls);
     if (OC_SOCKET_ERROR == len)
     {
+        oc_atomic_increment(&g_sendFailures);
          // If logging is not defined/enabled.
         if (g_ipErrorHandler)
         {
@@ -1356,6 +1762,7 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
     }
     else
     {
+        oc_atomic_increment(&g_sentMessages);
         OIC_LOG_V(INFO, TAG, "%s%s %s sendTo is successful: %zd bytes", secure, cast, fam, len);
         CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
                            len, true, NULL);
@@ -1367,11 +1774,13 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
     do {
         int dataToSend = ((dlen - sent) > INT_MAX) ? INT_MAX : (int)(dlen - sent);
         len = sendto(fd, ((char*)data) + sent, dataToSend, 0, (struct sockaddr *)&sock, socklen);
+        oc_atomic_increment(&g_sendSyscalls);
         if (OC_SOCKET_ERROR == len)
         {
             err = WSAGetLastError();
             if ((WSAEWOULDBLOCK != err) && (WSAENOBUFS != err))
             {
+                oc_atomic_increment(&g_sendFailures);
                  // If logging is not defined/enabled.
                 if (g_ipErrorHandler)
                 {
@@ -1394,6 +1803,7 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
             }
             else
             {
+                oc_atomic_increment(&g_sentMessages);
                 OIC_LOG_V(INFO, TAG, "%s%s %s sendTo is successful: %ld bytes",
                                      secure, cast, fam, len);
             }
@@ -1497,6 +1907,19 @@ static void sendMulticastData4(const u_arraylist_t *iflist,
     }
 }
 
+static CASocketFd_t CAGetUnicastSocket(bool ipv6, bool isSecure)
+{
+#ifdef __WITH_DTLS__
+    if (isSecure)
+    {
+        return ipv6 ? caglobals.ip.u6s.fd : caglobals.ip.u4s.fd;
+    }
+#else
+    (void)isSecure;
+#endif
+    return ipv6 ? caglobals.ip.u6.fd : caglobals.ip.u4.fd;
+}
+
 void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
                   bool isMulticast)
 {
@@ -1534,26 +1957,299 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
             endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
         }
 
-        CASocketFd_t fd;
         if (caglobals.ip.ipv6enabled && (endpoint->flags & CA_IPV6))
         {
-            fd = isSecure ? caglobals.ip.u6s.fd : caglobals.ip.u6.fd;
-#ifndef __WITH_DTLS__
-            fd = caglobals.ip.u6.fd;
-#endif
-            sendData(fd, endpoint, data, datalen, "unicast", "ipv6");
+            sendData(CAGetUnicastSocket(true, isSecure), endpoint, data, datalen,
+                     "unicast", "ipv6");
         }
         if (caglobals.ip.ipv4enabled && (endpoint->flags & CA_IPV4))
         {
-            fd = isSecure ? caglobals.ip.u4s.fd : caglobals.ip.u4.fd;
-#ifndef __WITH_DTLS__
-            fd = caglobals.ip.u4.fd;
-#endif
-            sendData(fd, endpoint, data, datalen, "unicast", "ipv4");
+            sendData(CAGetUnicastSocket(false, isSecure), endpoint, data, datalen,
+                     "unicast", "ipv4");
         }
     }
 }
 
+#if defined(CA_IP_SENDMMSG)
+static void CAFlushSendBatch(CAIPSendBatch_t *batch)
+{
+    size_t sent = 0;
+    while (sent < batch->count)
+    {
+        int ret = sendmmsg(batch->fd, &batch->msgs[sent], batch->count - sent, 0);
+        oc_atomic_increment(&g_sendSyscalls);
+        if (OC_SOCKET_ERROR == ret)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            // The first datagram of the remainder failed; report it and go on.
+            CAIPSendSlot_t *slot = &batch->slots[sent];
+            oc_atomic_increment(&g_sendFailures);
+            if (g_ipErrorHandler)
+            {
+                g_ipErrorHandler(&slot->endpoint, slot->iov.iov_base, slot->iov.iov_len,
+                                 CA_SEND_FAILED);
+            }
+            OIC_LOG_V(ERROR, TAG, "sendmmsg failed: %s", strerror(errno));
+            CALogSendStateInfo(slot->endpoint.adapter, slot->endpoint.addr, slot->endpoint.port,
+                               -1, false, strerror(errno));
+            sent++;
+            continue;
+        }
+
+        for (int i = 0; i < ret; i++)
+        {
+            CAIPSendSlot_t *slot = &batch->slots[sent + i];
+            CALogSendStateInfo(slot->endpoint.adapter, slot->endpoint.addr, slot->endpoint.port,
+                               batch->msgs[sent + i].msg_len, true, NULL);
+        }
+        oc_atomic_add(&g_sentMessages, ret);
+        OIC_LOG_V(DEBUG, TAG, "sendmmsg sent %d of %" PRIuPTR " datagrams", ret,
+                  batch->count - sent);
+        sent += ret;
+    }
+
+    batch->count = 0;
+    batch->used = 0;
+}
+
+/**
+ * Reserve room for a payload of dlen bytes on fd, flushing the batch first
+ * if it belongs to another socket or is full.
+ *
+ * @return pointer to the payload copy, or NULL if it cannot be batched.
+ */
+static uint8_t *CAReserveSendBatch(CAIPSendBatch_t *batch, CASocketFd_t fd,
+                                   const void *data, size_t dlen, size_t copies)
+{
+    if (copies > SEND_BATCH_SIZE || dlen > SEND_BATCH_BUF_LEN)
+    {
+        return NULL;
+    }
+
+    if (batch->count && (batch->fd != fd ||
+                         batch->count + copies > SEND_BATCH_SIZE ||
+                         batch->used + dlen > SEND_BATCH_BUF_LEN))
+    {
+        CAFlushSendBatch(batch);
+    }
+
+    batch->fd = fd;
+    uint8_t *payload = batch->payload + batch->used;
+    memcpy(payload, data, dlen);
+    batch->used += dlen;
+    return payload;
+}
+
+/**
+ * Add one datagram to the batch. ifindex selects the outgoing interface
+ * through pktinfo, or 0 to let routing decide.
+ */
+static void CAAddToSendBatch(CAIPSendBatch_t *batch, const CAEndpoint_t *endpoint,
+                             uint8_t *payload, size_t dlen, uint32_t ifindex)
+{
+    CAIPSendSlot_t *slot = &batch->slots[batch->count];
+    struct msghdr *msg = &batch->msgs[batch->count].msg_hdr;
+
+    slot->endpoint = *endpoint;
+    memset(&slot->dest, 0, sizeof (slot->dest));
+    CAConvertNameToAddr(endpoint->addr, endpoint->port, &slot->dest);
+    slot->iov.iov_base = payload;
+    slot->iov.iov_len = dlen;
+
+    memset(msg, 0, sizeof (*msg));
+    msg->msg_name = &slot->dest;
+    msg->msg_namelen = (slot->dest.ss_family == AF_INET6) ?
+                       sizeof (struct sockaddr_in6) : sizeof (struct sockaddr_in);
+    msg->msg_iov = &slot->iov;
+    msg->msg_iovlen = 1;
+
+    if (ifindex)
+    {
+        memset(&slot->cmsg, 0, sizeof (slot->cmsg));
+        msg->msg_control = &slot->cmsg;
+        struct cmsghdr *cmp = &slot->cmsg.cmsg;
+        if (slot->dest.ss_family == AF_INET6)
+        {
+            msg->msg_controllen = CMSG_SPACE(sizeof (struct in6_pktinfo));
+            cmp->cmsg_level = IPPROTO_IPV6;
+            cmp->cmsg_type = IPV6_PKTINFO;
+            cmp->cmsg_len = CMSG_LEN(sizeof (struct in6_pktinfo));
+            ((struct in6_pktinfo *)CMSG_DATA(cmp))->ipi6_ifindex = ifindex;
+        }
+        else
+        {
+            msg->msg_controllen = CMSG_SPACE(sizeof (struct in_pktinfo));
+            cmp->cmsg_level = IPPROTO_IP;
+            cmp->cmsg_type = IP_PKTINFO;
+            cmp->cmsg_len = CMSG_LEN(sizeof (struct in_pktinfo));
+            ((struct in_pktinfo *)CMSG_DATA(cmp))->ipi_ifindex = ifindex;
+        }
+    }
+
+    batch->count++;
+}
+
+static size_t CACountMulticastInterfaces(const u_arraylist_t *iflist, int family)
+{
+    size_t count = 0;
+    size_t len = u_arraylist_length(iflist);
+    for (size_t i = 0; i < len; i++)
+    {
+        CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+        if (ifitem && ifitem->family == family &&
+            (ifitem->flags & IFF_UP_RUNNING_FLAGS) == IFF_UP_RUNNING_FLAGS)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void CAQueueMulticastData(CAIPSendBatch_t *batch, const u_arraylist_t *iflist,
+                                 int family, CASocketFd_t fd, CAEndpoint_t *endpoint,
+                                 const void *data, size_t datalen)
+{
+    size_t copies = CACountMulticastInterfaces(iflist, family);
+    if (!copies)
+    {
+        return;
+    }
+
+    uint8_t *payload = CAReserveSendBatch(batch, fd, data, datalen, copies);
+    if (!payload)
+    {
+        if (AF_INET6 == family)
+        {
+            sendMulticastData6(iflist, endpoint, data, datalen);
+        }
+        else
+        {
+            sendMulticastData4(iflist, endpoint, data, datalen);
+        }
+        return;
+    }
+
+    size_t len = u_arraylist_length(iflist);
+    for (size_t i = 0; i < len; i++)
+    {
+        CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+        if (ifitem && ifitem->family == family &&
+            (ifitem->flags & IFF_UP_RUNNING_FLAGS) == IFF_UP_RUNNING_FLAGS)
+        {
+            CAAddToSendBatch(batch, endpoint, payload, datalen, ifitem->index);
+        }
+    }
+}
+
+static void CAQueueUnicastData(CAIPSendBatch_t *batch, CASocketFd_t fd,
+                               const CAEndpoint_t *endpoint,
+                               const void *data, size_t datalen,
+                               const char *fam)
+{
+    uint8_t *payload = CAReserveSendBatch(batch, fd, data, datalen, 1);
+    if (!payload)
+    {
+        sendData(fd, endpoint, data, datalen, "unicast", fam);
+        return;
+    }
+    CAAddToSendBatch(batch, endpoint, payload, datalen, 0);
+}
+#endif // CA_IP_SENDMMSG
+
+void CAIPQueueSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
+                       bool isMulticast)
+{
+#if defined(CA_IP_SENDMMSG)
+    VERIFY_NON_NULL_VOID(endpoint, TAG, "endpoint is NULL");
+    VERIFY_NON_NULL_VOID(data, TAG, "data is NULL");
+
+    bool isSecure = (endpoint->flags & CA_SECURE) != 0;
+
+    if (isMulticast)
+    {
+        endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
+
+        u_arraylist_t *iflist = CAIPGetInterfaceInformation(0);
+        if (!iflist)
+        {
+            OIC_LOG_V(ERROR, TAG, "get interface info failed: %s", strerror(errno));
+            return;
+        }
+
+        if ((endpoint->flags & CA_IPV6) && caglobals.ip.ipv6enabled)
+        {
+            int scope = endpoint->flags & CA_SCOPE_MASK;
+            char *ipv6mcname = ipv6mcnames[scope];
+            if (ipv6mcname)
+            {
+                OICStrcpy(endpoint->addr, sizeof(endpoint->addr), ipv6mcname);
+                CAQueueMulticastData(&g_sendBatch6, iflist, AF_INET6, caglobals.ip.u6.fd,
+                                     endpoint, data, datalen);
+            }
+            else
+            {
+                OIC_LOG_V(INFO, TAG, "IPv6 multicast scope invalid: %d", scope);
+            }
+        }
+        if ((endpoint->flags & CA_IPV4) && caglobals.ip.ipv4enabled)
+        {
+            OICStrcpy(endpoint->addr, sizeof(endpoint->addr), IPv4_MULTICAST);
+            CAQueueMulticastData(&g_sendBatch4, iflist, AF_INET, caglobals.ip.u4.fd,
+                                 endpoint, data, datalen);
+        }
+
+        u_arraylist_destroy(iflist);
+    }
+    else
+    {
+        if (!endpoint->port)    // unicast discovery
+        {
+            endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
+        }
+
+        if (caglobals.ip.ipv6enabled && (endpoint->flags & CA_IPV6))
+        {
+            CAQueueUnicastData(&g_sendBatch6, CAGetUnicastSocket(true, isSecure), endpoint,
+                               data, datalen, "ipv6");
+        }
+        if (caglobals.ip.ipv4enabled && (endpoint->flags & CA_IPV4))
+        {
+            CAQueueUnicastData(&g_sendBatch4, CAGetUnicastSocket(false, isSecure), endpoint,
+                               data, datalen, "ipv4");
+        }
+    }
+#else
+    CAIPSendData(endpoint, data, datalen, isMulticast);
+#endif
+}
+
+void CAIPFlushSendData(void)
+{
+#if defined(CA_IP_SENDMMSG)
+    if (g_sendBatch6.count)
+    {
+        CAFlushSendBatch(&g_sendBatch6);
+    }
+    if (g_sendBatch4.count)
+    {
+        CAFlushSendBatch(&g_sendBatch4);
+    }
+#endif
+}
+
+void CAIPGetSendStatistics(CAIPSendStatistics_t *stats)
+{
+    VERIFY_NON_NULL_VOID(stats, TAG, "stats is NULL");
+
+    stats->messages = (uint32_t)oc_atomic_add(&g_sentMessages, 0);
+    stats->syscalls = (uint32_t)oc_atomic_add(&g_sendSyscalls, 0);
+    stats->failures = (uint32_t)oc_atomic_add(&g_sendFailures, 0);
+}
+
 CAResult_t CAGetIPInterfaceInformation(CAEndpoint_t **info, size_t *size)
 {
     VERIFY_NON_NULL(info, TAG, "info is NULL");
@@ -63,7 +63,13 @@ typedef struct
     bool encryptedData;
 } CATCPData;
 
+/**
+ * Length of the queue of pending connections of the accept sockets. Raise it
+ * for servers that many clients connect to at once.
+ */
+#ifndef CA_TCP_LISTEN_BACKLOG
 #define CA_TCP_LISTEN_BACKLOG  3
+#endif
 
 #define CA_TCP_SELECT_TIMEOUT 10
 
@@ -170,8 +176,15 @@ void CATCPPacketReceivedCB(const CASecureEndpoint_t *sep, const void *data,
 
     OIC_LOG_V(DEBUG, TAG, "Address: %s, port:%d", sep->endpoint.addr, sep->endpoint.port);
 
-    unsigned char *buffer = (unsigned char*)data;
-    size_t bufferLen = dataLength;
+    // raw TCP is split into messages by the server already
+    if (!(sep->endpoint.flags & CA_SECURE))
+    {
+        if (g_networkPacketCallback)
+        {
+            g_networkPacketCallback(sep, data, dataLength);
+        }
+        return;
+    }
 
     //get remote device information from file descriptor.
     oc_refcounter ref = CAGetTCPSessionInfoRefCountedFromEndpoint(&sep->endpoint);
@@ -188,32 +201,28 @@ void CATCPPacketReceivedCB(const CASecureEndpoint_t *sep, const void *data,
         return;
     }
 
-    //totalLen filled only when header fully read and parsed
-    while (0 != bufferLen)
+    CAResult_t res = CAAppendReceivedData(svritem, (const unsigned char *) data, dataLength);
+    if (CA_STATUS_OK != res)
     {
-        CAResult_t res = CAConstructCoAP(svritem, &buffer, &bufferLen);
-        if (CA_STATUS_OK != res)
-        {
-            OIC_LOG_V(ERROR, TAG, "CAConstructCoAP return error : %d", res);
-            oc_refcounter_dec(ref);
-            return;
-        }
+        OIC_LOG_V(ERROR, TAG, "CAAppendReceivedData return error : %d", res);
+        oc_refcounter_dec(ref);
+        return;
+    }
 
-        //when successfully read all required data - pass them to upper layer.
-        if (svritem->len == svritem->totalLen)
-        {
-            if (g_networkPacketCallback)
-            {
-                g_networkPacketCallback(sep, svritem->data, svritem->totalLen);
-            }
-            CACleanData(svritem);
-        }
-        else
+    //pass each complete message to upper layer.
+    const unsigned char *frame = NULL;
+    size_t frameLength = 0;
+    while (CA_STATUS_OK == (res = CAGetNextCoAPFrame(svritem, &frame, &frameLength)) && frame)
+    {
+        if (g_networkPacketCallback)
         {
-            OIC_LOG_V(DEBUG, TAG, "%" PRIuPTR " bytes required for complete CoAP",
-                                svritem->totalLen - svritem->len);
+            g_networkPacketCallback(sep, frame, frameLength);
         }
     }
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG_V(ERROR, TAG, "CAGetNextCoAPFrame return error : %d", res);
+    }
     oc_refcounter_dec(ref);
 }
 
@@ -306,6 +315,9 @@ static void CAInitializeTCPGlobals(void)
 
     caglobals.tcp.selectTimeout = CA_TCP_SELECT_TIMEOUT;
     caglobals.tcp.listenBacklog = CA_TCP_LISTEN_BACKLOG;
+#if defined(HAVE_SYS_EPOLL_H)
+    caglobals.tcp.epollFd = -1;
+#endif
 
     CATransportFlags_t flags = 0;
     if (caglobals.client)
@@ -36,6 +36,9 @@
 #ifdef HAVE_SYS_POLL_H
 #include <sys/poll.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #include <stdio.h>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -52,6 +55,7 @@
 #endif
 #include <errno.h>
 #include <assert.h>
+#include <limits.h>
 
 #ifdef HAVE_NETDB_H
 #include <netdb.h>
@@ -90,6 +94,51 @@
  */
 #define TLS_HEADER_SIZE 5
 
+/**
+ * Initial size of the receive ring of a session. Must be a power of two.
+ * The ring grows to fit the largest message received on the session.
+ */
+#ifndef CA_TCP_RECV_BUFFER_SIZE
+#define CA_TCP_RECV_BUFFER_SIZE 4096
+#endif
+
+/**
+ * Seconds to wait for an outgoing connection to be established.
+ */
+#ifndef CA_TCP_CONNECT_TIMEOUT
+#define CA_TCP_CONNECT_TIMEOUT 30
+#endif
+
+#if defined(HAVE_SYS_EPOLL_H)
+/**
+ * Maximum number of ready events fetched by a single epoll_wait()
+ */
+#define EPOLL_MAX_EVENTS 64
+
+/**
+ * Initial number of buckets of the session index by socket. Must be a power of two.
+ */
+#define CA_TCP_FD_INDEX_INITIAL_SIZE 64
+
+/**
+ * Entry of the session index by socket.
+ */
+typedef struct CATCPFdEntry
+{
+    CASocketFd_t fd;                /**< socket of the session */
+    oc_refcounter ref;              /**< session, owned by the session list */
+    struct CATCPFdEntry *next;      /**< next entry in the same bucket */
+} CATCPFdEntry_t;
+
+/**
+ * Connected sessions by socket, so a ready socket is dispatched without
+ * walking the session list. Protected by g_mutexObjectList.
+ */
+static CATCPFdEntry_t **g_fdIndex = NULL;
+static size_t g_fdIndexSize = 0;
+static size_t g_fdIndexCount = 0;
+#endif
+
 /**
  * Mutex to synchronize device object list.
  */
@@ -127,6 +176,10 @@ static void CATCPDestroyCond(void);
 static CASocketFd_t CACreateAcceptSocket(int family, CASocket_t *sock);
 static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock);
 static void CAFindReadyMessage(u_arraylist_t* sessionList);
+#if defined(HAVE_SYS_EPOLL_H)
+static void CAInitializeEpoll(void);
+static void CAEpollFindReadyMessage(void);
+#endif
 #if !defined(WSA_WAIT_EVENT_0)
 static void CASelectReturned(u_arraylist_t* sessionList, fd_set *readFds);
 #else
@@ -221,6 +274,158 @@ static CATCPSessionInfo_t* session_list_get(u_arraylist_t* sessionList, size_t i
     return (CATCPSessionInfo_t*) oc_refcounter_get_data(ref);
 }
 
+#if defined(HAVE_SYS_EPOLL_H)
+static void CAEpollAdd(CASocketFd_t fd)
+{
+    if (-1 == caglobals.tcp.epollFd || OC_INVALID_SOCKET == fd)
+    {
+        return;
+    }
+
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+    if (-1 == epoll_ctl(caglobals.tcp.epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl add fd %d failed: %s", fd, strerror(errno));
+    }
+}
+
+static CAResult_t CAResizeFdIndex(size_t size)
+{
+    CATCPFdEntry_t **index = (CATCPFdEntry_t **) OICCalloc(size, sizeof (*index));
+    if (!index)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    for (size_t i = 0; i < g_fdIndexSize; i++)
+    {
+        CATCPFdEntry_t *entry = g_fdIndex[i];
+        while (entry)
+        {
+            CATCPFdEntry_t *next = entry->next;
+            size_t bucket = (size_t) entry->fd & (size - 1);
+            entry->next = index[bucket];
+            index[bucket] = entry;
+            entry = next;
+        }
+    }
+
+    OICFree(g_fdIndex);
+    g_fdIndex = index;
+    g_fdIndexSize = size;
+    return CA_STATUS_OK;
+}
+
+/**
+ * Index a connected session by its socket and start polling the socket.
+ * Called with g_mutexObjectList held.
+ */
+static void CAIndexSessionFd(CASocketFd_t fd, oc_refcounter ref)
+{
+    if (g_fdIndexCount >= g_fdIndexSize)
+    {
+        size_t size = g_fdIndexSize ? g_fdIndexSize * 2 : CA_TCP_FD_INDEX_INITIAL_SIZE;
+        // a crowded table still works, only an absent one doesn't
+        if (CA_STATUS_OK != CAResizeFdIndex(size) && !g_fdIndex)
+        {
+            return;
+        }
+    }
+
+    CATCPFdEntry_t *entry = (CATCPFdEntry_t *) OICMalloc(sizeof (*entry));
+    if (!entry)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return;
+    }
+    size_t bucket = (size_t) fd & (g_fdIndexSize - 1);
+    entry->fd = fd;
+    entry->ref = ref;
+    entry->next = g_fdIndex[bucket];
+    g_fdIndex[bucket] = entry;
+    g_fdIndexCount++;
+
+    CAEpollAdd(fd);
+}
+
+/**
+ * Stop polling the socket of a session removed from the session list.
+ * Called with g_mutexObjectList held.
+ */
+static void CAUnindexSessionFd(CASocketFd_t fd, oc_refcounter ref)
+{
+    if (!g_fdIndex || OC_INVALID_SOCKET == fd)
+    {
+        return;
+    }
+
+    size_t bucket = (size_t) fd & (g_fdIndexSize - 1);
+    for (CATCPFdEntry_t **link = &g_fdIndex[bucket]; *link; link = &(*link)->next)
+    {
+        CATCPFdEntry_t *entry = *link;
+        if (entry->ref == ref)
+        {
+            *link = entry->next;
+            OICFree(entry);
+            g_fdIndexCount--;
+
+            // the socket stays open until the last user lets go of the session
+            if (-1 != caglobals.tcp.epollFd)
+            {
+                epoll_ctl(caglobals.tcp.epollFd, EPOLL_CTL_DEL, fd, NULL);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * Look up a connected session by its socket. Called with g_mutexObjectList held.
+ */
+static oc_refcounter CAFindSessionByFd(CASocketFd_t fd)
+{
+    if (!g_fdIndex)
+    {
+        return NULL;
+    }
+
+    for (CATCPFdEntry_t *entry = g_fdIndex[(size_t) fd & (g_fdIndexSize - 1)];
+         entry; entry = entry->next)
+    {
+        if (entry->fd == fd)
+        {
+            return entry->ref;
+        }
+    }
+    return NULL;
+}
+
+static void CAClearFdIndex(void)
+{
+    for (size_t i = 0; i < g_fdIndexSize; i++)
+    {
+        CATCPFdEntry_t *entry = g_fdIndex[i];
+        while (entry)
+        {
+            CATCPFdEntry_t *next = entry->next;
+            OICFree(entry);
+            entry = next;
+        }
+    }
+    OICFree(g_fdIndex);
+    g_fdIndex = NULL;
+    g_fdIndexSize = 0;
+    g_fdIndexCount = 0;
+}
+
+#define INDEX_SESSION_FD(FD, REF) CAIndexSessionFd(FD, REF)
+#define UNINDEX_SESSION_FD(FD, REF) CAUnindexSessionFd(FD, REF)
+#else
+#define INDEX_SESSION_FD(FD, REF)
+#define UNINDEX_SESSION_FD(FD, REF)
+#endif // HAVE_SYS_EPOLL_H
+
 static void CARemoveSession(CATCPSessionInfo_t *session)
 {
     oc_refcounter ref = NULL;
@@ -233,6 +438,7 @@ static void CARemoveSession(CATCPSessionInfo_t *session)
             //swap last element with current position and remove last element
             u_arraylist_swap(s_sessionList, i, length-1);
             ref = (oc_refcounter) u_arraylist_remove(s_sessionList, length-1);
+            UNINDEX_SESSION_FD(session->fd, ref);
             break;
         }
     }
@@ -251,6 +457,14 @@ static void CAReceiveHandler(void *data)
     u_arraylist_t* sessionList = u_arraylist_create();
     while (sessionList && !caglobals.tcp.terminate)
     {
+#if defined(HAVE_SYS_EPOLL_H)
+        if (-1 != caglobals.tcp.epollFd)
+        {
+            // ready sessions are looked up by socket, no snapshot of the list needed
+            CAEpollFindReadyMessage();
+            continue;
+        }
+#endif
         oc_mutex_lock(g_mutexObjectList);
         for (size_t i = 0; i < u_arraylist_length(s_sessionList); ++i)
         {
@@ -275,6 +489,103 @@ static void CAReceiveHandler(void *data)
     OIC_LOG(DEBUG, TAG, "OUT - CAReceiveHandler");
 }
 
+#if defined(HAVE_SYS_EPOLL_H)
+
+/**
+ * Create the epoll instance and register the accept sockets and the pipes.
+ * Sessions are registered when they are connected. If epoll is not usable,
+ * the receive thread falls back to select().
+ */
+static void CAInitializeEpoll(void)
+{
+    caglobals.tcp.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == caglobals.tcp.epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s (using select)", strerror(errno));
+        return;
+    }
+
+    CAEpollAdd(caglobals.tcp.ipv4.fd);
+    CAEpollAdd(caglobals.tcp.ipv4s.fd);
+    CAEpollAdd(caglobals.tcp.ipv6.fd);
+    CAEpollAdd(caglobals.tcp.ipv6s.fd);
+    CAEpollAdd(caglobals.tcp.shutdownFds[0]);
+    CAEpollAdd(caglobals.tcp.connectionFds[0]);
+}
+
+static void CAEpollFindReadyMessage(void)
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    int timeout = caglobals.tcp.selectTimeout == -1 ? -1 : caglobals.tcp.selectTimeout * 1000;
+
+    int ret = epoll_wait(caglobals.tcp.epollFd, events, EPOLL_MAX_EVENTS, timeout);
+
+    if (caglobals.tcp.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (0 > ret)
+    {
+        if (EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(errno));
+        }
+        return;
+    }
+
+    for (int i = 0; i < ret && !caglobals.tcp.terminate; i++)
+    {
+        CASocketFd_t fd = events[i].data.fd;
+
+        if (fd == caglobals.tcp.ipv4.fd)
+        {
+            CAAcceptConnection(CA_IPV4, &caglobals.tcp.ipv4);
+        }
+        else if (fd == caglobals.tcp.ipv4s.fd)
+        {
+            CAAcceptConnection(CA_IPV4 | CA_SECURE, &caglobals.tcp.ipv4s);
+        }
+        else if (fd == caglobals.tcp.ipv6.fd)
+        {
+            CAAcceptConnection(CA_IPV6, &caglobals.tcp.ipv6);
+        }
+        else if (fd == caglobals.tcp.ipv6s.fd)
+        {
+            CAAcceptConnection(CA_IPV6 | CA_SECURE, &caglobals.tcp.ipv6s);
+        }
+        else if (fd == caglobals.tcp.connectionFds[0])
+        {
+            // connected sessions are registered directly, only drain the pipe
+            char buf[MAX_ADDR_STR_SIZE_CA] = {0};
+            ssize_t len = read(caglobals.tcp.connectionFds[0], buf, sizeof (buf));
+            (void)len;
+        }
+        else if (fd != caglobals.tcp.shutdownFds[0])
+        {
+            oc_mutex_lock(g_mutexObjectList);
+            oc_refcounter ref = oc_refcounter_inc(CAFindSessionByFd(fd));
+            oc_mutex_unlock(g_mutexObjectList);
+
+            CATCPSessionInfo_t *session = (CATCPSessionInfo_t *) oc_refcounter_get_data(ref);
+            if (session && CA_STATUS_OK != CAReceiveMessage(session))
+            {
+                //disconnect session and clean-up data if any error occurs
+#ifdef __WITH_TLS__
+                if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
+                {
+                    OIC_LOG(ERROR, TAG, "Failed to close TLS session");
+                }
+#endif
+                CARemoveSession(session);
+            }
+            oc_refcounter_dec(ref);
+        }
+    }
+}
+#endif // HAVE_SYS_EPOLL_H
+
 #if !defined(WSA_WAIT_EVENT_0)
 
 static void CAFindReadyMessage(u_arraylist_t* sessionList)
@@ -631,7 +942,7 @@ static void CADtorTCPSession(CATCPSessionInfo_t *removedData)
             g_connectionCallback(&(removedData->sep.endpoint), false, removedData->isClient);
         }
     }
-    OICFree(removedData->data);
+    CACleanData(removedData);
     OICFree(removedData);
 
     OIC_LOG(DEBUG, TAG, "data is removed");
@@ -680,6 +991,7 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
 
         oc_mutex_lock(g_mutexObjectList);
         u_arraylist_add(s_sessionList, ref);
+        INDEX_SESSION_FD(sockfd, ref);
         oc_mutex_unlock(g_mutexObjectList);
 
         CHECKFD(sockfd);
@@ -701,128 +1013,203 @@ void CACleanData(CATCPSessionInfo_t *svritem)
 {
     if (svritem)
     {
-        OICFree(svritem->data);
-        svritem->data = NULL;
-        svritem->len = 0;
+        OICFree(svritem->recvBuffer);
+        svritem->recvBuffer = NULL;
+        svritem->recvCapacity = 0;
+        svritem->recvStart = 0;
+        svritem->recvLen = 0;
+        OICFree(svritem->frameBuffer);
+        svritem->frameBuffer = NULL;
+        svritem->frameCapacity = 0;
         svritem->tlsLen = 0;
-        svritem->totalLen = 0;
         svritem->protocol = UNKNOWN;
     }
 }
 
 /**
- * Construct CoAP header and payload from buffer
+ * Copy unparsed data out of the receive ring.
  *
- * @param[in] svritem - used socket, buffer, current received message length and protocol
- * @param[in,out]  data  - data buffer, this value is updated as data is copied to svritem
- * @param[in,out]  dataLength  - length of data, this value decreased as data is copied to svritem
- * @return             - CA_STATUS_OK or appropriate error code
+ * @param[in]  svritem - session
+ * @param[in]  offset  - position of the first byte to copy, from the first unparsed byte
+ * @param[out] dst     - destination buffer
+ * @param[in]  length  - number of bytes to copy
  */
-CAResult_t CAConstructCoAP(CATCPSessionInfo_t *svritem, unsigned char **data,
-                          size_t *dataLength)
+static void CACopyFromRecvBuffer(const CATCPSessionInfo_t *svritem, size_t offset,
+                                 unsigned char *dst, size_t length)
 {
-    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+    if (0 == length)
+    {
+        return;
+    }
 
-    if (NULL == svritem || NULL == data || NULL == dataLength)
+    size_t start = (svritem->recvStart + offset) & (svritem->recvCapacity - 1);
+    size_t first = svritem->recvCapacity - start;
+    if (first > length)
     {
-        OIC_LOG(ERROR, TAG, "Invalid input parameter(NULL)");
-        return CA_STATUS_INVALID_PARAM;
+        first = length;
     }
+    memcpy(dst, svritem->recvBuffer + start, first);
+    memcpy(dst + first, svritem->recvBuffer, length - first);
+}
 
-    unsigned char *inBuffer = *data;
-    size_t inLen = *dataLength;
-    OIC_LOG_V(DEBUG, TAG, "before-datalength : %" PRIuPTR, *dataLength);
+/**
+ * Make room in the receive ring for more data. A grown ring is unwrapped.
+ *
+ * @param[in,out] svritem - session
+ * @param[in]     length  - number of bytes that must fit after the unparsed data
+ * @return             - CA_STATUS_OK or appropriate error code
+ */
+static CAResult_t CAReserveRecvBuffer(CATCPSessionInfo_t *svritem, size_t length)
+{
+    if (length > SIZE_MAX - svritem->recvLen)
+    {
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    size_t needed = svritem->recvLen + length;
+    if (needed <= svritem->recvCapacity)
+    {
+        return CA_STATUS_OK;
+    }
 
-    if (NULL == svritem->data && inLen > 0)
+    size_t capacity = svritem->recvCapacity ? svritem->recvCapacity : CA_TCP_RECV_BUFFER_SIZE;
+    while (capacity < needed)
     {
-        // allocate memory for message header (CoAP header size because it is bigger)
-        svritem->data = (unsigned char *) OICCalloc(1, COAP_MAX_HEADER_SIZE);
-        if (NULL == svritem->data)
+        if (capacity > SIZE_MAX / 2)
         {
-            OIC_LOG(ERROR, TAG, "OICCalloc - out of memory");
             return CA_MEMORY_ALLOC_FAILED;
         }
+        capacity *= 2;
+    }
 
-        // copy 1 byte to parse coap header length
-        memcpy(svritem->data, inBuffer, 1);
-        svritem->len = 1;
-        inBuffer++;
-        inLen--;
+    unsigned char *buffer = (unsigned char *) OICMalloc(capacity);
+    if (NULL == buffer)
+    {
+        OIC_LOG(ERROR, TAG, "OICMalloc - out of memory");
+        return CA_MEMORY_ALLOC_FAILED;
     }
+    CACopyFromRecvBuffer(svritem, 0, buffer, svritem->recvLen);
+    OICFree(svritem->recvBuffer);
+    svritem->recvBuffer = buffer;
+    svritem->recvCapacity = capacity;
+    svritem->recvStart = 0;
 
-    //if not enough data received - read them on next CAFillHeader() call
-    if (0 == inLen)
+    OIC_LOG_V(DEBUG, TAG, "receive buffer grown to %" PRIuPTR " bytes", capacity);
+    return CA_STATUS_OK;
+}
+
+/**
+ * Get the contiguous free space at the end of the unparsed data, so data can
+ * be received into the ring directly.
+ *
+ * @param[in,out] svritem - session
+ * @param[out]    length  - size of the free space
+ * @return             - free space, or NULL if no memory
+ */
+static unsigned char *CAGetRecvSpace(CATCPSessionInfo_t *svritem, size_t *length)
+{
+    if (CA_STATUS_OK != CAReserveRecvBuffer(svritem, 1))
     {
-        return CA_STATUS_OK;
+        return NULL;
     }
 
-    //if enough data received - parse header
-    svritem->protocol = COAP;
+    size_t end = (svritem->recvStart + svritem->recvLen) & (svritem->recvCapacity - 1);
+    size_t space = svritem->recvCapacity - svritem->recvLen;
+    if (space > svritem->recvCapacity - end)
+    {
+        space = svritem->recvCapacity - end;
+    }
+    *length = space;
+    return svritem->recvBuffer + end;
+}
 
-    //seems CoAP data received. read full coap header.
-    coap_transport_t transport = coap_get_tcp_header_type_from_initbyte(svritem->data[0] >> 4);
-    size_t headerLen = coap_get_tcp_header_length_for_transport(transport);
-    size_t copyLen = 0;
+CAResult_t CAAppendReceivedData(CATCPSessionInfo_t *svritem, const unsigned char *data,
+                                size_t dataLength)
+{
+    VERIFY_NON_NULL(svritem, TAG, "svritem is NULL");
+    VERIFY_NON_NULL(data, TAG, "data is NULL");
 
-    // HEADER
-    if (svritem->len < headerLen)
+    CAResult_t res = CAReserveRecvBuffer(svritem, dataLength);
+    if (CA_STATUS_OK != res)
     {
-        copyLen = headerLen - svritem->len;
-        if (inLen < copyLen)
+        return res;
+    }
+
+    while (dataLength > 0)
+    {
+        size_t space = 0;
+        unsigned char *dst = CAGetRecvSpace(svritem, &space);
+        if (space > dataLength)
         {
-            copyLen = inLen;
+            space = dataLength;
         }
+        memcpy(dst, data, space);
+        svritem->recvLen += space;
+        data += space;
+        dataLength -= space;
+    }
+    return CA_STATUS_OK;
+}
 
-        //read required bytes to have full CoAP header
-        memcpy(svritem->data + svritem->len, inBuffer, copyLen);
-        svritem->len += copyLen;
-        inBuffer += copyLen;
-        inLen -= copyLen;
+CAResult_t CAGetNextCoAPFrame(CATCPSessionInfo_t *svritem, const unsigned char **frame,
+                              size_t *frameLength)
+{
+    VERIFY_NON_NULL(svritem, TAG, "svritem is NULL");
+    VERIFY_NON_NULL(frame, TAG, "frame is NULL");
+    VERIFY_NON_NULL(frameLength, TAG, "frameLength is NULL");
 
-        //if not enough data received - read them on next CAFillHeader() call
-        if (svritem->len < headerLen)
-        {
-            *data = inBuffer;
-            *dataLength = inLen;
-            OIC_LOG(DEBUG, TAG, "CoAP header received partially. Wait for rest header data");
-            return CA_STATUS_OK;
-        }
+    *frame = NULL;
+    *frameLength = 0;
+    if (0 == svritem->recvLen)
+    {
+        return CA_STATUS_OK;
+    }
 
-        //calculate CoAP message length
-        svritem->totalLen = CAGetTotalLengthFromHeader(svritem->data);
+    // the header tells the message length, so it has to be complete first
+    unsigned char header[COAP_MAX_HEADER_SIZE];
+    CACopyFromRecvBuffer(svritem, 0, header, 1);
+    coap_transport_t transport = coap_get_tcp_header_type_from_initbyte(header[0] >> 4);
+    size_t headerLen = coap_get_tcp_header_length_for_transport(transport);
+    if (svritem->recvLen < headerLen)
+    {
+        OIC_LOG(DEBUG, TAG, "CoAP header received partially. Wait for rest header data");
+        return CA_STATUS_OK;
+    }
+    CACopyFromRecvBuffer(svritem, 0, header, headerLen);
+    size_t totalLen = CAGetTotalLengthFromHeader(header);
 
-        // allocate required memory
-        unsigned char *buffer = OICRealloc(svritem->data, svritem->totalLen);
-        if (NULL == buffer)
-        {
-            OIC_LOG(ERROR, TAG, "OICRealloc - out of memory");
-            return CA_MEMORY_ALLOC_FAILED;
-        }
-        svritem->data = buffer;
+    if (svritem->recvLen < totalLen)
+    {
+        OIC_LOG_V(DEBUG, TAG, "%" PRIuPTR " bytes required for complete CoAP",
+                  totalLen - svritem->recvLen);
+        // make the whole message fit now, so it isn't moved again while it is received
+        return CAReserveRecvBuffer(svritem, totalLen - svritem->recvLen);
     }
 
-    // PAYLOAD
-    if (inLen > 0)
+    if (svritem->recvStart + totalLen <= svritem->recvCapacity)
     {
-        // read required bytes to have full CoAP payload
-        copyLen = svritem->totalLen - svritem->len;
-        if (inLen < copyLen)
+        *frame = svritem->recvBuffer + svritem->recvStart;
+    }
+    else
+    {
+        if (svritem->frameCapacity < totalLen)
         {
-            copyLen = inLen;
+            unsigned char *buffer = (unsigned char *) OICRealloc(svritem->frameBuffer, totalLen);
+            if (NULL == buffer)
+            {
+                OIC_LOG(ERROR, TAG, "OICRealloc - out of memory");
+                return CA_MEMORY_ALLOC_FAILED;
+            }
+            svritem->frameBuffer = buffer;
+            svritem->frameCapacity = totalLen;
         }
-
-        //read required bytes to have full CoAP header
-        memcpy(svritem->data + svritem->len, inBuffer, copyLen);
-        svritem->len += copyLen;
-        inBuffer += copyLen;
-        inLen -= copyLen;
+        CACopyFromRecvBuffer(svritem, 0, svritem->frameBuffer, totalLen);
+        *frame = svritem->frameBuffer;
     }
+    *frameLength = totalLen;
 
-    *data = inBuffer;
-    *dataLength = inLen;
-
-    OIC_LOG_V(DEBUG, TAG, "after-datalength : %" PRIuPTR, *dataLength);
-    OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+    svritem->recvLen -= totalLen;
+    svritem->recvStart = svritem->recvLen ?
+                         (svritem->recvStart + totalLen) & (svritem->recvCapacity - 1) : 0;
     return CA_STATUS_OK;
 }
 
@@ -896,8 +1283,19 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
     {
         svritem->protocol = COAP;
 
-        // svritem->tlsdata can also be used as receiving buffer in case of raw tcp
-        len = recv(svritem->fd, (char*)svritem->tlsdata, sizeof(svritem->tlsdata), 0);
+        // receive straight into the ring, messages are parsed there in place
+        size_t space = 0;
+        unsigned char *buffer = CAGetRecvSpace(svritem, &space);
+        if (NULL == buffer)
+        {
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+        if (space > INT_MAX)
+        {
+            space = INT_MAX;
+        }
+
+        len = recv(svritem->fd, (char*)buffer, (int)space, 0);
         if (len < 0)
         {
             OIC_LOG_V(ERROR, TAG, "recv failed %s", strerror(errno));
@@ -911,10 +1309,18 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
         else
         {
             OIC_LOG_V(DEBUG, TAG, "recv() : %d bytes", len);
-            //when successfully read data - pass them to callback.
-            if (g_packetReceivedCallback)
+            svritem->recvLen += (size_t)len;
+
+            //pass each complete message to callback.
+            const unsigned char *frame = NULL;
+            size_t frameLength = 0;
+            while (CA_STATUS_OK == (res = CAGetNextCoAPFrame(svritem, &frame, &frameLength))
+                   && frame)
             {
-                g_packetReceivedCallback(&svritem->sep, svritem->tlsdata, len);
+                if (g_packetReceivedCallback)
+                {
+                    g_packetReceivedCallback(&svritem->sep, frame, frameLength);
+                }
             }
         }
     }
@@ -954,6 +1360,73 @@ static void CAWakeUpForReadFdsUpdate()
 }
 #endif
 
+#if !defined(WSA_WAIT_EVENT_0)
+/**
+ * Connect without blocking for longer than CA_TCP_CONNECT_TIMEOUT.
+ *
+ * @param[in] fd       socket to connect
+ * @param[in] sa       address to connect to
+ * @param[in] socklen  length of the address
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int CATCPConnect(CASocketFd_t fd, const struct sockaddr *sa, socklen_t socklen)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (-1 == flags || -1 == fcntl(fd, F_SETFL, flags | O_NONBLOCK))
+    {
+        return connect(fd, sa, socklen);
+    }
+
+    int ret = connect(fd, sa, socklen);
+    if (0 > ret && EINPROGRESS == errno)
+    {
+        struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+        do
+        {
+            ret = poll(&pfd, 1, CA_TCP_CONNECT_TIMEOUT * 1000);
+        } while (0 > ret && EINTR == errno);
+
+        if (0 == ret)
+        {
+            errno = ETIMEDOUT;
+            ret = -1;
+        }
+        else if (0 < ret)
+        {
+            int error = 0;
+            socklen_t len = sizeof (error);
+            if (0 > getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len))
+            {
+                ret = -1;
+            }
+            else if (error)
+            {
+                errno = error;
+                ret = -1;
+            }
+            else if (pfd.revents & (POLLERR | POLLHUP))
+            {
+                // shut down by CATCPCloseInProgressConnections
+                errno = ECONNABORTED;
+                ret = -1;
+            }
+            else
+            {
+                ret = 0;
+            }
+        }
+    }
+
+    // the session socket is used blocking from here on
+    int error = errno;
+    fcntl(fd, F_SETFL, flags);
+    errno = error;
+    return ret;
+}
+#else
+#define CATCPConnect(FD, SA, SOCKLEN) connect(FD, SA, SOCKLEN)
+#endif
+
 static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
 {
     VERIFY_NON_NULL(svritem, TAG, "svritem is NULL");
@@ -992,7 +1465,7 @@ static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
     }
 
     // #4. connect to remote server device.
-    if (connect(fd, (struct sockaddr *)&sa, socklen) < 0)
+    if (CATCPConnect(fd, (struct sockaddr *)&sa, socklen) < 0)
     {
         OIC_LOG_V(ERROR, TAG, "failed to connect socket, %s", strerror(errno));
         CALogSendStateInfo(svritem->sep.endpoint.adapter, svritem->sep.endpoint.addr,
@@ -1003,6 +1476,23 @@ static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
     OIC_LOG(DEBUG, TAG, "connect socket success");
     svritem->state = CONNECTED;
     CHECKFD(svritem->fd);
+#if defined(HAVE_SYS_EPOLL_H)
+    oc_mutex_lock(g_mutexObjectList);
+    oc_refcounter ref = NULL;
+    for (size_t i = 0; i < u_arraylist_length(s_sessionList) && !ref; ++i)
+    {
+        oc_refcounter tmp = (oc_refcounter) u_arraylist_get(s_sessionList, i);
+        if (oc_refcounter_get_data(tmp) == svritem)
+        {
+            ref = tmp;
+        }
+    }
+    if (ref)
+    {
+        CAIndexSessionFd(svritem->fd, ref);
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+#endif
 #if !defined(WSA_WAIT_EVENT_0)
     ssize_t len = CAWakeUpForReadFdsUpdate(svritem->sep.endpoint.addr);
     if (-1 == len)
@@ -1214,8 +1704,12 @@ CAResult_t CATCPStartServer(const ca_thread_pool_t threadPool)
     CHECKFD(caglobals.tcp.connectionFds[1]);
 #endif
 
+#if defined(HAVE_SYS_EPOLL_H)
+    CAInitializeEpoll();
+#endif
+
     caglobals.tcp.terminate = false;
-    res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
+    res = ca_thread_pool_add_dedicated_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread_pool_add_task failed");
@@ -1281,6 +1775,13 @@ void CATCPStopServer(void)
     close(caglobals.tcp.shutdownFds[0]);
     caglobals.tcp.shutdownFds[0] = OC_INVALID_SOCKET;
 #endif
+#if defined(HAVE_SYS_EPOLL_H)
+    if (-1 != caglobals.tcp.epollFd)
+    {
+        close(caglobals.tcp.epollFd);
+        caglobals.tcp.epollFd = -1;
+    }
+#endif
 
     // mutex unlock
     oc_mutex_unlock(g_mutexObjectList);
@@ -1577,11 +2078,15 @@ void CATCPDisconnectAll(void)
     oc_mutex_lock(g_mutexObjectList);
     u_arraylist_t* sessionList = s_sessionList;
     s_sessionList = NULL;
+#if defined(HAVE_SYS_EPOLL_H)
+    CAClearFdIndex();
+#endif
     oc_mutex_unlock(g_mutexObjectList);
     for (size_t i = 0; i < u_arraylist_length(sessionList); ++i)
     {
         oc_refcounter_dec((oc_refcounter)u_arraylist_get(sessionList, i));
     }
+    u_arraylist_free(&sessionList);
 
 #ifdef __WITH_TLS__
     CAcloseSslConnectionAll(CA_ADAPTER_TCP);
@@ -1667,6 +2172,7 @@ CAResult_t CASearchAndDeleteTCPSession(const CAEndpoint_t *endpoint)
         {
             u_arraylist_swap(s_sessionList, i, length-1);
             ref = (oc_refcounter)u_arraylist_remove(s_sessionList, length-1);
+            UNINDEX_SESSION_FD(s->fd, ref);
             break;
         }
     }
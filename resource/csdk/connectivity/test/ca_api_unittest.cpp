@@ -28,6 +28,9 @@
 #include "cafragmentation.h"
 #include "caleinterface.h"
 
+#include <chrono>
+#include <thread>
+
 #define CA_TRANSPORT_ADAPTER_SCOPE  1000
 #define CA_BLE_FIRST_SEGMENT_PAYLOAD_SIZE (((CA_DEFAULT_BLE_MTU_SIZE) - (CA_BLE_HEADER_SIZE)) \
                                            - (CA_BLE_LENGTH_HEADER_SIZE))
@@ -503,6 +506,64 @@ TEST_F(CATests, HandlerRequestResponseTest)
     EXPECT_EQ(CA_STATUS_OK, CAHandleRequestResponse());
 }
 
+// CAWaitForRequestResponse TC
+TEST_F(CATests, WaitForRequestResponseTimeoutTest)
+{
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(50, NULL));
+    EXPECT_LE(std::chrono::milliseconds(40), std::chrono::steady_clock::now() - start);
+}
+
+// CAWakeUpRequestResponse TC
+TEST_F(CATests, WakeUpRequestResponseTest)
+{
+    uint32_t wakeUps = 0;
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(1, &wakeUps));
+
+    // a wakeup the waiter has not seen yet ends its next wait
+    CAWakeUpRequestResponse();
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(0, &wakeUps));
+    EXPECT_GT(std::chrono::seconds(5), std::chrono::steady_clock::now() - start);
+
+    // and only that one
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(50, &wakeUps));
+    EXPECT_LE(std::chrono::milliseconds(40), std::chrono::steady_clock::now() - start);
+
+    std::thread waker([]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CAWakeUpRequestResponse();
+    });
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(0, &wakeUps));
+    EXPECT_GT(std::chrono::seconds(5), std::chrono::steady_clock::now() - start);
+    waker.join();
+}
+
+// CAWakeUpRequestResponse TC
+TEST_F(CATests, WakeUpRequestResponseWakesAllWaitersTest)
+{
+    uint32_t firstWakeUps = 0;
+    uint32_t secondWakeUps = 0;
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(1, &firstWakeUps));
+    secondWakeUps = firstWakeUps;
+
+    // one waiter must not consume the wakeup of the other
+    std::thread first([&firstWakeUps]()
+    {
+        EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(0, &firstWakeUps));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CAWakeUpRequestResponse();
+    first.join();
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CA_REQUEST_TIMEOUT, CAWaitForRequestResponse(0, &secondWakeUps));
+    EXPECT_GT(std::chrono::seconds(5), std::chrono::steady_clock::now() - start);
+}
+
 // CAGetNetworkInformation TC
 TEST_F(CATests, GetNetworkInformationTest)
 {
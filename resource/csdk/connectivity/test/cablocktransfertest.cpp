@@ -240,6 +240,157 @@ TEST_F(CABlockTransferTests, CAGetPayloadFromBlockDataListTest)
     free(requestData.payload);
 }
 
+TEST_F(CABlockTransferTests, CAUpdatePayloadDataReassemblesBlocks)
+{
+    CAEndpoint_t* tempRep = NULL;
+    CACreateEndpoint(CA_DEFAULT_FLAGS, CA_ADAPTER_IP, "127.0.0.1", 5683, &tempRep);
+
+    coap_pdu_t *pdu = NULL;
+    coap_list_t *options = NULL;
+    coap_transport_t transport = COAP_UDP;
+
+    CAToken_t tempToken = NULL;
+    CAGenerateToken(&tempToken, CA_MAX_TOKEN_LEN);
+
+    CAInfo_t requestData;
+    memset(&requestData, 0, sizeof(CAInfo_t));
+    requestData.token = tempToken;
+    requestData.tokenLength = CA_MAX_TOKEN_LEN;
+    requestData.type = CA_MSG_NONCONFIRM;
+
+    pdu = CAGeneratePDU(CA_GET, &requestData, tempRep, &options, &transport);
+
+    CAData_t *cadata = CACreateNewDataSet(pdu, tempRep);
+    EXPECT_TRUE(cadata != NULL);
+
+    CABlockData_t *currData = CACreateNewBlockData(cadata);
+    EXPECT_TRUE(currData != NULL);
+
+    if (currData)
+    {
+        uint8_t block[LARGE_PAYLOAD_LENGTH];
+        CARequestInfo_t requestInfo;
+        memset(&requestInfo, 0, sizeof(CARequestInfo_t));
+        requestInfo.info.payload = block;
+        requestInfo.info.payloadSize = sizeof(block);
+
+        CAData_t received;
+        memset(&received, 0, sizeof(CAData_t));
+        received.requestInfo = &requestInfo;
+        received.dataType = CA_REQUEST_DATA;
+
+        for (int i = 0; i < 5; i++)
+        {
+            memset(block, 'a' + i, sizeof(block));
+            EXPECT_EQ(CA_STATUS_OK, CAUpdatePayloadData(currData, &received,
+                                                        CA_OPTION1_REQUEST_BLOCK, false,
+                                                        COAP_OPTION_BLOCK1));
+        }
+
+        size_t fullPayloadLen = 0;
+        CAPayload_t payload = CAGetPayloadFromBlockDataList(currData->blockDataId,
+                                                            &fullPayloadLen);
+        ASSERT_TRUE(payload != NULL);
+        EXPECT_EQ(5u * LARGE_PAYLOAD_LENGTH, fullPayloadLen);
+        for (size_t i = 0; i < fullPayloadLen; i++)
+        {
+            EXPECT_EQ('a' + i / LARGE_PAYLOAD_LENGTH, payload[i]);
+        }
+
+        CARemoveBlockDataFromList(currData->blockDataId);
+    }
+
+    CADestroyDataSet(cadata);
+    coap_delete_list(options);
+    coap_delete_pdu(pdu);
+
+    CADestroyToken(tempToken);
+    CADestroyEndpoint(tempRep);
+}
+
+static size_t g_streamedLength = 0;
+
+static bool streamHandler(const CAEndpoint_t *endpoint, const CAToken_t token,
+                          uint8_t tokenLength, size_t offset, const uint8_t *data,
+                          size_t dataLength)
+{
+    (void) endpoint;
+    (void) token;
+    (void) tokenLength;
+    (void) data;
+    EXPECT_EQ(g_streamedLength, offset);
+    g_streamedLength += dataLength;
+    return true;
+}
+
+TEST_F(CABlockTransferTests, CAUpdatePayloadDataStreamsBlocks)
+{
+    CAEndpoint_t* tempRep = NULL;
+    CACreateEndpoint(CA_DEFAULT_FLAGS, CA_ADAPTER_IP, "127.0.0.1", 5683, &tempRep);
+
+    coap_pdu_t *pdu = NULL;
+    coap_list_t *options = NULL;
+    coap_transport_t transport = COAP_UDP;
+
+    CAToken_t tempToken = NULL;
+    CAGenerateToken(&tempToken, CA_MAX_TOKEN_LEN);
+
+    CAInfo_t requestData;
+    memset(&requestData, 0, sizeof(CAInfo_t));
+    requestData.token = tempToken;
+    requestData.tokenLength = CA_MAX_TOKEN_LEN;
+    requestData.type = CA_MSG_NONCONFIRM;
+
+    pdu = CAGeneratePDU(CA_GET, &requestData, tempRep, &options, &transport);
+
+    CAData_t *cadata = CACreateNewDataSet(pdu, tempRep);
+    EXPECT_TRUE(cadata != NULL);
+
+    CABlockData_t *currData = CACreateNewBlockData(cadata);
+    EXPECT_TRUE(currData != NULL);
+
+    g_streamedLength = 0;
+    CARegisterBlockWiseStreamHandler(streamHandler);
+
+    if (currData)
+    {
+        uint8_t block[LARGE_PAYLOAD_LENGTH] = { 0 };
+        CARequestInfo_t requestInfo;
+        memset(&requestInfo, 0, sizeof(CARequestInfo_t));
+        requestInfo.info.payload = block;
+        requestInfo.info.payloadSize = sizeof(block);
+
+        CAData_t received;
+        memset(&received, 0, sizeof(CAData_t));
+        received.requestInfo = &requestInfo;
+        received.dataType = CA_REQUEST_DATA;
+
+        for (int i = 0; i < 3; i++)
+        {
+            EXPECT_EQ(CA_STATUS_OK, CAUpdatePayloadData(currData, &received,
+                                                        CA_OPTION1_REQUEST_BLOCK, false,
+                                                        COAP_OPTION_BLOCK1));
+        }
+        EXPECT_EQ(3u * LARGE_PAYLOAD_LENGTH, g_streamedLength);
+
+        // the blocks went to the handler and were not kept
+        size_t fullPayloadLen = 0;
+        EXPECT_EQ(NULL, CAGetPayloadFromBlockDataList(currData->blockDataId, &fullPayloadLen));
+        EXPECT_EQ(0u, fullPayloadLen);
+
+        CARemoveBlockDataFromList(currData->blockDataId);
+    }
+
+    CARegisterBlockWiseStreamHandler(NULL);
+
+    CADestroyDataSet(cadata);
+    coap_delete_list(options);
+    coap_delete_pdu(pdu);
+
+    CADestroyToken(tempToken);
+    CADestroyEndpoint(tempRep);
+}
+
 // request and block option1
 TEST_F(CABlockTransferTests, CAAddBlockOptionTest)
 {
@@ -0,0 +1,176 @@
+/* ****************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "cacommon.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "oic_time.h"
+
+#include <string.h>
+
+// The history is built in with a clock the tests move, so that the lifetimes of
+// messages can be checked without waiting for them.
+static uint64_t g_testTime = 1000000;
+
+extern "C" uint64_t CADedupTestCurrentTime(OICTimePrecision /*precision*/)
+{
+    return g_testTime;
+}
+
+#define OICGetCurrentTime CADedupTestCurrentTime
+#define CADedupInitialize CADedupInitializeTest
+#define CADedupTerminate CADedupTerminateTest
+#define CADedupReceivedRequest CADedupReceivedRequestTest
+#define CADedupSentResponse CADedupSentResponseTest
+
+#include "../src/cadeduplication.c"
+
+class CADedupTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(CA_STATUS_OK, CADedupInitialize());
+        memset(&peer, 0, sizeof(peer));
+        peer.adapter = CA_ADAPTER_IP;
+        peer.flags = CA_IPV4;
+        peer.port = 5683;
+        peer.ifindex = 2;
+        OICStrcpy(peer.addr, sizeof(peer.addr), "192.168.1.10");
+    }
+
+    virtual void TearDown()
+    {
+        CADedupTerminate();
+    }
+
+    CADedupResult_t received(const CAEndpoint_t &ep, CAMessageType_t type, uint16_t id,
+                             const char *token = "tok")
+    {
+        void *response = NULL;
+        size_t responseLength = 0;
+        CADedupResult_t result = CADedupReceivedRequest(&ep, type, id, (const uint8_t *)token,
+                                                        (uint8_t)strlen(token),
+                                                        &response, &responseLength);
+        lastResponse.assign((const char *)response, responseLength);
+        OICFree(response);
+        return result;
+    }
+
+    CAEndpoint_t peer;
+    std::string lastResponse;
+};
+
+TEST_F(CADedupTests, DuplicateNonIsDropped)
+{
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 100));
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, 100));
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 101));
+}
+
+TEST_F(CADedupTests, OtherPeerIsNotDuplicate)
+{
+    CAEndpoint_t other = peer;
+    other.port = 5684;
+
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 100));
+    EXPECT_EQ(CA_DEDUP_NEW, received(other, CA_MSG_NONCONFIRM, 100));
+
+    other = peer;
+    OICStrcpy(other.addr, sizeof(other.addr), "192.168.1.11");
+    EXPECT_EQ(CA_DEDUP_NEW, received(other, CA_MSG_NONCONFIRM, 100));
+}
+
+TEST_F(CADedupTests, CopyOverOtherFamilyIsDropped)
+{
+    CAEndpoint_t v6 = peer;
+    v6.flags = CA_IPV6;
+    OICStrcpy(v6.addr, sizeof(v6.addr), "fe80::1");
+
+    EXPECT_EQ(CA_DEDUP_NEW, received(v6, CA_MSG_NONCONFIRM, 100, "abc"));
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, 100, "abc"));
+    // different token
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 101, "abc"));
+    EXPECT_EQ(CA_DEDUP_NEW, received(v6, CA_MSG_NONCONFIRM, 101, "xyz"));
+}
+
+TEST_F(CADedupTests, DuplicateConGetsResponseAgain)
+{
+    const char response[] = "piggybacked response";
+
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_CONFIRM, 200));
+    // not answered yet
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_CONFIRM, 200));
+
+    CADedupSentResponse(&peer, 200, response, sizeof(response));
+    EXPECT_EQ(CA_DEDUP_REPLAY, received(peer, CA_MSG_CONFIRM, 200));
+    EXPECT_EQ(std::string(response, sizeof(response)), lastResponse);
+
+    // the response of another exchange isn't kept
+    CADedupSentResponse(&peer, 201, response, sizeof(response));
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_CONFIRM, 201));
+}
+
+TEST_F(CADedupTests, OldestMessagesAreForgotten)
+{
+    for (uint16_t id = 0; id < CA_DEDUP_HISTORY_SIZE; id++)
+    {
+        EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, id));
+    }
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, 0));
+
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, CA_DEDUP_HISTORY_SIZE));
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 0));
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, CA_DEDUP_HISTORY_SIZE - 1));
+}
+
+TEST_F(CADedupTests, NonIsForgottenAfterNonLifetime)
+{
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 300));
+
+    g_testTime += CA_NON_LIFETIME_MSEC - 1;
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, 300));
+
+    // a duplicate does not extend the lifetime
+    g_testTime += 1;
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_NONCONFIRM, 300));
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_NONCONFIRM, 300));
+}
+
+TEST_F(CADedupTests, ConIsForgottenAfterExchangeLifetime)
+{
+    const char response[] = "piggybacked response";
+
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_CONFIRM, 301));
+    CADedupSentResponse(&peer, 301, response, sizeof(response));
+
+    // outlives a non-confirmable message
+    g_testTime += CA_NON_LIFETIME_MSEC;
+    EXPECT_EQ(CA_DEDUP_REPLAY, received(peer, CA_MSG_CONFIRM, 301));
+    EXPECT_EQ(std::string(response, sizeof(response)), lastResponse);
+
+    // the response is forgotten with the request
+    g_testTime += CA_EXCHANGE_LIFETIME_MSEC - CA_NON_LIFETIME_MSEC;
+    EXPECT_EQ(CA_DEDUP_NEW, received(peer, CA_MSG_CONFIRM, 301));
+    EXPECT_TRUE(lastResponse.empty());
+    EXPECT_EQ(CA_DEDUP_DUPLICATE, received(peer, CA_MSG_CONFIRM, 301));
+}
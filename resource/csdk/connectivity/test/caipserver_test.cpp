@@ -0,0 +1,151 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "caipinterface.h"
+#include "cathreadpool.h"
+
+#include <string.h>
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if !defined(_WIN32)
+#include <sys/time.h>
+#endif
+
+#if !defined(_WIN32)
+
+class CAIPServerTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        receiver = -1;
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &threadPool));
+
+        caglobals.ip.ipv6enabled = false;
+        caglobals.ip.ipv4enabled = true;
+        caglobals.ip.u6.fd = OC_INVALID_SOCKET;
+        caglobals.ip.u6s.fd = OC_INVALID_SOCKET;
+        caglobals.ip.u4.fd = OC_INVALID_SOCKET;
+        caglobals.ip.u4s.fd = OC_INVALID_SOCKET;
+        caglobals.ip.m6.fd = OC_INVALID_SOCKET;
+        caglobals.ip.m6s.fd = OC_INVALID_SOCKET;
+        caglobals.ip.m4.fd = OC_INVALID_SOCKET;
+        caglobals.ip.m4s.fd = OC_INVALID_SOCKET;
+        caglobals.ip.u4.port = 0;
+        caglobals.ip.u4s.port = 0;
+        caglobals.ip.m4.port = 0;
+        caglobals.ip.m4s.port = 0;
+        caglobals.ip.selectTimeout = 1;
+        caglobals.ip.terminate = false;
+
+        // the datagrams sent by the server end up here
+        receiver = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, receiver);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(0, bind(receiver, (struct sockaddr *)&addr, sizeof(addr)));
+        socklen_t addrLen = sizeof(addr);
+        ASSERT_EQ(0, getsockname(receiver, (struct sockaddr *)&addr, &addrLen));
+        receiverPort = ntohs(addr.sin_port);
+        struct timeval timeout = { 2, 0 };
+        ASSERT_EQ(0, setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)));
+
+        ASSERT_EQ(CA_STATUS_OK, CAIPStartServer(threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        if (caglobals.ip.started)
+        {
+            CAIPStopServer();
+        }
+        ca_thread_pool_free(threadPool);
+        if (-1 != receiver)
+        {
+            close(receiver);
+        }
+    }
+
+    CAEndpoint_t receiverEndpoint()
+    {
+        CAEndpoint_t endpoint;
+        memset(&endpoint, 0, sizeof(endpoint));
+        endpoint.adapter = CA_ADAPTER_IP;
+        endpoint.flags = CA_IPV4;
+        endpoint.port = receiverPort;
+        strncpy(endpoint.addr, "127.0.0.1", sizeof(endpoint.addr) - 1);
+        return endpoint;
+    }
+
+    ca_thread_pool_t threadPool;
+    int receiver;
+    uint16_t receiverPort;
+};
+
+// Datagrams waiting in a batch that is not full yet are sent when the server stops
+TEST_F(CAIPServerTests, StopSendsQueuedData)
+{
+    const char *messages[] = { "first", "second", "third" };
+    const size_t count = sizeof(messages) / sizeof(messages[0]);
+
+    CAIPSendStatistics_t before;
+    CAIPGetSendStatistics(&before);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CAEndpoint_t endpoint = receiverEndpoint();
+        CAIPQueueSendData(&endpoint, messages[i], strlen(messages[i]), false);
+    }
+
+    // the test thread stands in for the send thread, which is stopped before the server
+    CAIPStopServer();
+
+    char buffer[64];
+    for (size_t i = 0; i < count; i++)
+    {
+        ssize_t len = recv(receiver, buffer, sizeof(buffer), 0);
+        ASSERT_EQ((ssize_t)strlen(messages[i]), len);
+        EXPECT_EQ(0, memcmp(messages[i], buffer, len));
+    }
+
+    CAIPSendStatistics_t after;
+    CAIPGetSendStatistics(&after);
+    EXPECT_EQ(before.messages + count, after.messages);
+    EXPECT_EQ(before.failures, after.failures);
+
+    // nothing is left to be sent again
+    CAIPFlushSendData();
+    CAIPGetSendStatistics(&before);
+    EXPECT_EQ(after.messages, before.messages);
+}
+
+#endif // _WIN32
@@ -261,3 +261,96 @@ TEST(CAProtocolMessage, CAGetInfoFromPDU)
     coap_delete_list(options);
     coap_delete_pdu(pdu);
 }
+
+TEST(CAProtocolMessage, CAParsePDUInPlace)
+{
+    CAEndpoint_t tempRep;
+    memset(&tempRep, 0, sizeof(CAEndpoint_t));
+    tempRep.flags = CA_DEFAULT_FLAGS;
+    tempRep.adapter = CA_ADAPTER_IP;
+    tempRep.port = 5683;
+
+    coap_pdu_t *pdu = NULL;
+    coap_list_t *options = NULL;
+    coap_transport_t transport = COAP_UDP;
+
+    CAInfo_t inData;
+    memset(&inData, 0, sizeof(CAInfo_t));
+    inData.token = (CAToken_t)"token";
+    inData.tokenLength = (uint8_t)strlen(inData.token);
+    inData.type = CA_MSG_CONFIRM;
+    inData.resourceUri = (CAURI_t)"/a/light?if=oic.if.baseline";
+    inData.payload = (CAPayload_t) "requestPayload";
+    inData.payloadSize = strlen((const char *) inData.payload);
+    inData.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+
+    pdu = CAGeneratePDU(CA_PUT, &inData, &tempRep, &options, &transport);
+    ASSERT_TRUE(pdu != NULL);
+
+    // an unsigned short array keeps the copy aligned for coap_hdr_t.
+    unsigned short buffer[COAP_MAX_PDU_SIZE / sizeof(unsigned short) + 1];
+    ASSERT_LT(pdu->length, sizeof(buffer));
+    memcpy(buffer, pdu->transport_hdr, pdu->length);
+    const char *data = (const char *) buffer;
+
+    coap_pdu_t inPlacePdu;
+    uint32_t code = CA_NOT_FOUND;
+    EXPECT_EQ(CA_STATUS_OK, CAParsePDUInPlace(data, pdu->length, &inPlacePdu,
+                                              &code, &tempRep));
+    EXPECT_EQ((uint32_t) CA_PUT, code);
+    EXPECT_EQ((const void *) data, (const void *) inPlacePdu.transport_hdr);
+    EXPECT_EQ(pdu->length, inPlacePdu.length);
+    ASSERT_TRUE(inPlacePdu.data != NULL);
+    EXPECT_EQ(0, memcmp(inPlacePdu.data, inData.payload, inData.payloadSize));
+
+    CAInfo_t outData;
+    memset(&outData, 0, sizeof(CAInfo_t));
+    EXPECT_EQ(CA_STATUS_OK, CAGetInfoFromPDU(&inPlacePdu, &tempRep, &code, &outData));
+    EXPECT_EQ(CA_MSG_CONFIRM, outData.type);
+    ASSERT_EQ(inData.tokenLength, outData.tokenLength);
+    EXPECT_EQ(0, memcmp(inData.token, outData.token, outData.tokenLength));
+    EXPECT_EQ(inData.payloadSize, outData.payloadSize);
+    EXPECT_STREQ("/a/light?if=oic.if.baseline", outData.resourceUri);
+    OICFree(outData.token);
+    OICFree(outData.options);
+    OICFree(outData.payload);
+    OICFree(outData.resourceUri);
+
+    // a payload start marker must be followed by a payload.
+    ((unsigned char *) buffer)[pdu->length] = COAP_PAYLOAD_START;
+    size_t markerOnly = inPlacePdu.data - (unsigned char *) data;
+    EXPECT_EQ(CA_STATUS_FAILED, CAParsePDUInPlace(data, markerOnly, &inPlacePdu,
+                                                  NULL, &tempRep));
+
+    // only coap version 1 is accepted.
+    ((unsigned char *) buffer)[0] ^= 0xc0;
+    EXPECT_EQ(CA_STATUS_FAILED, CAParsePDUInPlace(data, pdu->length, &inPlacePdu,
+                                                  NULL, &tempRep));
+
+    coap_delete_list(options);
+    coap_delete_pdu(pdu);
+}
+
+TEST(CAProtocolMessage, CAParsePDUInPlaceUnaligned)
+{
+    CAEndpoint_t tempRep;
+    memset(&tempRep, 0, sizeof(CAEndpoint_t));
+    tempRep.flags = CA_DEFAULT_FLAGS;
+    tempRep.adapter = CA_ADAPTER_IP;
+    tempRep.port = 5683;
+
+    // empty ACK, version 1, message id 0x1234.
+    unsigned short buffer[4];
+    unsigned char *bytes = (unsigned char *) buffer;
+    const unsigned char ack[] = { 0x60, 0x00, 0x12, 0x34 };
+    memcpy(bytes, ack, sizeof(ack));
+
+    coap_pdu_t inPlacePdu;
+    EXPECT_EQ(CA_STATUS_OK, CAParsePDUInPlace((const char *) bytes, sizeof(ack),
+                                              &inPlacePdu, NULL, &tempRep));
+    EXPECT_TRUE(inPlacePdu.data == NULL);
+
+    memcpy(bytes + 1, ack, sizeof(ack));
+    EXPECT_EQ(CA_NOT_SUPPORTED, CAParsePDUInPlace((const char *) bytes + 1, sizeof(ack),
+                                                  &inPlacePdu, NULL, &tempRep));
+}
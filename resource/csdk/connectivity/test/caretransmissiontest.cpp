@@ -0,0 +1,227 @@
+/* ****************************************************************
+ *
+ * Copyright 2026 The IoTivity Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "cacommon.h"
+#include "caretransmission.h"
+#include "cathreadpool.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+
+#include <utility>
+#include <vector>
+
+// (destination port, message id) of the pdus handed to the send method
+static std::vector<std::pair<uint16_t, uint16_t> > g_sent;
+
+static CAResult_t RecordSend(const CAEndpoint_t *endpoint, const void *pdu, uint32_t size,
+                             CADataType_t)
+{
+    const unsigned char *bytes = (const unsigned char *)pdu;
+    EXPECT_LE(4u, size);
+    g_sent.push_back(std::make_pair(endpoint->port, (uint16_t)((bytes[2] << 8) | bytes[3])));
+    return CA_STATUS_OK;
+}
+
+/**
+ * Four byte CoAP header without token.
+ */
+static std::vector<unsigned char> makePdu(CAMessageType_t type, unsigned char code,
+                                          uint16_t messageId)
+{
+    std::vector<unsigned char> pdu;
+    pdu.push_back((unsigned char)(0x40 | (type << 4)));
+    pdu.push_back(code);
+    pdu.push_back((unsigned char)(messageId >> 8));
+    pdu.push_back((unsigned char)messageId);
+    return pdu;
+}
+
+class CARetransmissionTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        g_sent.clear();
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &threadPool));
+        // the retransmission thread isn't started, nothing times out
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&context, threadPool, RecordSend,
+                                                           NULL, NULL));
+
+        memset(&peer, 0, sizeof(peer));
+        peer.adapter = CA_ADAPTER_IP;
+        peer.flags = CA_IPV4;
+        peer.port = 5683;
+        OICStrcpy(peer.addr, sizeof(peer.addr), "192.168.1.10");
+    }
+
+    virtual void TearDown()
+    {
+        CARetransmissionDestroy(&context);
+        ca_thread_pool_free(threadPool);
+    }
+
+    void reinitialize(uint8_t nstart)
+    {
+        CARetransmissionConfig_t config = { (CATransportAdapter_t)DEFAULT_RETRANSMISSION_TYPE,
+                                            DEFAULT_RETRANSMISSION_COUNT, nstart };
+        CARetransmissionDestroy(&context);
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&context, threadPool, RecordSend,
+                                                           NULL, &config));
+    }
+
+    CAResult_t send(const CAEndpoint_t &ep, CAMessageType_t type, uint16_t messageId)
+    {
+        std::vector<unsigned char> pdu = makePdu(type, CA_GET, messageId);
+        return CARetransmissionSendData(&context, &ep, CA_REQUEST_DATA, pdu.data(),
+                                        (uint32_t)pdu.size());
+    }
+
+    void receive(const CAEndpoint_t &ep, CAMessageType_t type, uint16_t messageId)
+    {
+        std::vector<unsigned char> pdu = makePdu(type, CA_EMPTY, messageId);
+        void *retransmissionPdu = NULL;
+        EXPECT_EQ(CA_STATUS_OK, CARetransmissionReceivedData(&context, &ep, pdu.data(),
+                                                             (uint32_t)pdu.size(),
+                                                             &retransmissionPdu));
+        OICFree(retransmissionPdu);
+    }
+
+    CARetransmissionStatistics_t statistics()
+    {
+        CARetransmissionStatistics_t stats;
+        EXPECT_EQ(CA_STATUS_OK, CARetransmissionGetStatistics(&context, &stats));
+        return stats;
+    }
+
+    ca_thread_pool_t threadPool;
+    CARetransmission_t context;
+    CAEndpoint_t peer;
+};
+
+TEST_F(CARetransmissionTests, NonConfirmableIsNotHandled)
+{
+    EXPECT_EQ(CA_NOT_SUPPORTED, send(peer, CA_MSG_NONCONFIRM, 1));
+    EXPECT_TRUE(g_sent.empty());
+}
+
+TEST_F(CARetransmissionTests, NothingIsHeldByDefault)
+{
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 1));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 2));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 3));
+    EXPECT_EQ(3u, g_sent.size());
+
+    CARetransmissionStatistics_t stats = statistics();
+    EXPECT_EQ(3u, stats.sent);
+    EXPECT_EQ(0u, stats.held);
+}
+
+TEST_F(CARetransmissionTests, NstartHoldsDataPerEndpoint)
+{
+    reinitialize(1);
+
+    CAEndpoint_t other = peer;
+    other.port = 5684;
+
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 1));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 2));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 3));
+    // another endpoint doesn't wait
+    EXPECT_EQ(CA_STATUS_OK, send(other, CA_MSG_CONFIRM, 4));
+
+    ASSERT_EQ(2u, g_sent.size());
+    EXPECT_EQ(std::make_pair((uint16_t)5683, (uint16_t)1), g_sent[0]);
+    EXPECT_EQ(std::make_pair((uint16_t)5684, (uint16_t)4), g_sent[1]);
+
+    // each answer lets the next waiting data go, in order
+    receive(peer, CA_MSG_ACKNOWLEDGE, 1);
+    ASSERT_EQ(3u, g_sent.size());
+    EXPECT_EQ(std::make_pair((uint16_t)5683, (uint16_t)2), g_sent[2]);
+
+    receive(peer, CA_MSG_RESET, 2);
+    ASSERT_EQ(4u, g_sent.size());
+    EXPECT_EQ(std::make_pair((uint16_t)5683, (uint16_t)3), g_sent[3]);
+
+    // unknown message ids change nothing
+    receive(peer, CA_MSG_ACKNOWLEDGE, 1);
+    EXPECT_EQ(4u, g_sent.size());
+
+    CARetransmissionStatistics_t stats = statistics();
+    EXPECT_EQ(4u, stats.sent);
+    EXPECT_EQ(2u, stats.held);
+    EXPECT_EQ(2u, stats.acknowledged);
+    EXPECT_EQ(0u, stats.retransmitted);
+    // RSTs aren't RTT samples
+    EXPECT_EQ(1u, stats.strongRttSamples);
+    EXPECT_EQ(0u, stats.weakRttSamples);
+}
+
+TEST_F(CARetransmissionTests, NstartChangesAtRuntime)
+{
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 1));
+    EXPECT_EQ(CA_STATUS_OK, CARetransmissionSetNstart(&context, 1));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 2));
+    EXPECT_EQ(CA_STATUS_OK, send(peer, CA_MSG_CONFIRM, 3));
+    ASSERT_EQ(1u, g_sent.size());
+
+    // lifting the limit lets all waiting data go with the next answer
+    EXPECT_EQ(CA_STATUS_OK, CARetransmissionSetNstart(&context, 0));
+    receive(peer, CA_MSG_ACKNOWLEDGE, 1);
+    ASSERT_EQ(3u, g_sent.size());
+    EXPECT_EQ(std::make_pair((uint16_t)5683, (uint16_t)2), g_sent[1]);
+    EXPECT_EQ(std::make_pair((uint16_t)5683, (uint16_t)3), g_sent[2]);
+
+    CARetransmission_t uninitialized;
+    memset(&uninitialized, 0, sizeof(uninitialized));
+    EXPECT_EQ(CA_STATUS_NOT_INITIALIZED, CARetransmissionSetNstart(&uninitialized, 1));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CARetransmissionSetNstart(NULL, 1));
+}
+
+TEST_F(CARetransmissionTests, ManyEndpoints)
+{
+    const uint16_t count = 2 * RETRANSMISSION_PEER_CACHE_SIZE;
+    CAEndpoint_t ep = peer;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        ep.port = (uint16_t)(10000 + i);
+        EXPECT_EQ(CA_STATUS_OK, send(ep, CA_MSG_CONFIRM, i));
+    }
+    for (uint16_t i = 0; i < count; i++)
+    {
+        ep.port = (uint16_t)(10000 + i);
+        receive(ep, CA_MSG_ACKNOWLEDGE, i);
+    }
+    EXPECT_EQ(count, g_sent.size());
+
+    // idle endpoints are forgotten, the others are kept
+    for (uint16_t i = 0; i < count; i++)
+    {
+        ep.port = (uint16_t)(20000 + i);
+        EXPECT_EQ(CA_STATUS_OK, send(ep, CA_MSG_CONFIRM, (uint16_t)(count + i)));
+    }
+    EXPECT_EQ(2u * count, g_sent.size());
+
+    CARetransmissionStatistics_t stats = statistics();
+    EXPECT_EQ(2u * count, stats.sent);
+    EXPECT_EQ(0u, stats.held);
+    EXPECT_EQ((uint32_t)count, stats.acknowledged);
+}
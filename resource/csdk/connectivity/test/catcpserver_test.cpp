@@ -0,0 +1,364 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "catcpinterface.h"
+#include "cathreadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+/**
+ * Build a CoAP over TCP message with @p length bytes after the header and
+ * every byte of the message after the first set to @p fill.
+ */
+static std::vector<unsigned char> makeFrame(size_t length, unsigned char fill)
+{
+    std::vector<unsigned char> frame;
+    if (length < 13)
+    {
+        frame.push_back((unsigned char)(length << 4));
+    }
+    else if (length < 269)
+    {
+        frame.push_back(13 << 4);
+        frame.push_back((unsigned char)(length - 13));
+    }
+    else
+    {
+        frame.push_back(14 << 4);
+        frame.push_back((unsigned char)((length - 269) >> 8));
+        frame.push_back((unsigned char)(length - 269));
+    }
+    // code
+    frame.push_back(fill);
+    frame.insert(frame.end(), length, fill);
+    return frame;
+}
+
+class CATCPFramingTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(&session, 0, sizeof(session));
+    }
+
+    virtual void TearDown()
+    {
+        CACleanData(&session);
+    }
+
+    void expectFrame(const std::vector<unsigned char> &expected)
+    {
+        const unsigned char *frame = NULL;
+        size_t frameLength = 0;
+        ASSERT_EQ(CA_STATUS_OK, CAGetNextCoAPFrame(&session, &frame, &frameLength));
+        ASSERT_TRUE(frame != NULL);
+        ASSERT_EQ(expected.size(), frameLength);
+        EXPECT_EQ(0, memcmp(expected.data(), frame, frameLength));
+    }
+
+    void expectNoFrame()
+    {
+        const unsigned char *frame = NULL;
+        size_t frameLength = 0;
+        EXPECT_EQ(CA_STATUS_OK, CAGetNextCoAPFrame(&session, &frame, &frameLength));
+        EXPECT_EQ(NULL, frame);
+        EXPECT_EQ(0u, frameLength);
+    }
+
+    CATCPSessionInfo_t session;
+};
+
+TEST_F(CATCPFramingTests, EmptySession)
+{
+    expectNoFrame();
+}
+
+TEST_F(CATCPFramingTests, SeveralFramesInOneRead)
+{
+    std::vector<unsigned char> first = makeFrame(4, 1);
+    std::vector<unsigned char> second = makeFrame(100, 2);
+    std::vector<unsigned char> third = makeFrame(1000, 3);
+
+    std::vector<unsigned char> data(first);
+    data.insert(data.end(), second.begin(), second.end());
+    data.insert(data.end(), third.begin(), third.end());
+
+    EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, data.data(), data.size()));
+    expectFrame(first);
+    expectFrame(second);
+    expectFrame(third);
+    expectNoFrame();
+}
+
+TEST_F(CATCPFramingTests, FrameReceivedByteByByte)
+{
+    std::vector<unsigned char> frame = makeFrame(300, 7);
+
+    for (size_t i = 0; i + 1 < frame.size(); i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, &frame[i], 1));
+        expectNoFrame();
+    }
+    EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, &frame.back(), 1));
+    expectFrame(frame);
+}
+
+TEST_F(CATCPFramingTests, FramesWrapAroundTheRing)
+{
+    std::vector<std::vector<unsigned char> > frames;
+    std::vector<unsigned char> data;
+    for (unsigned char i = 0; i < 100; i++)
+    {
+        frames.push_back(makeFrame(500, i));
+        data.insert(data.end(), frames.back().begin(), frames.back().end());
+    }
+
+    // reads that end inside a message keep the ring from being emptied, so
+    // messages end up across its end
+    const size_t readLength = 700;
+    size_t next = 0;
+    for (size_t offset = 0; offset < data.size(); offset += readLength)
+    {
+        size_t length = std::min(readLength, data.size() - offset);
+        EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, &data[offset], length));
+
+        const unsigned char *frame = NULL;
+        size_t frameLength = 0;
+        while (CA_STATUS_OK == CAGetNextCoAPFrame(&session, &frame, &frameLength) && frame)
+        {
+            ASSERT_LT(next, frames.size());
+            ASSERT_EQ(frames[next].size(), frameLength);
+            EXPECT_EQ(0, memcmp(frames[next].data(), frame, frameLength));
+            next++;
+        }
+    }
+    EXPECT_EQ(frames.size(), next);
+    EXPECT_TRUE(session.frameBuffer != NULL);
+}
+
+TEST_F(CATCPFramingTests, RingGrowsForLargeFrame)
+{
+    std::vector<unsigned char> small = makeFrame(10, 1);
+    std::vector<unsigned char> large = makeFrame(20000, 2);
+
+    EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, small.data(), small.size()));
+    EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, large.data(), 10));
+    expectFrame(small);
+    expectNoFrame();
+    EXPECT_LE(large.size(), session.recvCapacity);
+
+    EXPECT_EQ(CA_STATUS_OK, CAAppendReceivedData(&session, large.data() + 10,
+                                                 large.size() - 10));
+    expectFrame(large);
+    expectNoFrame();
+}
+
+#if !defined(_WIN32)
+
+static std::atomic<size_t> g_connectedSessions(0);
+static std::atomic<size_t> g_receivedMessages(0);
+
+static void packetReceived(const CASecureEndpoint_t *, const void *, size_t)
+{
+    g_receivedMessages++;
+}
+
+static void connectionChanged(const CAEndpoint_t *, bool isConnected, bool isClient)
+{
+    if (!isClient)
+    {
+        if (isConnected)
+        {
+            g_connectedSessions++;
+        }
+        else
+        {
+            g_connectedSessions--;
+        }
+    }
+}
+
+static bool waitFor(const std::atomic<size_t> &counter, size_t value)
+{
+    for (int i = 0; i < 6000 && counter != value; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return counter == value;
+}
+
+/**
+ * Client sockets of a test, closed when it goes out of scope.
+ */
+class ClientSockets
+{
+public:
+    ClientSockets() {}
+
+    ~ClientSockets()
+    {
+        closeAll();
+    }
+
+    void add(int fd)
+    {
+        m_fds.push_back(fd);
+    }
+
+    const std::vector<int> &fds() const
+    {
+        return m_fds;
+    }
+
+    void closeAll()
+    {
+        for (int fd : m_fds)
+        {
+            close(fd);
+        }
+        m_fds.clear();
+    }
+
+private:
+    ClientSockets(const ClientSockets &);
+    ClientSockets &operator=(const ClientSockets &);
+
+    std::vector<int> m_fds;
+};
+
+class CATCPServerTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        g_connectedSessions = 0;
+        g_receivedMessages = 0;
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &threadPool));
+
+        caglobals.tcp.ipv4.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv4s.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv6.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv6s.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv4.port = 0;
+        caglobals.tcp.ipv4s.port = 0;
+        caglobals.tcp.ipv6.port = 0;
+        caglobals.tcp.ipv6s.port = 0;
+        caglobals.tcp.selectTimeout = 1;
+        caglobals.tcp.listenBacklog = SOMAXCONN;
+#if defined(HAVE_SYS_EPOLL_H)
+        caglobals.tcp.epollFd = -1;
+#endif
+        caglobals.tcp.terminate = false;
+
+        CATCPSetPacketReceiveCallback(packetReceived);
+        CATCPSetConnectionChangedCallback(connectionChanged);
+        ASSERT_EQ(CA_STATUS_OK, CATCPStartServer(threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        CATCPStopServer();
+        CATCPSetPacketReceiveCallback(NULL);
+        CATCPSetConnectionChangedCallback(NULL);
+        ca_thread_pool_free(threadPool);
+    }
+
+    /**
+     * Connect @p count clients to the server, send one message from each and
+     * wait for all of them to be received.
+     */
+    void driveSessions(size_t count)
+    {
+        // each session takes a socket on both ends
+        struct rlimit limit;
+        if (0 == getrlimit(RLIMIT_NOFILE, &limit))
+        {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+            getrlimit(RLIMIT_NOFILE, &limit);
+            if (limit.rlim_cur != RLIM_INFINITY && 2 * count + 64 > limit.rlim_cur)
+            {
+                count = (limit.rlim_cur - 64) / 2;
+            }
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(caglobals.tcp.ipv4.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        ClientSockets clients;
+        for (size_t i = 0; i < count; i++)
+        {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            ASSERT_NE(-1, fd);
+            clients.add(fd);
+            ASSERT_EQ(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+        }
+        EXPECT_TRUE(waitFor(g_connectedSessions, count));
+
+        std::vector<unsigned char> frame = makeFrame(32, 0x01);
+        for (int fd : clients.fds())
+        {
+            ASSERT_EQ((ssize_t)frame.size(), send(fd, frame.data(), frame.size(), 0));
+        }
+        EXPECT_TRUE(waitFor(g_receivedMessages, count));
+
+        clients.closeAll();
+        EXPECT_TRUE(waitFor(g_connectedSessions, 0));
+    }
+
+    ca_thread_pool_t threadPool;
+};
+
+TEST_F(CATCPServerTests, ManySessions)
+{
+    driveSessions(200);
+}
+
+// Run with --gtest_also_run_disabled_tests; needs a high enough open file limit.
+TEST_F(CATCPServerTests, DISABLED_Benchmark10kSessions)
+{
+    driveSessions(10000);
+}
+
+#endif // _WIN32
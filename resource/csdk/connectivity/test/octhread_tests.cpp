@@ -542,3 +542,142 @@ TEST(ConditionTests, TC_07_WAITDURATION)
 
     oc_cond_free(sharedCond);
 }
+
+typedef struct _tagPoolStruct
+{
+    oc_mutex mutex;
+    oc_cond cond;
+    int completed;
+    bool release;
+} _pool_struct;
+
+void countFunc(void *context)
+{
+    _pool_struct *pData = (_pool_struct *) context;
+
+    oc_mutex_lock(pData->mutex);
+    pData->completed++;
+    oc_cond_signal(pData->cond);
+    oc_mutex_unlock(pData->mutex);
+}
+
+void blockingFunc(void *context)
+{
+    _pool_struct *pData = (_pool_struct *) context;
+
+    oc_mutex_lock(pData->mutex);
+    while (!pData->release)
+    {
+        oc_cond_wait(pData->cond, pData->mutex);
+    }
+    pData->completed++;
+    oc_cond_broadcast(pData->cond);
+    oc_mutex_unlock(pData->mutex);
+}
+
+TEST(ThreadPoolTests, TC_01_MANY_TASKS)
+{
+    const int TASKS = 1000;
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(3, &mythreadpool));
+
+    _pool_struct pData = {oc_mutex_new(), oc_cond_new(), 0, true};
+
+    for (int i = 0; i < TASKS; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, countFunc, &pData));
+    }
+
+    oc_mutex_lock(pData.mutex);
+    while (pData.completed < TASKS)
+    {
+        oc_cond_wait(pData.cond, pData.mutex);
+    }
+    oc_mutex_unlock(pData.mutex);
+
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(TASKS, pData.completed);
+
+    oc_cond_free(pData.cond);
+    oc_mutex_free(pData.mutex);
+}
+
+TEST(ThreadPoolTests, TC_02_TASKS_BEYOND_WORKERS)
+{
+    const int TASKS = 6;
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &mythreadpool));
+
+    _pool_struct pData = {oc_mutex_new(), oc_cond_new(), 0, false};
+
+    // Both workers block, the remaining tasks wait in the deques.
+    for (int i = 0; i < TASKS; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, blockingFunc, &pData));
+    }
+
+    usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+
+    oc_mutex_lock(pData.mutex);
+    EXPECT_EQ(0, pData.completed);
+    pData.release = true;
+    oc_cond_broadcast(pData.cond);
+    oc_mutex_unlock(pData.mutex);
+
+    // Freeing the pool runs the queued tasks before joining the workers.
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(TASKS, pData.completed);
+
+    oc_cond_free(pData.cond);
+    oc_mutex_free(pData.mutex);
+}
+
+TEST(ThreadPoolTests, TC_03_DEDICATED_TASKS_DO_NOT_HOLD_WORKERS)
+{
+    const int TASKS = 10;
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &mythreadpool));
+
+    _pool_struct loopData = {oc_mutex_new(), oc_cond_new(), 0, false};
+    _pool_struct countData = {oc_mutex_new(), oc_cond_new(), 0, true};
+
+    // The blocking routines run on their own threads, so the only worker stays free.
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_dedicated_task(mythreadpool, blockingFunc, &loopData));
+    }
+    for (int i = 0; i < TASKS; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, countFunc, &countData));
+    }
+
+    oc_mutex_lock(countData.mutex);
+    while (countData.completed < TASKS)
+    {
+        oc_cond_wait(countData.cond, countData.mutex);
+    }
+    oc_mutex_unlock(countData.mutex);
+
+    oc_mutex_lock(loopData.mutex);
+    EXPECT_EQ(0, loopData.completed);
+    loopData.release = true;
+    oc_cond_broadcast(loopData.cond);
+    oc_mutex_unlock(loopData.mutex);
+
+    // Freeing the pool joins the dedicated threads too.
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(2, loopData.completed);
+    EXPECT_EQ(TASKS, countData.completed);
+
+    oc_cond_free(loopData.cond);
+    oc_mutex_free(loopData.mutex);
+    oc_cond_free(countData.cond);
+    oc_mutex_free(countData.mutex);
+}
@@ -26,6 +26,9 @@
 #include <cinttypes>
 #include "iotivity_config.h"
 #include <gtest/gtest.h>
+#include <deque>
+#include <utility>
+#include <vector>
 #include "time.h"
 #include "octypes.h"
 #ifdef HAVE_WINSOCK2_H
@@ -49,6 +52,11 @@
 #define SetCASecureEndpointAttribute SetCASecureEndpointAttributeTest
 #define GetCASecureEndpointAttributes GetCASecureEndpointAttributesTest
 #define CAsetPeerCNVerifyCallback CAsetPeerCNVerifyCallbackTest
+#define CAsslGetSessionCacheStatistics CAsslGetSessionCacheStatisticsTest
+#define CAsslNotifyPkixInfoChanged CAsslNotifyPkixInfoChangedTest
+#define CAsslInvalidateSessionCache CAsslInvalidateSessionCacheTest
+#define CAsslEnableSessionCache CAsslEnableSessionCacheTest
+#define CAsslEnableSessionCacheForPeer CAsslEnableSessionCacheForPeerTest
 
 #include "../src/adapter_util/ca_adapter_net_ssl.c"
 
@@ -1897,6 +1905,7 @@ static void * test0CAinitiateSslHandshake(void * arg)
     serverAddr.ifindex = 0;
 
     g_sslContextMutex = oc_mutex_new_recursive();
+    g_sslRngMutex = oc_mutex_new();
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
@@ -1977,6 +1986,8 @@ static void * test0CAinitiateSslHandshake(void * arg)
     oc_mutex_unlock(g_sslContextMutex);
     oc_mutex_free(g_sslContextMutex);
     g_sslContextMutex = NULL;
+    oc_mutex_free(g_sslRngMutex);
+    g_sslRngMutex = NULL;
 
     socketClose();
 
@@ -2963,6 +2974,7 @@ TEST(TLSAdapter, Test_11)
     ASSERT_FALSE(socket_error) << "Server: socket error";
 
     g_sslContextMutex = oc_mutex_new_recursive();
+    g_sslRngMutex = oc_mutex_new();
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
@@ -3029,6 +3041,272 @@ TEST(TLSAdapter, Test_11)
     OICFree(ownerPsk);
 }
 
+// Peers are found through the index after it has grown, and removed ones are gone
+TEST(TLSAdapter, PeerIndex)
+{
+    const uint16_t peerCount = 3 * SSL_PEER_INDEX_INITIAL_SIZE;
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_TCP;
+    endpoint.flags = CA_SECURE;
+    memcpy(endpoint.addr, "127.0.0.1", sizeof("127.0.0.1"));
+
+    oc_mutex_lock(g_sslContextMutex);
+    std::vector<SslEndPoint_t *> peers;
+    for (uint16_t i = 0; i < peerCount; i++)
+    {
+        endpoint.port = (uint16_t)(10000 + i);
+        SslEndPoint_t *tep = NewSslEndPoint(&endpoint, &g_caSslContext->serverTlsConf);
+        ASSERT_TRUE(NULL != tep);
+        ASSERT_TRUE(AddPeerToList(tep));
+        peers.push_back(tep);
+    }
+    EXPECT_LE((size_t)peerCount, g_caSslContext->peerIndexSize);
+
+    for (uint16_t i = 0; i < peerCount; i++)
+    {
+        endpoint.port = (uint16_t)(10000 + i);
+        EXPECT_EQ(peers[i], GetSslPeer(&endpoint));
+    }
+
+    // same address and port on another adapter
+    endpoint.adapter = CA_ADAPTER_IP;
+    endpoint.port = 10000;
+    EXPECT_EQ(NULL, GetSslPeer(&endpoint));
+    endpoint.adapter = CA_ADAPTER_TCP;
+
+    for (uint16_t i = 0; i < peerCount; i += 2)
+    {
+        endpoint.port = (uint16_t)(10000 + i);
+        RemovePeerFromList(&endpoint);
+    }
+    for (uint16_t i = 0; i < peerCount; i++)
+    {
+        endpoint.port = (uint16_t)(10000 + i);
+        EXPECT_EQ((i % 2) ? peers[i] : NULL, GetSslPeer(&endpoint));
+    }
+    EXPECT_EQ((size_t)peerCount / 2, u_arraylist_length(g_caSslContext->peerList));
+    oc_mutex_unlock(g_sslContextMutex);
+
+    CAdeinitSslAdapter();
+}
+
+/*
+ * Loopback between a client and a server session of the adapter itself: the records
+ * sent to one side are queued and then decrypted as coming from the other side.
+ */
+typedef std::pair<CAEndpoint_t, std::vector<uint8_t> > LoopbackRecord;
+static std::deque<LoopbackRecord> g_loopbackRecords;
+
+static ssize_t LoopbackSendCB(CAEndpoint_t *endpoint, const void *buf, size_t buflen)
+{
+    const uint8_t *data = (const uint8_t *)buf;
+    g_loopbackRecords.push_back(LoopbackRecord(*endpoint, std::vector<uint8_t>(data, data + buflen)));
+    return (ssize_t)buflen;
+}
+
+static void LoopbackReceivedCB(const CASecureEndpoint_t *, const void *, size_t)
+{
+}
+
+static void LoopbackErrorCB(const CAEndpoint_t *, const void *, size_t, CAResult_t)
+{
+}
+
+static int32_t LoopbackPskCredentials(CADtlsPskCredType_t, const unsigned char *, size_t,
+                                      unsigned char *result, size_t resultLength)
+{
+    // the same 16 bytes serve as identity and as key of both sides
+    if (NULL == result || resultLength < UUID_LENGTH)
+    {
+        return -1;
+    }
+    memcpy(result, RS_CLIENT_PSK, UUID_LENGTH);
+    return UUID_LENGTH;
+}
+
+static void LoopbackCredentialTypes(bool *list, const char *)
+{
+    list[0] = true;
+}
+
+static CAEndpoint_t LoopbackEndpoint(uint16_t port)
+{
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_TCP;
+    endpoint.flags = CA_SECURE;
+    endpoint.port = port;
+    memcpy(endpoint.addr, "127.0.0.1", sizeof("127.0.0.1"));
+    return endpoint;
+}
+
+/**
+ * Run a handshake of the client with the server and close both sessions again.
+ *
+ * @return  1 if mbedTLS resumed the session on both sides, 0 if both ran a full handshake,
+ *          or -1 if it did not complete or the sides disagree
+ */
+static int LoopbackHandshake(const CAEndpoint_t &client, const CAEndpoint_t &server)
+{
+    if (CA_STATUS_OK != CAinitiateSslHandshake(&server))
+    {
+        return -1;
+    }
+    while (!g_loopbackRecords.empty())
+    {
+        LoopbackRecord record = g_loopbackRecords.front();
+        g_loopbackRecords.pop_front();
+
+        CASecureEndpoint_t sep;
+        memset(&sep, 0, sizeof(sep));
+        sep.endpoint = (record.first.port == server.port) ? client : server;
+        CAdecryptSsl(&sep, record.second.data(), record.second.size());
+    }
+
+    oc_mutex_lock(g_sslContextMutex);
+    SslEndPoint_t *clientPeer = GetSslPeer(&server);
+    SslEndPoint_t *serverPeer = GetSslPeer(&client);
+    bool established = clientPeer && MBEDTLS_SSL_HANDSHAKE_OVER == clientPeer->ssl.state
+                       && serverPeer && MBEDTLS_SSL_HANDSHAKE_OVER == serverPeer->ssl.state;
+    // the identity of the client must survive an abbreviated handshake
+    established = established && UUID_LENGTH == serverPeer->sep.identity.id_length
+                  && 0 == memcmp(RS_CLIENT_PSK, serverPeer->sep.identity.id, UUID_LENGTH);
+    established = established && clientPeer->resumed == serverPeer->resumed;
+    bool resumed = established && clientPeer->resumed;
+    oc_mutex_unlock(g_sslContextMutex);
+
+    CAcloseSslConnection(&server);
+    CAcloseSslConnection(&client);
+    g_loopbackRecords.clear();
+
+    return established ? (resumed ? 1 : 0) : -1;
+}
+
+// Reconnecting peers resume their session instead of running a full handshake
+TEST(TLSAdapter, SessionResumption)
+{
+    const int handshakes = 20;
+    const CAEndpoint_t client = LoopbackEndpoint(20001);
+    const CAEndpoint_t server = LoopbackEndpoint(20002);
+
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAsetSslAdapterCallbacks(LoopbackReceivedCB, LoopbackSendCB, LoopbackErrorCB, CA_ADAPTER_TCP);
+    CAsetPskCredentialsCallback(LoopbackPskCredentials);
+    CAsetCredentialTypesCallback(LoopbackCredentialTypes);
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256));
+
+    for (int i = 0; i < handshakes; i++)
+    {
+        oc_mutex_lock(g_sslContextMutex);
+        FlushSslSessionCache();
+        oc_mutex_unlock(g_sslContextMutex);
+
+        ASSERT_EQ(0, LoopbackHandshake(client, server));
+    }
+
+    CASslSessionCacheStatistics_t stats;
+    CAsslGetSessionCacheStatistics(&stats);
+    EXPECT_EQ(0u, stats.clientHits);
+    EXPECT_EQ((uint32_t)handshakes, stats.clientMisses);
+    EXPECT_EQ(0u, stats.serverHits);
+    EXPECT_EQ((uint32_t)handshakes, stats.serverMisses);
+
+    for (int i = 0; i < handshakes; i++)
+    {
+        ASSERT_EQ(1, LoopbackHandshake(client, server));
+    }
+
+    CAsslGetSessionCacheStatistics(&stats);
+    EXPECT_EQ((uint32_t)handshakes, stats.clientHits);
+    EXPECT_EQ((uint32_t)handshakes, stats.clientMisses);
+    EXPECT_EQ((uint32_t)handshakes, stats.serverHits);
+    EXPECT_EQ((uint32_t)handshakes, stats.serverMisses);
+
+    // a new cipher suite selection drops the cached sessions
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM));
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256));
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    CAsslGetSessionCacheStatistics(&stats);
+    EXPECT_EQ((uint32_t)handshakes + 1, stats.clientMisses);
+
+    // so do changed credentials
+    CAsslNotifyPkixInfoChanged();
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    CAsslInvalidateSessionCache();
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    CAsslGetSessionCacheStatistics(&stats);
+    EXPECT_EQ((uint32_t)handshakes + 3, stats.clientMisses);
+    EXPECT_EQ((uint32_t)handshakes + 3, stats.serverMisses);
+
+    // sessions made while the cache is disabled are not resumed once it is enabled again
+    CAsslEnableSessionCache(false);
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    CAsslEnableSessionCache(true);
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    ASSERT_EQ(1, LoopbackHandshake(client, server));
+    CAsslGetSessionCacheStatistics(&stats);
+    EXPECT_EQ((uint32_t)handshakes + 1, stats.clientHits);
+    EXPECT_EQ((uint32_t)handshakes + 6, stats.clientMisses);
+
+    // disabling the cache for a peer being onboarded leaves the other peers alone
+    const CAEndpoint_t otherServer = LoopbackEndpoint(20003);
+    ASSERT_EQ(0, LoopbackHandshake(client, otherServer));
+    EXPECT_EQ(CA_STATUS_OK, CAsslEnableSessionCacheForPeer(&server, false));
+    EXPECT_EQ(CA_STATUS_OK, CAsslEnableSessionCacheForPeer(&server, false));
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    ASSERT_EQ(1, LoopbackHandshake(client, otherServer));
+    // and is undone at once, however often it was disabled
+    EXPECT_EQ(CA_STATUS_OK, CAsslEnableSessionCacheForPeer(&server, true));
+    ASSERT_EQ(0, LoopbackHandshake(client, server));
+    ASSERT_EQ(1, LoopbackHandshake(client, server));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAsslEnableSessionCacheForPeer(NULL, false));
+
+    CAsetCredentialTypesCallback(NULL);
+    CAdeinitSslAdapter();
+}
+
+static int g_pkixInfoLoads = 0;
+
+static void CountingPkixInfoCallback(PkiInfo_t * inf)
+{
+    g_pkixInfoLoads++;
+    infoCallback_that_loads_x509(inf);
+}
+
+// The parsed PKIX info is reused until it changes or another callback provides it
+TEST(TLSAdapter, PkixInfoCache)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAsetPkixInfoCallback(CountingPkixInfoCallback);
+    g_pkixInfoLoads = 0;
+
+    oc_mutex_lock(g_sslContextMutex);
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_IP));
+    EXPECT_EQ(1, g_pkixInfoLoads);
+
+    CAsslNotifyPkixInfoChanged();
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_IP));
+    EXPECT_EQ(2, g_pkixInfoLoads);
+
+    CAsetPkixInfoCallback(infoCallback_that_loads_x509);
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    CAsetPkixInfoCallback(CountingPkixInfoCallback);
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(3, g_pkixInfoLoads);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    CAsetPkixInfoCallback(NULL);
+    CAdeinitSslAdapter();
+}
+
 TEST(TLSAdapter, Test_ParseChain)
 {
     int errNum;
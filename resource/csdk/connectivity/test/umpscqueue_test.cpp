@@ -0,0 +1,185 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "umpscqueue.h"
+#include "octhread.h"
+
+#include <stdint.h>
+
+class UMpscQueueF : public testing::Test {
+public:
+    UMpscQueueF() :
+      testing::Test(),
+      queue(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        queue = u_mpsc_queue_create(8);
+        ASSERT_TRUE(queue != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        u_mpsc_queue_delete(queue);
+    }
+
+    u_mpsc_queue_t *queue;
+};
+
+TEST(UMpscQueue, Base)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(16);
+    ASSERT_TRUE(queue != NULL);
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, FreeNull)
+{
+    u_mpsc_queue_delete(NULL);
+    EXPECT_TRUE(u_mpsc_queue_is_empty(NULL));
+}
+
+TEST_F(UMpscQueueF, GetEmpty)
+{
+    u_queue_message_t message;
+    EXPECT_FALSE(u_mpsc_queue_get_element(queue, &message));
+}
+
+TEST_F(UMpscQueueF, FifoWithinRing)
+{
+    int values[4] = { 0, 1, 2, 3 };
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_mpsc_queue_add_element(queue, &values[i], sizeof(int)));
+    }
+    EXPECT_FALSE(u_mpsc_queue_is_empty(queue));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        u_queue_message_t message;
+        ASSERT_TRUE(u_mpsc_queue_get_element(queue, &message));
+        EXPECT_EQ(&values[i], message.msg);
+        EXPECT_EQ(sizeof(int), message.size);
+    }
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+}
+
+TEST_F(UMpscQueueF, FifoBeyondRing)
+{
+    // The ring holds 8 messages, the rest must spill and keep their order.
+    int values[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        values[i] = i;
+        EXPECT_EQ(CA_STATUS_OK, u_mpsc_queue_add_element(queue, &values[i], sizeof(int)));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        u_queue_message_t message;
+        ASSERT_TRUE(u_mpsc_queue_get_element(queue, &message));
+        EXPECT_EQ(i, *(int *) message.msg);
+
+        // refill while draining so ring and overflow are used together
+        if (i < 50)
+        {
+            EXPECT_EQ(CA_STATUS_OK, u_mpsc_queue_add_element(queue, &values[i], sizeof(int)));
+        }
+    }
+    for (int i = 0; i < 50; ++i)
+    {
+        u_queue_message_t message;
+        ASSERT_TRUE(u_mpsc_queue_get_element(queue, &message));
+        EXPECT_EQ(i, *(int *) message.msg);
+    }
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+}
+
+#define PRODUCERS 4
+#define MESSAGES_PER_PRODUCER 20000
+
+typedef struct
+{
+    u_mpsc_queue_t *queue;
+    uintptr_t producer;
+} producer_arg_t;
+
+static void *ProduceMessages(void *data)
+{
+    producer_arg_t *arg = (producer_arg_t *) data;
+    for (uintptr_t i = 0; i < MESSAGES_PER_PRODUCER; ++i)
+    {
+        // encode producer and sequence in the message pointer itself
+        uintptr_t value = (arg->producer << 24) | (i + 1);
+        while (CA_STATUS_OK != u_mpsc_queue_add_element(arg->queue, (void *) value,
+                                                        (uint32_t) arg->producer))
+        {
+        }
+    }
+    return NULL;
+}
+
+TEST_F(UMpscQueueF, MultipleProducers)
+{
+    oc_thread threads[PRODUCERS];
+    producer_arg_t args[PRODUCERS];
+    uintptr_t next[PRODUCERS] = { 0 };
+
+    for (uintptr_t p = 0; p < PRODUCERS; ++p)
+    {
+        args[p].queue = queue;
+        args[p].producer = p;
+        ASSERT_EQ(OC_THREAD_SUCCESS, oc_thread_new(&threads[p], ProduceMessages, &args[p]));
+    }
+
+    uint32_t received = 0;
+    while (received < PRODUCERS * MESSAGES_PER_PRODUCER)
+    {
+        u_queue_message_t message;
+        if (!u_mpsc_queue_get_element(queue, &message))
+        {
+            continue;
+        }
+        uintptr_t value = (uintptr_t) message.msg;
+        uintptr_t producer = value >> 24;
+        ASSERT_LT(producer, (uintptr_t) PRODUCERS);
+        EXPECT_EQ(producer, (uintptr_t) message.size);
+
+        // each producer's messages arrive in the order they were added
+        EXPECT_EQ(next[producer] + 1, value & 0xFFFFFF);
+        next[producer] = value & 0xFFFFFF;
+        received++;
+    }
+
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        oc_thread_wait(threads[p]);
+        oc_thread_free(threads[p]);
+        EXPECT_EQ((uintptr_t) MESSAGES_PER_PRODUCER, next[p]);
+    }
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+}
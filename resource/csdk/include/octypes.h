@@ -1444,7 +1444,9 @@ typedef enum
     /** The payload is an OCDiagnosticPayload */
     PAYLOAD_TYPE_DIAGNOSTIC,
     /** The payload is an OCIntrospectionPayload */
-    PAYLOAD_TYPE_INTROSPECTION
+    PAYLOAD_TYPE_INTROSPECTION,
+    /** The payload is an OCRepPayloadView */
+    PAYLOAD_TYPE_REPRESENTATION_VIEW
 } OCPayloadType;
 
 /** Enum to describe payload interface interface.*/
@@ -1541,6 +1543,12 @@ typedef struct OCRepPayload
     struct OCRepPayload* next;
 } OCRepPayload;
 
+/**
+ * A received representation whose properties are decoded from its CBOR encoding
+ * when they are read. See OCRepPayloadViewCreate.
+ */
+typedef struct OCRepPayloadView OCRepPayloadView;
+
 // used inside a resource payload
 typedef struct OCEndpointPayload
 {
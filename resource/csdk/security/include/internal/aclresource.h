@@ -44,6 +44,17 @@ OCStackResult InitACLResource(void);
  */
 OCStackResult DeInitACLResource(void);
 
+/**
+ * This method is used by PolicyEngine to retrieve all ACEs of the ACL, in order.
+ *
+ * @param[out] generation is set to a value that changes whenever an ACE is added
+ *                        or removed, so that the caller can tell when data it
+ *                        derived from the ACEs is stale. May be NULL.
+ *
+ * @return reference to the first @ref OicSecAce_t, or NULL if there is none.
+ */
+const OicSecAce_t* GetACLResourceAces(uint32_t *generation);
+
 /**
  * This method is used by PolicyEngine to retrieve ACL for a Subject.
  *
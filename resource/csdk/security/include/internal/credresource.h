@@ -73,7 +73,11 @@ OCStackResult DeInitCredResource(void);
 void LogCurrrentCredResource(void);
 
 /**
- * This method is used by tinydtls/SRM to retrieve credential for given subject.
+ * This method is used by SRM to retrieve credential for given subject.
+ *
+ * @note The credential stays owned by the cred resource and is freed when it is
+ *       removed, so it must only be used on the thread which updates the resource.
+ *       Handshake callbacks use GetCredEntryBySubject() instead.
  *
  * @param subjectId for which credential is required.
  *
@@ -82,6 +86,19 @@ void LogCurrrentCredResource(void);
  */
 OicSecCred_t* GetCredResourceData(const OicUuid_t* subjectId);
 
+/**
+ * This method is used by the handshake callbacks to retrieve a copy of the credential
+ * for given subject.
+ *
+ * @note Caller needs to release this memory by calling DeleteCredList().
+ *
+ * @param subjectId for which credential is required.
+ *
+ * @return copy of @ref OicSecCred_t, if credential is found, else NULL, if credential
+ * not found.
+ */
+OicSecCred_t* GetCredEntryBySubject(const OicUuid_t* subjectId);
+
 /**
  * This method is used by SRM to retrieve credential entry for given credId.
  *
@@ -40,6 +40,12 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
 /**
  * This method updates the database in PS
  *
+ * The update is appended to the journal of the database. The database is
+ * compacted into a single map of resources once the journal would grow past
+ * a few times the size of the map, so rewrites of the whole database are
+ * amortised over several updates. The payload of a resource is journaled
+ * whole and the whole database is read for every update.
+ *
  * @param databaseName  is the name of the database to access through persistent storage.
  * @param resourceName  is the name of the resource that will be updated.
  * @param payload       is the pointer to memory where the CBOR payload is located.
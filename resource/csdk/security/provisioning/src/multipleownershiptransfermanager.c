@@ -681,6 +681,22 @@ int MOTIsSupportedOnboardingType(OicSecDoxm_t *ptrDoxm)
     return 0;
 }
 
+/**
+ * Enables or disables resuming the secure sessions with the selected device.
+ * Other devices keep resuming their sessions.
+ */
+static void EnableSslSessionCache(const OCProvisionDev_t *selectedDeviceInfo, bool enable)
+{
+    CAEndpoint_t endpoint = {.adapter = CA_DEFAULT_ADAPTER};
+    CopyDevAddrToEndpoint(&selectedDeviceInfo->endpoint, &endpoint);
+    endpoint.port = selectedDeviceInfo->securePort;
+    if (CA_STATUS_OK != CAEnableSslSessionCacheForPeer(&endpoint, enable))
+    {
+        OIC_LOG_V(WARNING, TAG, "%s: Failed to %s TLS session cache", __func__,
+                  enable ? "enable" : "disable");
+    }
+}
+
 /**
  * Function to save the result of multiple ownership transfer.
  *
@@ -705,6 +721,7 @@ static void SetMOTResult(OTMContext_t *motCtx, const OCStackResult res)
             OicUuid_t emptyUuid = { .id = {0}};
             SetUuidForPinBasedOxm(&emptyUuid);
         }
+        EnableSslSessionCache(motCtx->selectedDeviceInfo, true);
 
         OCStackResult pdmRetVal = PDMSetDeviceState(&motCtx->selectedDeviceInfo->doxm->deviceID,
                                   PDM_DEVICE_ACTIVE);
@@ -1480,6 +1497,9 @@ static OCStackResult StartMultipleOwnershipTransfer(OTMContext_t *motCtx,
     res = AddOTMContext(motCtx, selectedDevice->endpoint.addr, selectedDevice->securePort);
     VERIFY_SUCCESS(TAG, OC_STACK_OK == res, ERROR);
 
+    // Sessions of ownership transfer must not be resumed later
+    EnableSslSessionCache(selectedDevice, false);
+
     res = motCtx->otmCallback.loadSecretCB(motCtx);
     VERIFY_SUCCESS(TAG, OC_STACK_OK == res, ERROR);
 
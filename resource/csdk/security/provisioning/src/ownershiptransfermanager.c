@@ -241,6 +241,22 @@ static bool CloseSslConnection(const OCProvisionDev_t *selectedDeviceInfo)
     return success;
 }
 
+/**
+ * Internal API to enable or disable resuming the secure sessions with the selected device.
+ * Other devices keep resuming their sessions.
+ */
+static void EnableSslSessionCache(const OCProvisionDev_t *selectedDeviceInfo, bool enable)
+{
+    CAEndpoint_t endpoint;
+    CopyDevAddrToEndpoint(&selectedDeviceInfo->endpoint, &endpoint);
+    endpoint.port = getSecurePort(selectedDeviceInfo);
+    if (CA_STATUS_OK != CAEnableSslSessionCacheForPeer(&endpoint, enable))
+    {
+        OIC_LOG_V(WARNING, TAG, "%s: Failed to %s TLS session cache", __func__,
+                  enable ? "enable" : "disable");
+    }
+}
+
 static void SetCBORFormat(OCHeaderOption *options, uint8_t *numOptions)
 {
     options->optionID = COAP_OPTION_ACCEPT;
@@ -545,6 +561,7 @@ static void SetResult(OTMContext_t* otmCtx, const OCStackResult res)
             OIC_LOG(WARNING, TAG, "Failed to revert CredentialTypesHandler.");
         }
     }
+    EnableSslSessionCache(otmCtx->selectedDeviceInfo, true);
 
     for(size_t i = 0; i < otmCtx->ctxResultArraySize; i++)
     {
@@ -981,6 +998,9 @@ static OCStackApplicationResult OwnerTransferModeHandler(void *ctx, OCDoHandle U
             return OC_STACK_DELETE_TRANSACTION;
         }
 
+        //Sessions of ownership transfer must not be resumed later
+        EnableSslSessionCache(otmCtx->selectedDeviceInfo, false);
+
         //Create DTLS secure session
         if(otmCtx->otmCallback.loadSecretCB)
         {
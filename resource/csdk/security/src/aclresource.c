@@ -68,6 +68,11 @@ static const uint8_t ACE_CONN_MAP_SIZE = 1;
 static const uint16_t CBOR_SIZE = 2048*8;
 
 static OicSecAcl_t *gAcl = NULL;
+/**
+ * Changed whenever an ACE is added to or removed from gAcl, so that the
+ * policy engine knows when its compiled copy of the ACL is stale.
+ */
+static uint32_t gAclGeneration = 0;
 static OCResourceHandle gAclHandle = NULL;
 static OCResourceHandle gAcl2Handle = NULL;
 
@@ -2252,6 +2257,8 @@ OCStackResult RemoveACE(const OicUuid_t *subject, const char *resource)
 
     if (deleteFlag)
     {
+        gAclGeneration++;
+
         // In case of unit test do not update persistant storage.
         if (memcmp(subject->id, &WILDCARD_SUBJECT_B64_ID, sizeof(subject->id)) == 0)
         {
@@ -2314,6 +2321,8 @@ static OCStackResult RemoveAceByAceIds(AceIdList_t *aceIdList)
 
     if (deleteFlag)
     {
+        gAclGeneration++;
+
         uint8_t *payload = NULL;
         size_t size = 0;
         if (OC_STACK_OK == AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size))
@@ -2746,6 +2755,8 @@ static OCStackResult RemoveAllAce(const char *resource)
             }
         }
 
+        gAclGeneration++;
+
         //Generate empty ACL payload
         ret = AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size);
         if (OC_STACK_OK == ret )
@@ -2771,6 +2782,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 {
                     DeleteACLList(gAcl);
                     gAcl = originAcl;
+                    gAclGeneration++;
                 }
                 else
                 {
@@ -2970,6 +2982,7 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
                         OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                         OIC_LOG_ACE(DEBUG, insertAce);
                         LL_PREPEND(gAcl->aces, insertAce);
+                        gAclGeneration++;
                     }
                     else
                     {
@@ -3077,6 +3090,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                             //remove old ace with the same aceid
                             LL_DELETE(gAcl->aces, existAce);
                             FreeACE(existAce);
+                            gAclGeneration++;
                             break;
                         }
                     }
@@ -3091,6 +3105,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                     OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                     OIC_LOG_ACE(DEBUG, insertAce);
                     LL_PREPEND(gAcl->aces, insertAce);
+                    gAclGeneration++;
                 }
                 else
                 {
@@ -3295,6 +3310,7 @@ static OCStackResult CreateACLResource(void)
 OCStackResult SetDefaultACL(OicSecAcl_t *acl)
 {
     gAcl = acl;
+    gAclGeneration++;
     return OC_STACK_OK;
 }
 
@@ -3515,6 +3531,7 @@ OCStackResult InitACLResource(void)
         // TODO Needs to update persistent storage
     }
     VERIFY_NOT_NULL(TAG, gAcl, FATAL);
+    gAclGeneration++;
 
     // Instantiate 'oic.sec.acl'
     ret = CreateACLResource();
@@ -3538,6 +3555,7 @@ OCStackResult DeInitACLResource(void)
     {
         DeleteACLList(gAcl);
         gAcl = NULL;
+        gAclGeneration++;
     }
 
     oc_mutex_free(g_AceIdCounterMutex);
@@ -3546,6 +3564,15 @@ OCStackResult DeInitACLResource(void)
     return (OC_STACK_OK != ret) ? ret : ret2;
 }
 
+const OicSecAce_t* GetACLResourceAces(uint32_t *generation)
+{
+    if (NULL != generation)
+    {
+        *generation = gAclGeneration;
+    }
+    return (NULL != gAcl) ? gAcl->aces : NULL;
+}
+
 const OicSecAce_t* GetACLResourceData(const OicUuid_t* subjectId, OicSecAce_t **savePtr)
 {
     OicSecAce_t *ace = NULL;
@@ -3741,6 +3768,7 @@ OCStackResult AppendACLObject(const OicSecAcl_t* acl)
     {
         gAcl->aces = acl->aces;
     }
+    gAclGeneration++;
 
     OIC_LOG_ACL(INFO, gAcl);
 
@@ -3986,6 +4014,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
                     LL_DELETE(gAcl->aces, ace);
                     FreeACE(ace);
                     isRemoved = true;
+                    gAclGeneration++;
                 }
             }
         }
@@ -4002,6 +4031,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
             if (secDefaultAce)
             {
                 LL_APPEND(gAcl->aces, secDefaultAce);
+                gAclGeneration++;
 
                 size_t size = 0;
                 uint8_t *payload = NULL;
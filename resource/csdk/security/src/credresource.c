@@ -42,6 +42,7 @@
 #include "ocpayload.h"
 #include "ocpayloadcbor.h"
 #include "utlist.h"
+#include "octhread.h"
 #include "credresource.h"
 #include "experimental/doxmresource.h"
 #include "pstatresource.h"
@@ -1562,9 +1563,298 @@ static bool UpdatePersistentStorage(const OicSecCred_t *cred)
 
     logCredMetadata();
 
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    // the certificates and keys parsed by the TLS adapter may be out of date now, and
+    // this also stops sessions from being resumed with a removed PSK or certificate
+    CAnotifyPkixInfoChanged();
+#endif
+
     return ret;
 }
 
+/**
+ * Number of subject buckets of the credential index. Must be a power of 2.
+ */
+#define CRED_INDEX_BUCKETS 64
+
+/**
+ * A credential of the credential index.
+ */
+typedef struct CredIndexEntry
+{
+    const OicSecCred_t *cred;
+    struct CredIndexEntry *nextBySubject;   /**< Next entry of the same bucket, in gCred order. */
+    struct CredIndexEntry *nextByUsage;     /**< Next entry of the same credusage, in gCred order. */
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    uint8_t *psk;       /**< Decoded key of a SYMMETRIC_PAIR_WISE_KEY, NULL if it can not be decoded. */
+    size_t pskLen;
+    bool pskDecoded;    /**< True if psk was allocated, false if it points to the privateData. */
+#endif
+} CredIndexEntry;
+
+/**
+ * The credentials of a credusage, in gCred order.
+ */
+typedef struct CredUsageChain
+{
+    const char *usage;
+    CredIndexEntry *head;
+    CredIndexEntry *tail;
+} CredUsageChain;
+
+/**
+ * Credentials indexed by subject and credusage. It is rebuilt from gCred
+ * on the first lookup after gCred changed.
+ */
+typedef struct CredIndex
+{
+    bool valid;
+    CredIndexEntry *entries;
+    size_t entryCount;
+    CredIndexEntry *subjects[CRED_INDEX_BUCKETS];
+    CredUsageChain *usages;
+    size_t usageCount;
+    bool hasPinPassword;
+    bool hasSymmetricPairWiseKey;
+} CredIndex;
+
+static CredIndex gCredIndex = { .valid = false };
+
+/**
+ * Protects gCredIndex, which the handshake callbacks use from the adapter threads.
+ */
+static oc_mutex gCredIndexMutex = NULL;
+
+static void LockCredIndex(void)
+{
+    // the credential resource may be used before InitCredResource, e.g. by the unit tests
+    if (gCredIndexMutex)
+    {
+        oc_mutex_lock(gCredIndexMutex);
+    }
+}
+
+static void UnlockCredIndex(void)
+{
+    if (gCredIndexMutex)
+    {
+        oc_mutex_unlock(gCredIndexMutex);
+    }
+}
+
+static size_t GetCredSubjectBucket(const OicUuid_t *subject)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(subject->id); i++)
+    {
+        hash ^= subject->id[i];
+        hash *= 16777619u;
+    }
+    return hash & (CRED_INDEX_BUCKETS - 1);
+}
+
+/**
+ * Frees the credential index. Must be called with gCredIndexMutex held.
+ */
+static void FreeCredIndex(void)
+{
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    for (size_t i = 0; i < gCredIndex.entryCount; i++)
+    {
+        CredIndexEntry *entry = &gCredIndex.entries[i];
+        if (entry->pskDecoded)
+        {
+            OICClearMemory(entry->psk, entry->pskLen);
+            OICFree(entry->psk);
+        }
+    }
+#endif
+    OICFree(gCredIndex.entries);
+    OICFree(gCredIndex.usages);
+    memset(&gCredIndex, 0, sizeof(gCredIndex));
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+/**
+ * Decodes the key of a SYMMETRIC_PAIR_WISE_KEY once, so that handshakes can copy it as is.
+ */
+static void DecodeIndexedPsk(CredIndexEntry *entry)
+{
+    const OicSecKey_t *key = &entry->cred->privateData;
+
+    if (OIC_ENCODING_RAW == key->encoding)
+    {
+        entry->psk = key->data;
+        entry->pskLen = key->len;
+    }
+    else if (OIC_ENCODING_BASE64 == key->encoding)
+    {
+        size_t outKeySize = 0;
+        int decodeResult = mbedtls_base64_decode(NULL, 0, &outKeySize, key->data, key->len);
+        if (MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL != decodeResult)
+        {
+            OIC_LOG_V(ERROR, TAG, "Failed base64 decoding of credid %u", entry->cred->credId);
+            return;
+        }
+        uint8_t *outKey = (uint8_t *)OICCalloc(1, outKeySize);
+        if (NULL == outKey)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate memory.");
+            return;
+        }
+        if (0 != mbedtls_base64_decode(outKey, outKeySize, &outKeySize, key->data, key->len))
+        {
+            OIC_LOG_V(ERROR, TAG, "Failed base64 decoding of credid %u", entry->cred->credId);
+            OICClearMemory(outKey, outKeySize);
+            OICFree(outKey);
+            return;
+        }
+        entry->psk = outKey;
+        entry->pskLen = outKeySize;
+        entry->pskDecoded = true;
+    }
+}
+#endif
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+static CredUsageChain *FindCredUsageChain(const char *usage)
+{
+    for (size_t i = 0; i < gCredIndex.usageCount; i++)
+    {
+        if (0 == strcmp(gCredIndex.usages[i].usage, usage))
+        {
+            return &gCredIndex.usages[i];
+        }
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * Gets the credential index, rebuilding it if gCred changed since it was built.
+ * Must be called with gCredIndexMutex held.
+ *
+ * @return the credential index, NULL if it could not be built.
+ */
+static const CredIndex *GetCredIndex(void)
+{
+    if (gCredIndex.valid)
+    {
+        return &gCredIndex;
+    }
+
+    FreeCredIndex();
+
+    size_t count = OicSecCredCount(gCred);
+    CredIndexEntry *subjectTails[CRED_INDEX_BUCKETS] = { NULL };
+
+    if (0 < count)
+    {
+        gCredIndex.entries = (CredIndexEntry *)OICCalloc(count, sizeof(CredIndexEntry));
+        gCredIndex.usages = (CredUsageChain *)OICCalloc(count, sizeof(CredUsageChain));
+        if ((NULL == gCredIndex.entries) || (NULL == gCredIndex.usages))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate the credential index");
+            FreeCredIndex();
+            return NULL;
+        }
+    }
+
+    const OicSecCred_t *cred = NULL;
+    LL_FOREACH(gCred, cred)
+    {
+        CredIndexEntry *entry = &gCredIndex.entries[gCredIndex.entryCount++];
+        entry->cred = cred;
+
+        size_t bucket = GetCredSubjectBucket(&cred->subject);
+        if (subjectTails[bucket])
+        {
+            subjectTails[bucket]->nextBySubject = entry;
+        }
+        else
+        {
+            gCredIndex.subjects[bucket] = entry;
+        }
+        subjectTails[bucket] = entry;
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+        if (cred->credUsage)
+        {
+            CredUsageChain *chain = FindCredUsageChain(cred->credUsage);
+            if (NULL == chain)
+            {
+                chain = &gCredIndex.usages[gCredIndex.usageCount++];
+                chain->usage = cred->credUsage;
+                chain->head = entry;
+            }
+            else
+            {
+                chain->tail->nextByUsage = entry;
+            }
+            chain->tail = entry;
+        }
+#endif
+
+        if (PIN_PASSWORD == cred->credType)
+        {
+            gCredIndex.hasPinPassword = true;
+        }
+        else if (SYMMETRIC_PAIR_WISE_KEY == cred->credType)
+        {
+            gCredIndex.hasSymmetricPairWiseKey = true;
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+            DecodeIndexedPsk(entry);
+#endif
+        }
+    }
+
+    gCredIndex.valid = true;
+    OIC_LOG_V(DEBUG, TAG, "Indexed %" PRIuPTR " credentials with %" PRIuPTR " credusages",
+              gCredIndex.entryCount, gCredIndex.usageCount);
+    return &gCredIndex;
+}
+
+/**
+ * Drops the credential index. gCred is only changed with gCredIndexMutex held,
+ * and the index must be dropped before any credential it refers to is freed.
+ */
+static void InvalidateCredIndex(void)
+{
+    FreeCredIndex();
+}
+
+/**
+ * Gets the first indexed credential of the bucket of a subject. The bucket
+ * may hold credentials of other subjects too, so callers compare the subject.
+ * Must be called with gCredIndexMutex held.
+ */
+static const CredIndexEntry *GetIndexedCredsBySubject(const OicUuid_t *subject)
+{
+    const CredIndex *index = GetCredIndex();
+    if (NULL == index)
+    {
+        return NULL;
+    }
+    return index->subjects[GetCredSubjectBucket(subject)];
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+/**
+ * Gets the first indexed credential of a credusage.
+ * Must be called with gCredIndexMutex held.
+ */
+static const CredIndexEntry *GetIndexedCredsByUsage(const char *usage)
+{
+    if ((NULL == usage) || (NULL == GetCredIndex()))
+    {
+        return NULL;
+    }
+    const CredUsageChain *chain = FindCredUsageChain(usage);
+    return chain ? chain->head : NULL;
+}
+#endif
+
 /**
  * Compare function used LL_SORT for sorting credentials.
  *
@@ -1594,6 +1884,7 @@ static int CmpCredId(const OicSecCred_t * first, const OicSecCred_t *second)
  * available credId. The next credId could be the credId that is
  * available due deletion of OicSecCred_t object or one more than
  * credId of last credential in the list.
+ * Must be called with gCredIndexMutex held.
  *
  * @return next available credId if successful, else 0 for error.
  */
@@ -1607,6 +1898,7 @@ static uint16_t GetCredId(void)
 #else
     LL_SORT(gCred, CmpCredId);
 #endif
+    InvalidateCredIndex();
 
     OicSecCred_t *currentCred = NULL, *credTmp = NULL;
     uint16_t nextCredId = 1;
@@ -1700,6 +1992,9 @@ OCStackResult AddCredential(OicSecCred_t * newCred)
         OIC_LOG_V(WARNING, TAG, "%s /cred resource is read-only in RESET and RFNOP.", __func__);
     }
 
+    LockCredIndex();
+    InvalidateCredIndex();
+
     //leave IOT-1936 fix for preconfig pin
 #if ((defined(__WITH_DTLS__) || defined(__WITH_TLS__)) && defined(MULTIPLE_OWNER))
     LL_FOREACH_SAFE(gCred, cred, tempCred)
@@ -1751,6 +2046,7 @@ OCStackResult AddCredential(OicSecCred_t * newCred)
     LL_APPEND(gCred, newCred);
 
 saveToDB:
+    UnlockCredIndex();
     if (UpdatePersistentStorage(gCred))
     {
         result = OC_STACK_OK;
@@ -1766,16 +2062,20 @@ OCStackResult RemoveCredential(const OicUuid_t *subject)
     OicSecCred_t *tempCred = NULL;
     bool deleteFlag = false;
 
+    LockCredIndex();
     LL_FOREACH_SAFE(gCred, cred, tempCred)
     {
         if (memcmp(cred->subject.id, subject->id, sizeof(subject->id)) == 0)
         {
             LL_DELETE(gCred, cred);
+            InvalidateCredIndex();
             FreeCred(cred);
             deleteFlag = 1;
         }
     }
 
+    UnlockCredIndex();
+
     if (deleteFlag)
     {
         if (UpdatePersistentStorage(gCred))
@@ -1800,7 +2100,7 @@ OCStackResult RemoveCredentialByCredId(uint16_t credId)
         return OC_STACK_INVALID_PARAM;
     }
 
-
+    LockCredIndex();
     LL_FOREACH_SAFE(gCred, cred, tempCred)
     {
         if (cred->credId == credId)
@@ -1808,11 +2108,14 @@ OCStackResult RemoveCredentialByCredId(uint16_t credId)
             OIC_LOG_V(DEBUG, TAG, "Credential(ID=%d) will be removed.", credId);
 
             LL_DELETE(gCred, cred);
+            InvalidateCredIndex();
             FreeCred(cred);
             deleteFlag = true;
         }
     }
 
+    UnlockCredIndex();
+
     if (deleteFlag)
     {
         if (UpdatePersistentStorage(gCred))
@@ -1845,6 +2148,7 @@ static OCStackResult RemoveCredentialByCredIds(CredIdList_t *credIdList)
 
     OIC_LOG(INFO, TAG, "IN RemoveCredentialByCredIds");
 
+    LockCredIndex();
     LL_FOREACH(credIdList, credIdElem)
     {
         LL_FOREACH_SAFE(gCred, cred, tempCred)
@@ -1854,6 +2158,7 @@ static OCStackResult RemoveCredentialByCredIds(CredIdList_t *credIdList)
                 OIC_LOG_V(DEBUG, TAG, "Credential(ID=%d) will be removed.", cred->credId);
 
                 LL_DELETE(gCred, cred);
+                InvalidateCredIndex();
                 FreeCred(cred);
                 deleteFlag = true;
                 //TODO: add break when cred's will have unique credid (during IOT-2464 fix)
@@ -1861,6 +2166,8 @@ static OCStackResult RemoveCredentialByCredIds(CredIdList_t *credIdList)
         }
     }
 
+    UnlockCredIndex();
+
     if (deleteFlag)
     {
         if (UpdatePersistentStorage(gCred))
@@ -1943,8 +2250,11 @@ exit:
  */
 static OCStackResult RemoveAllCredentials(void)
 {
+    LockCredIndex();
+    InvalidateCredIndex();
     DeleteCredList(gCred);
     gCred = GetCredDefault();
+    UnlockCredIndex();
 
     if (!UpdatePersistentStorage(gCred))
     {
@@ -2579,6 +2889,12 @@ OCStackResult InitCredResource(void)
     OicSecCred_t* cred = NULL;
     OicUuid_t   *rownerId = NULL;
 
+    if (NULL == gCredIndexMutex)
+    {
+        gCredIndexMutex = oc_mutex_new();
+        VERIFY_NOT_NULL_RETURN(TAG, gCredIndexMutex, ERROR, OC_STACK_NO_MEMORY);
+    }
+
     //Read Cred resource from PS
     uint8_t *data = NULL;
     size_t size = 0;
@@ -2589,6 +2905,8 @@ OCStackResult InitCredResource(void)
         OIC_LOG (DEBUG, TAG, "ReadSVDataFromPS failed");
     }
 
+    LockCredIndex();
+    InvalidateCredIndex();
     if ((ret == OC_STACK_OK) && data)
     {
         // Read Cred resource from PS
@@ -2651,6 +2969,7 @@ OCStackResult InitCredResource(void)
     {
         gCred = GetCredDefault();
     }
+    UnlockCredIndex();
 
     if (gCred)
     {
@@ -2708,8 +3027,16 @@ exit:
 OCStackResult DeInitCredResource(void)
 {
     OCStackResult result = OCDeleteResource(gCredHandle);
+    LockCredIndex();
+    InvalidateCredIndex();
     DeleteCredList(gCred);
     gCred = NULL;
+    UnlockCredIndex();
+    oc_mutex_free(gCredIndexMutex);
+    gCredIndexMutex = NULL;
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    CAnotifyPkixInfoChanged();
+#endif
     return result;
 }
 
@@ -2722,14 +3049,17 @@ OicSecCred_t* GetCredResourceData(const OicUuid_t* subject)
        return NULL;
     }
 
-    LL_FOREACH(gCred, cred)
+    LockCredIndex();
+    for (const CredIndexEntry *entry = GetIndexedCredsBySubject(subject); entry; entry = entry->nextBySubject)
     {
-        if(memcmp(cred->subject.id, subject->id, sizeof(subject->id)) == 0)
+        if(memcmp(entry->cred->subject.id, subject->id, sizeof(subject->id)) == 0)
         {
-            return cred;
+            cred = (OicSecCred_t *)entry->cred;
+            break;
         }
     }
-    return NULL;
+    UnlockCredIndex();
+    return cred;
 }
 
 const OicSecCred_t* GetCredList(void)
@@ -2737,6 +3067,71 @@ const OicSecCred_t* GetCredList(void)
     return gCred;
 }
 
+/**
+ * Copies a credential, for use without holding gCredIndexMutex.
+ *
+ * @return the copy, to be freed with FreeCred(), NULL on failure.
+ */
+static OicSecCred_t* DuplicateCred(const OicSecCred_t *src)
+{
+    OicSecCred_t *cred = NULL;
+
+    cred = (OicSecCred_t*)OICCalloc(1, sizeof(OicSecCred_t));
+    VERIFY_NOT_NULL(TAG, cred, ERROR);
+
+    // common
+    cred->next = NULL;
+    cred->credId = src->credId;
+    cred->credType = src->credType;
+    memcpy(cred->subject.id, src->subject.id , sizeof(cred->subject.id));
+    if (src->period)
+    {
+        cred->period = OICStrdup(src->period);
+    }
+
+    // key data
+    if (src->privateData.data)
+    {
+        cred->privateData.data = (uint8_t *)OICCalloc(1, src->privateData.len);
+        VERIFY_NOT_NULL(TAG, cred->privateData.data, ERROR);
+
+        memcpy(cred->privateData.data, src->privateData.data, src->privateData.len);
+        cred->privateData.len = src->privateData.len;
+        cred->privateData.encoding = src->privateData.encoding;
+    }
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    if (src->publicData.data)
+    {
+        cred->publicData.data = (uint8_t *)OICCalloc(1, src->publicData.len);
+        VERIFY_NOT_NULL(TAG, cred->publicData.data, ERROR);
+
+        memcpy(cred->publicData.data, src->publicData.data, src->publicData.len);
+        cred->publicData.len = src->publicData.len;
+        cred->publicData.encoding = src->publicData.encoding;
+    }
+    if (src->optionalData.data)
+    {
+        cred->optionalData.data = (uint8_t *)OICCalloc(1, src->optionalData.len);
+        VERIFY_NOT_NULL(TAG, cred->optionalData.data, ERROR);
+
+        memcpy(cred->optionalData.data, src->optionalData.data, src->optionalData.len);
+        cred->optionalData.len = src->optionalData.len;
+        cred->optionalData.encoding = src->optionalData.encoding;
+        cred->optionalData.revstat= src->optionalData.revstat;
+    }
+    if (src->credUsage)
+    {
+        cred->credUsage = OICStrdup(src->credUsage);
+    }
+#endif /* __WITH_DTLS__  or __WITH_TLS__*/
+
+    return cred;
+
+exit:
+    FreeCred(cred);
+    return NULL;
+}
+
 OicSecCred_t* GetCredEntryByCredId(const uint16_t credId)
 {
     OicSecCred_t *cred = NULL;
@@ -2747,66 +3142,39 @@ OicSecCred_t* GetCredEntryByCredId(const uint16_t credId)
        return NULL;
     }
 
+    LockCredIndex();
     LL_FOREACH(gCred, tmpCred)
     {
         if(tmpCred->credId == credId)
         {
-            cred = (OicSecCred_t*)OICCalloc(1, sizeof(OicSecCred_t));
-            VERIFY_NOT_NULL(TAG, cred, ERROR);
-
-            // common
-            cred->next = NULL;
-            cred->credId = tmpCred->credId;
-            cred->credType = tmpCred->credType;
-            memcpy(cred->subject.id, tmpCred->subject.id , sizeof(cred->subject.id));
-            if (tmpCred->period)
-            {
-                cred->period = OICStrdup(tmpCred->period);
-            }
-
-            // key data
-            if (tmpCred->privateData.data)
-            {
-                cred->privateData.data = (uint8_t *)OICCalloc(1, tmpCred->privateData.len);
-                VERIFY_NOT_NULL(TAG, cred->privateData.data, ERROR);
-
-                memcpy(cred->privateData.data, tmpCred->privateData.data, tmpCred->privateData.len);
-                cred->privateData.len = tmpCred->privateData.len;
-                cred->privateData.encoding = tmpCred->privateData.encoding;
-            }
-#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
-            if (tmpCred->publicData.data)
-            {
-                cred->publicData.data = (uint8_t *)OICCalloc(1, tmpCred->publicData.len);
-                VERIFY_NOT_NULL(TAG, cred->publicData.data, ERROR);
+            cred = DuplicateCred(tmpCred);
+            break;
+        }
+    }
+    UnlockCredIndex();
+    return cred;
+}
 
-                memcpy(cred->publicData.data, tmpCred->publicData.data, tmpCred->publicData.len);
-                cred->publicData.len = tmpCred->publicData.len;
-                cred->publicData.encoding = tmpCred->publicData.encoding;
-            }
-            if (tmpCred->optionalData.data)
-            {
-                cred->optionalData.data = (uint8_t *)OICCalloc(1, tmpCred->optionalData.len);
-                VERIFY_NOT_NULL(TAG, cred->optionalData.data, ERROR);
+OicSecCred_t* GetCredEntryBySubject(const OicUuid_t* subject)
+{
+    OicSecCred_t *cred = NULL;
 
-                memcpy(cred->optionalData.data, tmpCred->optionalData.data, tmpCred->optionalData.len);
-                cred->optionalData.len = tmpCred->optionalData.len;
-                cred->optionalData.encoding = tmpCred->optionalData.encoding;
-                cred->optionalData.revstat= tmpCred->optionalData.revstat;
-            }
-            if (tmpCred->credUsage)
-            {
-                cred->credUsage = OICStrdup(tmpCred->credUsage);
-            }
-#endif /* __WITH_DTLS__  or __WITH_TLS__*/
+    if (NULL == subject)
+    {
+        return NULL;
+    }
 
-            return cred;
+    LockCredIndex();
+    for (const CredIndexEntry *entry = GetIndexedCredsBySubject(subject); entry; entry = entry->nextBySubject)
+    {
+        if (memcmp(entry->cred->subject.id, subject->id, sizeof(subject->id)) == 0)
+        {
+            cred = DuplicateCred(entry->cred);
+            break;
         }
     }
-
-exit:
-    FreeCred(cred);
-    return NULL;
+    UnlockCredIndex();
+    return cred;
 }
 
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
@@ -2826,6 +3194,9 @@ int32_t GetDtlsPskCredentials(CADtlsPskCredType_t type,
               uint8_t *result, size_t result_length)
 {
     int32_t ret = -1;
+#ifdef MULTIPLE_OWNER
+    OicSecCred_t* wildCardCred = NULL;
+#endif
 
     OIC_LOG_V(DEBUG, TAG, "%s: IN", __func__);
 
@@ -2875,19 +3246,26 @@ int32_t GetDtlsPskCredentials(CADtlsPskCredType_t type,
 
         case CA_DTLS_PSK_KEY:
             {
-                OicSecCred_t *cred = NULL;
-                LL_FOREACH(gCred, cred)
+                const OicSecCred_t *cred = NULL;
+                bool found = false;
+                bool registerRole = false;
+
+                if (desc_len == sizeof(cred->subject.id))
                 {
-                    if (cred->credType != SYMMETRIC_PAIR_WISE_KEY)
-                    {
-                        OIC_LOG_V(DEBUG, TAG, "%s: credid %u not a SYMMETRIC_PAIR_WISE_KEY type... skipping",
-                            __func__, cred->credId);
-                        continue;
-                    }
+                    OicUuid_t subject;
+                    memcpy(subject.id, desc, sizeof(subject.id));
 
-                    if ((desc_len == sizeof(cred->subject.id)) &&
-                        (memcmp(desc, cred->subject.id, sizeof(cred->subject.id)) == 0))
+                    LockCredIndex();
+                    for (const CredIndexEntry *entry = GetIndexedCredsBySubject(&subject);
+                         entry; entry = entry->nextBySubject)
                     {
+                        cred = entry->cred;
+                        if ((cred->credType != SYMMETRIC_PAIR_WISE_KEY) ||
+                            (memcmp(desc, cred->subject.id, sizeof(cred->subject.id)) != 0))
+                        {
+                            continue;
+                        }
+                        found = true;
 #ifndef NDEBUG
                         if (OCConvertUuidToString(cred->subject.id, strUuidTmp))
                         {
@@ -2908,80 +3286,50 @@ int32_t GetDtlsPskCredentials(CADtlsPskCredType_t type,
                             if(IOTVTICAL_VALID_ACCESS != IsRequestWithinValidTime(cred->period, NULL))
                             {
                                 OIC_LOG (INFO, TAG, "Credentials are expired.");
-                                goto exit;
+                                break;
                             }
                         }
 
                         OIC_LOG_V(DEBUG, TAG, "%s: cred->privateData.encoding = %u", __func__, cred->privateData.encoding);
 
-                        // Copy PSK.
-                        // TODO: Added as workaround. Will be replaced soon.
-                        if(OIC_ENCODING_RAW == cred->privateData.encoding)
-                        {
-                            OIC_LOG_V(DEBUG, TAG, "%s: OIC_ENCODING_RAW detected; copying PSK.", __func__);
-                            if (ValueWithinBounds(cred->privateData.len, INT32_MAX))
-                            {
-                                size_t len = cred->privateData.len;
-                                if (result_length < len)
-                                {
-                                    OIC_LOG (ERROR, TAG, "Wrong value for result_length");
-                                    goto exit;
-                                }
-                                memcpy(result, cred->privateData.data, len);
-                                ret = (int32_t)len;
-                            }
-                        }
-                        else if(OIC_ENCODING_BASE64 == cred->privateData.encoding)
+                        // Copy the PSK decoded when the credential was indexed.
+                        if ((OIC_ENCODING_RAW == cred->privateData.encoding) ||
+                            (OIC_ENCODING_BASE64 == cred->privateData.encoding))
                         {
-                            OIC_LOG_V(DEBUG, TAG, "%s: OIC_ENCODING_BASE64 detected; copying PSK.", __func__);
-                            size_t outKeySize;
-                            int decodeResult = mbedtls_base64_decode(NULL, 0, &outKeySize, cred->privateData.data, cred->privateData.len);
-                            if(MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL != decodeResult)
+                            if ((OIC_ENCODING_BASE64 == cred->privateData.encoding) && !entry->pskDecoded)
                             {
                                 OIC_LOG(ERROR, TAG, "Failed base64 decoding");
-                                goto exit;
+                                break;
                             }
-                            size_t outBufSize = outKeySize;
-                            uint8_t* outKey = OICCalloc(1, outBufSize);
-                            if(NULL == outKey)
+                            if (ValueWithinBounds(entry->pskLen, INT32_MAX))
                             {
-                                OIC_LOG (ERROR, TAG, "Failed to allocate memory.");
-                                goto exit;
-                            }
-
-                            if(0 == mbedtls_base64_decode(outKey, outBufSize, &outKeySize, cred->privateData.data, cred->privateData.len))
-                            {
-                                if (ValueWithinBounds(outKeySize, INT32_MAX))
+                                if (result_length < entry->pskLen)
                                 {
-                                    if (result_length < outKeySize)
-                                    {
-                                        OIC_LOG (ERROR, TAG, "Wrong value for result_length");
-                                        OICFree(outKey);
-                                        goto exit;
-                                    }
-                                    memcpy(result, outKey, outKeySize);
-                                    ret = (int32_t)outKeySize;
+                                    OIC_LOG (ERROR, TAG, "Wrong value for result_length");
+                                    break;
                                 }
+                                memcpy(result, entry->psk, entry->pskLen);
+                                ret = (int32_t)entry->pskLen;
                             }
-                            else
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed base64 decoding.");
-                            }
-
-                            OICFree(outKey);
                         }
                         else
                         {
                             OIC_LOG_V(WARNING, TAG, "%s: unsupported encoding type.", __func__);
                         }
-
-                        if (OC_STACK_OK != RegisterSymmetricCredentialRole(cred))
-                        {
-                            OIC_LOG(WARNING, TAG, "Couldn't RegisterRoleForSubject");
-                        }
-
-                        goto exit;
+                        registerRole = true;
+                        break;
                     }
+                    // cred may be freed once the lock is released
+                    if (registerRole && (OC_STACK_OK != RegisterSymmetricCredentialRole(cred)))
+                    {
+                        OIC_LOG(WARNING, TAG, "Couldn't RegisterRoleForSubject");
+                    }
+                    UnlockCredIndex();
+                }
+
+                if (found)
+                {
+                    goto exit;
                 }
                 OIC_LOG(DEBUG, TAG, "Can not find subject matched credential.");
 
@@ -2992,7 +3340,7 @@ int32_t GetDtlsPskCredentials(CADtlsPskCredType_t type,
                     // in case of multiple owner transfer authentication
                     if(OIC_PRECONFIG_PIN == doxm->oxmSel)
                     {
-                        OicSecCred_t* wildCardCred = GetCredResourceData(&WILDCARD_SUBJECT_ID);
+                        wildCardCred = GetCredEntryBySubject(&WILDCARD_SUBJECT_ID);
                         if(wildCardCred)
                         {
                             OIC_LOG(DEBUG, TAG, "Detected wildcard credential.");
@@ -3092,6 +3440,12 @@ int32_t GetDtlsPskCredentials(CADtlsPskCredType_t type,
             break;
     }
 exit:
+#ifdef MULTIPLE_OWNER
+    if (wildCardCred)
+    {
+        FreeCred(wildCardCred);
+    }
+#endif
     OIC_LOG_V(DEBUG, TAG, "%s: OUT; returning %d.", __func__, ret);
 
     return ret;
@@ -3305,19 +3659,16 @@ void GetIdentityHandler(UuidContext_t* ctx, unsigned char* crt, size_t crtLen)
         }
     }
 
-    OicSecCred_t *cred = NULL;
-    LL_FOREACH(gCred, cred)
+    // runs on the adapter thread during handshakes, the credentials are only used under the lock
+    LockCredIndex();
+    for (const CredIndexEntry *entry = GetIndexedCredsByUsage(TRUST_CA); entry; entry = entry->nextByUsage)
     {
+        const OicSecCred_t *cred = entry->cred;
         if (SIGNED_ASYMMETRIC_KEY != cred->credType)
         {
             continue;
         }
 
-        if (0 != strcmp(cred->credUsage, TRUST_CA))
-        {
-            continue;
-        }
-
         uint8_t *der = NULL;
         size_t derLen = 0;
         if ((OIC_ENCODING_BASE64 == cred->publicData.encoding) ||
@@ -3374,6 +3725,7 @@ void GetIdentityHandler(UuidContext_t* ctx, unsigned char* crt, size_t crtLen)
             OICFree(node);
         }
     }
+    UnlockCredIndex();
 }
 
 #ifndef NDEBUG
@@ -3568,31 +3920,15 @@ void LogCurrrentCredResource(void) {
 #endif
 }
 
-static OCStackResult GetCaCert(ByteArray_t * crt, const char * usage, OicEncodingType_t desiredEncoding)
+/**
+ * Appends the CA certificates of the indexed credentials of a credusage to crt.
+ */
+static OCStackResult AppendCaCerts(ByteArray_t *crt, const CredIndexEntry *entries,
+                                   const char *usage, OicEncodingType_t desiredEncoding)
 {
-    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
-    if (NULL == crt || NULL == usage)
-    {
-        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
-        return OC_STACK_INVALID_PARAM;
-    }
-
-    switch (desiredEncoding)
-    {
-    case OIC_ENCODING_PEM:
-    case OIC_ENCODING_DER:
-    case OIC_ENCODING_BASE64:
-        break;
-    default:
-        OIC_LOG_V(ERROR, TAG, "%s: Unsupported encoding %d", __func__, desiredEncoding);
-        return OC_STACK_INVALID_PARAM;
-    }
-
-    crt->len = 0;
-    OicSecCred_t* temp = NULL;
-
-    LL_FOREACH(gCred, temp)
+    for (const CredIndexEntry *entry = entries; entry; entry = entry->nextByUsage)
     {
+        const OicSecCred_t *temp = entry->cred;
         if ((SIGNED_ASYMMETRIC_KEY == temp->credType) &&
             (temp->credUsage != NULL) &&
             (0 == strcmp(temp->credUsage, usage)) && (false == temp->optionalData.revstat))
@@ -3683,6 +4019,38 @@ static OCStackResult GetCaCert(ByteArray_t * crt, const char * usage, OicEncodin
             }
         }
     }
+    return OC_STACK_OK;
+}
+
+static OCStackResult GetCaCert(ByteArray_t * crt, const char * usage, OicEncodingType_t desiredEncoding)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+    if (NULL == crt || NULL == usage)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    switch (desiredEncoding)
+    {
+    case OIC_ENCODING_PEM:
+    case OIC_ENCODING_DER:
+    case OIC_ENCODING_BASE64:
+        break;
+    default:
+        OIC_LOG_V(ERROR, TAG, "%s: Unsupported encoding %d", __func__, desiredEncoding);
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    crt->len = 0;
+
+    LockCredIndex();
+    OCStackResult res = AppendCaCerts(crt, GetIndexedCredsByUsage(usage), usage, desiredEncoding);
+    UnlockCredIndex();
+    if (OC_STACK_OK != res)
+    {
+        return res;
+    }
     if(0 == crt->len)
     {
         OIC_LOG_V(WARNING, TAG, "%s not found", usage);
@@ -3725,7 +4093,7 @@ OCStackResult GetPemCaCert(ByteArray_t * crt, const char * usage)
     return GetCaCert(crt, usage, OIC_ENCODING_PEM);
 }
 
-static int cloneSecKey(OicSecKey_t * dst, OicSecKey_t * src)
+static int cloneSecKey(OicSecKey_t * dst, const OicSecKey_t * src)
 {
     if ((src == NULL) || (dst == NULL))
     {
@@ -3760,12 +4128,11 @@ OCStackResult GetAllRoleCerts(RoleCertChain_t ** output)
 
     *output = NULL;
 
-    OicSecCred_t * temp = NULL;
-    LL_FOREACH(gCred, temp)
+    LockCredIndex();
+    for (const CredIndexEntry *entry = GetIndexedCredsByUsage(ROLE_CERT); entry; entry = entry->nextByUsage)
     {
-        if ((SIGNED_ASYMMETRIC_KEY == temp->credType) &&
-            (temp->credUsage != NULL) &&
-            (0 == strcmp(temp->credUsage, ROLE_CERT)))
+        const OicSecCred_t *temp = entry->cred;
+        if (SIGNED_ASYMMETRIC_KEY == temp->credType)
         {
             if (temp->publicData.data == NULL)
             {
@@ -3788,29 +4155,27 @@ OCStackResult GetAllRoleCerts(RoleCertChain_t ** output)
             }
         }
     }
+    UnlockCredIndex();
 
     OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
     return OC_STACK_OK;
 
 error:
+    UnlockCredIndex();
     FreeRoleCertChainList(*output);
     *output = NULL;
     OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
     return OC_STACK_ERROR;
 }
 
-void GetPemOwnCert(ByteArray_t * crt, const char * usage)
+/**
+ * Appends the certificates of the indexed credentials of a credusage to crt, as PEM.
+ */
+static void AppendOwnCerts(ByteArray_t *crt, const CredIndexEntry *entries, const char *usage)
 {
-    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
-    if (NULL == crt || NULL == usage)
-    {
-        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
-        return;
-    }
-    crt->len = 0;
-    OicSecCred_t * temp = NULL;
-    LL_FOREACH(gCred, temp)
+    for (const CredIndexEntry *entry = entries; entry; entry = entry->nextByUsage)
     {
+        const OicSecCred_t *temp = entry->cred;
         if (SIGNED_ASYMMETRIC_KEY == temp->credType &&
             temp->credUsage != NULL &&
             0 == strcmp(temp->credUsage, usage))
@@ -3902,6 +4267,20 @@ void GetPemOwnCert(ByteArray_t * crt, const char * usage)
             OIC_LOG_V(DEBUG, TAG, "%s found", usage);
         }
     }
+}
+
+void GetPemOwnCert(ByteArray_t * crt, const char * usage)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+    if (NULL == crt || NULL == usage)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+        return;
+    }
+    crt->len = 0;
+    LockCredIndex();
+    AppendOwnCerts(crt, GetIndexedCredsByUsage(usage), usage);
+    UnlockCredIndex();
     if(0 == crt->len)
     {
         OIC_LOG_V(WARNING, TAG, "%s not found", usage);
@@ -3918,19 +4297,14 @@ void GetPemOwnCert(ByteArray_t * crt, const char * usage)
     return;
 }
 
-void GetDerKey(ByteArray_t * key, const char * usage)
+/**
+ * Copies the private key of the first indexed credential of a credusage that has one to key, as DER.
+ */
+static void CopyDerKey(ByteArray_t *key, const CredIndexEntry *entries, const char *usage)
 {
-    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
-    if (NULL == key || NULL == usage)
-    {
-        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
-        return;
-    }
-
-    OicSecCred_t * temp = NULL;
-    key->len = 0;
-    LL_FOREACH(gCred, temp)
+    for (const CredIndexEntry *entry = entries; entry; entry = entry->nextByUsage)
     {
+        const OicSecCred_t *temp = entry->cred;
         if ((SIGNED_ASYMMETRIC_KEY == temp->credType || ASYMMETRIC_KEY == temp->credType) &&
             temp->privateData.len > 0 &&
             NULL != temp->credUsage &&
@@ -4022,6 +4396,21 @@ void GetDerKey(ByteArray_t * key, const char * usage)
             }
         }
     }
+}
+
+void GetDerKey(ByteArray_t * key, const char * usage)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+    if (NULL == key || NULL == usage)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+        return;
+    }
+
+    key->len = 0;
+    LockCredIndex();
+    CopyDerKey(key, GetIndexedCredsByUsage(usage), usage);
+    UnlockCredIndex();
     if(0 == key->len)
     {
         OIC_LOG_V(WARNING, TAG, "Key for %s not found", usage);
@@ -4029,17 +4418,14 @@ void GetDerKey(ByteArray_t * key, const char * usage)
     OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
 }
 
-void GetPrimaryCertKey(ByteArray_t * key)
+/**
+ * Copies the private key of the first indexed PRIMARY_CERT credential that has one to key.
+ */
+static void CopyPrimaryCertKey(ByteArray_t *key, const CredIndexEntry *entries)
 {
-    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
-
-    VERIFY_NOT_NULL(TAG, key, ERROR);
-
-    key->len = 0;
-    OicSecCred_t * temp = NULL;
-
-    LL_FOREACH(gCred, temp)
+    for (const CredIndexEntry *entry = entries; entry; entry = entry->nextByUsage)
     {
+        const OicSecCred_t *temp = entry->cred;
         size_t length = temp->privateData.len;
 
         if ((SIGNED_ASYMMETRIC_KEY == temp->credType) &&
@@ -4104,6 +4490,19 @@ void GetPrimaryCertKey(ByteArray_t * key)
             }
         }
     }
+}
+
+void GetPrimaryCertKey(ByteArray_t * key)
+{
+    OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
+
+    VERIFY_NOT_NULL(TAG, key, ERROR);
+
+    key->len = 0;
+
+    LockCredIndex();
+    CopyPrimaryCertKey(key, GetIndexedCredsByUsage(PRIMARY_CERT));
+    UnlockCredIndex();
 
     if(0 == key->len)
     {
@@ -4123,53 +4522,60 @@ void InitCipherSuiteListInternal(bool * list, const char * usage, const char *de
         OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
         return;
     }
-    OicSecCred_t * temp = NULL;
-    LL_FOREACH(gCred, temp)
+    LockCredIndex();
+    const CredIndex *index = GetCredIndex();
+    if (NULL == index)
+    {
+        UnlockCredIndex();
+        OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
+        return;
+    }
+
+    if (index->hasPinPassword)
     {
-        switch (temp->credType)
+        list[0] = true;
+        OIC_LOG(DEBUG, TAG, "PIN_PASSWORD found");
+    }
+
+    if (index->hasSymmetricPairWiseKey && !list[0])
+    {
+        OicUuid_t uuid;
+
+        if (NULL == deviceId || deviceId[0] == '\0' ||
+            OC_STACK_OK != ConvertStrToUuid(deviceId, &uuid))
         {
-            case PIN_PASSWORD:
-            {
-                list[0] = true;
-                OIC_LOG(DEBUG, TAG, "PIN_PASSWORD found");
-                break;
-            }
-            case SYMMETRIC_PAIR_WISE_KEY:
+            list[0] = true;
+        }
+        else
+        {
+            for (const CredIndexEntry *entry = GetIndexedCredsBySubject(&uuid); entry;
+                 entry = entry->nextBySubject)
             {
-                OicUuid_t uuid;
-
-                if (NULL == deviceId || deviceId[0] == '\0' ||
-                    OC_STACK_OK != ConvertStrToUuid(deviceId, &uuid) ||
-                    0 == memcmp(uuid.id, temp->subject.id, sizeof(uuid.id)))
+                if (SYMMETRIC_PAIR_WISE_KEY == entry->cred->credType &&
+                    0 == memcmp(uuid.id, entry->cred->subject.id, sizeof(uuid.id)))
                 {
                     list[0] = true;
-                    OIC_LOG(DEBUG, TAG, "SYMMETRIC_PAIR_WISE_KEY found");
-                }
-                break;
-            }
-            case SIGNED_ASYMMETRIC_KEY:
-            {
-                if (NULL != temp->credUsage && 0 == strcmp(temp->credUsage, usage))
-                {
-                    list[1] = true;
-                    OIC_LOG_V(DEBUG, TAG, "SIGNED_ASYMMETRIC_KEY found for %s", usage);
+                    break;
                 }
-                break;
-            }
-            case SYMMETRIC_GROUP_KEY:
-            case ASYMMETRIC_KEY:
-            case ASYMMETRIC_ENCRYPTION_KEY:
-            {
-                OIC_LOG(WARNING, TAG, "Unsupported credential type for TLS.");
-                break;
-            }
-            default:
-            {
-                OIC_LOG(WARNING, TAG, "Unknown credential type for TLS.");
-                break;
             }
         }
+        if (list[0])
+        {
+            OIC_LOG(DEBUG, TAG, "SYMMETRIC_PAIR_WISE_KEY found");
+        }
     }
+
+    for (const CredIndexEntry *entry = GetIndexedCredsByUsage(usage); entry; entry = entry->nextByUsage)
+    {
+        if (SIGNED_ASYMMETRIC_KEY == entry->cred->credType)
+        {
+            list[1] = true;
+            OIC_LOG_V(DEBUG, TAG, "SIGNED_ASYMMETRIC_KEY found for %s", usage);
+            break;
+        }
+    }
+    UnlockCredIndex();
+
     OIC_LOG_V(DEBUG, TAG, "Out %s", __func__);
 }
 #endif
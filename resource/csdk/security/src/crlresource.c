@@ -32,6 +32,7 @@
 #include "oic_string.h"
 #include "crlresource.h"
 #include "ocpayloadcbor.h"
+#include "casecurityinterface.h"
 #include "mbedtls/base64.h"
 #include <time.h>
 
@@ -445,6 +446,10 @@ OCStackResult UpdateCRLResource(OicSecCrl_t *crl)
         OIC_LOG(ERROR, TAG, "Can't update global crl");
         return OC_STACK_ERROR;
     }
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    // the TLS adapter has to parse the new CRL before the next handshake
+    CAnotifyPkixInfoChanged();
+#endif
 
     char currentTime[32] = {0};
     getCurrentUTCTime(currentTime, sizeof(currentTime));
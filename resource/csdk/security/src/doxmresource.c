@@ -788,6 +788,28 @@ exit:
     return ret;
 }
 
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+/**
+ * Lets the TLS adapter resume sessions only while no ownership transfer can take place,
+ * as its sessions are authenticated by a PIN, a manufacturer certificate or not at all.
+ * Sessions cached before are dropped in any case.
+ */
+static void UpdateSslSessionCache(const OicSecDoxm_t *doxm)
+{
+    bool enable = (NULL != doxm) && doxm->owned;
+#ifdef MULTIPLE_OWNER
+    if (enable && (NULL != doxm->mom) && (OIC_MULTIPLE_OWNER_DISABLE != doxm->mom->mode))
+    {
+        enable = false;
+    }
+#endif // MULTIPLE_OWNER
+    if (CA_STATUS_OK != CAEnableSslSessionCache(enable))
+    {
+        OIC_LOG(WARNING, TAG, "Failed to update the TLS session cache");
+    }
+}
+#endif // __WITH_DTLS__ or __WITH_TLS__
+
 /**
  * @todo document this function including why code might need to call this.
  * The current suspicion is that it's not being called as much as it should.
@@ -817,6 +839,10 @@ static bool UpdatePersistentStorage(OicSecDoxm_t * doxm)
         }
     }
 
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    UpdateSslSessionCache(doxm);
+#endif // __WITH_DTLS__ or __WITH_TLS__
+
     return bRet;
 }
 
@@ -1935,6 +1961,7 @@ OCStackResult InitDoxmResource(void)
     }
     OIC_LOG_V(INFO, TAG, "%s: Anon Ciphersuite %sENABLED.", __func__,
         isAnonEnabled ? "" : "NOT ");
+    UpdateSslSessionCache(gDoxm);
 #endif // __WITH_DTLS__ or __WITH_TLS__
 
     return ret;
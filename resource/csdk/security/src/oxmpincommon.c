@@ -429,6 +429,77 @@ int DerivePSKUsingPIN(uint8_t* result)
     return dtlsRes;
 }
 
+/**
+ * Loads the preconfigured PIN of the wildcard credential, if there is one, to derive
+ * the PSK from. The credential is copied, since the handshake runs on the adapter thread
+ * while the stack thread may remove it.
+ *
+ * @return false if the credential could not be loaded.
+ */
+static bool LoadPreconfigPin(void)
+{
+    bool ret = false;
+    unsigned char* pinBuffer = NULL;
+    size_t pinLength = 0;
+    OicSecCred_t* cred = GetCredEntryBySubject(&WILDCARD_SUBJECT_ID);
+    if (NULL == cred)
+    {
+        return true;
+    }
+
+    if(OIC_ENCODING_RAW == cred->privateData.encoding)
+    {
+        pinBuffer = (unsigned char*)OICCalloc(1, cred->privateData.len + 1);
+        if(NULL == pinBuffer)
+        {
+            OIC_LOG (ERROR, TAG, "Failed to allocate memory");
+            goto exit;
+        }
+        pinLength = cred->privateData.len;
+        memcpy(pinBuffer, cred->privateData.data, pinLength);
+    }
+    else if(OIC_ENCODING_BASE64 == cred->privateData.encoding)
+    {
+        int decodeResult = mbedtls_base64_decode(NULL, 0, &pinLength, cred->privateData.data, cred->privateData.len);
+        if (MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL != decodeResult)
+        {
+            OIC_LOG(ERROR, TAG, "Base64 decoding failed");
+            goto exit;
+        }
+        size_t pinBufSize = pinLength;
+        pinBuffer = (unsigned char*)OICCalloc(1, pinBufSize);
+        if(NULL == pinBuffer)
+        {
+            OIC_LOG (ERROR, TAG, "Failed to allocate memory");
+            goto exit;
+        }
+
+        if(0 != mbedtls_base64_decode(pinBuffer, pinBufSize, &pinLength, cred->privateData.data, cred->privateData.len))
+        {
+            OIC_LOG (ERROR, TAG, "Failed to base64 decoding.");
+            goto exit;
+        }
+    }
+    else
+    {
+        OIC_LOG(ERROR, TAG, "Unknown encoding type of PIN/PW credential.");
+        goto exit;
+    }
+
+    if (g_PinOxmData.pinSize < pinLength)
+    {
+        OIC_LOG (ERROR, TAG, "PIN length too long");
+        goto exit;
+    }
+    memcpy(g_PinOxmData.pinData, pinBuffer, pinLength);
+    ret = true;
+
+exit:
+    OICFree(pinBuffer);
+    FreeCred(cred);
+    return ret;
+}
+
 int32_t GetDtlsPskForRandomPinOxm( CADtlsPskCredType_t type,
               const unsigned char *UNUSED1, size_t UNUSED2,
               unsigned char *result, size_t result_length)
@@ -591,63 +662,10 @@ int32_t GetDtlsPskForPreconfPinOxm( CADtlsPskCredType_t type,
 
             case CA_DTLS_PSK_KEY:
                 {
-                    OicUuid_t uuid;
-                    memcpy(&uuid, &WILDCARD_SUBJECT_ID, sizeof(uuid));
-
                     //Load PreConfigured-PIN
-                    const OicSecCred_t* cred = GetCredResourceData(&uuid);
-                    if(cred)
+                    if (!LoadPreconfigPin())
                     {
-                        unsigned char* pinBuffer = NULL;
-                        size_t pinLength = 0;
-                        if(OIC_ENCODING_RAW == cred->privateData.encoding)
-                        {
-                            pinBuffer = (unsigned char*)OICCalloc(1, cred->privateData.len + 1);
-                            if(NULL == pinBuffer)
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to allocate memory");
-                                return ret;
-                            }
-                            pinLength = cred->privateData.len;
-                            memcpy(pinBuffer, cred->privateData.data, pinLength);
-                        }
-                        else if(OIC_ENCODING_BASE64 == cred->privateData.encoding)
-                        {
-                            int decodeResult = mbedtls_base64_decode(NULL, 0, &pinLength, cred->privateData.data, cred->privateData.len);
-                            if (MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL != decodeResult)
-                            {
-                                OIC_LOG(ERROR, TAG, "Base64 decoding failed");
-                                return ret;
-                            }
-                            size_t pinBufSize = pinLength;
-                            pinBuffer = (unsigned char*)OICCalloc(1, pinBufSize);
-                            if(NULL == pinBuffer)
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to allocate memory");
-                                return ret;
-                            }
-
-                            if(0 != mbedtls_base64_decode(pinBuffer, pinBufSize, &pinLength, cred->privateData.data, cred->privateData.len))
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to base64 decoding.");
-                                OICFree(pinBuffer);
-                                return ret;
-                            }
-                        }
-                        else
-                        {
-                            OIC_LOG(ERROR, TAG, "Unknown encoding type of PIN/PW credential.");
-                            return ret;
-                        }
-
-                        if (g_PinOxmData.pinSize < pinLength)
-                        {
-                            OIC_LOG (ERROR, TAG, "PIN length too long");
-                            OICFree(pinBuffer);
-                            return ret;
-                        }
-                        memcpy(g_PinOxmData.pinData, pinBuffer, pinLength);
-                        OICFree(pinBuffer);
+                        return ret;
                     }
 
                     if(0 == DerivePSKUsingPIN((uint8_t*)result))
@@ -703,63 +721,10 @@ int32_t GetDtlsPskForMotPreconfPinOxm( CADtlsPskCredType_t type,
                 break;
             case CA_DTLS_PSK_KEY:
                 {
-                    OicUuid_t uuid;
-                    memcpy(&uuid, &WILDCARD_SUBJECT_ID, sizeof(uuid));
-
                     //Load PreConfigured-PIN
-                    const OicSecCred_t* cred = GetCredResourceData(&uuid);
-                    if(cred)
+                    if (!LoadPreconfigPin())
                     {
-                        unsigned char* pinBuffer = NULL;
-                        size_t pinLength = 0;
-                        if(OIC_ENCODING_RAW == cred->privateData.encoding)
-                        {
-                            pinBuffer = (unsigned char*)OICCalloc(1, cred->privateData.len + 1);
-                            if(NULL == pinBuffer)
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to allocate memory");
-                                return ret;
-                            }
-                            pinLength = cred->privateData.len;
-                            memcpy(pinBuffer, cred->privateData.data, pinLength);
-                        }
-                        else if(OIC_ENCODING_BASE64 == cred->privateData.encoding)
-                        {
-                            int decodeResult = mbedtls_base64_decode(NULL, 0, &pinLength, cred->privateData.data, cred->privateData.len);
-                            if ( MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL != decodeResult)
-                            {
-                                OIC_LOG(ERROR, TAG, "Failed base64 decoding");
-                                return ret;
-                            }
-                            size_t pinBufSize = pinLength;
-                            pinBuffer = (unsigned char*)OICCalloc(1, pinBufSize);
-                            if(NULL == pinBuffer)
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to allocate memory");
-                                return ret;
-                            }
-
-                            if(0 != mbedtls_base64_decode(pinBuffer, pinBufSize, &pinLength, cred->privateData.data, cred->privateData.len))
-                            {
-                                OIC_LOG (ERROR, TAG, "Failed to base64 decoding.");
-                                OICFree(pinBuffer);
-                                return ret;
-                            }
-                        }
-                        else
-                        {
-                            OIC_LOG(ERROR, TAG, "Unknown encoding type of PIN/PW credential.");
-                            return ret;
-                        }
-
-                        if (g_PinOxmData.pinSize < pinLength)
-                        {
-                            OIC_LOG (ERROR, TAG, "PIN length is too long");
-                            OICFree(pinBuffer);
-                            return ret;
-                        }
-                        memcpy(g_PinOxmData.pinData, pinBuffer, pinLength);
-                        OICFree(pinBuffer);
+                        return ret;
                     }
 
                     if(0 == DerivePSKUsingPIN((uint8_t*)result))
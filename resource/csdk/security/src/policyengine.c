@@ -22,6 +22,7 @@
 
 #include "utlist.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "experimental/ocrandom.h"
 #include "policyengine.h"
 #include "resourcemanager.h"
@@ -39,6 +40,98 @@
 
 #define TAG "OIC_SRM_PE"
 
+/**
+ * Number of recent access decisions remembered by the policy engine.
+ */
+#ifndef PE_DECISION_CACHE_SIZE
+#define PE_DECISION_CACHE_SIZE 16
+#endif
+
+/** Marks the end of a chain of compiled ACEs. */
+#define PE_NO_ACE SIZE_MAX
+
+/**
+ * Number of asserted roles whose ACEs are looked up without allocating.
+ */
+#ifndef PE_ROLE_CURSORS
+#define PE_ROLE_CURSORS 8
+#endif
+
+/**
+ * A resource of a compiled ACE.
+ */
+typedef struct PECompiledRsrc
+{
+    uint32_t                hash;                   // hash of href
+    const char              *href;                  // href of the resource, owned by the ACE
+} PECompiledRsrc_t;
+
+/**
+ * An ACE of the compiled ACL, with its resources in a form that is cheap to match.
+ */
+typedef struct PECompiledAce
+{
+    const OicSecAce_t       *ace;                   // the ACE in gAcl
+    size_t                  nextInBucket;           // next ACE of the same subject bucket
+    size_t                  firstRsrc;              // resources with an href
+    size_t                  rsrcCount;
+    bool                    anyHref;                // has the "*" href
+    bool                    allNcrs;                // has the "*" wildcard
+    bool                    discoverableSecureNcrs; // has the "+" wildcard
+    bool                    discoverableNonsecureNcrs; // has the "-" wildcard
+} PECompiledAce_t;
+
+/**
+ * The ACL, compiled into chains of ACEs by subject.
+ *
+ * ACEs whose subjects (uuid, role or conntype) hash to the same bucket are
+ * chained in the order of the ACL, so that walking a chain visits the ACEs of
+ * a subject in the same order as a walk of the whole ACL would.
+ */
+typedef struct PECompiledAcl
+{
+    bool                    valid;                  // built for generation
+    uint32_t                generation;             // generation of the ACL it was built from
+    PECompiledAce_t         *aces;
+    size_t                  aceCount;
+    PECompiledRsrc_t        *rsrcs;
+    size_t                  *buckets;               // first ACE of each bucket
+    size_t                  bucketCount;            // power of two
+} PECompiledAcl_t;
+
+/**
+ * The subject of a request as ACEs name it.
+ */
+typedef struct PESubject
+{
+    OicSecAceSubjectType    type;
+    const OicUuid_t         *uuid;                  // for OicSecAceUuidSubject
+    const OicSecRole_t      *role;                  // for OicSecAceRoleSubject
+    OicSecConntype_t        conntype;               // for OicSecAceConntypeSubject
+} PESubject_t;
+
+/**
+ * A recent result of the conntype and subject ACEs for a request.
+ */
+typedef struct PEDecision
+{
+    bool                    used;
+    uint32_t                lastUsed;               // value of gDecisionClock when last hit
+    uint32_t                uriHash;
+    OicUuid_t               subjectUuid;
+    uint16_t                requestedPermission;
+    bool                    secureChannel;
+    bool                    resourceIsOcSecure;
+    bool                    resourceIsOcNonsecure;
+    OicSecDiscoverable_t    discoverable;
+    char                    resourceUri[MAX_URI_LENGTH + 1];
+    SRMAccessResponse_t     responseVal;
+} PEDecision_t;
+
+static PECompiledAcl_t gCompiledAcl = { false, 0, NULL, 0, NULL, NULL, 0 };
+static PEDecision_t gDecisions[PE_DECISION_CACHE_SIZE];
+static uint32_t gDecisionClock = 0;
+
 uint16_t GetPermissionFromCAMethod_t(const CAMethod_t method)
 {
     uint16_t perm = 0;
@@ -580,80 +673,309 @@ static bool IsAccessWithinValidTime(const OicSecAce_t *ace)
 }
 
 /**
- * Check whether 'resource' is in the passed ACE.
- *
- * @param[in] context Context->resourceUri contains the Resource being checked,
- *                    as well as the discoverability of the Resource.
- * @param[in] ace The ACE to check.
- *
- * @return true if match found, otherwise false.
+ * FNV-1a hash of 'size' bytes, continuing from 'hash'.
  */
-static bool IsResourceInAce(SRMRequestContext_t *context, const OicSecAce_t *ace)
+static uint32_t Hash(uint32_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t HashString(const char *string)
+{
+    return Hash(2166136261u, string, strlen(string));
+}
+
+static uint32_t HashSubject(const PESubject_t *subject)
+{
+    uint32_t hash = Hash(2166136261u, &subject->type, sizeof(subject->type));
+    switch (subject->type)
+    {
+        case OicSecAceUuidSubject:
+            hash = Hash(hash, subject->uuid->id, sizeof(subject->uuid->id));
+            break;
+        case OicSecAceRoleSubject:
+            hash = Hash(hash, subject->role->id,
+                        strnlen(subject->role->id, sizeof(subject->role->id)));
+            hash = Hash(hash, subject->role->authority,
+                        strnlen(subject->role->authority, sizeof(subject->role->authority)));
+            break;
+        case OicSecAceConntypeSubject:
+            hash = Hash(hash, &subject->conntype, sizeof(subject->conntype));
+            break;
+    }
+    return hash;
+}
+
+static PESubject_t GetAceSubject(const OicSecAce_t *ace)
 {
-    if (NULL == context || NULL == ace)
+    PESubject_t subject = { ace->subjectType, NULL, NULL, AUTH_CRYPT };
+    switch (ace->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            subject.uuid = &ace->subjectuuid;
+            break;
+        case OicSecAceRoleSubject:
+            subject.role = &ace->subjectRole;
+            break;
+        case OicSecAceConntypeSubject:
+            subject.conntype = ace->subjectConn;
+            break;
+    }
+    return subject;
+}
+
+/**
+ * Compare the subject of an ACE to the subject of a request, the same way
+ * GetACLResourceData(), GetACLResourceDataByRoles() and
+ * GetACLResourceDataByConntype() do.
+ */
+static bool IsAceForSubject(const OicSecAce_t *ace, const PESubject_t *subject)
+{
+    if (ace->subjectType != subject->type)
     {
         return false;
     }
+    switch (subject->type)
+    {
+        case OicSecAceUuidSubject:
+            return (0 == memcmp(&ace->subjectuuid, subject->uuid, sizeof(OicUuid_t)));
+        case OicSecAceRoleSubject:
+            return ((0 == strcmp(ace->subjectRole.id, subject->role->id)) &&
+                    (0 == strcmp(ace->subjectRole.authority, subject->role->authority)));
+        case OicSecAceConntypeSubject:
+            return (ace->subjectConn == subject->conntype);
+    }
+    return false;
+}
+
+static void FreeCompiledAcl(void)
+{
+    OICFree(gCompiledAcl.aces);
+    OICFree(gCompiledAcl.rsrcs);
+    OICFree(gCompiledAcl.buckets);
+    memset(&gCompiledAcl, 0, sizeof(gCompiledAcl));
+}
+
+static void ClearDecisions(void)
+{
+    memset(gDecisions, 0, sizeof(gDecisions));
+    gDecisionClock = 0;
+}
+
+/**
+ * Get the compiled ACL, compiling the ACL first if it changed since the last call.
+ *
+ * @return the compiled ACL, or NULL if there is not enough memory to compile it.
+ */
+static const PECompiledAcl_t *GetCompiledAcl(void)
+{
+    uint32_t generation = 0;
+    const OicSecAce_t *aces = GetACLResourceAces(&generation);
+
+    if (gCompiledAcl.valid && (gCompiledAcl.generation == generation))
+    {
+        return &gCompiledAcl;
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "%s: compiling ACL generation %u", __func__, generation);
+    FreeCompiledAcl();
+    ClearDecisions();
 
-    OicSecRsrc_t* rsrc = NULL;
-    LL_FOREACH(ace->resources, rsrc)
+    size_t aceCount = 0;
+    size_t rsrcCount = 0;
+    const OicSecAce_t *ace = NULL;
+    const OicSecRsrc_t *rsrc = NULL;
+    LL_FOREACH(aces, ace)
     {
-        if (NULL == rsrc->href)
+        aceCount++;
+        LL_FOREACH(ace->resources, rsrc)
         {
-            if (NO_WILDCARD != rsrc->wildcard)
+            rsrcCount++;
+        }
+    }
+
+    size_t bucketCount = 1;
+    while (bucketCount < 2 * aceCount)
+    {
+        bucketCount <<= 1;
+    }
+
+    gCompiledAcl.buckets = (size_t *)OICMalloc(bucketCount * sizeof(size_t));
+    if (0 < aceCount)
+    {
+        gCompiledAcl.aces = (PECompiledAce_t *)OICCalloc(aceCount, sizeof(PECompiledAce_t));
+    }
+    if (0 < rsrcCount)
+    {
+        gCompiledAcl.rsrcs = (PECompiledRsrc_t *)OICCalloc(rsrcCount, sizeof(PECompiledRsrc_t));
+    }
+    if ((NULL == gCompiledAcl.buckets) ||
+        ((0 < aceCount) && (NULL == gCompiledAcl.aces)) ||
+        ((0 < rsrcCount) && (NULL == gCompiledAcl.rsrcs)))
+    {
+        OIC_LOG(ERROR, TAG, "Failed to allocate the compiled ACL");
+        FreeCompiledAcl();
+        return NULL;
+    }
+
+    for (size_t i = 0; i < bucketCount; i++)
+    {
+        gCompiledAcl.buckets[i] = PE_NO_ACE;
+    }
+    gCompiledAcl.bucketCount = bucketCount;
+
+    size_t a = 0;
+    size_t r = 0;
+    LL_FOREACH(aces, ace)
+    {
+        PECompiledAce_t *compiled = &gCompiledAcl.aces[a++];
+        compiled->ace = ace;
+        compiled->firstRsrc = r;
+        LL_FOREACH(ace->resources, rsrc)
+        {
+            if (NULL != rsrc->href)
             {
-                if  (IsNonConfigurationResourceUri(context->resourceUri) &&
-                        (
-                            // "*" matches all NCRs
-                            (
-                                (ALL_NCRS == rsrc->wildcard)
-                            ) ||
-                            // "+" matches all discoverable NCRs that expose at least one Secure Endpoint
-                            (
-                                (ALL_DISCOVERABLE_NCRS_WITH_OC_SECURE == rsrc->wildcard) &&
-                                (DISCOVERABLE_TRUE == context->discoverable) &&
-                                (true == context->resourceIsOcSecure)
-                            ) ||
-                            // "-" matches all discoverable NCRs that expose at least one Unsecure Endpoint
-                            (
-                                (ALL_DISCOVERABLE_NCRS_WITH_OC_NONSECURE == rsrc->wildcard) &&
-                                (DISCOVERABLE_TRUE == context->discoverable) &&
-                                (true == context->resourceIsOcNonsecure)
-                            )
-                        )
-                    )
+                if (0 == strcmp(WILDCARD_RESOURCE_URI, rsrc->href))
                 {
-                    OIC_LOG_V(DEBUG, TAG, "%s: found wc type %d matching resource.",
-                        __func__, rsrc->wildcard);
-                    return true;
+                    compiled->anyHref = true;
                 }
+                gCompiledAcl.rsrcs[r].hash = HashString(rsrc->href);
+                gCompiledAcl.rsrcs[r].href = rsrc->href;
+                r++;
+            }
+            else if (ALL_NCRS == rsrc->wildcard)
+            {
+                compiled->allNcrs = true;
+            }
+            else if (ALL_DISCOVERABLE_NCRS_WITH_OC_SECURE == rsrc->wildcard)
+            {
+                compiled->discoverableSecureNcrs = true;
+            }
+            else if (ALL_DISCOVERABLE_NCRS_WITH_OC_NONSECURE == rsrc->wildcard)
+            {
+                compiled->discoverableNonsecureNcrs = true;
             }
         }
-        else if (0 == strcmp(context->resourceUri, rsrc->href) ||
-                 0 == strcmp(WILDCARD_RESOURCE_URI, rsrc->href))
+        compiled->rsrcCount = r - compiled->firstRsrc;
+    }
+    gCompiledAcl.aceCount = aceCount;
+
+    // Prepend from the last ACE so that each chain is in ACL order.
+    for (size_t i = aceCount; i > 0; i--)
+    {
+        PESubject_t subject = GetAceSubject(gCompiledAcl.aces[i - 1].ace);
+        size_t *bucket = &gCompiledAcl.buckets[HashSubject(&subject) & (bucketCount - 1)];
+        gCompiledAcl.aces[i - 1].nextInBucket = *bucket;
+        *bucket = i - 1;
+    }
+
+    gCompiledAcl.generation = generation;
+    gCompiledAcl.valid = true;
+    return &gCompiledAcl;
+}
+
+/**
+ * Get the next ACE of 'subject' in the compiled ACL.
+ *
+ * @param acl is the compiled ACL.
+ * @param subject is the subject to look for.
+ * @param bucket is the bucket of 'subject'.
+ * @param from is the index of the previous ACE returned, or PE_NO_ACE for the first call.
+ *
+ * @return index of the next ACE of 'subject', or PE_NO_ACE if there is none.
+ */
+static size_t GetNextAceForSubject(const PECompiledAcl_t *acl, const PESubject_t *subject,
+    size_t bucket, size_t from)
+{
+    size_t i = (PE_NO_ACE == from) ? acl->buckets[bucket] : acl->aces[from].nextInBucket;
+    while ((PE_NO_ACE != i) && !IsAceForSubject(acl->aces[i].ace, subject))
+    {
+        i = acl->aces[i].nextInBucket;
+    }
+    return i;
+}
+
+/**
+ * Check whether 'resource' is in the passed ACE.
+ *
+ * @param[in] context Context->resourceUri contains the Resource being checked,
+ *                    as well as the discoverability of the Resource.
+ * @param[in] uriHash Hash of context->resourceUri.
+ * @param[in] acl The compiled ACL.
+ * @param[in] compiled The compiled ACE to check.
+ *
+ * @return true if match found, otherwise false.
+ */
+static bool IsResourceInAce(SRMRequestContext_t *context, uint32_t uriHash,
+    const PECompiledAcl_t *acl, const PECompiledAce_t *compiled)
+{
+    if (compiled->anyHref)
+    {
+        OIC_LOG_V(DEBUG, TAG, "%s: found href %s matching resource.",
+                    __func__, WILDCARD_RESOURCE_URI);
+        return true;
+    }
+
+    for (size_t i = compiled->firstRsrc; i < compiled->firstRsrc + compiled->rsrcCount; i++)
+    {
+        if ((uriHash == acl->rsrcs[i].hash) &&
+            (0 == strcmp(context->resourceUri, acl->rsrcs[i].href)))
         {
             OIC_LOG_V(DEBUG, TAG, "%s: found href %s matching resource.",
-                        __func__, rsrc->href);
+                        __func__, acl->rsrcs[i].href);
+            return true;
+        }
+    }
+
+    if (compiled->allNcrs ||
+        // "+" matches all discoverable NCRs that expose at least one Secure Endpoint
+        (compiled->discoverableSecureNcrs &&
+         (DISCOVERABLE_TRUE == context->discoverable) &&
+         (true == context->resourceIsOcSecure)) ||
+        // "-" matches all discoverable NCRs that expose at least one Unsecure Endpoint
+        (compiled->discoverableNonsecureNcrs &&
+         (DISCOVERABLE_TRUE == context->discoverable) &&
+         (true == context->resourceIsOcNonsecure)))
+    {
+        if (IsNonConfigurationResourceUri(context->resourceUri))
+        {
+            OIC_LOG_V(DEBUG, TAG, "%s: found wildcard matching resource.", __func__);
             return true;
         }
     }
     return false;
 }
 
-static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *currentAce)
+/**
+ * @param[in,out] timeDependent is set if the result depends on the time of the request.
+ */
+static void ProcessMatchingACE(SRMRequestContext_t *context, uint32_t uriHash,
+    const PECompiledAcl_t *acl, const PECompiledAce_t *compiled, bool *timeDependent)
 {
+    const OicSecAce_t *currentAce = compiled->ace;
+
     // Found the subject, so how about resource?
     OIC_LOG_V(DEBUG, TAG, "%s: found ACE matching subject.", __func__);
 
     // Subject was found, so err changes to Rsrc not found for now.
     context->responseVal = ACCESS_DENIED_RESOURCE_NOT_FOUND;
     OIC_LOG_V(DEBUG, TAG, "%s: Searching for resource...", __func__);
-    if (IsResourceInAce(context, currentAce))
+    if (IsResourceInAce(context, uriHash, acl, compiled))
     {
         OIC_LOG_V(INFO, TAG, "%s: found matching resource in ACE.", __func__);
 
         // Found the resource, so it's down to valid period & permission.
         context->responseVal = ACCESS_DENIED_INVALID_PERIOD;
+        if (NULL != currentAce->validities)
+        {
+            *timeDependent = true;
+        }
         if (IsAccessWithinValidTime(currentAce))
         {
             context->responseVal = ACCESS_DENIED_INSUFFICIENT_PERMISSION;
@@ -666,10 +988,166 @@ static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *
     }
 }
 
+/**
+ * Process the ACEs of 'subject' in ACL order until one grants access.
+ *
+ * @return true if an ACE of 'subject' was found.
+ */
+static bool ProcessSubjectAces(SRMRequestContext_t *context, uint32_t uriHash,
+    const PECompiledAcl_t *acl, const PESubject_t *subject, bool *timeDependent)
+{
+    size_t bucket = HashSubject(subject) & (acl->bucketCount - 1);
+    size_t i = GetNextAceForSubject(acl, subject, bucket, PE_NO_ACE);
+    bool found = (PE_NO_ACE != i);
+
+    while ((PE_NO_ACE != i) && !IsAccessGranted(context->responseVal))
+    {
+        ProcessMatchingACE(context, uriHash, acl, &acl->aces[i], timeDependent);
+        i = GetNextAceForSubject(acl, subject, bucket, i);
+    }
+    return found;
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+/**
+ * Process the ACEs of any of 'roles' in ACL order until one grants access.
+ * The chains of the roles are merged so that an ACE is processed once, in the
+ * same order as GetACLResourceDataByRoles() returns them.
+ */
+static void ProcessRoleAces(SRMRequestContext_t *context, uint32_t uriHash,
+    const PECompiledAcl_t *acl, const OicSecRole_t *roles, size_t roleCount,
+    bool *timeDependent)
+{
+    size_t bucketBuffer[PE_ROLE_CURSORS];
+    size_t cursorBuffer[PE_ROLE_CURSORS];
+    size_t *buckets = bucketBuffer;
+    size_t *cursors = cursorBuffer;
+
+    if (PE_ROLE_CURSORS < roleCount)
+    {
+        buckets = (size_t *)OICCalloc(roleCount, sizeof(size_t));
+        cursors = (size_t *)OICCalloc(roleCount, sizeof(size_t));
+        if ((NULL == buckets) || (NULL == cursors))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate role cursors");
+            OICFree(buckets);
+            OICFree(cursors);
+            return;
+        }
+    }
+
+    for (size_t r = 0; r < roleCount; r++)
+    {
+        PESubject_t subject = { OicSecAceRoleSubject, NULL, &roles[r], AUTH_CRYPT };
+        buckets[r] = HashSubject(&subject) & (acl->bucketCount - 1);
+        cursors[r] = GetNextAceForSubject(acl, &subject, buckets[r], PE_NO_ACE);
+    }
+
+    while (!IsAccessGranted(context->responseVal))
+    {
+        size_t next = PE_NO_ACE;
+        for (size_t r = 0; r < roleCount; r++)
+        {
+            if (cursors[r] < next)
+            {
+                next = cursors[r];
+            }
+        }
+        if (PE_NO_ACE == next)
+        {
+            OIC_LOG_V(INFO, TAG, "%s:no ACL found matching roles for resource %s",
+                __func__, context->resourceUri);
+            break;
+        }
+
+        ProcessMatchingACE(context, uriHash, acl, &acl->aces[next], timeDependent);
+
+        for (size_t r = 0; r < roleCount; r++)
+        {
+            if (cursors[r] == next)
+            {
+                PESubject_t subject = { OicSecAceRoleSubject, NULL, &roles[r], AUTH_CRYPT };
+                cursors[r] = GetNextAceForSubject(acl, &subject, buckets[r], next);
+            }
+        }
+    }
+
+    if (bucketBuffer != buckets)
+    {
+        OICFree(buckets);
+        OICFree(cursors);
+    }
+}
+#endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
+
+static bool IsSameRequest(const PEDecision_t *decision, const SRMRequestContext_t *context,
+    uint32_t uriHash)
+{
+    return decision->used &&
+           (decision->uriHash == uriHash) &&
+           (decision->requestedPermission == context->requestedPermission) &&
+           (decision->secureChannel == context->secureChannel) &&
+           (decision->resourceIsOcSecure == context->resourceIsOcSecure) &&
+           (decision->resourceIsOcNonsecure == context->resourceIsOcNonsecure) &&
+           (decision->discoverable == context->discoverable) &&
+           (0 == memcmp(&decision->subjectUuid, &context->subjectUuid, sizeof(OicUuid_t))) &&
+           (0 == strcmp(decision->resourceUri, context->resourceUri));
+}
+
+static const PEDecision_t *GetDecision(const SRMRequestContext_t *context, uint32_t uriHash)
+{
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE; i++)
+    {
+        if (IsSameRequest(&gDecisions[i], context, uriHash))
+        {
+            gDecisions[i].lastUsed = ++gDecisionClock;
+            return &gDecisions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Remember a decision, replacing the least recently used one.
+ */
+static void AddDecision(const SRMRequestContext_t *context, uint32_t uriHash)
+{
+    PEDecision_t *decision = &gDecisions[0];
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE; i++)
+    {
+        if (!gDecisions[i].used)
+        {
+            decision = &gDecisions[i];
+            break;
+        }
+        if (gDecisions[i].lastUsed < decision->lastUsed)
+        {
+            decision = &gDecisions[i];
+        }
+    }
+
+    decision->used = true;
+    decision->lastUsed = ++gDecisionClock;
+    decision->uriHash = uriHash;
+    decision->subjectUuid = context->subjectUuid;
+    decision->requestedPermission = context->requestedPermission;
+    decision->secureChannel = context->secureChannel;
+    decision->resourceIsOcSecure = context->resourceIsOcSecure;
+    decision->resourceIsOcNonsecure = context->resourceIsOcNonsecure;
+    decision->discoverable = context->discoverable;
+    OICStrcpy(decision->resourceUri, sizeof(decision->resourceUri), context->resourceUri);
+    decision->responseVal = context->responseVal;
+}
+
 /**
  * Search for an ACE that matches the Resource URI, by conntype, subjectuuid, or roles.
  * For each matching ACE, check whether it grants permission.
  * If any ACE grants permission, set responseVal to ACCESS_GRANTED.
+ *
+ * The result of the conntype and subjectuuid ACEs is remembered until the ACL
+ * changes, unless it depends on the validity period of an ACE. Role ACEs are
+ * processed for every request, as the roles asserted by an endpoint can change
+ * without the ACL changing.
  */
 static void ProcessAccessRequest(SRMRequestContext_t *context)
 {
@@ -681,66 +1159,62 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
 
     OIC_LOG_V(DEBUG, TAG, "Entering %s(%s)", __func__, context->resourceUri);
 
-    const OicSecAce_t *currentAce = NULL;
-    OicSecAce_t *aceSavePtr = NULL;
+    const PECompiledAcl_t *acl = GetCompiledAcl();
+    if (NULL == acl)
+    {
+        context->responseVal = ACCESS_DENIED_POLICY_ENGINE_ERROR;
+        return;
+    }
 
-    // Start out assuming subject not found.
-    context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
+    uint32_t uriHash = HashString(context->resourceUri);
+    bool timeDependent = false;
 
-    // First, check for a conntype ACE that matches.
-    OicSecConntype_t conntype;
-    if (context->secureChannel)
+    const PEDecision_t *decision = GetDecision(context, uriHash);
+    if (NULL != decision)
     {
-        conntype = AUTH_CRYPT;
+        OIC_LOG_V(DEBUG, TAG, "%s: using remembered decision", __func__);
+        context->responseVal = decision->responseVal;
     }
     else
     {
-        conntype = ANON_CLEAR;
-    }
-    do
-    {
-        currentAce = GetACLResourceDataByConntype(conntype, &aceSavePtr);
+        // Start out assuming subject not found.
+        context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
 
-        if (NULL != currentAce)
+        // First, check for a conntype ACE that matches.
+        PESubject_t subject = { OicSecAceConntypeSubject, NULL, NULL, ANON_CLEAR };
+        if (context->secureChannel)
         {
-            OIC_LOG_V(DEBUG, TAG, "%s: found conntype %s match; processing for access.",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"));
-            ProcessMatchingACE(context, currentAce);
+            subject.conntype = AUTH_CRYPT;
         }
-        else
+        if (!ProcessSubjectAces(context, uriHash, acl, &subject, &timeDependent))
         {
             OIC_LOG_V(INFO, TAG, "%s:no ACL found matching conntype %s for resource %s",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"), context->resourceUri);
+                __func__, (AUTH_CRYPT == subject.conntype?"auth-crypt":"anon-clear"),
+                context->resourceUri);
         }
-    } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
 
-    // If not granted via conntype, try Subject-based match.
-    if (!IsAccessGranted(context->responseVal))
-    {
-        currentAce = NULL;
-        aceSavePtr = NULL;
-        do
+        // If not granted via conntype, try Subject-based match.
+        if (!IsAccessGranted(context->responseVal))
         {
-            currentAce = GetACLResourceData(&context->subjectUuid, &aceSavePtr);
-
-            if (NULL != currentAce)
-            {
-                ProcessMatchingACE(context, currentAce);
-            }
-            else
+            subject.type = OicSecAceUuidSubject;
+            subject.uuid = &context->subjectUuid;
+            if (!ProcessSubjectAces(context, uriHash, acl, &subject, &timeDependent))
             {
                 OIC_LOG_V(INFO, TAG, "%s:no ACL found matching subject for resource %s",
                     __func__, context->resourceUri);
             }
-        } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+        }
+
+        if (!timeDependent)
+        {
+            AddDecision(context, uriHash);
+        }
     }
 
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
     // If no subject ACE granted access, try role ACEs.
     if (!IsAccessGranted(context->responseVal))
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
         OicSecRole_t *roles = NULL;
         size_t roleCount = 0;
         OCStackResult res = GetEndpointRoles(context->endPoint, &roles, &roleCount);
@@ -751,20 +1225,10 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
         else
         {
             OIC_LOG_V(DEBUG, TAG, "Found %u asserted roles for endpoint", (unsigned int) roleCount);
-            do
+            if ((NULL != roles) && (0 < roleCount))
             {
-                currentAce = GetACLResourceDataByRoles(roles, roleCount, &aceSavePtr);
-                if (NULL != currentAce)
-                {
-                    ProcessMatchingACE(context, currentAce);
-                }
-                else
-                {
-                    OIC_LOG_V(INFO, TAG, "%s:no ACL found matching roles for resource %s",
-                        __func__, context->resourceUri);
-                }
-            } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
-
+                ProcessRoleAces(context, uriHash, acl, roles, roleCount, &timeDependent);
+            }
             OICFree(roles);
         }
     }
@@ -775,6 +1239,12 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
     return;
 }
 
+void DeInitPolicyEngine(void)
+{
+    FreeCompiledAcl();
+    ClearDecisions();
+}
+
 void CheckPermission(SRMRequestContext_t *context)
 {
     assert(NULL != context);
@@ -28,6 +28,7 @@
 #include "ocpayloadcbor.h"
 #include "ocstack.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "experimental/payload_logging.h"
 #include "resourcemanager.h"
 #include "secureresourcemanager.h"
@@ -54,24 +55,85 @@
 const size_t DB_FILE_SIZE_BLOCK = 1023;
 #endif
 
-typedef enum _PSDatabase
+/*
+ * A database is a CBOR map from section names to CBOR payloads, optionally
+ * followed by a journal. Updating a section appends a journal record instead
+ * of rewriting the whole database. A journal record is an array holding the
+ * section name and its new payload, or null when the section was removed.
+ * Readers replay the journal over the map. Once the journal would grow past
+ * PS_JOURNAL_COMPACT_RATIO times the map, the update compacts the database
+ * back into a single map, so a full rewrite happens at most once every few
+ * updates even when one section, such as the cred list, is most of the database.
+ *
+ * A database written before the journal existed is a plain map, which is a
+ * database with an empty journal, and is read and updated as such.
+ *
+ * A record holds a whole section: resources such as the cred list encode all
+ * their entries on every update, so the bytes written per update still grow
+ * with the size of the section. Every update also reads the whole database to
+ * find the end of the journal.
+ */
+
+/**
+ * Number of fields of a journal record.
+ */
+#define PS_JOURNAL_RECORD_FIELDS 2
+
+/**
+ * The journal is never compacted while it is smaller than this.
+ */
+#define PS_JOURNAL_MIN_COMPACT_SIZE 4096
+
+/**
+ * The journal is compacted once it would grow past this many times the section map.
+ */
+#define PS_JOURNAL_COMPACT_RATIO 4
+
+/**
+ * Largest size of the CBOR headers of a journal record: the array header
+ * and the section name and payload string headers.
+ */
+#define PS_JOURNAL_RECORD_HEADERS_SIZE 19
+
+/**
+ * Initial capacity of a section list.
+ */
+#define PS_SECTION_LIST_CAPACITY 16
+
+/**
+ * A section of the database.
+ */
+typedef struct PSSection
+{
+    char *name;
+    uint8_t *payload;   /**< NULL if the section was removed. */
+    size_t size;
+} PSSection;
+
+/**
+ * The sections of the database, after replaying the journal.
+ */
+typedef struct PSSectionList
 {
-    PS_DATABASE_SECURITY = 0,
-    PS_DATABASE_DEVICEPROPERTIES
-} PSDatabase;
+    PSSection *sections;
+    size_t count;
+    size_t capacity;
+} PSSectionList;
 
 /**
  * Writes CBOR payload to the specified database in persistent storage.
  *
  * @param databaseName is the name of the database to access through persistent storage.
+ * @param mode         is "wb" to replace the database or "ab" to append to it.
  * @param payload      is the CBOR payload to write to the database in persistent storage.
  * @param size         is the size of payload.
  *
  * @return ::OC_STACK_OK for Success, otherwise some error value
  */
-static OCStackResult WritePayloadToPS(const char *databaseName, uint8_t *payload, size_t size)
+static OCStackResult WritePayloadToPS(const char *databaseName, const char *mode,
+                                      uint8_t *payload, size_t size)
 {
-    if (!databaseName || !payload || (size <= 0))
+    if (!databaseName || !mode || !payload || (size <= 0))
     {
         return OC_STACK_INVALID_PARAM;
     }
@@ -83,7 +145,7 @@ static OCStackResult WritePayloadToPS(const char *databaseName, uint8_t *payload
     OCPersistentStorage* ps = OCGetPersistentStorageHandler();
     if (ps)
     {
-        FILE *fp = ps->open(databaseName, "wb");
+        FILE *fp = ps->open(databaseName, mode);
         if (fp)
         {
             size_t numberItems = ps->write(payload, 1, size, fp);
@@ -138,9 +200,455 @@ static size_t GetDatabaseSize(const OCPersistentStorage *ps, const char *databas
     return size;
 }
 
+/**
+ * Reads the raw content of a database.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the data argument.
+ *
+ * @param ps           is a pointer to OCPersistentStorage for the Virtual Resource(s).
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param data         is set to the content of the database, NULL if it is empty.
+ * @param size         is set to the size of the database.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult ReadDatabaseFile(const OCPersistentStorage *ps, const char *databaseName,
+                                      uint8_t **data, size_t *size)
+{
+    FILE *fp = NULL;
+    uint8_t *fsData = NULL;
+    OCStackResult ret = OC_STACK_ERROR;
+
+    *data = NULL;
+    *size = 0;
+
+    size_t fileSize = GetDatabaseSize(ps, databaseName);
+    OIC_LOG_V(DEBUG, TAG, "File Read Size: %" PRIuPTR, fileSize);
+    if (0 == fileSize)
+    {
+        return OC_STACK_OK;
+    }
+
+    fsData = (uint8_t *) OICCalloc(1, fileSize);
+    VERIFY_NOT_NULL(TAG, fsData, ERROR);
+
+    fp = ps->open(databaseName, "rb");
+    VERIFY_NOT_NULL(TAG, fp, ERROR);
+    VERIFY_SUCCESS(TAG, ps->read(fsData, 1, fileSize, fp) == fileSize, ERROR);
+
+    *data = fsData;
+    *size = fileSize;
+    fsData = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    if (fp)
+    {
+        ps->close(fp);
+    }
+    OICFree(fsData);
+    return ret;
+}
+
+/**
+ * Gets the size of the section map at the head of the database.
+ *
+ * @return size of the section map, 0 if the database does not start with one.
+ */
+static size_t GetSectionMapSize(const uint8_t *data, size_t size)
+{
+    CborParser parser;  // will be initialized in |cbor_parser_init|
+    CborValue cbor;     // will be initialized in |cbor_parser_init|
+
+    if (!data || (CborNoError != cbor_parser_init(data, size, 0, &parser, &cbor)) ||
+        !cbor_value_is_map(&cbor) || (CborNoError != cbor_value_advance(&cbor)))
+    {
+        return 0;
+    }
+    return (size_t)(cbor_value_get_next_byte(&cbor) - data);
+}
+
+/**
+ * Parses the journal record at the head of data.
+ *
+ * @param data    is the start of the journal record.
+ * @param size    is the number of bytes available at data.
+ * @param parser  is the parser which name and payload refer to.
+ * @param name    is set to the section name of the record.
+ * @param payload is set to the section payload of the record, a CBOR null if the
+ *                section was removed.
+ *
+ * @return size of the record, 0 if data does not start with a complete record.
+ */
+static size_t ParseJournalRecord(const uint8_t *data, size_t size, CborParser *parser,
+                                 CborValue *name, CborValue *payload)
+{
+    CborValue record;  // will be initialized in |cbor_parser_init|
+    CborValue field;   // will be initialized in |cbor_value_enter_container|
+    size_t fields = 0;
+
+    if ((CborNoError != cbor_parser_init(data, size, 0, parser, &record)) ||
+        !cbor_value_is_array(&record) ||
+        (CborNoError != cbor_value_get_array_length(&record, &fields)) ||
+        (PS_JOURNAL_RECORD_FIELDS != fields) ||
+        (CborNoError != cbor_value_enter_container(&record, &field)) ||
+        !cbor_value_is_text_string(&field))
+    {
+        return 0;
+    }
+    *name = field;
+
+    if ((CborNoError != cbor_value_advance(&field)) ||
+        (!cbor_value_is_byte_string(&field) && !cbor_value_is_null(&field)))
+    {
+        return 0;
+    }
+    *payload = field;
+
+    if ((CborNoError != cbor_value_advance(&field)) ||
+        (CborNoError != cbor_value_leave_container(&record, &field)))
+    {
+        return 0;
+    }
+    return (size_t)(cbor_value_get_next_byte(&record) - data);
+}
+
+/**
+ * Gets the size of the complete journal records at the head of data.
+ * A record torn by an interrupted append ends the journal.
+ */
+static size_t GetJournalSize(const uint8_t *data, size_t size)
+{
+    size_t journalSize = 0;
+    while (journalSize < size)
+    {
+        CborParser parser;  // will be initialized in |ParseJournalRecord|
+        CborValue name;     // will be initialized in |ParseJournalRecord|
+        CborValue payload;  // will be initialized in |ParseJournalRecord|
+        size_t recordSize = ParseJournalRecord(data + journalSize, size - journalSize,
+                                               &parser, &name, &payload);
+        if (0 == recordSize)
+        {
+            break;
+        }
+        journalSize += recordSize;
+    }
+    return journalSize;
+}
+
+/**
+ * Frees the sections of a section list.
+ */
+static void FreeSectionList(PSSectionList *list)
+{
+    for (size_t i = 0; i < list->count; i++)
+    {
+        OICFree(list->sections[i].name);
+        OICFree(list->sections[i].payload);
+    }
+    OICFree(list->sections);
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * Sets the payload of a section, adding the section to the list if needed.
+ *
+ * @note The list takes ownership of name and payload, also on failure.
+ *
+ * @param list    is the section list to update.
+ * @param name    is the section name.
+ * @param payload is the section payload, NULL if the section was removed.
+ * @param size    is the size of payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult SetSection(PSSectionList *list, char *name, uint8_t *payload, size_t size)
+{
+    for (size_t i = 0; i < list->count; i++)
+    {
+        if (0 == strcmp(list->sections[i].name, name))
+        {
+            OICFree(name);
+            OICFree(list->sections[i].payload);
+            list->sections[i].payload = payload;
+            list->sections[i].size = size;
+            return OC_STACK_OK;
+        }
+    }
+
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? (2 * list->capacity) : PS_SECTION_LIST_CAPACITY;
+        PSSection *sections = (PSSection *) OICRealloc(list->sections, capacity * sizeof(PSSection));
+        if (!sections)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to grow the section list");
+            OICFree(name);
+            OICFree(payload);
+            return OC_STACK_NO_MEMORY;
+        }
+        list->sections = sections;
+        list->capacity = capacity;
+    }
+
+    list->sections[list->count].name = name;
+    list->sections[list->count].payload = payload;
+    list->sections[list->count].size = size;
+    list->count++;
+    return OC_STACK_OK;
+}
+
+/**
+ * Sets a section from the CBOR name and payload found in the database.
+ */
+static OCStackResult SetSectionFromCbor(PSSectionList *list, const CborValue *nameValue,
+                                        const CborValue *payloadValue)
+{
+    char *name = NULL;
+    uint8_t *payload = NULL;
+    size_t len = 0;
+
+    if (CborNoError != cbor_value_dup_text_string(nameValue, &name, &len, NULL))
+    {
+        OIC_LOG(ERROR, TAG, "Failed Finding Section Name.");
+        return OC_STACK_ERROR;
+    }
+    if (cbor_value_is_byte_string(payloadValue) &&
+        (CborNoError != cbor_value_dup_byte_string(payloadValue, &payload, &len, NULL)))
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed Finding %s Value.", name);
+        OICFree(name);
+        return OC_STACK_ERROR;
+    }
+    return SetSection(list, name, payload, payload ? len : 0);
+}
+
+/**
+ * Loads the sections of the database, replaying its journal over its section map.
+ *
+ * @param data        is the content of the database.
+ * @param mapSize     is the size of the section map at the head of data.
+ * @param journalSize is the size of the complete journal records after the section map.
+ * @param list        is the section list to load the sections into.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult LoadSections(const uint8_t *data, size_t mapSize, size_t journalSize,
+                                  PSSectionList *list)
+{
+    OCStackResult ret = OC_STACK_ERROR;
+    CborParser parser;  // will be initialized in |cbor_parser_init|
+    CborValue cbor;     // will be initialized in |cbor_parser_init|
+    CborValue entry;    // will be initialized in |cbor_value_enter_container|
+
+    VERIFY_SUCCESS(TAG, CborNoError == cbor_parser_init(data, mapSize, 0, &parser, &cbor), ERROR);
+    VERIFY_SUCCESS(TAG, CborNoError == cbor_value_enter_container(&cbor, &entry), ERROR);
+    while (!cbor_value_at_end(&entry))
+    {
+        CborValue name = entry;
+        VERIFY_SUCCESS(TAG, cbor_value_is_text_string(&name), ERROR);
+        VERIFY_SUCCESS(TAG, CborNoError == cbor_value_advance(&entry), ERROR);
+        // only byte strings are sections, anything else is dropped
+        if (cbor_value_is_byte_string(&entry))
+        {
+            VERIFY_SUCCESS(TAG, OC_STACK_OK == SetSectionFromCbor(list, &name, &entry), ERROR);
+        }
+        VERIFY_SUCCESS(TAG, CborNoError == cbor_value_advance(&entry), ERROR);
+    }
+
+    for (size_t offset = mapSize; offset < (mapSize + journalSize); )
+    {
+        CborParser recordParser;  // will be initialized in |ParseJournalRecord|
+        CborValue name;           // will be initialized in |ParseJournalRecord|
+        CborValue payload;        // will be initialized in |ParseJournalRecord|
+        size_t recordSize = ParseJournalRecord(data + offset, mapSize + journalSize - offset,
+                                               &recordParser, &name, &payload);
+        VERIFY_SUCCESS(TAG, 0 != recordSize, ERROR);
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == SetSectionFromCbor(list, &name, &payload), ERROR);
+        offset += recordSize;
+    }
+    ret = OC_STACK_OK;
+
+exit:
+    return ret;
+}
+
+/**
+ * Encodes the sections of a section list into a single section map.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the payload argument.
+ *
+ * @param list    is the section list to encode.
+ * @param payload is set to the encoded section map.
+ * @param size    is set to the size of the encoded section map.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult EncodeSections(const PSSectionList *list, uint8_t **payload, size_t *size)
+{
+    OCStackResult ret = OC_STACK_ERROR;
+    int64_t cborEncoderResult = CborNoError;
+    uint8_t *outPayload = NULL;
+    size_t allocSize = CBOR_ENCODING_SIZE_ADDITION;
+
+    for (size_t i = 0; i < list->count; i++)
+    {
+        allocSize += strlen(list->sections[i].name) + list->sections[i].size
+                   + PS_JOURNAL_RECORD_HEADERS_SIZE;
+    }
+
+    outPayload = (uint8_t *) OICCalloc(1, allocSize);
+    VERIFY_NOT_NULL(TAG, outPayload, ERROR);
+    CborEncoder encoder;  // will be initialized in |cbor_encoder_init|
+    cbor_encoder_init(&encoder, outPayload, allocSize, 0);
+    CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
+    cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+
+    for (size_t i = 0; i < list->count; i++)
+    {
+        const PSSection *section = &list->sections[i];
+        if (!section->payload || !section->size)
+        {
+            continue;
+        }
+        cborEncoderResult |= cbor_encode_text_string(&resource, section->name, strlen(section->name));
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Section Name.");
+        cborEncoderResult |= cbor_encode_byte_string(&resource, section->payload, section->size);
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Section Value.");
+    }
+
+    cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Map.");
+    VERIFY_SUCCESS(TAG, CborNoError == cborEncoderResult, ERROR);
+
+    *size = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    *payload = outPayload;
+    outPayload = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    OICFree(outPayload);
+    return ret;
+}
+
+/**
+ * Encodes a journal record.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the record argument.
+ *
+ * @param resourceName is the name of the updated section.
+ * @param payload      is the new payload of the section, NULL if the section was removed.
+ * @param size         is the size of payload.
+ * @param record       is set to the encoded journal record.
+ * @param recordSize   is set to the size of the encoded journal record.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult EncodeJournalRecord(const char *resourceName, const uint8_t *payload,
+                                         size_t size, uint8_t **record, size_t *recordSize)
+{
+    OCStackResult ret = OC_STACK_ERROR;
+    int64_t cborEncoderResult = CborNoError;
+    size_t nameLen = strlen(resourceName);
+    size_t allocSize = nameLen + size + PS_JOURNAL_RECORD_HEADERS_SIZE;
+
+    uint8_t *outPayload = (uint8_t *) OICCalloc(1, allocSize);
+    VERIFY_NOT_NULL(TAG, outPayload, ERROR);
+    CborEncoder encoder;  // will be initialized in |cbor_encoder_init|
+    cbor_encoder_init(&encoder, outPayload, allocSize, 0);
+    CborEncoder fields;  // will be initialized in |cbor_encoder_create_array|
+    cborEncoderResult |= cbor_encoder_create_array(&encoder, &fields, PS_JOURNAL_RECORD_FIELDS);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Journal Record.");
+    cborEncoderResult |= cbor_encode_text_string(&fields, resourceName, nameLen);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
+    if (payload && size)
+    {
+        cborEncoderResult |= cbor_encode_byte_string(&fields, payload, size);
+    }
+    else
+    {
+        cborEncoderResult |= cbor_encode_null(&fields);
+    }
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+    cborEncoderResult |= cbor_encoder_close_container(&encoder, &fields);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Journal Record.");
+    VERIFY_SUCCESS(TAG, CborNoError == cborEncoderResult, ERROR);
+
+    *recordSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    *record = outPayload;
+    outPayload = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    OICFree(outPayload);
+    return ret;
+}
+
+/**
+ * Finds the payload of a section, replaying the journal over the section map.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the payload argument.
+ *
+ * @return ::OC_STACK_OK if the section was found, otherwise some error value
+ */
+static OCStackResult FindSection(const uint8_t *data, size_t mapSize, size_t journalSize,
+                                 const char *resourceName, uint8_t **payload, size_t *size)
+{
+    CborParser parser;  // will be initialized in |cbor_parser_init|
+    CborValue cbor;     // will be initialized in |cbor_parser_init|
+    CborValue cborValue = {0};
+    CborError cborFindResult = CborNoError;
+    bool found = false;
+    size_t lastRecord = 0;
+
+    // The last journal record of the section wins over the section map
+    for (size_t offset = mapSize; offset < (mapSize + journalSize); )
+    {
+        bool equals = false;
+        CborValue name;  // will be initialized in |ParseJournalRecord|
+        size_t recordSize = ParseJournalRecord(data + offset, mapSize + journalSize - offset,
+                                               &parser, &name, &cborValue);
+        if (0 == recordSize)
+        {
+            break;
+        }
+        if ((CborNoError == cbor_value_text_string_equals(&name, resourceName, &equals)) && equals)
+        {
+            found = true;
+            lastRecord = offset;
+        }
+        offset += recordSize;
+    }
+
+    if (found)
+    {
+        CborValue name;  // will be initialized in |ParseJournalRecord|
+        ParseJournalRecord(data + lastRecord, mapSize + journalSize - lastRecord,
+                           &parser, &name, &cborValue);
+    }
+    else
+    {
+        cbor_parser_init(data, mapSize, 0, &parser, &cbor);
+        cborFindResult = cbor_value_map_find_value(&cbor, resourceName, &cborValue);
+    }
+
+    // in case of |else (...)|, svr_data not found
+    if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&cborValue) &&
+        (CborNoError == cbor_value_dup_byte_string(&cborValue, payload, size, NULL)))
+    {
+        return OC_STACK_OK;
+    }
+    return OC_STACK_ERROR;
+}
+
 /**
  * Reads the database from PS
- * 
+ *
  * @note Caller of this method MUST use OICFree() method to release memory
  *       referenced by the data argument.
  *
@@ -161,58 +669,46 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
         return OC_STACK_INVALID_PARAM;
     }
 
-    FILE *fp = NULL;
     uint8_t *fsData = NULL;
     size_t fileSize = 0;
+    PSSectionList sections = {NULL, 0, 0};
     OCStackResult ret = OC_STACK_ERROR;
 
     OCPersistentStorage *ps = OCGetPersistentStorageHandler();
     VERIFY_NOT_NULL(TAG, ps, ERROR);
 
-    fileSize = GetDatabaseSize(ps, databaseName);
-    OIC_LOG_V(DEBUG, TAG, "File Read Size: %" PRIuPTR, fileSize);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadDatabaseFile(ps, databaseName, &fsData, &fileSize), ERROR);
     if (fileSize)
     {
-        fsData = (uint8_t *) OICCalloc(1, fileSize);
-        VERIFY_NOT_NULL(TAG, fsData, ERROR);
+        size_t mapSize = GetSectionMapSize(fsData, fileSize);
+        size_t journalSize = mapSize ? GetJournalSize(fsData + mapSize, fileSize - mapSize) : 0;
 
-        fp = ps->open(databaseName, "rb");
-        VERIFY_NOT_NULL(TAG, fp, ERROR);
-        if (ps->read(fsData, 1, fileSize, fp) == fileSize)
+        if (resourceName)
         {
-            if (resourceName)
+            if (mapSize)
             {
-                CborParser parser;  // will be initialized in |cbor_parser_init|
-                CborValue cbor;     // will be initialized in |cbor_parser_init|
-                cbor_parser_init(fsData, fileSize, 0, &parser, &cbor);
-                CborValue cborValue = {0};
-                CborError cborFindResult = cbor_value_map_find_value(&cbor, resourceName, &cborValue);
-                if (CborNoError == cborFindResult && cbor_value_is_byte_string(&cborValue))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&cborValue, data, size, NULL);
-                    VERIFY_SUCCESS(TAG, CborNoError == cborFindResult, ERROR);
-                    ret = OC_STACK_OK;
-                }
-                // in case of |else (...)|, svr_data not found
-            }
-            // return everything in case resourceName is NULL
-            else
-            {
-                *size = fileSize;
-                *data = (uint8_t *) OICCalloc(1, fileSize);
-                VERIFY_NOT_NULL(TAG, *data, ERROR);
-                memcpy(*data, fsData, fileSize);
-                ret = OC_STACK_OK;
+                ret = FindSection(fsData, mapSize, journalSize, resourceName, data, size);
             }
         }
+        // return everything in case resourceName is NULL
+        else if (!mapSize || (mapSize == fileSize))
+        {
+            *size = fileSize;
+            *data = fsData;
+            fsData = NULL;
+            ret = OC_STACK_OK;
+        }
+        // with the journal replayed over the section map
+        else
+        {
+            VERIFY_SUCCESS(TAG, OC_STACK_OK == LoadSections(fsData, mapSize, journalSize, &sections), ERROR);
+            ret = EncodeSections(&sections, data, size);
+        }
     }
     OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS OUT");
 
 exit:
-    if (fp)
-    {
-        ps->close(fp);
-    }
+    FreeSectionList(&sections);
     OICFree(fsData);
     return ret;
 }
@@ -236,277 +732,89 @@ OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceN
     }
 
     size_t dbSize = 0;
+    size_t mapSize = 0;
+    size_t journalSize = 0;
     size_t outSize = 0;
     uint8_t *dbData = NULL;
     uint8_t *outPayload = NULL;
+    char *sectionName = NULL;
+    uint8_t *sectionPayload = NULL;
+    PSSectionList sections = {NULL, 0, 0};
+    OCStackResult ret = OC_STACK_ERROR;
 
-    uint8_t *aclCbor = NULL;
-    uint8_t *pstatCbor = NULL;
-    uint8_t *doxmCbor = NULL;
-    uint8_t *amaclCbor = NULL;
-    uint8_t *credCbor = NULL;
-    uint8_t *resetPfCbor = NULL;
-    uint8_t *crlCbor = NULL;
-    uint8_t *dpCbor = NULL;
-    uint8_t *spCbor = NULL;
+    OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    VERIFY_NOT_NULL(TAG, ps, ERROR);
 
-    int64_t cborEncoderResult = CborNoError;
-    OCStackResult ret = ReadDatabaseFromPS(databaseName, NULL, &dbData, &dbSize);
-    if (dbData && dbSize)
+    // a database which can not be read is replaced
+    if (OC_STACK_OK == ReadDatabaseFile(ps, databaseName, &dbData, &dbSize))
     {
-        PSDatabase database = PS_DATABASE_SECURITY;
-        size_t allocSize = 0;
-        size_t aclCborLen = 0;
-        size_t pstatCborLen = 0;
-        size_t doxmCborLen = 0;
-        size_t amaclCborLen = 0;
-        size_t credCborLen = 0;
-        size_t resetPfCborLen = 0;
-        size_t crlCborLen = 0;
-        size_t dpCborLen = 0;
-        size_t spCborLen = 0;
-
-        // Determine which database we are working with so we can scope our operations
-        if (0 == strcmp(OC_DEVICE_PROPS_FILE_NAME, databaseName))
-        {
-            database = PS_DATABASE_DEVICEPROPERTIES;
-        }
-
-        // Gets each secure virtual resource from persistent storage
-        // this local scoping intended, for destroying large cbor instances after use
-        {
-            CborParser parser;  // will be initialized in |cbor_parser_init|
-            CborValue cbor;     // will be initialized in |cbor_parser_init|
-            cbor_parser_init(dbData, dbSize, 0, &parser, &cbor);
-            CborValue curVal = {0};
-            CborError cborFindResult = CborNoError;
+        mapSize = GetSectionMapSize(dbData, dbSize);
+        journalSize = mapSize ? GetJournalSize(dbData + mapSize, dbSize - mapSize) : 0;
+    }
 
-            // Only search for and copy resources owned by the target database
-            if (PS_DATABASE_SECURITY == database)
-            {
-                // Security database
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_ACL_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &aclCbor, &aclCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding ACL Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_PSTAT_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &pstatCbor, &pstatCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding PSTAT Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_DOXM_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &doxmCbor, &doxmCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding DOXM Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_AMACL_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &amaclCbor, &amaclCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding AMACL Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_CRED_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &credCbor, &credCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding CRED Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_RESET_PF_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &resetPfCbor, &resetPfCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding Reset Profile Name Value.");
-                }
-                int64_t cborFindCrlResult = cbor_value_map_find_value(&cbor, OIC_JSON_CRL_NAME, &curVal);
-                if ((CborNoError == cborFindCrlResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindCrlResult = cbor_value_dup_byte_string(&curVal, &crlCbor, &crlCborLen, NULL);
-                    if ((CborNoError != cborFindCrlResult) && (CborErrorOutOfMemory != cborFindCrlResult))
-                    {
-                        OIC_LOG(ERROR, TAG, "Failed Finding optional CRL Name Value.");
-                    }
-                    else
-                    {
-                        OIC_LOG(INFO, TAG, "Successfully Finding optional CRL Name Value.");
-                    }
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_SP_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &spCbor, &spCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding SP Name Value.");
-                }
-            }
-            else
-            {
-                // Device Properties database
-                cborFindResult = cbor_value_map_find_value(&cbor, OC_JSON_DEVICE_PROPS_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &dpCbor, &dpCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding Device Properties Name Value.");
-                }
-            }
-        }
+    // Append the update to the journal as long as the journal is small and not torn
+    if (mapSize && ((mapSize + journalSize) == dbSize))
+    {
+        ret = EncodeJournalRecord(resourceName, payload, size, &outPayload, &outSize);
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
 
-        // Updates the added |payload| with the existing secure virtual resource(s)
-        // this local scoping intended, for destroying large cbor instances after use
+        size_t newJournalSize = journalSize + outSize;
+        if ((newJournalSize <= (PS_JOURNAL_COMPACT_RATIO * mapSize)) ||
+            (newJournalSize <= PS_JOURNAL_MIN_COMPACT_SIZE))
         {
-            if (PS_DATABASE_SECURITY == database)
-            {
-                allocSize = aclCborLen + pstatCborLen + doxmCborLen + amaclCborLen
-                          + credCborLen + /* pconfCborLen + */ resetPfCborLen + crlCborLen + spCborLen
-                          + size + CBOR_ENCODING_SIZE_ADDITION;
-            }
-            else
-            {
-                allocSize = dpCborLen + size + CBOR_ENCODING_SIZE_ADDITION;
-            }
-
-
-            outPayload = (uint8_t *)OICCalloc(1, allocSize);
-            VERIFY_NOT_NULL(TAG, outPayload, ERROR);
-            CborEncoder encoder;  // will be initialized in |cbor_parser_init|
-            cbor_encoder_init(&encoder, outPayload, allocSize, 0);
-            CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
-            cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
-            VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
-
-            // Encode the updated payload and add it to our map so it will be stored in the database.
-            if (payload && size)
-            {
-                cborEncoderResult |= cbor_encode_text_string(&resource, resourceName, strlen(resourceName));
-                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
-                cborEncoderResult |= cbor_encode_byte_string(&resource, payload, size);
-                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
-            }
-
-            // Check all of the resources from a particular database to see if we need to encode them. If the resource
-            // currently exists in the database and has not been updated then we need to encode it and add it to the
-            // map. If the resource has been updated then it was encoded and added to the map above so we skip it to
-            // avoid having duplicate entries for the resource in the database.
-            if (PS_DATABASE_SECURITY == database)
-            {
-                // Security database
-                if (strcmp(OIC_JSON_ACL_NAME, resourceName) && aclCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_ACL_NAME, strlen(OIC_JSON_ACL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding ACL Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, aclCbor, aclCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding ACL Value.");
-                }
-                if (strcmp(OIC_JSON_PSTAT_NAME, resourceName) && pstatCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_PSTAT_NAME, strlen(OIC_JSON_PSTAT_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PSTAT Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, pstatCbor, pstatCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PSTAT Value.");
-                }
-                if (strcmp(OIC_JSON_DOXM_NAME, resourceName) && doxmCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_DOXM_NAME, strlen(OIC_JSON_DOXM_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Doxm Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, doxmCbor, doxmCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Doxm Value.");
-                }
-                if (strcmp(OIC_JSON_AMACL_NAME, resourceName) && amaclCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_AMACL_NAME, strlen(OIC_JSON_AMACL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Amacl Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, amaclCbor, amaclCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Amacl Value.");
-                }
-                if (strcmp(OIC_JSON_CRED_NAME, resourceName) && credCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_CRED_NAME, strlen(OIC_JSON_CRED_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Cred Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, credCbor, credCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Cred Value.");
-                }
-                if (strcmp(OIC_JSON_RESET_PF_NAME, resourceName) && resetPfCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_RESET_PF_NAME, strlen(OIC_JSON_RESET_PF_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Reset Profile Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, resetPfCbor, resetPfCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Reset Profile Value.");
-                }
-                if (strcmp(OIC_JSON_CRL_NAME, resourceName) && crlCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_CRL_NAME, strlen(OIC_JSON_CRL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Crl Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, crlCbor, crlCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Crl Value.");
-                }
-                if (strcmp(OIC_JSON_SP_NAME, resourceName) && crlCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_SP_NAME, strlen(OIC_JSON_SP_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding SP Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, spCbor, spCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding SP Value.");
-                }
-
-
-            }
-            else
+            ret = WritePayloadToPS(databaseName, "ab", outPayload, outSize);
+            if (OC_STACK_OK == ret)
             {
-                // Device Properties database
-                if (strcmp(OC_JSON_DEVICE_PROPS_NAME, resourceName) && dpCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OC_JSON_DEVICE_PROPS_NAME, strlen(OC_JSON_DEVICE_PROPS_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Device Properties Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, dpCbor, dpCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Device Properties Value.");
-                }
+                OIC_LOG_V(DEBUG, TAG, "Journaled %s, journal size %" PRIuPTR,
+                          resourceName, newJournalSize);
+                goto exit;
             }
-
-            cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
-            VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Array.");
-            outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
+            OIC_LOG(WARNING, TAG, "Failed appending to the journal, compacting");
         }
+        OICFree(outPayload);
+        outPayload = NULL;
     }
-    else if (payload && size)
+    else if (!mapSize && !(payload && size))
     {
-        size_t allocSize = size + CBOR_ENCODING_SIZE_ADDITION;
-
-        outPayload = (uint8_t *)OICCalloc(1, allocSize);
-        VERIFY_NOT_NULL(TAG, outPayload, ERROR);
-        CborEncoder encoder;  // will be initialized in |cbor_parser_init|
-        cbor_encoder_init(&encoder, outPayload, allocSize, 0);
-        CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
-        cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
-
-        cborEncoderResult |= cbor_encode_text_string(&resource, resourceName, strlen(resourceName));
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
-        cborEncoderResult |= cbor_encode_byte_string(&resource, payload, size);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+        // there is no database to remove the section from
+        ret = OC_STACK_INVALID_PARAM;
+        goto exit;
+    }
 
-        cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Array.");
-        outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    // Compact the database with the update applied
+    if (mapSize)
+    {
+        ret = LoadSections(dbData, mapSize, journalSize, &sections);
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
     }
+    ret = OC_STACK_NO_MEMORY;
+    sectionName = OICStrdup(resourceName);
+    VERIFY_NOT_NULL(TAG, sectionName, ERROR);
+    if (payload && size)
+    {
+        sectionPayload = (uint8_t *) OICMalloc(size);
+        VERIFY_NOT_NULL(TAG, sectionPayload, ERROR);
+        memcpy(sectionPayload, payload, size);
+    }
+    ret = SetSection(&sections, sectionName, sectionPayload, sectionPayload ? size : 0);
+    sectionName = NULL;
+    sectionPayload = NULL;
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
+
+    ret = EncodeSections(&sections, &outPayload, &outSize);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
 
-    ret = WritePayloadToPS(databaseName, outPayload, outSize);
+    ret = WritePayloadToPS(databaseName, "wb", outPayload, outSize);
     VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
 
     OIC_LOG(DEBUG, TAG, "UpdateResourceInPS OUT");
 
 exit:
+    FreeSectionList(&sections);
+    OICFree(sectionName);
+    OICFree(sectionPayload);
     OICFree(dbData);
     OICFree(outPayload);
-    OICFree(aclCbor);
-    OICFree(pstatCbor);
-    OICFree(doxmCbor);
-    OICFree(amaclCbor);
-    OICFree(credCbor);
-    OICFree(resetPfCbor);
-    OICFree(crlCbor);
-    OICFree(dpCbor);
-    OICFree(spCbor);
     return ret;
 }
 
@@ -682,7 +990,7 @@ OCStackResult ResetSecureResourceInPS(void)
             outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
         }
 
-        ret = WritePayloadToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
+        ret = WritePayloadToPS(SVR_DB_DAT_FILE_NAME, "wb", outPayload, outSize);
         VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
     }
 
@@ -36,6 +36,7 @@
 #include "srmresourcestrings.h"
 #include "srmutility.h"
 #include "deviceonboardingstate.h"
+#include "casecurityinterface.h"
 
 #define TAG  "OIC_SRM_PSTAT"
 
@@ -166,6 +167,14 @@ static bool UpdatePersistentStorage(OicSecPstat_t *pstat)
         OICFree(cborPayload);
     }
 
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    // sessions must not be resumed across a change of the provisioning state
+    if (CA_STATUS_OK != CAinvalidateSslSessionCache())
+    {
+        OIC_LOG(WARNING, TAG, "Failed to invalidate the TLS session cache");
+    }
+#endif // __WITH_DTLS__ or __WITH_TLS__
+
     return bRet;
 }
 
@@ -26,6 +26,7 @@
 #include "credresource.h"
 #include "spresource.h"
 #include "amaclresource.h"
+#include "policyengine.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "experimental/logger.h"
@@ -131,6 +132,7 @@ OCStackResult DestroySecureResources( )
     OIC_LOG_V(DEBUG, TAG, "IN %s", __func__);
 
     DeInitACLResource();
+    DeInitPolicyEngine();
     DeInitCredResource();
     DeInitDoxmResource();
     DeInitPstatResource();
@@ -505,6 +505,67 @@ TEST(ACLResourceTest, ACLDeleteWithSingleResourceTest)
     OICFree(payload);
 }
 
+TEST(ACLResourceTest, ACLGenerationChangesWithAces)
+{
+    // Intialize /pstat global, so that the GetDos() calls in aclresource.c
+    // can succeed, or all UPDATE requests will be rejected based on DOS.
+    OCStackResult res = InitPstatResourceToDefault();
+    ASSERT_TRUE(OC_STACK_OK == res);
+
+    static OCPersistentStorage ps = OCPersistentStorage();
+    SetPersistentHandler(&ps, true);
+
+    OicSecAcl_t *defaultAcl = NULL;
+    EXPECT_EQ(OC_STACK_OK, GetDefaultACL(&defaultAcl));
+    ASSERT_TRUE(defaultAcl != NULL);
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(defaultAcl));
+
+    uint32_t generation1 = 0;
+    EXPECT_EQ(defaultAcl->aces, GetACLResourceAces(&generation1));
+
+    //Populate ACL
+    OicSecAcl_t *acl = (OicSecAcl_t *) OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != acl);
+    EXPECT_EQ(OC_STACK_OK, populateAcl(acl, 1));
+
+    size_t size = 0;
+    uint8_t  *payload = NULL;
+    EXPECT_EQ(OC_STACK_OK, AclToCBORPayload(acl, OIC_SEC_ACL_V2, &payload, &size));
+    ASSERT_TRUE(NULL != payload);
+    OCSecurityPayload *securityPayload = OCSecurityPayloadCreate(payload, size);
+    ASSERT_TRUE(NULL != securityPayload);
+
+    // A GET leaves the ACEs alone
+    OCEntityHandlerRequest ehReq = OCEntityHandlerRequest();
+    ehReq.method = OC_REST_GET;
+    ACLEntityHandler(OC_REQUEST_FLAG, &ehReq, NULL);
+    uint32_t generation2 = 0;
+    GetACLResourceAces(&generation2);
+    EXPECT_EQ(generation1, generation2);
+
+    // A POST adds an ACE
+    ehReq.payload = (OCPayload *) securityPayload;
+    ehReq.method = OC_REST_POST;
+    ACLEntityHandler(OC_REQUEST_FLAG, &ehReq, NULL);
+    GetACLResourceAces(&generation2);
+    EXPECT_NE(generation1, generation2);
+
+    // A DELETE removes it
+    ehReq.method = OC_REST_DELETE;
+    char query[] = "subjectuuid=32323232-3232-3232-3232-323232323232;resources=/a/led";
+    ehReq.query = query;
+    ACLEntityHandler(OC_REQUEST_FLAG, &ehReq, NULL);
+    uint32_t generation3 = 0;
+    GetACLResourceAces(&generation3);
+    EXPECT_NE(generation2, generation3);
+
+    // Perform cleanup
+    DeInitACLResource();
+    DeleteACLList(acl);
+    OCPayloadDestroy((OCPayload *)securityPayload);
+    OICFree(payload);
+}
+
 TEST(ACLResourceTest, ACLDeleteWithMultiResourceTest)
 {
     // Intialize /pstat global, so that the GetDos() calls in aclresource.c
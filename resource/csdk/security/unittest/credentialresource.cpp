@@ -394,7 +394,61 @@ TEST(CredAddTmpPskWithPINTest, NullSubject)
     EXPECT_EQ(OC_STACK_INVALID_PARAM, AddTmpPskWithPIN(NULL, SYMMETRIC_PAIR_WISE_KEY,
               NULL, 0, NULL, NULL));
 }
+
+TEST(CredGetDtlsPskCredentialsTest, FollowsCredentialChanges)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    SetPersistentHandler(&ps, true);
+
+    OicUuid_t subject = {{0}};
+    OICStrcpy((char *)subject.id, sizeof(subject.id), "pskSubject11");
+
+    uint8_t base64Key[] = "MTIzNDU2Nzg5MDEyMzQ1Ng==";
+    OicSecKey_t key = {base64Key, sizeof(base64Key) - 1, OIC_ENCODING_BASE64};
+    OicSecCred_t *cred = GenerateCredential(&subject, SYMMETRIC_PAIR_WISE_KEY, NULL,
+                                            &key, NULL);
+    ASSERT_TRUE(NULL != cred);
+    ASSERT_EQ(OC_STACK_OK, AddCredential(cred));
+
+    uint8_t psk[OWNER_PSK_LENGTH_256] = {0};
+    ASSERT_EQ(16, GetDtlsPskCredentials(CA_DTLS_PSK_KEY, subject.id, sizeof(subject.id),
+                                        psk, sizeof(psk)));
+    EXPECT_EQ(0, memcmp("1234567890123456", psk, 16));
+
+    EXPECT_EQ(OC_STACK_RESOURCE_DELETED, RemoveCredential(&subject));
+    EXPECT_EQ(-1, GetDtlsPskCredentials(CA_DTLS_PSK_KEY, subject.id, sizeof(subject.id),
+                                        psk, sizeof(psk)));
+}
 #endif // __WITH_DTLS__ or __WITH_TLS__
+
+TEST(CredGetCredEntryBySubjectTest, CopyOutlivesCredential)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    SetPersistentHandler(&ps, true);
+
+    OicUuid_t subject = {{0}};
+    OICStrcpy((char *)subject.id, sizeof(subject.id), "copySubject1");
+    EXPECT_EQ(NULL, GetCredEntryBySubject(&subject));
+    EXPECT_EQ(NULL, GetCredEntryBySubject(NULL));
+
+    uint8_t keyData[] = "0123456789abcdef";
+    OicSecKey_t key = {keyData, sizeof(keyData) - 1, OIC_ENCODING_RAW};
+    OicSecCred_t *cred = GenerateCredential(&subject, SYMMETRIC_PAIR_WISE_KEY, NULL,
+                                            &key, NULL);
+    ASSERT_TRUE(NULL != cred);
+    ASSERT_EQ(OC_STACK_OK, AddCredential(cred));
+
+    OicSecCred_t *copy = GetCredEntryBySubject(&subject);
+    ASSERT_TRUE(NULL != copy);
+    EXPECT_NE(cred, copy);
+    EXPECT_EQ(OC_STACK_RESOURCE_DELETED, RemoveCredential(&subject));
+
+    // the copy is still usable once the credential is removed
+    EXPECT_EQ(0, memcmp(subject.id, copy->subject.id, sizeof(subject.id)));
+    ASSERT_EQ(sizeof(keyData) - 1, copy->privateData.len);
+    EXPECT_EQ(0, memcmp(keyData, copy->privateData.data, copy->privateData.len));
+    DeleteCredList(copy);
+}
 TEST(CredCBORPayloadToCredTest, NullPayload)
 {
     EXPECT_EQ(OC_STACK_INVALID_PARAM, CBORPayloadToCred(NULL, 0, NULL, NULL));
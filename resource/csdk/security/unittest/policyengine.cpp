@@ -19,99 +19,327 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include <gtest/gtest.h>
+#include <vector>
+
+#include "utlist.h"
 #include "ocstack.h"
 #include "cainterface.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "secureresourcemanager.h"
 #include "srmresourcestrings.h"
+#include "aclresource.h"
+#include "pstatresource.h"
+#include "rolesresource.h"
+#include "security_internals.h"
+#include "srmtestcommon.h"
 
-using namespace std;
+extern "C" {
+// policyenginehooks.c
+void CheckPermissionTest(SRMRequestContext_t *context);
+void DeInitPolicyEngineTest(void);
+OCStackResult GetEndpointRolesTest(const CAEndpoint_t *endpoint, OicSecRole_t **roles,
+                                   size_t *roleCount);
+size_t GetDecisionCountTest(void);
+bool IsDecisionRememberedTest(const char *uri);
+extern const size_t PE_DECISION_CACHE_SIZE_TEST;
+extern const size_t PE_ROLE_CURSORS_TEST;
+}
 
-#define PE_UT_TAG "\tPE-UT-message: "
+// roles asserted by the endpoint of every request
+static std::vector<OicSecRole_t> g_roles;
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include "policyengine.h"
-#include "experimental/doxmresource.h"
-
-// test parameters
-// PEContext_t g_peContext;
-
-#ifdef __cplusplus
-}
-#endif
-
-OicUuid_t g_subjectIdA = {"SubjectA"};
-OicUuid_t g_subjectIdB = {"SubjectB"};
-OicUuid_t g_devOwner;
-char g_resource1[] = "Resource1";
-char g_resource2[] = "Resource2";
-
-extern OicSecDoxm_t *gDoxm;
-
-// These tests need to be rewritten; they do not cover internal ACE/request
-// logic.
-// See JIRA 1787 (https://jira.iotivity.org/browse/IOT-1787)
-
-//Policy Engine Core Tests
-// TEST(PolicyEngineCore, InitPolicyEngine)
-// {
-//     EXPECT_EQ(OC_STACK_OK, InitPolicyEngine(&g_peContext));
-// }
-
-// TODO - in order to unittest this we need InitDoxmResource() to put doxm
-// into Owned state with a known owner.  This will have to be done post v1.1.
-// TEST(PolicyEngineCore, CheckPermissionNoAcls)
-// {
-//     if(OC_STACK_OK == InitDoxmResource())
-//     {
-//         EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND,
-//             CheckPermission(&g_peContext,
-//                             &g_subjectIdA,
-//                             g_resource1,
-//                             PERMISSION_READ));
-//     }
-//     else
-//     {
-//         printf("%s WARNING: InitDoxmResource() returned ERROR!\n", PE_UT_TAG);
-//     }
-// }
-
-// // TODO - in order to unittest this we need InitDoxmResource() to put doxm
-// // into Owned state with a known owner.  This will have to be done post v1.1.
-// TEST(PolicyEngineCore, CheckDevOwnerRequest)
-// {
-//     if(OC_STACK_OK == InitDoxmResource())
-//     {
-//         if(OC_STACK_OK == GetDoxmDevOwnerId(&g_devOwner))
-//         {
-//             printf("%s", PE_UT_TAG);
-//             for(int i = 0; i < UUID_LENGTH; i++)
-//             {
-//                 printf("%d", g_devOwner.id[i]);
-//             }
-//             printf("\n");
-//                 EXPECT_EQ(ACCESS_GRANTED,
-//                     CheckPermission(&g_peContext,
-//                         &g_devOwner,
-//                         g_resource1,
-//                         PERMISSION_FULL_CONTROL));
-//         }
-//         else
-//         {
-//             printf("%s WARNING: GetDoxmDevOwnerId() returned ERROR!\n", PE_UT_TAG);
-//         }
-//     }
-//     else
-//     {
-//         printf("%s WARNING: InitDoxmResource() returned ERROR!\n", PE_UT_TAG);
-//     }
-// }
-
-// TEST(PolicyEngineCore, DeInitPolicyEngine)
-// {
-//     DeInitPolicyEngine(&g_peContext);
-//     EXPECT_EQ(STOPPED, g_peContext.state);
-//     EXPECT_EQ((uint16_t)0, g_peContext.permission);
-//     EXPECT_EQ(ACCESS_DENIED_POLICY_ENGINE_ERROR, g_peContext.retVal);
-// }
+OCStackResult GetEndpointRolesTest(const CAEndpoint_t *endpoint, OicSecRole_t **roles,
+                                   size_t *roleCount)
+{
+    OC_UNUSED(endpoint);
+    *roles = NULL;
+    *roleCount = g_roles.size();
+    if (!g_roles.empty())
+    {
+        *roles = (OicSecRole_t *)OICCalloc(g_roles.size(), sizeof(OicSecRole_t));
+        if (NULL == *roles)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        memcpy(*roles, g_roles.data(), g_roles.size() * sizeof(OicSecRole_t));
+    }
+    return OC_STACK_OK;
+}
+
+static OicSecRole_t MakeRole(const char *id)
+{
+    OicSecRole_t role;
+    memset(&role, 0, sizeof(role));
+    OICStrcpy(role.id, sizeof(role.id), id);
+    return role;
+}
+
+static OicSecRsrc_t *MakeRsrc(const char *href, OicSecAceResourceWildcard_t wildcard)
+{
+    OicSecRsrc_t *rsrc = (OicSecRsrc_t *)OICCalloc(1, sizeof(OicSecRsrc_t));
+    if (NULL != rsrc)
+    {
+        rsrc->href = (NULL != href) ? OICStrdup(href) : NULL;
+        rsrc->wildcard = wildcard;
+    }
+    return rsrc;
+}
+
+static OicSecAce_t *MakeAce(OicSecAceSubjectType subjectType, uint16_t permission)
+{
+    OicSecAce_t *ace = (OicSecAce_t *)OICCalloc(1, sizeof(OicSecAce_t));
+    if (NULL != ace)
+    {
+        ace->subjectType = subjectType;
+        ace->permission = permission;
+    }
+    return ace;
+}
+
+static OicSecAce_t *MakeUuidAce(const OicUuid_t &subject, const char *href,
+                                uint16_t permission)
+{
+    OicSecAce_t *ace = MakeAce(OicSecAceUuidSubject, permission);
+    if (NULL != ace)
+    {
+        ace->subjectuuid = subject;
+        LL_APPEND(ace->resources, MakeRsrc(href, NO_WILDCARD));
+    }
+    return ace;
+}
+
+static OicSecAce_t *MakeRoleAce(const char *roleId, const char *href, uint16_t permission)
+{
+    OicSecAce_t *ace = MakeAce(OicSecAceRoleSubject, permission);
+    if (NULL != ace)
+    {
+        ace->subjectRole = MakeRole(roleId);
+        LL_APPEND(ace->resources, MakeRsrc(href, NO_WILDCARD));
+    }
+    return ace;
+}
+
+static OicSecAce_t *MakeConntypeAce(OicSecConntype_t conntype, const char *href,
+                                    OicSecAceResourceWildcard_t wildcard, uint16_t permission)
+{
+    OicSecAce_t *ace = MakeAce(OicSecAceConntypeSubject, permission);
+    if (NULL != ace)
+    {
+        ace->subjectConn = conntype;
+        LL_APPEND(ace->resources, MakeRsrc(href, wildcard));
+    }
+    return ace;
+}
+
+class PolicyEngineTest : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        g_roles.clear();
+        memset(subjectA.id, 'A', sizeof(subjectA.id));
+        memset(subjectB.id, 'B', sizeof(subjectB.id));
+
+        ASSERT_EQ(OC_STACK_OK, InitPstatResourceToDefault());
+        ASSERT_EQ(OC_STACK_OK, GetPstatDosS(&savedDos));
+        ASSERT_EQ(OC_STACK_OK, SetPstatDosS(DOS_RFNOP));
+
+        SetPersistentHandler(&ps, true);
+
+        acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+        ASSERT_TRUE(NULL != acl);
+        EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+        memset(&endpoint, 0, sizeof(endpoint));
+        endpoint.adapter = CA_ADAPTER_IP;
+    }
+
+    virtual void TearDown()
+    {
+        DeInitPolicyEngineTest();
+        DeInitACLResource();
+        SetPstatDosS(savedDos);
+        g_roles.clear();
+    }
+
+    void addAce(OicSecAce_t *ace)
+    {
+        ASSERT_TRUE(NULL != ace);
+        LL_APPEND(acl->aces, ace);
+        // the ACEs were changed behind the ACL resource, publish them again
+        EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+    }
+
+    SRMAccessResponse_t check(const OicUuid_t &subject, const char *uri,
+                              uint16_t permission, bool secureChannel = true)
+    {
+        SRMRequestContext_t context;
+        memset(&context, 0, sizeof(context));
+        context.endPoint = &endpoint;
+        context.resourceType = NOT_A_SVR_RESOURCE;
+        OICStrcpy(context.resourceUri, sizeof(context.resourceUri), uri);
+        context.requestedPermission = permission;
+        context.secureChannel = secureChannel;
+        context.resourceIsOcSecure = secureChannel;
+        context.resourceIsOcNonsecure = !secureChannel;
+        context.discoverable = DISCOVERABLE_TRUE;
+        context.subjectIdType = SUBJECT_ID_TYPE_UUID;
+        context.subjectUuid = subject;
+        CheckPermissionTest(&context);
+        return context.responseVal;
+    }
+
+    OCPersistentStorage ps;
+    OicSecDeviceOnboardingState_t savedDos;
+    OicSecAcl_t *acl;
+    CAEndpoint_t endpoint;
+    OicUuid_t subjectA;
+    OicUuid_t subjectB;
+};
+
+TEST_F(PolicyEngineTest, SubjectAceGrantsAndDenies)
+{
+    addAce(MakeUuidAce(subjectA, "/a/led", PERMISSION_READ));
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION, check(subjectA, "/a/led", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_DENIED_RESOURCE_NOT_FOUND, check(subjectA, "/a/fan", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+}
+
+TEST_F(PolicyEngineTest, LaterAceOfSubjectGrants)
+{
+    addAce(MakeUuidAce(subjectA, "/a/led", PERMISSION_READ));
+    addAce(MakeUuidAce(subjectB, "/a/led", PERMISSION_FULL_CONTROL));
+    addAce(MakeUuidAce(subjectA, "/a/led", PERMISSION_WRITE));
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION, check(subjectA, "/a/led", PERMISSION_DELETE));
+}
+
+TEST_F(PolicyEngineTest, WildcardResources)
+{
+    addAce(MakeUuidAce(subjectA, WILDCARD_RESOURCE_URI, PERMISSION_READ));
+    addAce(MakeConntypeAce(AUTH_CRYPT, NULL, ALL_DISCOVERABLE_NCRS_WITH_OC_SECURE,
+                           PERMISSION_WRITE));
+    addAce(MakeConntypeAce(ANON_CLEAR, NULL, ALL_NCRS, PERMISSION_READ));
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/fan", PERMISSION_READ));
+    // "+" matches discoverable resources with a secure endpoint
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/fan", PERMISSION_WRITE));
+    // "*" matches resources for requests without a secure channel
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/fan", PERMISSION_READ, false));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              check(subjectB, "/a/fan", PERMISSION_WRITE, false));
+    // wildcards don't match configuration resources
+    EXPECT_NE(ACCESS_GRANTED, check(subjectB, OIC_RSRC_DOXM_URI, PERMISSION_READ, false));
+}
+
+TEST_F(PolicyEngineTest, ConntypeSubjects)
+{
+    addAce(MakeConntypeAce(AUTH_CRYPT, "/a/led", NO_WILDCARD, PERMISSION_FULL_CONTROL));
+    addAce(MakeConntypeAce(ANON_CLEAR, "/a/led", NO_WILDCARD, PERMISSION_READ));
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ, false));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              check(subjectA, "/a/led", PERMISSION_WRITE, false));
+}
+
+TEST_F(PolicyEngineTest, DecisionIsRemembered)
+{
+    OicSecAce_t *ace = MakeUuidAce(subjectA, "/a/led", PERMISSION_READ);
+    addAce(ace);
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(1u, GetDecisionCountTest());
+
+    // changing the ACE without a new ACL generation isn't noticed
+    ace->permission = PERMISSION_WRITE;
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(1u, GetDecisionCountTest());
+
+    // a request that differs in anything is decided again
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(3u, GetDecisionCountTest());
+}
+
+TEST_F(PolicyEngineTest, LeastRecentlyUsedDecisionIsReplaced)
+{
+    addAce(MakeUuidAce(subjectA, WILDCARD_RESOURCE_URI, PERMISSION_READ));
+
+    char uri[MAX_URI_LENGTH];
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE_TEST; i++)
+    {
+        snprintf(uri, sizeof(uri), "/a/%u", (unsigned int)i);
+        EXPECT_EQ(ACCESS_GRANTED, check(subjectA, uri, PERMISSION_READ));
+    }
+    EXPECT_EQ(PE_DECISION_CACHE_SIZE_TEST, GetDecisionCountTest());
+
+    // hit the oldest decision, the second oldest is replaced
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/0", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/new", PERMISSION_READ));
+
+    EXPECT_EQ(PE_DECISION_CACHE_SIZE_TEST, GetDecisionCountTest());
+    EXPECT_TRUE(IsDecisionRememberedTest("/a/0"));
+    EXPECT_FALSE(IsDecisionRememberedTest("/a/1"));
+    EXPECT_TRUE(IsDecisionRememberedTest("/a/new"));
+}
+
+TEST_F(PolicyEngineTest, AclChangeForgetsDecisions)
+{
+    addAce(MakeUuidAce(subjectA, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+
+    OicSecAcl_t *more = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != more);
+    more->aces = MakeUuidAce(subjectB, "/a/led", PERMISSION_READ);
+    ASSERT_TRUE(NULL != more->aces);
+    AppendACLObject(more);
+    OICFree(more);
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/led", PERMISSION_READ));
+
+    RemoveACE(&subjectB, "/a/led");
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectA, "/a/led", PERMISSION_READ));
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+TEST_F(PolicyEngineTest, RoleSubjects)
+{
+    addAce(MakeUuidAce(subjectA, "/a/fan", PERMISSION_READ));
+    addAce(MakeRoleAce("role1", "/a/led", PERMISSION_READ));
+    addAce(MakeRoleAce("role2", "/a/led", PERMISSION_WRITE));
+
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+
+    g_roles.push_back(MakeRole("role1"));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION, check(subjectB, "/a/led", PERMISSION_WRITE));
+
+    g_roles.push_back(MakeRole("role2"));
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/led", PERMISSION_WRITE));
+
+    // roles come from credentials and role certificates, which change without
+    // the ACL: they aren't remembered
+    g_roles.clear();
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND, check(subjectB, "/a/led", PERMISSION_READ));
+}
+
+TEST_F(PolicyEngineTest, ManyRoles)
+{
+    char roleId[ROLEID_LENGTH];
+    for (size_t i = 0; i < 2 * PE_ROLE_CURSORS_TEST; i++)
+    {
+        snprintf(roleId, sizeof(roleId), "role%u", (unsigned int)i);
+        g_roles.push_back(MakeRole(roleId));
+    }
+    addAce(MakeRoleAce(roleId, "/a/led", PERMISSION_READ));
+
+    EXPECT_EQ(ACCESS_GRANTED, check(subjectB, "/a/led", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_RESOURCE_NOT_FOUND, check(subjectB, "/a/fan", PERMISSION_READ));
+}
+#endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
@@ -0,0 +1,62 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+// The policy engine of policyengine.cpp: the roles of an endpoint come from
+// GetEndpointRolesTest() and the remembered decisions can be inspected.
+
+// Test function hooks
+#define GetEndpointRoles GetEndpointRolesTest
+#define CheckPermission CheckPermissionTest
+#define DeInitPolicyEngine DeInitPolicyEngineTest
+#define GetPermissionFromCAMethod_t GetPermissionFromCAMethod_tTest
+#define IsRequestFromResourceOwner IsRequestFromResourceOwnerTest
+#define IsRequestFromDoxs IsRequestFromDoxsTest
+#define IsRequestFromAms IsRequestFromAmsTest
+#define IsRequestFromCms IsRequestFromCmsTest
+
+#include "../src/policyengine.c"
+
+const size_t PE_DECISION_CACHE_SIZE_TEST = PE_DECISION_CACHE_SIZE;
+const size_t PE_ROLE_CURSORS_TEST = PE_ROLE_CURSORS;
+
+size_t GetDecisionCountTest(void)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE; i++)
+    {
+        if (gDecisions[i].used)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool IsDecisionRememberedTest(const char *uri)
+{
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE; i++)
+    {
+        if (gDecisions[i].used && (0 == strcmp(gDecisions[i].resourceUri, uri)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,239 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "ocstack.h"
+#include "oic_malloc.h"
+#include "psinterface.h"
+#include "srmtestcommon.h"
+
+#define PS_TEST_DATABASE "psinterface_test.dat"
+
+static size_t s_rewrites = 0;
+
+/**
+ * Opens files like fopen, counting the databases replaced instead of appended to.
+ */
+static FILE *CountingOpen(const char *path, const char *mode)
+{
+    if (0 == strcmp(mode, "wb"))
+    {
+        s_rewrites++;
+    }
+    return fopen(path, mode);
+}
+
+class PSInterfaceTest : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        remove(PS_TEST_DATABASE);
+        SetPersistentHandler(&m_ps, true);
+        m_ps.open = CountingOpen;
+        s_rewrites = 0;
+    }
+
+    virtual void TearDown()
+    {
+        SetPersistentHandler(&m_ps, false);
+        remove(PS_TEST_DATABASE);
+    }
+
+    static size_t GetFileSize()
+    {
+        size_t size = 0;
+        FILE *fp = fopen(PS_TEST_DATABASE, "rb");
+        if (fp)
+        {
+            fseek(fp, 0, SEEK_END);
+            size = (size_t)ftell(fp);
+            fclose(fp);
+        }
+        return size;
+    }
+
+    static void ExpectSection(const char *name, const uint8_t *expected, size_t expectedSize)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        ASSERT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, name, &data, &size));
+        ASSERT_EQ(expectedSize, size);
+        EXPECT_EQ(0, memcmp(expected, data, size));
+        OICFree(data);
+    }
+
+    OCPersistentStorage m_ps;
+};
+
+TEST_F(PSInterfaceTest, UpdateAppendsToJournal)
+{
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[] = { 0x04, 0x05 };
+    uint8_t newCred[] = { 0x06, 0x07, 0x08, 0x09 };
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+    size_t fileSize = GetFileSize();
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", newCred, sizeof(newCred)));
+    // record header, "cred" and its payload
+    EXPECT_EQ(fileSize + 1 + 5 + 5, GetFileSize());
+
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", newCred, sizeof(newCred));
+}
+
+TEST_F(PSInterfaceTest, ReadWholeDatabaseReplaysJournal)
+{
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[] = { 0x04, 0x05 };
+    uint8_t newCred[] = { 0x06 };
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", newCred, sizeof(newCred)));
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    ASSERT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, NULL, &data, &size));
+    EXPECT_GT(GetFileSize(), size);
+
+    // the whole database is a single map again
+    FILE *fp = fopen(PS_TEST_DATABASE, "wb");
+    ASSERT_TRUE(NULL != fp);
+    ASSERT_EQ(size, fwrite(data, 1, size, fp));
+    fclose(fp);
+    OICFree(data);
+
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", newCred, sizeof(newCred));
+}
+
+TEST_F(PSInterfaceTest, RemovedSectionIsNotFound)
+{
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[] = { 0x04, 0x05 };
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", NULL, 0));
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    EXPECT_NE(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, "cred", &data, &size));
+    EXPECT_TRUE(NULL == data);
+    ExpectSection("acl", acl, sizeof(acl));
+}
+
+TEST_F(PSInterfaceTest, JournalIsCompacted)
+{
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[512];
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    for (size_t i = 0; i < 100; i++)
+    {
+        memset(cred, (int)i, sizeof(cred));
+        ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+        // the journal never outgrows the compaction thresholds
+        EXPECT_GT(16 * sizeof(cred), GetFileSize());
+    }
+
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", cred, sizeof(cred));
+}
+
+TEST_F(PSInterfaceTest, TornJournalRecordIsDropped)
+{
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[] = { 0x04, 0x05 };
+    uint8_t newCred[] = { 0x06 };
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+
+    // start of a journal record whose append was interrupted
+    const uint8_t torn[] = { 0x82, 0x64, 'c', 'r' };
+    FILE *fp = fopen(PS_TEST_DATABASE, "ab");
+    ASSERT_TRUE(NULL != fp);
+    ASSERT_EQ(sizeof(torn), fwrite(torn, 1, sizeof(torn), fp));
+    fclose(fp);
+
+    ExpectSection("cred", cred, sizeof(cred));
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", newCred, sizeof(newCred)));
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", newCred, sizeof(newCred));
+
+    // the update compacted the database instead of appending after the torn record
+    uint8_t *data = NULL;
+    size_t size = 0;
+    ASSERT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, NULL, &data, &size));
+    EXPECT_EQ(GetFileSize(), size);
+    OICFree(data);
+}
+
+TEST_F(PSInterfaceTest, GrowingSectionRewritesAreAmortised)
+{
+    const size_t updates = 64;
+    const size_t entrySize = 128;
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t *cred = (uint8_t *)OICCalloc(updates, entrySize);
+    ASSERT_TRUE(NULL != cred);
+
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "acl", acl, sizeof(acl)));
+    s_rewrites = 0;
+    // like the cred list, every update writes the whole section with one more entry
+    for (size_t i = 1; i <= updates; i++)
+    {
+        memset(cred + (i - 1) * entrySize, (int)i, entrySize);
+        ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, i * entrySize));
+    }
+    // a rewrite every update or two would be quadratic, the ratio allows a few appends
+    EXPECT_GE(updates / 3, s_rewrites);
+
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", cred, updates * entrySize);
+    OICFree(cred);
+}
+
+TEST_F(PSInterfaceTest, DatabaseWithoutJournalIsRead)
+{
+    // {"acl": h'010203'}, as written before the journal existed
+    const uint8_t legacy[] = { 0xa1, 0x63, 'a', 'c', 'l', 0x43, 0x01, 0x02, 0x03 };
+    uint8_t acl[] = { 0x01, 0x02, 0x03 };
+    uint8_t cred[] = { 0x04, 0x05 };
+
+    FILE *fp = fopen(PS_TEST_DATABASE, "wb");
+    ASSERT_TRUE(NULL != fp);
+    ASSERT_EQ(sizeof(legacy), fwrite(legacy, 1, sizeof(legacy), fp));
+    fclose(fp);
+
+    ExpectSection("acl", acl, sizeof(acl));
+
+    // the update is journaled after the legacy map
+    ASSERT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, "cred", cred, sizeof(cred)));
+    EXPECT_EQ(0u, s_rewrites);
+    ExpectSection("acl", acl, sizeof(acl));
+    ExpectSection("cred", cred, sizeof(cred));
+}
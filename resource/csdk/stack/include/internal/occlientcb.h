@@ -128,14 +128,24 @@ typedef struct ClientCB {
      * can be explicitly cancelled.*/
     uint32_t TTL;
 
+    /** Deliver representations as an OCRepPayloadView, see OCDoRequestWithPayloadView().*/
+    bool payloadView;
+
+    /** Position of this callback in the timeout order, maintained by occlientcb.c.*/
+    size_t timeoutIndex;
+
     /** next node in this list.*/
     struct ClientCB    *next;
+
+    /** previous node in this list.*/
+    struct ClientCB    *prev;
 } ClientCB;
 
 //TODO: Now ocstack is directly accessing the clientCB list to process presence.
 //      It should be avoided after we make a presence feature separately.
 /**
- * Linked list of ClientCB node.
+ * Linked list of ClientCB node. Nodes are also indexed by token and handle,
+ * so it must only be modified through the functions below.
  */
 extern struct ClientCB *g_cbList;
 
@@ -160,6 +170,7 @@ extern struct ClientCB *g_cbList;
  * @param[in]  requestUri          The resource URI of the request.
  * @param[in]  resourceTypeName    The resource type associated with a presence request.
  * @param[in]  ttl                 time to live in coap_ticks for the callback.
+ * @param[in]  payloadView         Deliver representations as an OCRepPayloadView.
  *
  * @note If the handle you're looking for does not exist, the stack will reply with a RST message.
  *
@@ -180,7 +191,17 @@ OCStackResult AddClientCB(ClientCB** clientCB,
                           OCDevAddr *devAddr,
                           char *requestUri,
                           char *resourceTypeName,
-                          uint32_t ttl);
+                          uint32_t ttl,
+                          bool payloadView);
+
+/**
+ * This method is used to change the time to live of a callback node.
+ * The TTL member must not be written directly once the node is in cbList.
+ *
+ * @param[in]  cbNode               Address to client callback node.
+ * @param[in]  ttl                  time to live in coap_ticks, 0 for no timeout.
+ */
+void UpdateClientCBTTL(ClientCB *cbNode, uint32_t ttl);
 
 /**
  * This method is used to remove a callback node from cbList.
@@ -46,6 +46,22 @@
 
 #define MILLISECONDS_PER_SECOND   (1000)
 
+/**
+ * When non-zero, SendAllObserverNotification() invokes the entity handler once per group of
+ * observers that receive the same representation, i.e. the same query, accept format, accept
+ * version and kind of endpoint. The payload is encoded once and sent to every observer of the
+ * group with only the token, message type and destination changed. Virtual resources are
+ * always notified one observer at a time.
+ */
+#ifndef OBSERVE_FANOUT
+#if defined (ROUTING_GATEWAY) || defined (ROUTING_EP)
+// Route info is appended to the response options for each destination.
+#define OBSERVE_FANOUT                (0)
+#else
+#define OBSERVE_FANOUT                (1)
+#endif
+#endif
+
 /**
  * Forward declaration of resource.
  */
@@ -34,6 +34,32 @@ OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadFormat format, OCP
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size);
 
+/**
+ * Upper bound of the encoded size of a payload, computed without encoding it for
+ * representation, security, introspection and diagnostic payloads.
+ *
+ * @param payload   Payload to be encoded.
+ * @param format    Payload format the payload will be encoded in.
+ *
+ * @return number of bytes sufficient to encode the payload, 0 on error.
+ */
+size_t OCEstimatePayloadSize(OCPayload *payload, OCPayloadFormat format);
+
+/**
+ * Encode a payload into a buffer owned by the caller.
+ *
+ * @param payload       Payload to be encoded.
+ * @param format        Payload format.
+ * @param buffer        Buffer receiving the encoded payload.
+ * @param[in,out] size  Capacity of buffer on input, length of the encoded payload on output.
+ *                      If ::OC_STACK_NO_MEMORY is returned it holds the size needed instead.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NO_MEMORY if buffer is too small, some
+ *         other value upon failure.
+ */
+OCStackResult OCConvertPayloadToBuffer(OCPayload *payload, OCPayloadFormat format,
+        uint8_t *buffer, size_t *size);
+
 #ifdef __cplusplus
 }
 #endif
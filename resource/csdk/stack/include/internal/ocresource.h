@@ -193,6 +193,12 @@ typedef struct OCResource {
     /** Points to next resource in list.*/
     struct OCResource *next;
 
+    /** Points to next resource in the same bucket of the uri index.*/
+    struct OCResource *uriNext;
+
+    /** Points to next resource in the same bucket of the handle index.*/
+    struct OCResource *handleNext;
+
     /** Relative path on the device; will be combined with base url to create fully qualified path.*/
     char *uri;
 
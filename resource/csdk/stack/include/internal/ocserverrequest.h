@@ -46,6 +46,25 @@ extern "C"
  */
 typedef OCStackResult (* OCEHResponseHandler)(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Additional destination of a notification. It receives the response encoded for the
+ * request it is attached to.
+ */
+typedef struct OCNotificationTarget
+{
+    /** Token of the observe request.*/
+    uint8_t token[CA_MAX_TOKEN_LEN];
+
+    /** Token length of the observe request.*/
+    uint8_t tokenLength;
+
+    /** Quality of service decided for this observer.*/
+    OCQualityOfService qos;
+
+    /** Remote endpoint address.*/
+    OCDevAddr devAddr;
+} OCNotificationTarget;
+
 /**
  * following structure will be created in occoap and passed up the stack on the server side.
  */
@@ -121,6 +140,12 @@ typedef struct OCServerRequest
     /** Payload format retrieved from the received request PDU. */
     OCPayloadFormat payloadFormat;
 
+    /** Other observers the notification is sent to; owned by the request.*/
+    OCNotificationTarget *notificationTargets;
+
+    /** Number of entries in notificationTargets.*/
+    size_t numNotificationTargets;
+
     /** Payload Size.*/
     size_t payloadSize;
 
@@ -178,6 +178,14 @@ OCStackResult OCStackFeedBack(CAToken_t token, uint8_t tokenLength, uint8_t stat
  */
 OCStackResult HandleStackRequests(OCServerProtocolRequest * protocolRequest);
 
+/**
+ * Handle a response received from CA, calling the client callback of its request.
+ *
+ * @param endPoint          Endpoint the response came from.
+ * @param responseInfo      The response.
+ */
+void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo_t* responseInfo);
+
 OCStackResult SendDirectStackResponse(const CAEndpoint_t* endPoint, const uint16_t coapID,
         const CAResponseResult_t responseResult, const CAMessageType_t type,
         const uint8_t numOptions, const CAHeaderOption_t *options,
@@ -283,6 +291,15 @@ OCStackResult OCChangeResourceProperty(OCResourceProperty * inputProperty,
         OCResourceProperty resourceProperties, uint8_t enable);
 #endif
 
+/**
+ * Look up a resource in the hashed uri index kept alongside the resource list.
+ *
+ * @param uri   Resource uri, without query.
+ *
+ * @return the resource with exactly that uri, or NULL if there is none.
+ */
+OCResource *GetResourceFromUriIndex(const char *uri);
+
 const char *OC_CALL convertTriggerEnumToString(OCPresenceTrigger trigger);
 
 OCPresenceTrigger OC_CALL convertTriggerStringToEnum(const char * triggerStr);
@@ -390,6 +407,55 @@ OCEndpointPayload* CreateEndpointPayloadList(const OCResource *resource,
 */
 void OC_CALL OCEndpointPayloadDestroy(OCEndpointPayload* payload);
 
+/**
+ * Allocate zeroed memory for a property value of a representation payload, to be handed
+ * over to one of its *AsOwner setters. It comes from the arena of a payload created by
+ * OCRepPayloadCreateWithArena, and from the heap otherwise.
+ *
+ * @param payload   Payload the memory is for.
+ * @param size      Number of bytes.
+ *
+ * @return the memory, NULL on allocation failure.
+ */
+void *OCRepPayloadAlloc(OCRepPayload *payload, size_t size);
+
+/**
+ * Free memory from OCRepPayloadAlloc that was not handed over to the payload.
+ * Memory from the arena of a payload is only released with the payload.
+ *
+ * @param payload   Payload the memory was allocated for.
+ * @param ptr       Memory to be freed.
+ */
+void OCRepPayloadFree(const OCRepPayload *payload, void *ptr);
+
+/**
+ * Whether the values of a payload are allocated from its arena.
+ *
+ * @param payload   Payload from OCRepPayloadCreate or OCRepPayloadCreateWithArena.
+ *
+ * @return true for a payload from OCRepPayloadCreateWithArena.
+ */
+bool OCRepPayloadHasArena(const OCRepPayload *payload);
+
+/**
+ * Whether a payload keeps an index of its values by name.
+ *
+ * @param payload   Payload from OCRepPayloadCreate or OCRepPayloadCreateWithArena.
+ *
+ * @return true if lookups use the index instead of walking the values.
+ */
+bool OCRepPayloadHasIndex(const OCRepPayload *payload);
+
+/**
+ * Find a property value of a representation payload.
+ *
+ * @param payload   Payload to search.
+ * @param name      Property name.
+ *
+ * @return the value, NULL if there is no such property.
+ */
+OCRepPayloadValue *OCRepPayloadFindValue(const OCRepPayload *payload, const char *name);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -104,6 +104,17 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload);
 // Representation Payload
 OCRepPayload* OC_CALL OCRepPayloadCreate(void);
 
+/**
+ * Create a representation payload whose property names and values are carved out of
+ * memory blocks owned by the payload, which OCRepPayloadDestroy releases together.
+ * The payload is used through the same functions as one from OCRepPayloadCreate.
+ *
+ * @param sizeHint  Expected size of the properties in bytes, 0 for a default size.
+ *
+ * @return the payload, NULL on allocation failure.
+ */
+OCRepPayload* OC_CALL OCRepPayloadCreateWithArena(size_t sizeHint);
+
 size_t OC_CALL calcDimTotal(const size_t dimensions[MAX_REP_ARRAY_DEPTH]);
 
 OCRepPayload* OC_CALL OCRepPayloadClone(const OCRepPayload* payload);
@@ -264,6 +275,79 @@ bool OC_CALL OCRepPayloadGetPropObjectArray(const OCRepPayload* payload, const c
 
 void OC_CALL OCRepPayloadDestroy(OCRepPayload* payload);
 
+// Representation Payload View
+/**
+ * Create a view of a CBOR encoded representation. Properties are decoded from the
+ * buffer when they are read, instead of converting the whole representation up front.
+ * The buffer is not copied, so it must outlive the view.
+ *
+ * @param cbor      CBOR encoded representation, a map. Batch representations
+ *                  (arrays of maps) are not supported.
+ * @param size      Size of cbor in bytes.
+ * @param view      The created view, to be destroyed with OCRepPayloadViewDestroy.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_MALFORMED_RESPONSE if cbor is not a
+ *         single, complete representation, some other value upon failure.
+ */
+OCStackResult OC_CALL OCRepPayloadViewCreate(const uint8_t* cbor, size_t size,
+        OCRepPayloadView** view);
+
+bool OC_CALL OCRepPayloadViewIsNull(const OCRepPayloadView* view, const char* name);
+bool OC_CALL OCRepPayloadViewGetPropInt(const OCRepPayloadView* view, const char* name,
+        int64_t* value);
+bool OC_CALL OCRepPayloadViewGetPropDouble(const OCRepPayloadView* view, const char* name,
+        double* value);
+bool OC_CALL OCRepPayloadViewGetPropBool(const OCRepPayloadView* view, const char* name,
+        bool* value);
+
+/**
+ * Get a copy of a string property of a view, like OCRepPayloadGetPropString.
+ *
+ * @param view      View to read from.
+ * @param name      Property name.
+ * @param value     The string, to be freed with OICFree.
+ *
+ * @return true on success, false upon failure.
+ */
+bool OC_CALL OCRepPayloadViewGetPropString(const OCRepPayloadView* view, const char* name,
+        char** value);
+
+/**
+ * Get a string property of a view without copying it.
+ *
+ * @param view      View to read from.
+ * @param name      Property name.
+ * @param value     The string. It is not NUL terminated, and is only valid as long as
+ *                  the view and its buffer.
+ * @param len       Length of the string in bytes.
+ *
+ * @return true on success, false if there is no such string or it is encoded in chunks,
+ *         which OCRepPayloadViewGetPropString still reads.
+ */
+bool OC_CALL OCRepPayloadViewGetPropStringRef(const OCRepPayloadView* view, const char* name,
+        const char** value, size_t* len);
+
+/**
+ * Get a byte string property of a view without copying it.
+ * Same as OCRepPayloadViewGetPropStringRef, for byte strings.
+ */
+bool OC_CALL OCRepPayloadViewGetPropByteStringRef(const OCRepPayloadView* view,
+        const char* name, const uint8_t** value, size_t* len);
+
+/**
+ * Get the representation of a view as a payload, e.g. to modify it or to read nested
+ * objects and arrays. The representation is converted on the first call; afterwards the
+ * getters of the view read from the payload, so they see its modifications.
+ *
+ * @param view      View to convert.
+ *
+ * @return the payload, owned by the view. NULL if the representation is malformed or
+ *         on allocation failure.
+ */
+OCRepPayload* OC_CALL OCRepPayloadViewGetPayload(OCRepPayloadView* view);
+
+void OC_CALL OCRepPayloadViewDestroy(OCRepPayloadView* view);
+
 // Discovery Payload
 OCDiscoveryPayload* OC_CALL OCDiscoveryPayloadCreate(void);
 
@@ -144,6 +144,33 @@ OCStackResult OC_CALL OCStopMulticastServer(void);
  */
 OCStackResult OC_CALL OCProcess(void);
 
+/**
+ * Block until OCProcess() has work to do, OCProcessWakeUp() is called or the
+ * timeout expires. Lets the main loop sleep instead of polling OCProcess().
+ * Unlike OCProcess() this may be called without holding the lock the
+ * application uses to serialize calls into the stack.
+ *
+ * @param timeoutMs    Maximum time to wait in milliseconds, 0 to wait until
+ *                     there is work. The wait may end earlier when OCProcess()
+ *                     has timed work pending.
+ * @param wakeUps      Wake-up count owned by the calling loop, 0 before its
+ *                     first wait. Returns at once if OCProcessWakeUp() was called
+ *                     since the previous wait of this loop returned, so a loop
+ *                     that checks its stop flag before waiting can't miss the
+ *                     wake-up that goes with it. Every thread calling
+ *                     OCProcessWait() needs its own count. May be NULL.
+ *
+ * @return ::OC_STACK_OK if OCProcess() has work, ::OC_STACK_TIMEOUT if the
+ *         timeout expired or the wait was woken up, some other value upon failure.
+ */
+OCStackResult OC_CALL OCProcessWait(uint32_t timeoutMs, uint32_t *wakeUps);
+
+/**
+ * Make all threads blocked in OCProcessWait() return, and the next call of
+ * each loop that has not seen this wake-up yet.
+ */
+void OC_CALL OCProcessWakeUp(void);
+
 /**
  * This function discovers or Perform requests on a specified resource
  * (specified by that Resource's respective URI).
@@ -236,6 +263,27 @@ OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
                           OCHeaderOption *options,
                           uint8_t numOptions);
 
+/**
+ * Same as OCDoRequest(), except for how the representations of the responses are delivered.
+ * OCDoRequest() gives the client callback an ::OCRepPayload, converted from the whole response.
+ * This function gives it an ::OCRepPayloadView of the received buffer instead, which only
+ * decodes the properties that are read; OCRepPayloadViewGetPayload() converts it if needed.
+ * The view is only valid during the callback. Responses that are not a single, complete
+ * representation, e.g. to batch requests, are still delivered as an ::OCRepPayload.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCDoRequestWithPayloadView(OCDoHandle *handle,
+                          OCMethod method,
+                          const char *requestUri,
+                          const OCDevAddr *destination,
+                          OCPayload* payload,
+                          OCConnectivityType connectivityType,
+                          OCQualityOfService qos,
+                          OCCallbackData *cbData,
+                          OCHeaderOption *options,
+                          uint8_t numOptions);
+
 /**
  * This function cancels a request associated with a specific @ref OCDoResource invocation.
  *
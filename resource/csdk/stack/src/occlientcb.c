@@ -24,6 +24,7 @@
 #include "experimental/logger.h"
 #include "trace.h"
 #include "oic_malloc.h"
+#include <stdint.h>
 #include <string.h>
 
 #ifdef HAVE_SYS_TIME_H
@@ -36,6 +37,34 @@
 /// Module Name
 #define TAG "OIC_RI_CLIENTCB"
 
+/// Initial number of slots of a callback index, a power of two
+#define CB_INDEX_INITIAL_CAPACITY 32
+
+/// Marks a timeout order position as unused
+#define CB_NO_TIMEOUT SIZE_MAX
+
+/**
+ * Open addressing index over the callback nodes, linear probing.
+ * Removed nodes leave a tombstone so probe sequences stay intact.
+ */
+typedef struct
+{
+    ClientCB **slots;
+    size_t capacity;
+    size_t count;
+    size_t used;
+    size_t (*hash)(const ClientCB *cbNode);
+} ClientCBIndex;
+
+/**
+ * Entry of the timeout order, a binary min-heap on the TTL.
+ */
+typedef struct
+{
+    uint32_t TTL;
+    ClientCB *cbNode;
+} ClientCBTimeout;
+
 //-------------------------------------------------------------------------------------------------
 // Private variables
 //-------------------------------------------------------------------------------------------------
@@ -43,9 +72,288 @@
 //      This should be static variable after we make a presence feature separately.
 struct ClientCB *g_cbList = NULL;
 
+static size_t HashClientCBToken(const ClientCB *cbNode);
+static size_t HashClientCBHandle(const ClientCB *cbNode);
+static size_t HashClientCBNode(const ClientCB *cbNode);
+
+/// Nodes by token, for response dispatch
+static ClientCBIndex g_tokenIndex = { NULL, 0, 0, 0, HashClientCBToken };
+
+/// Nodes by invocation handle
+static ClientCBIndex g_handleIndex = { NULL, 0, 0, 0, HashClientCBHandle };
+
+/// Nodes by address, to tell whether a node is still in the list
+static ClientCBIndex g_nodeIndex = { NULL, 0, 0, 0, HashClientCBNode };
+
+/// Tombstone left behind by a removed index entry
+static char g_removedSlot;
+#define CB_INDEX_REMOVED ((ClientCB *) &g_removedSlot)
+
+/// Nodes with a TTL, the first one times out first
+static ClientCBTimeout *g_timeouts = NULL;
+static size_t g_timeoutCount = 0;
+static size_t g_timeoutCapacity = 0;
+
 //-------------------------------------------------------------------------------------------------
 // Local functions
 //-------------------------------------------------------------------------------------------------
+static size_t HashBytes(const uint8_t *data, size_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t HashPointer(const void *pointer)
+{
+    uintptr_t value = (uintptr_t) pointer;
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return (size_t) value;
+}
+
+static size_t HashClientCBToken(const ClientCB *cbNode)
+{
+    return HashBytes((const uint8_t *) cbNode->token, cbNode->tokenLength);
+}
+
+static size_t HashClientCBHandle(const ClientCB *cbNode)
+{
+    return HashPointer(cbNode->handle);
+}
+
+static size_t HashClientCBNode(const ClientCB *cbNode)
+{
+    return HashPointer(cbNode);
+}
+
+static void PlaceInIndex(ClientCB **slots, size_t capacity, ClientCB *cbNode, size_t hash)
+{
+    size_t i = hash & (capacity - 1);
+    while (slots[i] && slots[i] != CB_INDEX_REMOVED)
+    {
+        i = (i + 1) & (capacity - 1);
+    }
+    slots[i] = cbNode;
+}
+
+static bool ResizeIndex(ClientCBIndex *index, size_t capacity)
+{
+    ClientCB **slots = (ClientCB **) OICCalloc(capacity, sizeof(ClientCB *));
+    if (!slots)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < index->capacity; i++)
+    {
+        ClientCB *cbNode = index->slots[i];
+        if (cbNode && cbNode != CB_INDEX_REMOVED)
+        {
+            PlaceInIndex(slots, capacity, cbNode, index->hash(cbNode));
+        }
+    }
+
+    OICFree(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    index->used = index->count;
+    return true;
+}
+
+static bool AddToIndex(ClientCBIndex *index, ClientCB *cbNode)
+{
+    // keep at most 3/4 of the slots in use so every probe ends on an empty slot
+    if ((index->used + 1) * 4 > index->capacity * 3)
+    {
+        size_t capacity = index->capacity ? index->capacity : CB_INDEX_INITIAL_CAPACITY;
+        while ((index->count + 1) * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+        if (!ResizeIndex(index, capacity))
+        {
+            return false;
+        }
+    }
+
+    size_t i = index->hash(cbNode) & (index->capacity - 1);
+    while (index->slots[i] && index->slots[i] != CB_INDEX_REMOVED)
+    {
+        i = (i + 1) & (index->capacity - 1);
+    }
+    if (!index->slots[i])
+    {
+        index->used++;
+    }
+    index->slots[i] = cbNode;
+    index->count++;
+    return true;
+}
+
+/*
+ * Looks the node up by its address only, so this is safe to call with a
+ * pointer to a node that has already been deleted.
+ */
+static ClientCB **FindInIndex(ClientCBIndex *index, const ClientCB *cbNode, size_t hash)
+{
+    if (!index->capacity)
+    {
+        return NULL;
+    }
+
+    for (size_t i = hash & (index->capacity - 1); index->slots[i];
+         i = (i + 1) & (index->capacity - 1))
+    {
+        if (index->slots[i] == cbNode)
+        {
+            return &index->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void RemoveFromIndex(ClientCBIndex *index, const ClientCB *cbNode)
+{
+    ClientCB **slot = FindInIndex(index, cbNode, index->hash(cbNode));
+    if (slot)
+    {
+        *slot = CB_INDEX_REMOVED;
+        index->count--;
+    }
+}
+
+static void ClearIndex(ClientCBIndex *index)
+{
+    OICFree(index->slots);
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->used = 0;
+}
+
+static void SwapTimeouts(size_t a, size_t b)
+{
+    ClientCBTimeout tmp = g_timeouts[a];
+    g_timeouts[a] = g_timeouts[b];
+    g_timeouts[b] = tmp;
+    g_timeouts[a].cbNode->timeoutIndex = a;
+    g_timeouts[b].cbNode->timeoutIndex = b;
+}
+
+static void SiftTimeoutUp(size_t i)
+{
+    while (i > 0 && g_timeouts[i].TTL < g_timeouts[(i - 1) / 2].TTL)
+    {
+        SwapTimeouts(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void SiftTimeoutDown(size_t i)
+{
+    for (;;)
+    {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < g_timeoutCount && g_timeouts[left].TTL < g_timeouts[smallest].TTL)
+        {
+            smallest = left;
+        }
+        if (right < g_timeoutCount && g_timeouts[right].TTL < g_timeouts[smallest].TTL)
+        {
+            smallest = right;
+        }
+        if (smallest == i)
+        {
+            return;
+        }
+        SwapTimeouts(i, smallest);
+        i = smallest;
+    }
+}
+
+static bool AddTimeout(ClientCB *cbNode)
+{
+    if (g_timeoutCount == g_timeoutCapacity)
+    {
+        size_t capacity = g_timeoutCapacity ? g_timeoutCapacity * 2 : CB_INDEX_INITIAL_CAPACITY;
+        ClientCBTimeout *timeouts = (ClientCBTimeout *) OICRealloc(g_timeouts,
+                                                    capacity * sizeof(ClientCBTimeout));
+        if (!timeouts)
+        {
+            return false;
+        }
+        g_timeouts = timeouts;
+        g_timeoutCapacity = capacity;
+    }
+
+    size_t i = g_timeoutCount++;
+    g_timeouts[i].TTL = cbNode->TTL;
+    g_timeouts[i].cbNode = cbNode;
+    cbNode->timeoutIndex = i;
+    SiftTimeoutUp(i);
+    return true;
+}
+
+static void RemoveTimeout(ClientCB *cbNode)
+{
+    size_t i = cbNode->timeoutIndex;
+    if (CB_NO_TIMEOUT == i)
+    {
+        return;
+    }
+
+    cbNode->timeoutIndex = CB_NO_TIMEOUT;
+    g_timeoutCount--;
+    if (i != g_timeoutCount)
+    {
+        g_timeouts[i] = g_timeouts[g_timeoutCount];
+        g_timeouts[i].cbNode->timeoutIndex = i;
+        SiftTimeoutUp(i);
+        SiftTimeoutDown(i);
+    }
+}
+
+/*
+ * Adds the node to every index. Undoes what was done if one of them fails.
+ */
+static bool IndexClientCB(ClientCB *cbNode)
+{
+    cbNode->timeoutIndex = CB_NO_TIMEOUT;
+
+    if (!AddToIndex(&g_nodeIndex, cbNode))
+    {
+        return false;
+    }
+    if (!AddToIndex(&g_handleIndex, cbNode))
+    {
+        RemoveFromIndex(&g_nodeIndex, cbNode);
+        return false;
+    }
+    if (!AddToIndex(&g_tokenIndex, cbNode))
+    {
+        RemoveFromIndex(&g_handleIndex, cbNode);
+        RemoveFromIndex(&g_nodeIndex, cbNode);
+        return false;
+    }
+    if (cbNode->TTL != 0 && !AddTimeout(cbNode))
+    {
+        RemoveFromIndex(&g_tokenIndex, cbNode);
+        RemoveFromIndex(&g_handleIndex, cbNode);
+        RemoveFromIndex(&g_nodeIndex, cbNode);
+        return false;
+    }
+    return true;
+}
+
 static void DeleteClientCBInternal(ClientCB * cbNode)
 {
     assert(cbNode);
@@ -56,7 +364,11 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
     OIC_TRACE_BUFFER("OIC_RI_CLIENTCB:DeleteClientCB:token:",
                      (const uint8_t *)cbNode->token, cbNode->tokenLength);
 
-    LL_DELETE(g_cbList, cbNode);
+    RemoveTimeout(cbNode);
+    RemoveFromIndex(&g_tokenIndex, cbNode);
+    RemoveFromIndex(&g_handleIndex, cbNode);
+    RemoveFromIndex(&g_nodeIndex, cbNode);
+    DL_DELETE(g_cbList, cbNode);
     CADestroyToken(cbNode->token);
     OICFree(cbNode->devAddr);
     OICFree(cbNode->handle);
@@ -106,27 +418,40 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
 }
 
 /*
- * This function checks if the node is past its time to live and
- * deletes it if timed-out. Calling this function with a  presence or observe
- * callback with ttl set to 0 will not delete anything as presence nodes have
- * their own mechanisms for timeouts. A null argument will cause the function to
- * silently return.
+ * This function deletes the callbacks that are past their time to live, in
+ * order of their TTL. Presence and observe callbacks with ttl set to 0 are never
+ * in the timeout order as presence nodes have their own mechanisms for timeouts.
+ * The node just looked up is kept, the same as before it was found.
  */
-static void CheckAndDeleteTimedOutCB(ClientCB * cbNode)
+static void DeleteTimedOutCBs(ClientCB *keep)
 {
-    assert(cbNode);
-
-    if (cbNode->TTL == 0)
+    if (0 == g_timeoutCount)
     {
         return;
     }
+
     coap_tick_t now;
     coap_ticks(&now);
 
-    if (cbNode->TTL < now)
+    // Take the kept node out of the order, so it does not hide the expired ones after it.
+    bool reorderKeep = (keep && CB_NO_TIMEOUT != keep->timeoutIndex);
+    if (reorderKeep)
+    {
+        RemoveTimeout(keep);
+    }
+
+    while (g_timeoutCount > 0 && g_timeouts[0].TTL < now)
     {
         OIC_LOG(INFO, TAG, "Deleting timed-out callback");
-        DeleteClientCBInternal(cbNode);
+        DeleteClientCBInternal(g_timeouts[0].cbNode);
+    }
+
+    if (reorderKeep)
+    {
+        // cannot fail, the slot the node left is still allocated
+        bool added = AddTimeout(keep);
+        assert(added);
+        OC_UNUSED(added);
     }
 }
 
@@ -167,7 +492,8 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
                           CAPayloadFormat_t payloadFormat,
                           OCDoHandle *handle, OCMethod method,
                           OCDevAddr *devAddr, char *requestUri,
-                          char *resourceTypeName, uint32_t ttl)
+                          char *resourceTypeName, uint32_t ttl,
+                          bool payloadView)
 {
     if (!clientCB || !cbData || !handle || tokenLength > CA_MAX_TOKEN_LEN)
     {
@@ -201,6 +527,7 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         cbNode->callBack = cbData->cb;
         cbNode->context = cbData->context;
         cbNode->deleteCallback = cbData->cd;
+        cbNode->payloadView = payloadView;
 
         if (!options || !numOptions)
         {
@@ -270,9 +597,18 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         }
         cbNode->requestUri = requestUri;    // I own it now
         cbNode->devAddr = devAddr;          // I own it now
+        if (!IndexClientCB(cbNode))
+        {
+            OIC_LOG(ERROR, TAG, "Out of memory");
+            OICFree(cbNode->options);
+            OICFree(cbNode->payload);
+            OICFree(cbNode);
+            *clientCB = NULL;
+            goto exit;
+        }
         OIC_LOG_V(INFO, TAG, "Added Callback for uri : %s", requestUri);
         OIC_TRACE_MARK(%s:AddClientCB:uri:%s, TAG, requestUri);
-        LL_APPEND(g_cbList, cbNode);
+        DL_APPEND(g_cbList, cbNode);
         *clientCB = cbNode;
     }
 #ifdef WITH_PRESENCE
@@ -317,19 +653,41 @@ exit:
     return OC_STACK_NO_MEMORY;
 }
 
+void UpdateClientCBTTL(ClientCB *cbNode, uint32_t ttl)
+{
+    if (!cbNode)
+    {
+        return;
+    }
+
+    cbNode->TTL = ttl;
+    if (0 == ttl)
+    {
+        RemoveTimeout(cbNode);
+    }
+    else if (CB_NO_TIMEOUT == cbNode->timeoutIndex)
+    {
+        if (!AddTimeout(cbNode))
+        {
+            OIC_LOG(ERROR, TAG, "Out of memory, callback will not time out");
+        }
+    }
+    else
+    {
+        g_timeouts[cbNode->timeoutIndex].TTL = ttl;
+        SiftTimeoutUp(cbNode->timeoutIndex);
+        SiftTimeoutDown(cbNode->timeoutIndex);
+    }
+}
+
 void DeleteClientCB(ClientCB * cbNode)
 {
     if (cbNode)
     {
-        ClientCB* out = NULL;
-        ClientCB* tmp = NULL;
-        LL_FOREACH_SAFE(g_cbList, out, tmp)
+        // the node may already be gone, so only its address is looked at
+        if (FindInIndex(&g_nodeIndex, cbNode, HashPointer(cbNode)))
         {
-            if (cbNode == out)
-            {
-                DeleteClientCBInternal(out);
-                break;
-            }
+            DeleteClientCBInternal(cbNode);
         }
     }
 }
@@ -338,11 +696,19 @@ void DeleteClientCBList(void)
 {
     ClientCB* out = NULL;
     ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    DL_FOREACH_SAFE(g_cbList, out, tmp)
     {
         DeleteClientCBInternal(out);
     }
     g_cbList = NULL;
+
+    ClearIndex(&g_tokenIndex);
+    ClearIndex(&g_handleIndex);
+    ClearIndex(&g_nodeIndex);
+    OICFree(g_timeouts);
+    g_timeouts = NULL;
+    g_timeoutCount = 0;
+    g_timeoutCapacity = 0;
 }
 
 ClientCB* GetClientCBUsingToken(const CAToken_t token,
@@ -358,17 +724,28 @@ ClientCB* GetClientCBUsingToken(const CAToken_t token,
     OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)token, tokenLength);
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    if (g_tokenIndex.capacity)
     {
-        /* de-annotate below line if want to see all token in g_cbList */
-        //OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->token, tokenLength);
-        if (memcmp(out->token, token, tokenLength) == 0)
+        size_t mask = g_tokenIndex.capacity - 1;
+        for (size_t i = HashBytes((const uint8_t *)token, tokenLength) & mask;
+             g_tokenIndex.slots[i]; i = (i + 1) & mask)
         {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
+            ClientCB *cbNode = g_tokenIndex.slots[i];
+            if (cbNode != CB_INDEX_REMOVED && cbNode->tokenLength == tokenLength
+                && memcmp(cbNode->token, token, tokenLength) == 0)
+            {
+                out = cbNode;
+                break;
+            }
         }
-        CheckAndDeleteTimedOutCB(out);
+    }
+
+    DeleteTimedOutCBs(out);
+
+    if (out)
+    {
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -386,15 +763,26 @@ ClientCB* GetClientCBUsingHandle(const OCDoHandle handle)
     OIC_LOG(INFO, TAG,  "Looking for handle");
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    if (g_handleIndex.capacity)
     {
-        if (out->handle == handle)
+        size_t mask = g_handleIndex.capacity - 1;
+        for (size_t i = HashPointer(handle) & mask; g_handleIndex.slots[i]; i = (i + 1) & mask)
         {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
+            ClientCB *cbNode = g_handleIndex.slots[i];
+            if (cbNode != CB_INDEX_REMOVED && cbNode->handle == handle)
+            {
+                out = cbNode;
+                break;
+            }
         }
-        CheckAndDeleteTimedOutCB(out);
+    }
+
+    DeleteTimedOutCBs(out);
+
+    if (out)
+    {
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -420,10 +808,16 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
         //OIC_LOG_V(INFO, TAG, "%s", out->requestUri);
         if (out->requestUri && strcmp(out->requestUri, requestUri ) == 0)
         {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
+            break;
         }
-        CheckAndDeleteTimedOutCB(out);
+    }
+
+    DeleteTimedOutCBs(out);
+
+    if (out)
+    {
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
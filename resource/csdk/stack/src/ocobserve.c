@@ -100,12 +100,17 @@ static OCQualityOfService DetermineObserverQoS(OCMethod method,
  *
  * @param observer Observer that need to be notified.
  * @param qos Quality of service of resource.
+ * @param targets Other observers to send the same response to, or NULL. Ownership
+ *                passes to this function.
+ * @param numTargets Number of entries in targets.
  *
  * @return ::OC_STACK_OK on success, some other value upon failure.
  */
 static OCStackResult SendObserveNotification(ResourceObserver *observer,
                                              uint32_t sequenceNum,
-                                             OCQualityOfService qos)
+                                             OCQualityOfService qos,
+                                             OCNotificationTarget *targets,
+                                             size_t numTargets)
 {
     OCStackResult result = OC_STACK_ERROR;
     OCServerRequest * request = NULL;
@@ -117,9 +122,15 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
                               observer->resUri, 0, observer->acceptFormat,
                               observer->acceptVersion, &observer->devAddr);
 
-    if (request)
+    if (!request)
+    {
+        OICFree(targets);
+    }
+    else
     {
         request->observeResult = OC_STACK_OK;
+        request->notificationTargets = targets;
+        request->numNotificationTargets = numTargets;
         if (result == OC_STACK_OK)
         {
             ResourceHandling resHandling = OC_RESOURCE_VIRTUAL;
@@ -137,6 +148,157 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
     return result;
 }
 
+#if OBSERVE_FANOUT
+/**
+ * Observers of a resource that receive the same representation.
+ */
+typedef struct
+{
+    /** Observer the entity handler is invoked for.*/
+    ResourceObserver *leader;
+
+    /** Quality of service decided for the leader.*/
+    OCQualityOfService qos;
+
+    /** The other observers of the group.*/
+    OCNotificationTarget *targets;
+
+    /** Number of entries in targets.*/
+    size_t numTargets;
+
+    /** Allocated entries in targets.*/
+    size_t capacity;
+} NotificationGroup;
+
+static bool IsSameNotificationGroup(const ResourceObserver *a, const ResourceObserver *b)
+{
+    return a->acceptFormat == b->acceptFormat
+        && a->acceptVersion == b->acceptVersion
+        && a->devAddr.adapter == b->devAddr.adapter
+        && a->devAddr.flags == b->devAddr.flags
+        && 0 == strcmp(a->resUri, b->resUri)
+        && 0 == strcmp(a->query ? a->query : "", b->query ? b->query : "");
+}
+
+static bool AddNotificationTarget(NotificationGroup *group, const ResourceObserver *observer,
+                                  OCQualityOfService qos)
+{
+    if (observer->tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        return false;
+    }
+    if (group->numTargets == group->capacity)
+    {
+        size_t capacity = group->capacity ? group->capacity * 2 : 8;
+        OCNotificationTarget *targets = (OCNotificationTarget *)
+                OICRealloc(group->targets, capacity * sizeof(OCNotificationTarget));
+        if (!targets)
+        {
+            return false;
+        }
+        group->targets = targets;
+        group->capacity = capacity;
+    }
+
+    OCNotificationTarget *target = &group->targets[group->numTargets++];
+    memcpy(target->token, observer->token, observer->tokenLength);
+    target->tokenLength = observer->tokenLength;
+    target->qos = qos;
+    target->devAddr = observer->devAddr;
+    return true;
+}
+
+/**
+ * Notify all observers of a resource, invoking the entity handler and encoding the
+ * payload once per group of observers that receive the same representation.
+ *
+ * @param method RESTful method.
+ * @param resPtr Observed resource.
+ * @param qos Quality of service of resource.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult SendGroupedObserverNotification(OCMethod method, OCResource *resPtr,
+                                                     OCQualityOfService qos)
+{
+    OCStackResult result = OC_STACK_ERROR;
+    bool observeErrorFlag = false;
+    NotificationGroup *groups = NULL;
+    size_t numGroups = 0;
+    size_t capacity = 0;
+
+    for (ResourceObserver *observer = resPtr->observersHead; observer; observer = observer->next)
+    {
+        qos = DetermineObserverQoS(method, observer, qos);
+
+        size_t i = 0;
+        while (i < numGroups && !IsSameNotificationGroup(groups[i].leader, observer))
+        {
+            i++;
+        }
+
+        if (i < numGroups)
+        {
+            if (AddNotificationTarget(&groups[i], observer, qos))
+            {
+                // Reset Observer TTL.
+                observer->TTL = GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
+                continue;
+            }
+        }
+        else
+        {
+            if (numGroups == capacity)
+            {
+                size_t newCapacity = capacity ? capacity * 2 : 4;
+                NotificationGroup *newGroups = (NotificationGroup *)
+                        OICRealloc(groups, newCapacity * sizeof(NotificationGroup));
+                if (newGroups)
+                {
+                    groups = newGroups;
+                    capacity = newCapacity;
+                }
+            }
+            if (numGroups < capacity)
+            {
+                NotificationGroup *group = &groups[numGroups++];
+                memset(group, 0, sizeof(*group));
+                group->leader = observer;
+                group->qos = qos;
+                continue;
+            }
+        }
+
+        // Out of memory: fall back to notifying this observer on its own.
+        result = SendObserveNotification(observer, resPtr->sequenceNum, qos, NULL, 0);
+        if (result != OC_STACK_OK)
+        {
+            observeErrorFlag = true;
+        }
+    }
+
+    for (size_t i = 0; i < numGroups; i++)
+    {
+        OIC_LOG_V(INFO, TAG, "Notifying %u observers with one encoded payload",
+                  (unsigned int) (groups[i].numTargets + 1));
+        result = SendObserveNotification(groups[i].leader, resPtr->sequenceNum, groups[i].qos,
+                                         groups[i].targets, groups[i].numTargets);
+        if (result != OC_STACK_OK)
+        {
+            observeErrorFlag = true;
+        }
+    }
+    OICFree(groups);
+
+    if (observeErrorFlag)
+    {
+        OIC_LOG(ERROR, TAG, "Observer notification error");
+        result = OC_STACK_ERROR;
+    }
+    return result;
+}
+#endif // OBSERVE_FANOUT
+
 #ifdef WITH_PRESENCE
 OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr, uint32_t maxAge,
         OCPresenceTrigger trigger, OCResourceType *resourceType, OCQualityOfService qos)
@@ -156,6 +318,18 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         return OC_STACK_NO_OBSERVERS;
     }
 
+#if OBSERVE_FANOUT
+    // The representation of virtual resources depends on the requesting endpoint.
+#ifdef WITH_PRESENCE
+    if (method != OC_REST_PRESENCE && OC_UNKNOWN_URI == GetTypeOfVirtualURI(resPtr->uri))
+#else
+    if (OC_UNKNOWN_URI == GetTypeOfVirtualURI(resPtr->uri))
+#endif
+    {
+        return SendGroupedObserverNotification(method, resPtr, qos);
+    }
+#endif
+
     OCStackResult result = OC_STACK_ERROR;
     ResourceObserver * resourceObserver = resPtr->observersHead;
     OCServerRequest * request = NULL;
@@ -169,7 +343,8 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         {
 #endif
             qos = DetermineObserverQoS(method, resourceObserver, qos);
-            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos);
+            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos,
+                                             NULL, 0);
 #ifdef WITH_PRESENCE
         }
         else
@@ -449,7 +624,7 @@ static void CheckTimedOutObserver(ResourceObserver* observer, OCResource *resour
     {
         // Send confirmable notification message to observer.
         OIC_LOG(INFO, TAG, "Sending High-QoS notification to observer");
-        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS);
+        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS, NULL, 0);
     }
 }
 
@@ -40,7 +40,405 @@
 #define CSV_SEPARATOR ','
 #define MASK_SECURE_FAMS (OC_FLAG_SECURE | OC_MASK_FAMS)
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val);
+static void OCFreeRepPayloadValueContents(const OCRepPayload* payload, OCRepPayloadValue* val);
+
+/**
+ * Default size of the first block of an arena-allocated payload.
+ */
+#define OC_REP_PAYLOAD_ARENA_SIZE 256
+
+/**
+ * Largest block an arena grows by, unless a single allocation needs more.
+ */
+#define OC_REP_PAYLOAD_ARENA_MAX_BLOCK_SIZE 4096
+
+/**
+ * Alignment of the allocations from an arena, enough for any property value.
+ */
+#define OC_REP_PAYLOAD_ARENA_ALIGNMENT 8
+
+/**
+ * Number of values from which a payload keeps an index of its values.
+ */
+#define OC_REP_PAYLOAD_INDEX_THRESHOLD 8
+
+/**
+ * A block of an arena.
+ */
+typedef struct OCPayloadArenaBlock
+{
+    struct OCPayloadArenaBlock *next;   /**< Block that filled up before this one. */
+    uint8_t *data;
+    size_t size;
+    size_t used;
+} OCPayloadArenaBlock;
+
+/**
+ * Heap memory handed over to an arena-allocated payload by the *AsOwner setters.
+ */
+typedef struct OCRepPayloadOwned
+{
+    struct OCRepPayloadOwned *next;
+    size_t count;
+    void **ptrs;
+} OCRepPayloadOwned;
+
+/**
+ * Memory of the values of an arena-allocated payload. Allocations are carved out of
+ * the current block and are all released when the payload is destroyed.
+ */
+typedef struct OCPayloadArena
+{
+    OCPayloadArenaBlock *blocks;        /**< Current block, earlier blocks follow. */
+    OCRepPayloadOwned *owned;
+    OCPayloadArenaBlock first;          /**< Block allocated with the payload. */
+} OCPayloadArena;
+
+/**
+ * Open-addressing index of the values of a payload by name. Values are never removed
+ * from a payload, so lookups stop at the first empty slot.
+ */
+typedef struct OCRepPayloadIndex
+{
+    size_t count;                       /**< Number of values. */
+    size_t capacity;                    /**< Number of slots, a power of 2. */
+    OCRepPayloadValue *tail;            /**< Last value, new values are appended to it. */
+    OCRepPayloadValue **slots;
+} OCRepPayloadIndex;
+
+/**
+ * A representation payload together with the state the stack keeps for it. Every
+ * OCRepPayload is allocated as one, so the public structure keeps its layout.
+ */
+typedef struct
+{
+    OCRepPayload payload;
+    OCPayloadArena *arena;              /**< Memory of the values, NULL for heap values. */
+    OCRepPayloadIndex *index;           /**< Only kept for payloads with many values. */
+} OCRepPayloadPrivate;
+
+/**
+ * An arena-allocated payload, allocated as a whole with the data of its first block.
+ */
+typedef struct
+{
+    OCRepPayloadPrivate payload;
+    OCPayloadArena arena;
+} OCRepArenaPayload;
+
+static OCPayloadArena *OCRepPayloadGetArena(const OCRepPayload *payload)
+{
+    return ((const OCRepPayloadPrivate *)payload)->arena;
+}
+
+static OCRepPayloadIndex *OCRepPayloadGetIndex(const OCRepPayload *payload)
+{
+    return ((const OCRepPayloadPrivate *)payload)->index;
+}
+
+static void OCRepPayloadSetIndex(OCRepPayload *payload, OCRepPayloadIndex *index)
+{
+    ((OCRepPayloadPrivate *)payload)->index = index;
+}
+
+static uintptr_t OCPayloadArenaAlign(uintptr_t address)
+{
+    return (address + OC_REP_PAYLOAD_ARENA_ALIGNMENT - 1) &
+           ~(uintptr_t)(OC_REP_PAYLOAD_ARENA_ALIGNMENT - 1);
+}
+
+static void *OCPayloadArenaAlloc(OCPayloadArena *arena, size_t size)
+{
+    OCPayloadArenaBlock *block = arena->blocks;
+    uintptr_t start = OCPayloadArenaAlign((uintptr_t)(block->data + block->used));
+    size_t offset = (size_t)(start - (uintptr_t)block->data);
+
+    if ((offset > block->size) || (size > block->size - offset))
+    {
+        if (size > SIZE_MAX - sizeof(OCPayloadArenaBlock) - OC_REP_PAYLOAD_ARENA_ALIGNMENT)
+        {
+            return NULL;
+        }
+
+        size_t blockSize = block->size * 2;
+        if (blockSize > OC_REP_PAYLOAD_ARENA_MAX_BLOCK_SIZE)
+        {
+            blockSize = OC_REP_PAYLOAD_ARENA_MAX_BLOCK_SIZE;
+        }
+        if (blockSize < size + OC_REP_PAYLOAD_ARENA_ALIGNMENT)
+        {
+            blockSize = size + OC_REP_PAYLOAD_ARENA_ALIGNMENT;
+        }
+
+        block = (OCPayloadArenaBlock *)OICCalloc(1, sizeof(OCPayloadArenaBlock) + blockSize);
+        if (!block)
+        {
+            return NULL;
+        }
+        block->data = (uint8_t *)(block + 1);
+        block->size = blockSize;
+        block->next = arena->blocks;
+        arena->blocks = block;
+
+        start = OCPayloadArenaAlign((uintptr_t)block->data);
+        offset = (size_t)(start - (uintptr_t)block->data);
+    }
+
+    block->used = offset + size;
+    return (void *)start;
+}
+
+static bool OCPayloadArenaContains(const OCPayloadArena *arena, const void *ptr)
+{
+    for (const OCPayloadArenaBlock *block = arena->blocks; block; block = block->next)
+    {
+        if (((const uint8_t *)ptr >= block->data) &&
+            ((const uint8_t *)ptr < block->data + block->size))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void OCPayloadArenaDestroy(OCPayloadArena *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    for (OCRepPayloadOwned *owned = arena->owned; owned; owned = owned->next)
+    {
+        for (size_t i = 0; i < owned->count; i++)
+        {
+            OICFree(owned->ptrs[i]);
+        }
+    }
+
+    OCPayloadArenaBlock *block = arena->blocks;
+    while (block && (block != &arena->first))
+    {
+        OCPayloadArenaBlock *next = block->next;
+        OICFree(block);
+        block = next;
+    }
+}
+
+void *OCRepPayloadAlloc(OCRepPayload *payload, size_t size)
+{
+    if (payload && OCRepPayloadGetArena(payload))
+    {
+        return OCPayloadArenaAlloc(OCRepPayloadGetArena(payload), size);
+    }
+    return OICCalloc(1, size);
+}
+
+void OCRepPayloadFree(const OCRepPayload *payload, void *ptr)
+{
+    if (!payload || !OCRepPayloadGetArena(payload))
+    {
+        OICFree(ptr);
+    }
+}
+
+bool OCRepPayloadHasArena(const OCRepPayload *payload)
+{
+    return payload && OCRepPayloadGetArena(payload);
+}
+
+bool OCRepPayloadHasIndex(const OCRepPayload *payload)
+{
+    return payload && OCRepPayloadGetIndex(payload);
+}
+
+static char *OCRepPayloadStrdup(OCRepPayload *payload, const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+    size_t size = strlen(str) + 1;
+    char *dup = (char *)OCRepPayloadAlloc(payload, size);
+    if (dup)
+    {
+        memcpy(dup, str, size);
+    }
+    return dup;
+}
+
+/**
+ * Whether ptr is heap memory that an arena-allocated payload has to free itself once
+ * it is handed over to an *AsOwner setter.
+ */
+static bool OCRepPayloadIsForeign(const OCRepPayload *payload, const void *ptr)
+{
+    return payload && OCRepPayloadGetArena(payload) && ptr &&
+           !OCPayloadArenaContains(OCRepPayloadGetArena(payload), ptr);
+}
+
+/**
+ * Reserve the record of count blocks handed over to an *AsOwner setter before the
+ * value is changed, so that the setter can not fail once the value is set.
+ */
+static bool OCRepPayloadReserveOwned(OCRepPayload *payload, size_t count, OCRepPayloadOwned **owned)
+{
+    *owned = NULL;
+    if (0 == count)
+    {
+        return true;
+    }
+
+    *owned = (OCRepPayloadOwned *)OCPayloadArenaAlloc(OCRepPayloadGetArena(payload),
+            sizeof(OCRepPayloadOwned) + count * sizeof(void *));
+    if (!*owned)
+    {
+        return false;
+    }
+    (*owned)->ptrs = (void **)(*owned + 1);
+    return true;
+}
+
+static void OCRepPayloadAddOwned(const OCRepPayload *payload, OCRepPayloadOwned *owned, void *ptr)
+{
+    if (OCRepPayloadIsForeign(payload, ptr))
+    {
+        owned->ptrs[owned->count++] = ptr;
+    }
+}
+
+static void OCRepPayloadCommitOwned(OCRepPayload *payload, OCRepPayloadOwned *owned)
+{
+    if (owned)
+    {
+        OCPayloadArena *arena = OCRepPayloadGetArena(payload);
+        owned->next = arena->owned;
+        arena->owned = owned;
+    }
+}
+
+/**
+ * Reserve the record of the block handed over to an *AsOwner setter, if it is heap memory.
+ */
+static bool OCRepPayloadReserveOwnedPtr(OCRepPayload *payload, const void *ptr,
+        OCRepPayloadOwned **owned)
+{
+    return OCRepPayloadReserveOwned(payload, OCRepPayloadIsForeign(payload, ptr) ? 1 : 0, owned);
+}
+
+static void OCRepPayloadCommitOwnedPtr(OCRepPayload *payload, OCRepPayloadOwned *owned, void *ptr)
+{
+    if (owned)
+    {
+        OCRepPayloadAddOwned(payload, owned, ptr);
+        OCRepPayloadCommitOwned(payload, owned);
+    }
+}
+
+static size_t OCRepPayloadHashName(const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const uint8_t *c = (const uint8_t *)name; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void OCRepPayloadIndexInsert(OCRepPayloadIndex *index, OCRepPayloadValue *val)
+{
+    size_t mask = index->capacity - 1;
+    size_t slot = OCRepPayloadHashName(val->name) & mask;
+    while (index->slots[slot])
+    {
+        slot = (slot + 1) & mask;
+    }
+    index->slots[slot] = val;
+}
+
+/**
+ * Builds the index of the values of a payload, or drops it if the payload has too few
+ * values. Lookups fall back to walking the values if the index can not be allocated.
+ */
+static void OCRepPayloadBuildIndex(OCRepPayload *payload)
+{
+    size_t count = 0;
+    OCRepPayloadValue *tail = NULL;
+    for (OCRepPayloadValue *val = payload->values; val; val = val->next)
+    {
+        count++;
+        tail = val;
+    }
+
+    OCRepPayloadFree(payload, OCRepPayloadGetIndex(payload));
+    OCRepPayloadSetIndex(payload, NULL);
+    if (count < OC_REP_PAYLOAD_INDEX_THRESHOLD)
+    {
+        return;
+    }
+
+    // keep the load under 1/4 after a rebuild, it is rebuilt when it exceeds 1/2
+    size_t capacity = 2 * OC_REP_PAYLOAD_INDEX_THRESHOLD;
+    while (capacity < 4 * count)
+    {
+        capacity *= 2;
+    }
+
+    OCRepPayloadIndex *index = (OCRepPayloadIndex *)OCRepPayloadAlloc(payload,
+            sizeof(OCRepPayloadIndex) + capacity * sizeof(OCRepPayloadValue *));
+    if (!index)
+    {
+        OIC_LOG(WARNING, TAG, "Failed to allocate the index of the payload values");
+        return;
+    }
+    index->slots = (OCRepPayloadValue **)(index + 1);
+    index->capacity = capacity;
+    index->count = count;
+    index->tail = tail;
+
+    for (OCRepPayloadValue *val = payload->values; val; val = val->next)
+    {
+        OCRepPayloadIndexInsert(index, val);
+    }
+    OCRepPayloadSetIndex(payload, index);
+}
+
+static void OCRepPayloadAppendValue(OCRepPayload *payload, OCRepPayloadValue *val)
+{
+    OCRepPayloadIndex *index = OCRepPayloadGetIndex(payload);
+    if (index)
+    {
+        index->tail->next = val;
+        index->tail = val;
+        index->count++;
+        if (2 * index->count > index->capacity)
+        {
+            OCRepPayloadBuildIndex(payload);
+        }
+        else
+        {
+            OCRepPayloadIndexInsert(index, val);
+        }
+        return;
+    }
+
+    size_t count = 1;
+    OCRepPayloadValue **link = &payload->values;
+    while (*link)
+    {
+        link = &(*link)->next;
+        count++;
+    }
+    *link = val;
+
+    if (count >= OC_REP_PAYLOAD_INDEX_THRESHOLD)
+    {
+        OCRepPayloadBuildIndex(payload);
+    }
+}
 
 void OC_CALL OCPayloadDestroy(OCPayload* payload)
 {
@@ -69,6 +467,9 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload)
         case PAYLOAD_TYPE_INTROSPECTION:
             OCIntrospectionPayloadDestroy((OCIntrospectionPayload*)payload);
             break;
+        case PAYLOAD_TYPE_REPRESENTATION_VIEW:
+            OCRepPayloadViewDestroy((OCRepPayloadView*)payload);
+            break;
         default:
             OIC_LOG_V(ERROR, TAG, "Unsupported payload type in destroy: %d", payload->type);
             OICFree(payload);
@@ -78,7 +479,7 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload)
 
 OCRepPayload* OC_CALL OCRepPayloadCreate(void)
 {
-    OCRepPayload* payload = (OCRepPayload*)OICCalloc(1, sizeof(OCRepPayload));
+    OCRepPayload* payload = (OCRepPayload*)OICCalloc(1, sizeof(OCRepPayloadPrivate));
 
     if (!payload)
     {
@@ -91,6 +492,35 @@ OCRepPayload* OC_CALL OCRepPayloadCreate(void)
     return payload;
 }
 
+OCRepPayload* OC_CALL OCRepPayloadCreateWithArena(size_t sizeHint)
+{
+    size_t size = sizeHint ? sizeHint : OC_REP_PAYLOAD_ARENA_SIZE;
+    if (size > SIZE_MAX - sizeof(OCRepArenaPayload))
+    {
+        return NULL;
+    }
+
+    OCRepArenaPayload* arenaPayload =
+        (OCRepArenaPayload*)OICCalloc(1, sizeof(OCRepArenaPayload) + size);
+    if (!arenaPayload)
+    {
+        return NULL;
+    }
+
+    OCPayloadArena* arena = &arenaPayload->arena;
+    arena->first.data = (uint8_t*)(arenaPayload + 1);
+    arena->first.size = size;
+    arena->blocks = &arena->first;
+
+    arenaPayload->payload.arena = arena;
+
+    OCRepPayload* payload = &arenaPayload->payload.payload;
+    payload->ifType = PAYLOAD_NON_BATCH_INTERFACE;
+    payload->base.type = PAYLOAD_TYPE_REPRESENTATION;
+
+    return payload;
+}
+
 void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
 {
     if (!parent)
@@ -107,13 +537,28 @@ void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
     child->next = NULL;
 }
 
-static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
+OCRepPayloadValue *OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
 {
     if (!payload || !name)
     {
         return NULL;
     }
 
+    const OCRepPayloadIndex* index = OCRepPayloadGetIndex(payload);
+    if (index)
+    {
+        size_t mask = index->capacity - 1;
+        for (size_t slot = OCRepPayloadHashName(name) & mask; index->slots[slot];
+             slot = (slot + 1) & mask)
+        {
+            if (0 == strcmp(index->slots[slot]->name, name))
+            {
+                return index->slots[slot];
+            }
+        }
+        return NULL;
+    }
+
     OCRepPayloadValue* val = payload->values;
     while(val)
     {
@@ -226,7 +671,7 @@ exit:
     return;
 }
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
+static void OCFreeRepPayloadValueContents(const OCRepPayload* payload, OCRepPayloadValue* val)
 {
     if (!val)
     {
@@ -235,11 +680,11 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
 
     if (val->type == OCREP_PROP_STRING)
     {
-        OICFree(val->str);
+        OCRepPayloadFree(payload, val->str);
     }
     else if (val->type == OCREP_PROP_BYTE_STRING)
     {
-        OICFree(val->ocByteStr.bytes);
+        OCRepPayloadFree(payload, val->ocByteStr.bytes);
     }
     else if (val->type == OCREP_PROP_OBJECT)
     {
@@ -255,31 +700,31 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
             case OCREP_PROP_BOOL:
                 // Since this is a union, iArray will
                 // point to all of the above
-                OICFree(val->arr.iArray);
+                OCRepPayloadFree(payload, val->arr.iArray);
                 break;
             case OCREP_PROP_STRING:
                 for(size_t i = 0; i < dimTotal; ++i)
                 {
-                    OICFree(val->arr.strArray[i]);
+                    OCRepPayloadFree(payload, val->arr.strArray[i]);
                 }
-                OICFree(val->arr.strArray);
+                OCRepPayloadFree(payload, val->arr.strArray);
                 break;
             case OCREP_PROP_BYTE_STRING:
                 for (size_t i = 0; i < dimTotal; ++i)
                 {
                     if (val->arr.ocByteStrArray[i].bytes)
                     {
-                        OICFree(val->arr.ocByteStrArray[i].bytes);
+                        OCRepPayloadFree(payload, val->arr.ocByteStrArray[i].bytes);
                     }
                 }
-                OICFree(val->arr.ocByteStrArray);
+                OCRepPayloadFree(payload, val->arr.ocByteStrArray);
                 break;
             case OCREP_PROP_OBJECT: // This case is the temporary fix for string input
                 for(size_t i = 0; i< dimTotal; ++i)
                 {
                     OCRepPayloadDestroy(val->arr.objArray[i]);
                 }
-                OICFree(val->arr.objArray);
+                OCRepPayloadFree(payload, val->arr.objArray);
                 break;
             case OCREP_PROP_NULL:
             case OCREP_PROP_ARRAY:
@@ -290,17 +735,17 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
     }
 }
 
-static void OC_CALL OCFreeRepPayloadValue(OCRepPayloadValue* val)
+static void OC_CALL OCFreeRepPayloadValue(const OCRepPayload* payload, OCRepPayloadValue* val)
 {
     if (!val)
     {
         return;
     }
 
-    OICFree(val->name);
-    OCFreeRepPayloadValueContents(val);
-    OCFreeRepPayloadValue(val->next);
-    OICFree(val);
+    OCRepPayloadFree(payload, val->name);
+    OCFreeRepPayloadValueContents(payload, val);
+    OCFreeRepPayloadValue(payload, val->next);
+    OCRepPayloadFree(payload, val);
 }
 static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* source)
 {
@@ -330,7 +775,7 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
         destIter->next = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
         if (!destIter->next)
         {
-            OCFreeRepPayloadValue (headOfClone);
+            OCFreeRepPayloadValue (NULL, headOfClone);
             return NULL;
         }
 
@@ -352,56 +797,29 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payl
         return NULL;
     }
 
-    OCRepPayloadValue* val = payload->values;
-    if (val == NULL)
+    OCRepPayloadValue* val = OCRepPayloadFindValue(payload, name);
+    if (val)
     {
-        payload->values = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-        if (!payload->values)
-        {
-            return NULL;
-        }
-        payload->values->name = OICStrdup(name);
-        if (!payload->values->name)
-        {
-            OICFree(payload->values);
-            payload->values = NULL;
-            return NULL;
-        }
-        payload->values->type =type;
-        return payload->values;
+        OCFreeRepPayloadValueContents(payload, val);
+        val->type = type;
+        return val;
     }
 
-    while(val)
+    val = (OCRepPayloadValue*)OCRepPayloadAlloc(payload, sizeof(OCRepPayloadValue));
+    if (!val)
     {
-        if (0 == strcmp(val->name, name))
-        {
-            OCFreeRepPayloadValueContents(val);
-            val->type = type;
-            return val;
-        }
-        else if (val->next == NULL)
-        {
-            val->next = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-            if (!val->next)
-            {
-                return NULL;
-            }
-            val->next->name = OICStrdup(name);
-            if (!val->next->name)
-            {
-                OICFree(val->next);
-                val->next = NULL;
-                return NULL;
-            }
-            val->next->type =type;
-            return val->next;
-        }
-
-        val = val->next;
+        return NULL;
+    }
+    val->name = OCRepPayloadStrdup(payload, name);
+    if (!val->name)
+    {
+        OCRepPayloadFree(payload, val);
+        return NULL;
     }
+    val->type = type;
 
-    OIC_LOG(ERROR, TAG, "FindAndSetValue reached point after while loop, pointer corruption?");
-    return NULL;
+    OCRepPayloadAppendValue(payload, val);
+    return val;
 }
 
 bool OC_CALL OCRepPayloadAddResourceType(OCRepPayload* payload, const char* resourceType)
@@ -616,19 +1034,27 @@ bool OC_CALL OCRepPayloadGetPropDouble(const OCRepPayload* payload, const char*
 
 bool OC_CALL OCRepPayloadSetPropString(OCRepPayload* payload, const char* name, const char* value)
 {
-    char* temp = OICStrdup(value);
+    char* temp = OCRepPayloadStrdup(payload, value);
     bool b = OCRepPayloadSetPropStringAsOwner(payload, name, temp);
 
     if (!b)
     {
-        OICFree(temp);
+        OCRepPayloadFree(payload, temp);
     }
     return b;
 }
 
 bool OC_CALL OCRepPayloadSetPropStringAsOwner(OCRepPayload* payload, const char* name, char* value)
 {
-    return OCRepPayloadSetProp(payload, name, value, OCREP_PROP_STRING);
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwnedPtr(payload, value, &owned) ||
+        !OCRepPayloadSetProp(payload, name, value, OCREP_PROP_STRING))
+    {
+        return false;
+    }
+
+    OCRepPayloadCommitOwnedPtr(payload, owned, value);
+    return true;
 }
 
 bool OC_CALL OCRepPayloadGetPropString(const OCRepPayload* payload, const char* name, char** value)
@@ -646,23 +1072,37 @@ bool OC_CALL OCRepPayloadGetPropString(const OCRepPayload* payload, const char*
 
 bool OC_CALL OCRepPayloadSetPropByteString(OCRepPayload* payload, const char* name, OCByteString value)
 {
-    OCByteString ocByteStr = {NULL, 0};
-    bool b = OCByteStringCopy(&ocByteStr, &value);
-
-    if (b)
+    OCByteString ocByteStr = {NULL, value.len};
+    if (value.len)
     {
-        b = OCRepPayloadSetPropByteStringAsOwner(payload, name, &ocByteStr);
+        ocByteStr.bytes = (uint8_t*)OCRepPayloadAlloc(payload, value.len);
+        if (!ocByteStr.bytes)
+        {
+            return false;
+        }
+        memcpy(ocByteStr.bytes, value.bytes, value.len);
     }
+
+    bool b = OCRepPayloadSetPropByteStringAsOwner(payload, name, &ocByteStr);
     if (!b)
     {
-        OICFree(ocByteStr.bytes);
+        OCRepPayloadFree(payload, ocByteStr.bytes);
     }
     return b;
 }
 
 bool OC_CALL OCRepPayloadSetPropByteStringAsOwner(OCRepPayload* payload, const char* name, OCByteString* value)
 {
-    return OCRepPayloadSetProp(payload, name, value, OCREP_PROP_BYTE_STRING);
+    OCRepPayloadOwned* owned = NULL;
+    if (!value ||
+        !OCRepPayloadReserveOwnedPtr(payload, value->bytes, &owned) ||
+        !OCRepPayloadSetProp(payload, name, value, OCREP_PROP_BYTE_STRING))
+    {
+        return false;
+    }
+
+    OCRepPayloadCommitOwnedPtr(payload, owned, value->bytes);
+    return true;
 }
 
 bool OC_CALL OCRepPayloadGetPropByteString(const OCRepPayload* payload, const char* name, OCByteString* value)
@@ -912,6 +1352,19 @@ size_t OC_CALL calcDimTotal(const size_t dimensions[MAX_REP_ARRAY_DEPTH])
 bool OC_CALL OCRepPayloadSetByteStringArrayAsOwner(OCRepPayload* payload, const char* name,
         OCByteString* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    size_t dimTotal = calcDimTotal(dimensions);
+    size_t foreign = OCRepPayloadIsForeign(payload, array) ? 1 : 0;
+    for (size_t i = 0; array && i < dimTotal; ++i)
+    {
+        foreign += OCRepPayloadIsForeign(payload, array[i].bytes) ? 1 : 0;
+    }
+
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwned(payload, foreign, &owned))
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if (!val)
@@ -923,6 +1376,15 @@ bool OC_CALL OCRepPayloadSetByteStringArrayAsOwner(OCRepPayload* payload, const
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.ocByteStrArray = array;
 
+    if (owned)
+    {
+        OCRepPayloadAddOwned(payload, owned, array);
+        for (size_t i = 0; i < dimTotal; ++i)
+        {
+            OCRepPayloadAddOwned(payload, owned, array[i].bytes);
+        }
+        OCRepPayloadCommitOwned(payload, owned);
+    }
     return true;
 }
 
@@ -940,7 +1402,8 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
         return false;
     }
 
-    OCByteString* newArray = (OCByteString*)OICCalloc(dimTotal, sizeof(OCByteString));
+    OCByteString* newArray = (OCByteString*)OCRepPayloadAlloc(payload,
+            dimTotal * sizeof(OCByteString));
 
     if (!newArray)
     {
@@ -951,15 +1414,15 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
     {
         if (array[i].len)
         {
-            newArray[i].bytes = (uint8_t*)OICMalloc(array[i].len * sizeof(uint8_t));
+            newArray[i].bytes = (uint8_t*)OCRepPayloadAlloc(payload, array[i].len * sizeof(uint8_t));
             if (NULL == newArray[i].bytes)
             {
                 for (size_t j = 0; j < i; ++j)
                 {
-                    OICFree(newArray[j].bytes);
+                    OCRepPayloadFree(payload, newArray[j].bytes);
                 }
 
-                OICFree(newArray);
+                OCRepPayloadFree(payload, newArray);
                 return false;
             }
         }
@@ -972,10 +1435,10 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
     {
         for (size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(newArray[i].bytes);
+            OCRepPayloadFree(payload, newArray[i].bytes);
         }
 
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1034,6 +1497,12 @@ bool OC_CALL OCRepPayloadGetByteStringArray(const OCRepPayload* payload, const c
 bool OC_CALL OCRepPayloadSetIntArrayAsOwner(OCRepPayload* payload, const char* name,
         int64_t* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwnedPtr(payload, array, &owned))
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if (!val)
@@ -1045,6 +1514,7 @@ bool OC_CALL OCRepPayloadSetIntArrayAsOwner(OCRepPayload* payload, const char* n
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.iArray = array;
 
+    OCRepPayloadCommitOwnedPtr(payload, owned, array);
     return true;
 }
 
@@ -1053,7 +1523,7 @@ bool OC_CALL OCRepPayloadSetIntArray(OCRepPayload* payload, const char* name,
 {
     size_t dimTotal = calcDimTotal(dimensions);
 
-    int64_t* newArray = (int64_t*)OICMalloc(dimTotal * sizeof(int64_t));
+    int64_t* newArray = (int64_t*)OCRepPayloadAlloc(payload, dimTotal * sizeof(int64_t));
 
     if (newArray && array)
     {
@@ -1063,7 +1533,7 @@ bool OC_CALL OCRepPayloadSetIntArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetIntArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1098,6 +1568,12 @@ bool OC_CALL OCRepPayloadGetIntArray(const OCRepPayload* payload, const char* na
 bool OC_CALL OCRepPayloadSetDoubleArrayAsOwner(OCRepPayload* payload, const char* name,
         double* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwnedPtr(payload, array, &owned))
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if (!val)
@@ -1109,6 +1585,7 @@ bool OC_CALL OCRepPayloadSetDoubleArrayAsOwner(OCRepPayload* payload, const char
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.dArray = array;
 
+    OCRepPayloadCommitOwnedPtr(payload, owned, array);
     return true;
 }
 bool OC_CALL OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
@@ -1120,7 +1597,7 @@ bool OC_CALL OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
         return false;
     }
 
-    double* newArray = (double*)OICMalloc(dimTotal * sizeof(double));
+    double* newArray = (double*)OCRepPayloadAlloc(payload, dimTotal * sizeof(double));
 
     if (!newArray)
     {
@@ -1132,7 +1609,7 @@ bool OC_CALL OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetDoubleArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1188,6 +1665,19 @@ bool OC_CALL OCRepPayloadGetDoubleArray(const OCRepPayload* payload, const char*
 bool OC_CALL OCRepPayloadSetStringArrayAsOwner(OCRepPayload* payload, const char* name,
         char** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    size_t dimTotal = calcDimTotal(dimensions);
+    size_t foreign = OCRepPayloadIsForeign(payload, array) ? 1 : 0;
+    for (size_t i = 0; array && i < dimTotal; ++i)
+    {
+        foreign += OCRepPayloadIsForeign(payload, array[i]) ? 1 : 0;
+    }
+
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwned(payload, foreign, &owned))
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if (!val)
@@ -1199,6 +1689,15 @@ bool OC_CALL OCRepPayloadSetStringArrayAsOwner(OCRepPayload* payload, const char
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.strArray = array;
 
+    if (owned)
+    {
+        OCRepPayloadAddOwned(payload, owned, array);
+        for (size_t i = 0; i < dimTotal; ++i)
+        {
+            OCRepPayloadAddOwned(payload, owned, array[i]);
+        }
+        OCRepPayloadCommitOwned(payload, owned);
+    }
     return true;
 }
 bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
@@ -1210,7 +1709,7 @@ bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
         return false;
     }
 
-    char** newArray = (char**)OICMalloc(dimTotal * sizeof(char*));
+    char** newArray = (char**)OCRepPayloadAlloc(payload, dimTotal * sizeof(char*));
 
     if (!newArray)
     {
@@ -1219,7 +1718,7 @@ bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
 
     for(size_t i = 0; i < dimTotal; ++i)
     {
-        newArray[i] = OICStrdup(array[i]);
+        newArray[i] = OCRepPayloadStrdup(payload, array[i]);
     }
 
     bool b = OCRepPayloadSetStringArrayAsOwner(payload, name, newArray, dimensions);
@@ -1228,9 +1727,9 @@ bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(newArray[i]);
+            OCRepPayloadFree(payload, newArray[i]);
         }
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1271,6 +1770,11 @@ bool OC_CALL OCRepPayloadGetStringArray(const OCRepPayload* payload, const char*
 bool OC_CALL OCRepPayloadSetBoolArrayAsOwner(OCRepPayload* payload, const char* name,
         bool* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwnedPtr(payload, array, &owned))
+    {
+        return false;
+    }
 
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
@@ -1283,6 +1787,7 @@ bool OC_CALL OCRepPayloadSetBoolArrayAsOwner(OCRepPayload* payload, const char*
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.bArray = array;
 
+    OCRepPayloadCommitOwnedPtr(payload, owned, array);
     return true;
 }
 bool OC_CALL OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
@@ -1294,7 +1799,7 @@ bool OC_CALL OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
         return false;
     }
 
-    bool* newArray = (bool*)OICMalloc(dimTotal * sizeof(bool));
+    bool* newArray = (bool*)OCRepPayloadAlloc(payload, dimTotal * sizeof(bool));
 
     if (!newArray)
     {
@@ -1307,7 +1812,7 @@ bool OC_CALL OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetBoolArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1342,6 +1847,12 @@ bool OC_CALL OCRepPayloadGetBoolArray(const OCRepPayload* payload, const char* n
 bool OC_CALL OCRepPayloadSetPropObjectArrayAsOwner(OCRepPayload* payload, const char* name,
         OCRepPayload** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCRepPayloadOwned* owned = NULL;
+    if (!OCRepPayloadReserveOwnedPtr(payload, array, &owned))
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if (!val)
@@ -1353,6 +1864,7 @@ bool OC_CALL OCRepPayloadSetPropObjectArrayAsOwner(OCRepPayload* payload, const
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
     val->arr.objArray = array;
 
+    OCRepPayloadCommitOwnedPtr(payload, owned, array);
     return true;
 }
 
@@ -1365,7 +1877,8 @@ bool OC_CALL OCRepPayloadSetPropObjectArray(OCRepPayload* payload, const char* n
         return false;
     }
 
-    OCRepPayload** newArray = (OCRepPayload**)OICMalloc(dimTotal * sizeof(OCRepPayload*));
+    OCRepPayload** newArray = (OCRepPayload**)OCRepPayloadAlloc(payload,
+            dimTotal * sizeof(OCRepPayload*));
 
     if (!newArray)
     {
@@ -1385,7 +1898,7 @@ bool OC_CALL OCRepPayloadSetPropObjectArray(OCRepPayload* payload, const char* n
         {
            OCRepPayloadDestroy(newArray[i]);
         }
-        OICFree(newArray);
+        OCRepPayloadFree(payload, newArray);
     }
     return b;
 }
@@ -1613,6 +2126,7 @@ OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
     clone->types = CloneOCStringLL (payload->types);
     clone->interfaces = CloneOCStringLL (payload->interfaces);
     clone->values = OCRepPayloadValueClone (payload->values);
+    OCRepPayloadBuildIndex(clone);
 
     return clone;
 }
@@ -1637,6 +2151,7 @@ OCRepPayload* OC_CALL OCRepPayloadBatchClone(const OCRepPayload* repPayload)
     clone->ifType = repPayload->ifType;
     clone->interfaces  = CloneOCStringLL(repPayload->interfaces);
     clone->values = OCRepPayloadValueClone(repPayload->values);
+    OCRepPayloadBuildIndex(clone);
     OCRepPayloadSetPropObjectAsOwner(newPayload, OC_RSRVD_REPRESENTATION, clone);
 
     return newPayload;
@@ -1652,7 +2167,9 @@ void OC_CALL OCRepPayloadDestroy(OCRepPayload* payload)
     OICFree(payload->uri);
     OCFreeOCStringLL(payload->types);
     OCFreeOCStringLL(payload->interfaces);
-    OCFreeRepPayloadValue(payload->values);
+    OCFreeRepPayloadValue(payload, payload->values);
+    OCRepPayloadFree(payload, OCRepPayloadGetIndex(payload));
+    OCPayloadArenaDestroy(OCRepPayloadGetArena(payload));
     OCRepPayloadDestroy(payload->next);
     OICFree(payload);
 }
@@ -65,6 +65,219 @@ static int64_t AddTextStringToMap(CborEncoder *map, const char *key, size_t keyl
 static int64_t ConditionalAddTextStringToMap(CborEncoder *map, const char *key, size_t keylen,
         const char *value);
 
+/**
+ * Size of the head of a CBOR data item: the initial byte plus the bytes needed for
+ * its argument (a length, a count or an integer value).
+ */
+static size_t CborHeadSize(uint64_t value)
+{
+    if (value < 24)
+    {
+        return 1;
+    }
+    if (value <= UINT8_MAX)
+    {
+        return 2;
+    }
+    if (value <= UINT16_MAX)
+    {
+        return 3;
+    }
+    if (value <= UINT32_MAX)
+    {
+        return 5;
+    }
+    return 9;
+}
+
+static size_t EstimateTextString(const char *str)
+{
+    if (!str)
+    {
+        // encoded as null
+        return 1;
+    }
+    size_t len = strlen(str);
+    return CborHeadSize(len) + len;
+}
+
+static size_t EstimateStringLL(const char *type, const OCStringLL *val)
+{
+    size_t count = 0;
+    size_t estimate = 0;
+    for (; val; val = val->next)
+    {
+        estimate += EstimateTextString(val->value);
+        ++count;
+    }
+    return count ? EstimateTextString(type) + CborHeadSize(count) + estimate : 0;
+}
+
+static size_t EstimateRepMap(const OCRepPayload *payload);
+
+static size_t EstimateArrayItem(const OCRepPayloadValueArray *valArray, size_t index)
+{
+    switch (valArray->type)
+    {
+        case OCREP_PROP_INT:
+        case OCREP_PROP_DOUBLE:
+            return 9;
+        case OCREP_PROP_BOOL:
+            return 1;
+        case OCREP_PROP_STRING:
+            return valArray->strArray ? EstimateTextString(valArray->strArray[index]) : 0;
+        case OCREP_PROP_BYTE_STRING:
+            return CborHeadSize(valArray->ocByteStrArray[index].len)
+                   + valArray->ocByteStrArray[index].len;
+        case OCREP_PROP_OBJECT:
+            if (!valArray->objArray)
+            {
+                return 0;
+            }
+            return valArray->objArray[index] ? EstimateRepMap(valArray->objArray[index]) : 1;
+        default:
+            return 0;
+    }
+}
+
+static size_t EstimateArray(const OCRepPayloadValueArray *valArray)
+{
+    size_t dim0 = valArray->dimensions[0];
+    size_t dim1 = valArray->dimensions[1];
+    size_t dim2 = valArray->dimensions[2];
+    size_t estimate = CborHeadSize(dim0);
+    if (dim1)
+    {
+        estimate += dim0 * CborHeadSize(dim1);
+        if (dim2)
+        {
+            estimate += dim0 * dim1 * CborHeadSize(dim2);
+        }
+    }
+
+    size_t count = calcDimTotal(valArray->dimensions);
+    for (size_t i = 0; i < count; ++i)
+    {
+        estimate += EstimateArrayItem(valArray, i);
+    }
+    return estimate;
+}
+
+static size_t EstimateRepValue(const OCRepPayloadValue *value)
+{
+    switch (value->type)
+    {
+        case OCREP_PROP_NULL:
+        case OCREP_PROP_BOOL:
+            return 1;
+        case OCREP_PROP_INT:
+        case OCREP_PROP_DOUBLE:
+            return 9;
+        case OCREP_PROP_STRING:
+            return EstimateTextString(value->str);
+        case OCREP_PROP_BYTE_STRING:
+            return CborHeadSize(value->ocByteStr.len) + value->ocByteStr.len;
+        case OCREP_PROP_OBJECT:
+            return EstimateRepMap(value->obj);
+        case OCREP_PROP_ARRAY:
+            return EstimateArray(&value->arr);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Upper bound of OCConvertSingleRepPayload() wrapped in an indefinite length map, which
+ * is never smaller than the array form OCConvertRepMap() may choose instead.
+ */
+static size_t EstimateRepMap(const OCRepPayload *payload)
+{
+    // map start and break
+    size_t estimate = 2;
+    if (payload->uri && payload->uri[0])
+    {
+        estimate += EstimateTextString(OC_RSRVD_HREF) + EstimateTextString(payload->uri);
+    }
+    estimate += EstimateStringLL(OC_RSRVD_RESOURCE_TYPE, payload->types);
+    estimate += EstimateStringLL(OC_RSRVD_INTERFACE, payload->interfaces);
+    for (const OCRepPayloadValue *value = payload->values; value; value = value->next)
+    {
+        estimate += EstimateTextString(value->name) + EstimateRepValue(value);
+    }
+    return estimate;
+}
+
+static size_t EstimateRepPayload(const OCRepPayload *payload)
+{
+    size_t count = 0;
+    size_t estimate = 0;
+    for (; payload; payload = payload->next)
+    {
+        estimate += EstimateRepMap(payload);
+        ++count;
+    }
+    // root array, used for batches and lists of payloads
+    return CborHeadSize(count) + estimate;
+}
+
+size_t OCEstimatePayloadSize(OCPayload *payload, OCPayloadFormat format)
+{
+    if (!payload)
+    {
+        return 0;
+    }
+
+    switch (payload->type)
+    {
+        case PAYLOAD_TYPE_REPRESENTATION:
+            return EstimateRepPayload((OCRepPayload *)payload);
+        case PAYLOAD_TYPE_SECURITY:
+            return ((OCSecurityPayload *)payload)->payloadSize;
+        case PAYLOAD_TYPE_INTROSPECTION:
+            return ((OCIntrospectionPayload *)payload)->cborPayload.len;
+        case PAYLOAD_TYPE_DIAGNOSTIC:
+            return EstimateTextString(((OCDiagnosticPayload *)payload)->message);
+        default:
+        {
+            // Discovery and presence payloads are not worth a dedicated estimator, measure
+            // them with a dry run of the encoder that counts bytes without writing any.
+            size_t size = 0;
+            int64_t err = OCConvertPayloadHelper(payload, format, NULL, &size);
+            return (CborNoError == err || (CborErrorOutOfMemory & err)) ? size : 0;
+        }
+    }
+}
+
+OCStackResult OCConvertPayloadToBuffer(OCPayload *payload, OCPayloadFormat format,
+        uint8_t *buffer, size_t *size)
+{
+    VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
+    VERIFY_PARAM_NON_NULL(TAG, size, "size parameter is NULL");
+    if (!buffer && *size)
+    {
+        OIC_LOG(ERROR, TAG, "buffer parameter is NULL");
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    size_t curSize = *size;
+    int64_t err = OCConvertPayloadHelper(payload, format, buffer, &curSize);
+    *size = curSize;
+    if (CborNoError == err)
+    {
+        return OC_STACK_OK;
+    }
+    if (CborErrorOutOfMemory & err)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
+    //TODO: Proper conversion from CborError to OCStackResult.
+    return (OCStackResult)-err;
+
+exit:
+    return OC_STACK_INVALID_PARAM;
+}
+
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size)
 {
@@ -78,36 +291,30 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
     OCStackResult ret = OC_STACK_INVALID_PARAM;
     int64_t err = CborErrorOutOfMemory;
     uint8_t *out = NULL;
-    size_t curSize = INIT_SIZE;
+    size_t curSize = 0;
+    size_t allocSize = 0;
 
     VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "OutPayload parameter is NULL");
     VERIFY_PARAM_NON_NULL(TAG, size, "size parameter is NULL");
 
     OIC_LOG_V(INFO, TAG, "Converting payload of type %d", payload->type);
-    if (PAYLOAD_TYPE_SECURITY == payload->type)
-    {
-        size_t securityPayloadSize = ((OCSecurityPayload *)payload)->payloadSize;
-        if (securityPayloadSize > 0)
-        {
-            curSize = securityPayloadSize;
-        }
-    }
-    if (PAYLOAD_TYPE_INTROSPECTION == payload->type)
+
+    // The estimate is an upper bound, so the payload is normally encoded once into a buffer
+    // that already fits it. The loop only repeats if the estimate ever comes out short.
+    allocSize = OCEstimatePayloadSize(payload, format);
+    if (0 == allocSize)
     {
-        size_t introspectionPayloadSize = ((OCIntrospectionPayload *)payload)->cborPayload.len;
-        if (introspectionPayloadSize > 0)
-        {
-            curSize = introspectionPayloadSize;
-        }
+        allocSize = INIT_SIZE;
     }
 
     ret = OC_STACK_NO_MEMORY;
 
     for (;;)
     {
-        out = (uint8_t *)OICCalloc(1, curSize);
+        out = (uint8_t *)OICMalloc(allocSize);
         VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
+        curSize = allocSize;
         err = OCConvertPayloadHelper(payload, format, out, &curSize);
 
         if ((CborErrorOutOfMemory & err) == 0)
@@ -115,17 +322,19 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
             break;
         }
 
+        OIC_LOG_V(DEBUG, TAG, "Payload size estimate %zu short of %zu", allocSize, curSize);
         OICFree(out);
+        allocSize = curSize;
     }
 
     if (err == CborNoError)
     {
-        if ((curSize < INIT_SIZE) &&
-            (PAYLOAD_TYPE_SECURITY != payload->type) &&
-            (PAYLOAD_TYPE_INTROSPECTION != payload->type))
+        // Only give back memory when the estimate was far off, shrinking costs a copy on
+        // some allocators.
+        if (allocSize - curSize > INIT_SIZE)
         {
-            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
-            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
+            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize ? curSize : 1);
+            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to decrease payload size");
             out = out2;
         }
 
@@ -191,6 +400,11 @@ static int64_t checkError(int64_t err, CborEncoder* encoder, uint8_t* outPayload
 static int64_t OCConvertSecurityPayload(OCSecurityPayload* payload, uint8_t* outPayload,
         size_t* size)
 {
+    if (*size < payload->payloadSize)
+    {
+        *size = payload->payloadSize;
+        return CborErrorOutOfMemory;
+    }
     memcpy(outPayload, payload->securityData, payload->payloadSize);
     *size = payload->payloadSize;
 
@@ -200,6 +414,11 @@ static int64_t OCConvertSecurityPayload(OCSecurityPayload* payload, uint8_t* out
 static int64_t OCConvertIntrospectionPayload(OCIntrospectionPayload *payload,
         uint8_t *outPayload, size_t *size)
 {
+    if (*size < payload->cborPayload.len)
+    {
+        *size = payload->cborPayload.len;
+        return CborErrorOutOfMemory;
+    }
     memcpy(outPayload, payload->cborPayload.bytes, payload->cborPayload.len);
     *size = payload->cborPayload.len;
 
@@ -45,6 +45,11 @@
  */
 #define UINT64_MAX_STRLEN 20
 
+/*
+ * Size of the buffer property names are read into, longer names are duplicated.
+ */
+#define REP_NAME_BUFFER_SIZE 64
+
 static OCStackResult OCParseDiscoveryPayload(OCPayload **outPayload, OCPayloadFormat format,
         CborValue *arrayVal);
 static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot);
@@ -817,13 +822,54 @@ static size_t arrayStep(size_t dimensions[MAX_REP_ARRAY_DEPTH], size_t elementNu
         elementNum;
 }
 
-static CborError OCParseArrayFillArray(const CborValue *parent,
+/*
+ * Read a text or byte string into memory from the arena of payload, instead of
+ * duplicating it on the heap.
+ */
+static CborError OCParseString(OCRepPayload *payload, const CborValue *value, void **str, size_t *len)
+{
+    size_t size = 0;
+    *str = NULL;
+    CborError err = cbor_value_calculate_string_length(value, &size);
+    if (CborNoError != err)
+    {
+        return err;
+    }
+
+    // one more byte for the terminating NUL of a text string
+    *str = OCRepPayloadAlloc(payload, size + 1);
+    if (!*str)
+    {
+        return CborErrorOutOfMemory;
+    }
+
+    size++;
+    if (cbor_value_is_text_string(value))
+    {
+        err = cbor_value_copy_text_string(value, (char *)*str, &size, NULL);
+    }
+    else
+    {
+        err = cbor_value_copy_byte_string(value, (uint8_t *)*str, &size, NULL);
+    }
+    if (CborNoError != err)
+    {
+        OCRepPayloadFree(payload, *str);
+        *str = NULL;
+        return err;
+    }
+
+    *len = size;
+    return CborNoError;
+}
+
+static CborError OCParseArrayFillArray(OCRepPayload *out, const CborValue *parent,
         size_t dimensions[MAX_REP_ARRAY_DEPTH], OCRepPayloadPropType type, void *targetArray)
 {
     CborValue insideArray;
 
     size_t i = 0;
-    char *tempStr = NULL;
+    void *tempStr = NULL;
     OCByteString ocByteStr = { .bytes = NULL, .len = 0};
     size_t tempLen = 0;
     OCRepPayload *tempPl = NULL;
@@ -850,7 +896,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                             &(((int64_t*)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
@@ -873,7 +919,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                             &(((double*)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
@@ -884,33 +930,34 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                             &(((bool*)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
                 case OCREP_PROP_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_text_string(&insideArray, &tempStr, &tempLen, NULL);
-                        ((char**)targetArray)[i] = tempStr;
+                        err = OCParseString(out, &insideArray, &tempStr, &tempLen);
+                        ((char**)targetArray)[i] = (char *)tempStr;
                         tempStr = NULL;
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                             &(((char**)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
                 case OCREP_PROP_BYTE_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_byte_string(&insideArray, &(ocByteStr.bytes),
-                                &(ocByteStr.len), NULL);
+                        err = OCParseString(out, &insideArray, &tempStr, &(ocByteStr.len));
+                        ocByteStr.bytes = (uint8_t *)tempStr;
+                        tempStr = NULL;
                         ((OCByteString*)targetArray)[i] = ocByteStr;
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                                 &(((OCByteString*)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
@@ -924,7 +971,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     }
                     else
                     {
-                        err = OCParseArrayFillArray(&insideArray, newdim, type,
+                        err = OCParseArrayFillArray(out, &insideArray, newdim, type,
                             &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]));
                     }
                     break;
@@ -970,10 +1017,18 @@ static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *co
 
     dimTotal = calcDimTotal(dimensions);
     allocSize = getAllocSize(type);
-    arr = OICCalloc(dimTotal, allocSize);
+    if ((0 != allocSize) && (dimTotal > SIZE_MAX / allocSize))
+    {
+        err = CborErrorDataTooLarge;
+        goto exit;
+    }
+    if ((0 != dimTotal) && (0 != allocSize))
+    {
+        arr = OCRepPayloadAlloc(out, dimTotal * allocSize);
+    }
     VERIFY_PARAM_NON_NULL(TAG, arr, "Array Parse allocation failed");
 
-    res = OCParseArrayFillArray(container, dimensions, type, arr);
+    res = OCParseArrayFillArray(out, container, dimensions, type, arr);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed parse array");
 
     switch (type)
@@ -1004,34 +1059,35 @@ static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *co
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting array parameter");
     return CborNoError;
 exit:
-    if (type == OCREP_PROP_STRING)
+    if (arr && type == OCREP_PROP_STRING)
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((char**)arr)[i]);
+            OCRepPayloadFree(out, ((char**)arr)[i]);
         }
     }
-    if (type == OCREP_PROP_BYTE_STRING)
+    if (arr && type == OCREP_PROP_BYTE_STRING)
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((OCByteString*)arr)[i].bytes);
+            OCRepPayloadFree(out, ((OCByteString*)arr)[i].bytes);
         }
     }
-    if (type == OCREP_PROP_OBJECT)
+    if (arr && type == OCREP_PROP_OBJECT)
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
             OCRepPayloadDestroy(((OCRepPayload**)arr)[i]);
         }
     }
-    OICFree(arr);
+    OCRepPayloadFree(out, arr);
     return err;
 }
 
 static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot)
 {
     CborError err = CborUnknownError;
+    char nameBuf[REP_NAME_BUFFER_SIZE];
     char *name = NULL;
     bool res = false;
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "Invalid Parameter outPayload");
@@ -1041,7 +1097,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     {
         if (!*outPayload)
         {
-            *outPayload = OCRepPayloadCreate();
+            *outPayload = OCRepPayloadCreateWithArena(0);
             if (!*outPayload)
             {
                 return CborErrorOutOfMemory;
@@ -1060,8 +1116,16 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
         {
             if (cbor_value_is_map(objMap) && cbor_value_is_text_string(&repMap))
             {
-                err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
-                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed finding tag name in the map");
+                len = sizeof(nameBuf);
+                if (CborNoError == cbor_value_copy_text_string(&repMap, nameBuf, &len, NULL))
+                {
+                    name = nameBuf;
+                }
+                else
+                {
+                    err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed finding tag name in the map");
+                }
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advancing rootMap");
                 if (name &&
@@ -1071,15 +1135,17 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                     (0 == strcmp(OC_RSRVD_INTERFACE, name))))
                 {
                     err = cbor_value_advance(&repMap);
-                    free(name);  // Free *TinyCBOR allocated* string.
+                    if (name != nameBuf)
+                    {
+                        free(name);  // Free *TinyCBOR allocated* string.
+                    }
                     name = NULL;
                     continue;
                 }
             }
             else if (cbor_value_is_array(objMap))
             {
-                name = (char*)OICCalloc(UINT64_MAX_STRLEN + 1, sizeof(char));
-                VERIFY_PARAM_NON_NULL(TAG, name, "Failed allocating tag name in the map");
+                name = nameBuf;
 #ifdef PRIu64
                 snprintf(name, UINT64_MAX_STRLEN + 1, "%" PRIu64, arrayIndex);
 #else
@@ -1095,7 +1161,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 else
                 {
                     err = CborErrorDataTooLarge;
-                    OICFree(name);
+                    name = NULL;
                     continue;
                 }
 #endif
@@ -1132,19 +1198,27 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                     break;
                 case CborTextStringType:
                     {
-                        char *strval = NULL;
-                        err = cbor_value_dup_text_string(&repMap, &strval, &len, NULL);
+                        void *strval = NULL;
+                        err = OCParseString(curPayload, &repMap, &strval, &len);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting string value");
-                        res = OCRepPayloadSetPropStringAsOwner(curPayload, name, strval);
+                        res = OCRepPayloadSetPropStringAsOwner(curPayload, name, (char *)strval);
+                        if (!res)
+                        {
+                            OCRepPayloadFree(curPayload, strval);
+                        }
                     }
                     break;
                 case CborByteStringType:
                     {
-                        uint8_t* bytestrval = NULL;
-                        err = cbor_value_dup_byte_string(&repMap, &bytestrval, &len, NULL);
+                        void *bytestrval = NULL;
+                        err = OCParseString(curPayload, &repMap, &bytestrval, &len);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting byte string value");
-                        OCByteString tmp = {.bytes = bytestrval, .len = len};
+                        OCByteString tmp = {.bytes = (uint8_t *)bytestrval, .len = len};
                         res = OCRepPayloadSetPropByteStringAsOwner(curPayload, name, &tmp);
+                        if (!res)
+                        {
+                            OCRepPayloadFree(curPayload, bytestrval);
+                        }
                     }
                     break;
                 case CborMapType:
@@ -1182,7 +1256,10 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advance repMap");
             }
-            OICFree(name);
+            if (name != nameBuf)
+            {
+                OICFree(name);
+            }
             name = NULL;
             ++arrayIndex;
         }
@@ -1195,7 +1272,10 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     }
 
 exit:
-    OICFree(name);
+    if (name != nameBuf)
+    {
+        OICFree(name);
+    }
     OCRepPayloadDestroy(*outPayload);
     *outPayload = NULL;
     return err;
@@ -1221,7 +1301,7 @@ static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
     }
     while (cbor_value_is_valid(&rootMap))
     {
-        temp = OCRepPayloadCreate();
+        temp = OCRepPayloadCreateWithArena(0);
         ret = OC_STACK_NO_MEMORY;
         VERIFY_PARAM_NON_NULL(TAG, temp, "Failed allocating memory");
 
@@ -0,0 +1,321 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <string.h>
+#include "ocpayload.h"
+#include "oic_malloc.h"
+#include "ocpayloadcbor.h"
+#include "ocstackinternal.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_PAYLOADVIEW"
+
+struct OCRepPayloadView
+{
+    OCPayload base;
+    /** Encoded representation, owned by the creator of the view. */
+    const uint8_t *cbor;
+    size_t size;
+    CborParser parser;
+    /** Map of the representation, iterated by the getters. */
+    CborValue map;
+    /** Representation converted by OCRepPayloadViewGetPayload, NULL until then. */
+    OCRepPayload *payload;
+};
+
+OCStackResult OC_CALL OCRepPayloadViewCreate(const uint8_t *cbor, size_t size,
+        OCRepPayloadView **view)
+{
+    OCStackResult ret = OC_STACK_INVALID_PARAM;
+    OCRepPayloadView *temp = NULL;
+    CborError err;
+    VERIFY_PARAM_NON_NULL(TAG, cbor, "Invalid Parameter cbor");
+    VERIFY_PARAM_NON_NULL(TAG, view, "Invalid Parameter view");
+
+    ret = OC_STACK_NO_MEMORY;
+    temp = (OCRepPayloadView *)OICCalloc(1, sizeof(OCRepPayloadView));
+    VERIFY_PARAM_NON_NULL(TAG, temp, "Failed allocating memory");
+
+    temp->base.type = PAYLOAD_TYPE_REPRESENTATION_VIEW;
+    temp->cbor = cbor;
+    temp->size = size;
+
+    ret = OC_STACK_MALFORMED_RESPONSE;
+    err = cbor_parser_init(cbor, size, 0, &temp->parser, &temp->map);
+    VERIFY_CBOR_SUCCESS(TAG, err, "Failed initializing parser");
+    if (!cbor_value_is_map(&temp->map))
+    {
+        OIC_LOG(ERROR, TAG, "Representation is not a map");
+        goto exit;
+    }
+
+    // The getters decode lazily, so check now that the map is complete and nothing follows it
+    CborValue end = temp->map;
+    err = cbor_value_advance(&end);
+    VERIFY_CBOR_SUCCESS(TAG, err, "Failed walking representation");
+    if (cbor_value_get_next_byte(&end) != (cbor + size))
+    {
+        OIC_LOG(ERROR, TAG, "Representation is followed by other data");
+        goto exit;
+    }
+
+    *view = temp;
+    return OC_STACK_OK;
+
+exit:
+    OICFree(temp);
+    return ret;
+}
+
+void OC_CALL OCRepPayloadViewDestroy(OCRepPayloadView *view)
+{
+    if (!view)
+    {
+        return;
+    }
+    OCRepPayloadDestroy(view->payload);
+    OICFree(view);
+}
+
+OCRepPayload* OC_CALL OCRepPayloadViewGetPayload(OCRepPayloadView *view)
+{
+    if (!view)
+    {
+        return NULL;
+    }
+
+    if (!view->payload)
+    {
+        OCPayload *payload = NULL;
+        if (OC_STACK_OK != OCParsePayload(&payload, OC_FORMAT_CBOR,
+                    PAYLOAD_TYPE_REPRESENTATION, view->cbor, view->size))
+        {
+            OIC_LOG(ERROR, TAG, "Failed converting view to payload");
+            OCPayloadDestroy(payload);
+            return NULL;
+        }
+        view->payload = (OCRepPayload *)payload;
+    }
+    return view->payload;
+}
+
+/**
+ * Find a property in the map of a view. Like OCParseRepPayload, the uri, resource types
+ * and interfaces of the representation are not properties.
+ */
+static bool OCRepPayloadViewFindValue(const OCRepPayloadView *view, const char *name,
+        CborValue *value)
+{
+    if (!view || !name ||
+        (0 == strcmp(OC_RSRVD_HREF, name)) ||
+        (0 == strcmp(OC_RSRVD_RESOURCE_TYPE, name)) ||
+        (0 == strcmp(OC_RSRVD_INTERFACE, name)))
+    {
+        return false;
+    }
+
+    if (CborNoError != cbor_value_map_find_value(&view->map, name, value))
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed finding %s in view", name);
+        return false;
+    }
+    return cbor_value_is_valid(value);
+}
+
+bool OC_CALL OCRepPayloadViewIsNull(const OCRepPayloadView *view, const char *name)
+{
+    if (view && view->payload)
+    {
+        return OCRepPayloadIsNull(view->payload, name);
+    }
+
+    CborValue value;
+    if (!OCRepPayloadViewFindValue(view, name, &value))
+    {
+        return true;
+    }
+    return cbor_value_is_null(&value);
+}
+
+bool OC_CALL OCRepPayloadViewGetPropInt(const OCRepPayloadView *view, const char *name,
+        int64_t *value)
+{
+    if (view && view->payload)
+    {
+        return OCRepPayloadGetPropInt(view->payload, name, value);
+    }
+
+    CborValue val;
+    if (!value || !OCRepPayloadViewFindValue(view, name, &val) || !cbor_value_is_integer(&val))
+    {
+        return false;
+    }
+    return CborNoError == cbor_value_get_int64(&val, value);
+}
+
+bool OC_CALL OCRepPayloadViewGetPropDouble(const OCRepPayloadView *view, const char *name,
+        double *value)
+{
+    if (view && view->payload)
+    {
+        return OCRepPayloadGetPropDouble(view->payload, name, value);
+    }
+
+    CborValue val;
+    if (!value || !OCRepPayloadViewFindValue(view, name, &val))
+    {
+        return false;
+    }
+
+    if (cbor_value_is_double(&val))
+    {
+        return CborNoError == cbor_value_get_double(&val, value);
+    }
+    else if (cbor_value_is_integer(&val))
+    {
+        int64_t i = 0;
+        if (CborNoError != cbor_value_get_int64(&val, &i))
+        {
+            return false;
+        }
+        *value = (double)i;
+        return true;
+    }
+    return false;
+}
+
+bool OC_CALL OCRepPayloadViewGetPropBool(const OCRepPayloadView *view, const char *name,
+        bool *value)
+{
+    if (view && view->payload)
+    {
+        return OCRepPayloadGetPropBool(view->payload, name, value);
+    }
+
+    CborValue val;
+    if (!value || !OCRepPayloadViewFindValue(view, name, &val) || !cbor_value_is_boolean(&val))
+    {
+        return false;
+    }
+    return CborNoError == cbor_value_get_boolean(&val, value);
+}
+
+bool OC_CALL OCRepPayloadViewGetPropString(const OCRepPayloadView *view, const char *name,
+        char **value)
+{
+    if (view && view->payload)
+    {
+        return OCRepPayloadGetPropString(view->payload, name, value);
+    }
+
+    CborValue val;
+    if (!value || !OCRepPayloadViewFindValue(view, name, &val) ||
+        !cbor_value_is_text_string(&val))
+    {
+        return false;
+    }
+
+    size_t len = 0;
+    if (CborNoError != cbor_value_calculate_string_length(&val, &len))
+    {
+        return false;
+    }
+    char *str = (char *)OICMalloc(len + 1);
+    if (!str)
+    {
+        OIC_LOG(ERROR, TAG, "Failed allocating memory");
+        return false;
+    }
+    len++;
+    if (CborNoError != cbor_value_copy_text_string(&val, str, &len, NULL))
+    {
+        OICFree(str);
+        return false;
+    }
+    *value = str;
+    return true;
+}
+
+/**
+ * Get a string of the map of a view without copying it. A string of known length is
+ * stored in one piece right before the value following it.
+ */
+static bool OCRepPayloadViewGetStringRef(const OCRepPayloadView *view, const char *name,
+        CborType type, const uint8_t **value, size_t *len)
+{
+    CborValue val;
+    if (!value || !len || !OCRepPayloadViewFindValue(view, name, &val) ||
+        (type != cbor_value_get_type(&val)) || !cbor_value_is_length_known(&val))
+    {
+        return false;
+    }
+
+    size_t size = 0;
+    if ((CborNoError != cbor_value_get_string_length(&val, &size)) ||
+        (CborNoError != cbor_value_advance(&val)))
+    {
+        return false;
+    }
+    *value = cbor_value_get_next_byte(&val) - size;
+    *len = size;
+    return true;
+}
+
+bool OC_CALL OCRepPayloadViewGetPropStringRef(const OCRepPayloadView *view, const char *name,
+        const char **value, size_t *len)
+{
+    if (view && view->payload)
+    {
+        OCRepPayloadValue *val = OCRepPayloadFindValue(view->payload, name);
+        if (!value || !len || !val || (OCREP_PROP_STRING != val->type))
+        {
+            return false;
+        }
+        *value = val->str;
+        *len = strlen(val->str);
+        return true;
+    }
+
+    const uint8_t *str = NULL;
+    if (!value || !OCRepPayloadViewGetStringRef(view, name, CborTextStringType, &str, len))
+    {
+        return false;
+    }
+    *value = (const char *)str;
+    return true;
+}
+
+bool OC_CALL OCRepPayloadViewGetPropByteStringRef(const OCRepPayloadView *view,
+        const char *name, const uint8_t **value, size_t *len)
+{
+    if (view && view->payload)
+    {
+        OCRepPayloadValue *val = OCRepPayloadFindValue(view->payload, name);
+        if (!value || !len || !val || (OCREP_PROP_BYTE_STRING != val->type))
+        {
+            return false;
+        }
+        *value = val->ocByteStr.bytes;
+        *len = val->ocByteStr.len;
+        return true;
+    }
+
+    return OCRepPayloadViewGetStringRef(view, name, CborByteStringType, value, len);
+}
@@ -415,6 +415,7 @@ void DeleteServerRequest(OCServerRequest * serverRequest)
 
         RBL_REMOVE(ServerRequestTree, &g_serverRequestTree, serverRequest);
         OICFree(serverRequest->requestToken);
+        OICFree(serverRequest->notificationTargets);
         OICFree(serverRequest);
         serverRequest = NULL;
         OIC_LOG(INFO, TAG, "Server Request Removed");
@@ -470,6 +471,79 @@ OCStackResult FormOCEntityHandlerRequest(OCEntityHandlerRequest * entityHandlerR
     return OC_STACK_INVALID_PARAM;
 }
 
+/**
+ * Send a response to a remote endpoint. Presence notifications to the default adapter go
+ * out on every adapter.
+ *
+ * @param[in]  responseEndpoint CA remote endpoint; its adapter may be updated.
+ * @param[in]  responseInfo     CA response info.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult SendResponseToEndpoint(CAEndpoint_t *responseEndpoint,
+                                            CAResponseInfo_t *responseInfo)
+{
+#ifdef WITH_PRESENCE
+    CATransportAdapter_t CAConnTypes[] = {
+                            CA_ADAPTER_IP,
+                            CA_ADAPTER_GATT_BTLE,
+                            CA_ADAPTER_RFCOMM_BTEDR,
+                            CA_ADAPTER_NFC
+#ifdef RA_ADAPTER
+                            , CA_ADAPTER_REMOTE_ACCESS
+#endif
+                            , CA_ADAPTER_TCP
+                        };
+
+    size_t size = sizeof(CAConnTypes)/ sizeof(CATransportAdapter_t);
+
+    CATransportAdapter_t adapter = responseEndpoint->adapter;
+    // Default adapter, try to send response out on all adapters.
+    if (adapter == CA_DEFAULT_ADAPTER)
+    {
+        adapter =
+            (CATransportAdapter_t)(
+                CA_ADAPTER_IP           |
+                CA_ADAPTER_GATT_BTLE    |
+                CA_ADAPTER_RFCOMM_BTEDR |
+                CA_ADAPTER_NFC
+#ifdef RA_ADAP
+                | CA_ADAPTER_REMOTE_ACCESS
+#endif
+                | CA_ADAPTER_TCP
+            );
+    }
+
+    OCStackResult result = OC_STACK_OK;
+    OCStackResult tempResult = OC_STACK_OK;
+
+    for(size_t i = 0; i < size; i++ )
+    {
+        responseEndpoint->adapter = (CATransportAdapter_t)(adapter & CAConnTypes[i]);
+        if(responseEndpoint->adapter)
+        {
+            //The result is set to OC_STACK_OK only if OCSendResponse succeeds in sending the
+            //response on all the n/w interfaces else it is set to OC_STACK_ERROR
+            tempResult = OCSendResponse(responseEndpoint, responseInfo);
+        }
+        if(OC_STACK_OK != tempResult)
+        {
+            result = tempResult;
+        }
+    }
+#else
+
+    OIC_LOG(INFO, TAG, "Calling OCSendResponse with:");
+    OIC_LOG_V(INFO, TAG, "\tEndpoint address: %s", responseEndpoint->addr);
+    OIC_LOG_V(INFO, TAG, "\tEndpoint adapter: %s", responseEndpoint->adapter);
+    OIC_LOG_V(INFO, TAG, "\tResponse result : %s", responseInfo->result);
+    OIC_LOG_V(INFO, TAG, "\tResponse for uri: %s", responseInfo->info.resourceUri);
+
+    OCStackResult result = OCSendResponse(responseEndpoint, responseInfo);
+#endif
+    return result;
+}
+
 /**
  * Handler function for sending a response from a single resource
  *
@@ -771,64 +845,26 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
         }
     }
 
-#ifdef WITH_PRESENCE
-    CATransportAdapter_t CAConnTypes[] = {
-                            CA_ADAPTER_IP,
-                            CA_ADAPTER_GATT_BTLE,
-                            CA_ADAPTER_RFCOMM_BTEDR,
-                            CA_ADAPTER_NFC
-#ifdef RA_ADAPTER
-                            , CA_ADAPTER_REMOTE_ACCESS
-#endif
-                            , CA_ADAPTER_TCP
-                        };
+    result = SendResponseToEndpoint(&responseEndpoint, &responseInfo);
 
-    size_t size = sizeof(CAConnTypes)/ sizeof(CATransportAdapter_t);
-
-    CATransportAdapter_t adapter = responseEndpoint.adapter;
-    // Default adapter, try to send response out on all adapters.
-    if (adapter == CA_DEFAULT_ADAPTER)
+    // Observers grouped with this one get the same encoded notification.
+    for (size_t i = 0; i < serverRequest->numNotificationTargets; i++)
     {
-        adapter =
-            (CATransportAdapter_t)(
-                CA_ADAPTER_IP           |
-                CA_ADAPTER_GATT_BTLE    |
-                CA_ADAPTER_RFCOMM_BTEDR |
-                CA_ADAPTER_NFC
-#ifdef RA_ADAP
-                | CA_ADAPTER_REMOTE_ACCESS
-#endif
-                | CA_ADAPTER_TCP
-            );
-    }
+        const OCNotificationTarget *target = &serverRequest->notificationTargets[i];
 
-    result = OC_STACK_OK;
-    OCStackResult tempResult = OC_STACK_OK;
+        CopyDevAddrToEndpoint(&target->devAddr, &responseEndpoint);
+        responseInfo.info.type = (target->qos == OC_HIGH_QOS) ? CA_MSG_CONFIRM
+                                                              : CA_MSG_NONCONFIRM;
+        memcpy(responseInfo.info.token, target->token, target->tokenLength);
+        responseInfo.info.tokenLength = target->tokenLength;
 
-    for(size_t i = 0; i < size; i++ )
-    {
-        responseEndpoint.adapter = (CATransportAdapter_t)(adapter & CAConnTypes[i]);
-        if(responseEndpoint.adapter)
-        {
-            //The result is set to OC_STACK_OK only if OCSendResponse succeeds in sending the
-            //response on all the n/w interfaces else it is set to OC_STACK_ERROR
-            tempResult = OCSendResponse(&responseEndpoint, &responseInfo);
-        }
-        if(OC_STACK_OK != tempResult)
+        OCStackResult targetResult = SendResponseToEndpoint(&responseEndpoint, &responseInfo);
+        if (OC_STACK_OK != targetResult)
         {
-            result = tempResult;
+            OIC_LOG_V(ERROR, TAG, "Notification to %s failed", responseEndpoint.addr);
+            result = targetResult;
         }
     }
-#else
-
-    OIC_LOG(INFO, TAG, "Calling OCSendResponse with:");
-    OIC_LOG_V(INFO, TAG, "\tEndpoint address: %s", responseEndpoint.addr);
-    OIC_LOG_V(INFO, TAG, "\tEndpoint adapter: %s", responseEndpoint.adapter);
-    OIC_LOG_V(INFO, TAG, "\tResponse result : %s", responseInfo.result);
-    OIC_LOG_V(INFO, TAG, "\tResponse for uri: %s", responseInfo.info.resourceUri);
-
-    result = OCSendResponse(&responseEndpoint, &responseInfo);
-#endif
 
     OICFree(responseInfo.info.payload);
     OICFree(responseInfo.info.options);
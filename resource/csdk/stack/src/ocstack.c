@@ -135,6 +135,22 @@ static OCStackState stackState = OC_STACK_UNINITIALIZED;
 
 OCResource *headResource = NULL;
 static OCResource *tailResource = NULL;
+
+/**
+ * Initial number of buckets in the resource indexes. Must be a power of two.
+ */
+#ifndef RESOURCE_INDEX_INITIAL_SIZE
+#define RESOURCE_INDEX_INITIAL_SIZE 64
+#endif
+
+// Resources hashed on their uri, chained through OCResource::uriNext.
+static OCResource **g_resourceUriIndex = NULL;
+// Resources hashed on their address, chained through OCResource::handleNext.
+static OCResource **g_resourceHandleIndex = NULL;
+// Number of buckets in each of the two indexes.
+static size_t g_resourceIndexSize = 0;
+// Number of resources in the handle index.
+static size_t g_resourceCount = 0;
 static OCResourceHandle platformResource = {0};
 static OCResourceHandle deviceResource = {0};
 static OCResourceHandle introspectionResource = {0};
@@ -149,6 +165,17 @@ static OCPresenceState presenceState = OC_PRESENCE_UNINITIALIZED;
 static PresenceResource presenceResource = {0};
 static uint8_t PresenceTimeOutSize = 0;
 static uint32_t PresenceTimeOut[] = {50, 75, 85, 95, 100};
+// Tick at which OCProcessPresence() next has work, if g_hasPresenceDeadline.
+static volatile uint32_t g_presenceDeadline = 0;
+static volatile bool g_hasPresenceDeadline = false;
+#endif
+
+/**
+ * Longest time OCProcessWait() blocks while OCProcess() also has periodic work
+ * that is not driven by received data (keepalive, ping, routing), in msec.
+ */
+#ifndef OC_PROCESS_WAIT_MAX_MSEC
+#define OC_PROCESS_WAIT_MAX_MSEC (1000)
 #endif
 
 static OCMode myStackMode;
@@ -212,11 +239,35 @@ static OCDoHandle GenerateInvocationHandle(void);
 static OCStackResult initResources(void);
 
 /**
- * Add a resource to the end of the linked list of resources.
+ * Add a resource to the end of the linked list of resources and to the handle index.
  *
  * @param resource Resource to be added
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NO_MEMORY if the index could not be allocated.
+ */
+static OCStackResult insertResource(OCResource *resource);
+
+/**
+ * Add a resource whose uri has been set to the uri index.
+ *
+ * @param resource Resource previously added with insertResource().
+ */
+static void indexResourceUri(OCResource *resource);
+
+/**
+ * Remove a resource from the uri and handle indexes.
+ *
+ * @param resource Resource to be removed.
+ */
+static void unindexResource(OCResource *resource);
+
+/**
+ * Look up a resource in the uri index.
+ *
+ * @param uri    Resource uri, without query.
+ * @param length Number of characters of the uri that have to match.
+ * @return the resource whose uri matches, or NULL if there is none.
  */
-static void insertResource(OCResource *resource);
+static OCResource *findResourceInUriIndex(const char *uri, size_t length);
 
 /**
  * Find a resource in the linked list of resources.
@@ -412,6 +463,13 @@ static OCResourceType *findResourceType(OCResourceType * resourceTypeList,
  */
 static OCStackResult ResetPresenceTTL(ClientCB *cbNode, uint32_t maxAgeSeconds);
 
+#ifdef WITH_PRESENCE
+/**
+ * Record when presence next has to be processed and wake up OCProcessWait() if needed.
+ */
+static void UpdatePresenceDeadline(void);
+#endif
+
 /**
  * Set Header Option.
  * @param caHdrOpt            Pointer to existing options
@@ -1824,7 +1882,19 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 if (OCResultToSuccess(response->result) || PAYLOAD_TYPE_REPRESENTATION == type ||
                         PAYLOAD_TYPE_DIAGNOSTIC == type)
                 {
-                    if (OC_STACK_OK != OCParsePayload(&response->payload,
+                    // The view references the received buffer, which outlives the callback.
+                    // Anything but a single, complete representation is parsed as usual.
+                    if (cbNode->payloadView && PAYLOAD_TYPE_REPRESENTATION == type &&
+                        (CA_FORMAT_APPLICATION_CBOR == responseInfo->info.payloadFormat ||
+                         CA_FORMAT_APPLICATION_VND_OCF_CBOR == responseInfo->info.payloadFormat) &&
+                        OC_STACK_OK == OCRepPayloadViewCreate(
+                            (const uint8_t *)responseInfo->info.payload,
+                            responseInfo->info.payloadSize,
+                            (OCRepPayloadView **)&response->payload))
+                    {
+                        OIC_LOG(DEBUG, TAG, "Delivering representation as a view");
+                    }
+                    else if (OC_STACK_OK != OCParsePayload(&response->payload,
                             CAToOCPayloadFormat(responseInfo->info.payloadFormat),
                             type,
                             responseInfo->info.payload,
@@ -1960,8 +2030,8 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 else
                 {
                     // To keep discovery callbacks active.
-                    cbNode->TTL = GetTicks(MAX_CB_TIMEOUT_SECONDS *
-                                            MILLISECONDS_PER_SECOND);
+                    UpdateClientCBTTL(cbNode, GetTicks(MAX_CB_TIMEOUT_SECONDS *
+                                                       MILLISECONDS_PER_SECOND));
                 }
             }
 
@@ -3242,17 +3312,20 @@ static void assertRolesCB(void* ctx, bool hasError)
 
 /**
  * Discover or Perform requests on a specified resource
+ *
+ * @param payloadView   Deliver representations of the responses as an OCRepPayloadView.
  */
-OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
-                                  OCMethod method,
-                                  const char *requestUri,
-                                  const OCDevAddr *destination,
-                                  OCPayload* payload,
-                                  OCConnectivityType connectivityType,
-                                  OCQualityOfService qos,
-                                  OCCallbackData *cbData,
-                                  OCHeaderOption *options,
-                                  uint8_t numOptions)
+static OCStackResult DoRequest(OCDoHandle *handle,
+                               OCMethod method,
+                               const char *requestUri,
+                               const OCDevAddr *destination,
+                               OCPayload* payload,
+                               OCConnectivityType connectivityType,
+                               OCQualityOfService qos,
+                               OCCallbackData *cbData,
+                               OCHeaderOption *options,
+                               uint8_t numOptions,
+                               bool payloadView)
 {
     OIC_LOG(INFO, TAG, "Entering OCDoResource");
 
@@ -3591,7 +3664,7 @@ OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
                          requestInfo.info.options, requestInfo.info.numOptions,
                          requestInfo.info.payload, requestInfo.info.payloadSize,
                          requestInfo.info.payloadFormat, &resHandle, method,
-                         devAddr, resourceUri, resourceType, ttl);
+                         devAddr, resourceUri, resourceType, ttl, payloadView);
 
     if (OC_STACK_OK != result)
     {
@@ -3606,6 +3679,7 @@ OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
     if (method == OC_REST_PRESENCE)
     {
         OIC_LOG(ERROR, TAG, "AddClientCB for presence done.");
+        UpdatePresenceDeadline();
 
         if (handle)
         {
@@ -3707,6 +3781,36 @@ exit:
     return result;
 }
 
+OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
+                                  OCMethod method,
+                                  const char *requestUri,
+                                  const OCDevAddr *destination,
+                                  OCPayload* payload,
+                                  OCConnectivityType connectivityType,
+                                  OCQualityOfService qos,
+                                  OCCallbackData *cbData,
+                                  OCHeaderOption *options,
+                                  uint8_t numOptions)
+{
+    return DoRequest(handle, method, requestUri, destination, payload, connectivityType,
+                     qos, cbData, options, numOptions, false);
+}
+
+OCStackResult OC_CALL OCDoRequestWithPayloadView(OCDoHandle *handle,
+                                                 OCMethod method,
+                                                 const char *requestUri,
+                                                 const OCDevAddr *destination,
+                                                 OCPayload* payload,
+                                                 OCConnectivityType connectivityType,
+                                                 OCQualityOfService qos,
+                                                 OCCallbackData *cbData,
+                                                 OCHeaderOption *options,
+                                                 uint8_t numOptions)
+{
+    return DoRequest(handle, method, requestUri, destination, payload, connectivityType,
+                     qos, cbData, options, numOptions, true);
+}
+
 OCStackResult OC_CALL OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHeaderOption * options,
         uint8_t numOptions)
 {
@@ -3941,6 +4045,44 @@ exit:
 
     return result;
 }
+
+/**
+ * Record when OCProcessPresence() next has to run, for OCProcessWait().
+ * Wakes up the waiting threads if that is earlier than they wait for, as they
+ * may be waiting without limit, or for a deadline recorded by another thread.
+ */
+static void UpdatePresenceDeadline(void)
+{
+    ClientCB *cbNode = NULL;
+    uint32_t deadline = 0;
+    bool hasDeadline = false;
+
+    LL_FOREACH(g_cbList, cbNode)
+    {
+        if (OC_REST_PRESENCE != cbNode->method || !cbNode->presence
+            || cbNode->presence->TTLlevel > PresenceTimeOutSize)
+        {
+            continue;
+        }
+
+        // The last level reports the timeout on the next pass.
+        uint32_t next = (cbNode->presence->TTLlevel < PresenceTimeOutSize) ?
+                        cbNode->presence->timeOut[cbNode->presence->TTLlevel] : 0;
+        if (!hasDeadline || next < deadline)
+        {
+            deadline = next;
+            hasDeadline = true;
+        }
+    }
+
+    bool earlier = hasDeadline && (!g_hasPresenceDeadline || deadline < g_presenceDeadline);
+    g_presenceDeadline = deadline;
+    g_hasPresenceDeadline = hasDeadline;
+    if (earlier)
+    {
+        CAWakeUpRequestResponse();
+    }
+}
 #endif // WITH_PRESENCE
 
 OCStackResult OC_CALL OCProcess(void)
@@ -3963,9 +4105,61 @@ OCStackResult OC_CALL OCProcess(void)
     ProcessKeepAlive();
     CAProcessPing();
 #endif
+
+#ifdef WITH_PRESENCE
+    UpdatePresenceDeadline();
+#endif
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCProcessWait(uint32_t timeoutMs, uint32_t *wakeUps)
+{
+    if (stackState == OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCProcessWait has failed. ocstack is not initialized");
+        return OC_STACK_ERROR;
+    }
+
+    uint32_t waitMs = timeoutMs;
+#if defined(TCP_ADAPTER) || defined(ROUTING_GATEWAY)
+    if (0 == waitMs || waitMs > OC_PROCESS_WAIT_MAX_MSEC)
+    {
+        waitMs = OC_PROCESS_WAIT_MAX_MSEC;
+    }
+#endif
+
+#ifdef WITH_PRESENCE
+    if (g_hasPresenceDeadline)
+    {
+        uint32_t deadline = g_presenceDeadline;
+        uint32_t now = GetTicks(0);
+        if (deadline <= now)
+        {
+            return OC_STACK_OK;
+        }
+        if (0 == waitMs || deadline - now < waitMs)
+        {
+            waitMs = deadline - now;
+        }
+    }
+#endif
+
+    switch (CAWaitForRequestResponse(waitMs, wakeUps))
+    {
+        case CA_STATUS_OK:
+            return OC_STACK_OK;
+        case CA_REQUEST_TIMEOUT:
+            return OC_STACK_TIMEOUT;
+        default:
+            return OC_STACK_ERROR;
+    }
+}
+
+void OC_CALL OCProcessWakeUp(void)
+{
+    CAWakeUpRequestResponse();
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult OC_CALL OCStartPresence(const uint32_t ttl)
 {
@@ -4166,21 +4360,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         return OC_STACK_INVALID_PARAM;
     }
 
-    // If the headResource is NULL, then no resources have been created...
-    pointer = headResource;
-    if (pointer)
+    // Repeated URLs are not allowed.  If a repeat is found, exit with an error
+    if (findResourceInUriIndex(uri, MAX_URI_LENGTH))
     {
-        // At least one resources is in the resource list, so we need to search for
-        // repeated URLs, which are not allowed.  If a repeat is found, exit with an error
-        while (pointer)
-        {
-            if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-            {
-                OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
-                return OC_STACK_INVALID_PARAM;
-            }
-            pointer = pointer->next;
-        }
+        OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
+        return OC_STACK_INVALID_PARAM;
     }
     // Create the pointer and insert it into the resource list
     pointer = (OCResource *) OICCalloc(1, sizeof(OCResource));
@@ -4191,7 +4375,13 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
     }
     pointer->sequenceNum = OC_OFFSET_SEQUENCE_NUMBER;
 
-    insertResource(pointer);
+    result = insertResource(pointer);
+    if (result != OC_STACK_OK)
+    {
+        OICFree(pointer);
+        pointer = NULL;
+        goto exit;
+    }
 
     // Set the uri
     pointer->uri = OICStrdup(uri);
@@ -4200,6 +4390,7 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         result = OC_STACK_NO_MEMORY;
         goto exit;
     }
+    indexResourceUri(pointer);
 
     // Set resource to secure if caller did not specify
     if ((resourceProperties & OC_MASK_RESOURCE_SECURE) == 0)
@@ -5245,8 +5436,93 @@ OCStackResult initResources(void)
     return result;
 }
 
-void insertResource(OCResource *resource)
+static size_t hashResourceUri(const char *uri)
+{
+    // FNV-1a
+    // Only the first MAX_URI_LENGTH characters, the uris OCCreateResource tells apart.
+    uint32_t hash = 2166136261u;
+    const unsigned char *end = (const unsigned char *) uri + MAX_URI_LENGTH;
+    for (const unsigned char *c = (const unsigned char *) uri; (c < end) && *c; c++)
+    {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+static size_t hashResourceHandle(const OCResource *resource)
+{
+    // Allocations are aligned, drop the low bits before mixing.
+    uintptr_t value = (uintptr_t) resource >> 3;
+    return (size_t) ((value ^ (value >> 16)) * 2654435761u);
+}
+
+/**
+ * Rehash both resource indexes into @p size buckets. On allocation failure the
+ * current tables are kept; lookups stay correct, only the chains get longer.
+ */
+static bool resizeResourceIndex(size_t size)
 {
+    OCResource **uriIndex = (OCResource **) OICCalloc(size, sizeof(OCResource *));
+    OCResource **handleIndex = (OCResource **) OICCalloc(size, sizeof(OCResource *));
+    if (!uriIndex || !handleIndex)
+    {
+        OICFree(uriIndex);
+        OICFree(handleIndex);
+        return false;
+    }
+
+    for (size_t i = 0; i < g_resourceIndexSize; i++)
+    {
+        OCResource *next = NULL;
+        for (OCResource *resource = g_resourceUriIndex[i]; resource; resource = next)
+        {
+            next = resource->uriNext;
+            size_t bucket = hashResourceUri(resource->uri) & (size - 1);
+            resource->uriNext = uriIndex[bucket];
+            uriIndex[bucket] = resource;
+        }
+        for (OCResource *resource = g_resourceHandleIndex[i]; resource; resource = next)
+        {
+            next = resource->handleNext;
+            size_t bucket = hashResourceHandle(resource) & (size - 1);
+            resource->handleNext = handleIndex[bucket];
+            handleIndex[bucket] = resource;
+        }
+    }
+
+    OICFree(g_resourceUriIndex);
+    OICFree(g_resourceHandleIndex);
+    g_resourceUriIndex = uriIndex;
+    g_resourceHandleIndex = handleIndex;
+    g_resourceIndexSize = size;
+    return true;
+}
+
+static void freeResourceIndex(void)
+{
+    OICFree(g_resourceUriIndex);
+    OICFree(g_resourceHandleIndex);
+    g_resourceUriIndex = NULL;
+    g_resourceHandleIndex = NULL;
+    g_resourceIndexSize = 0;
+    g_resourceCount = 0;
+}
+
+OCStackResult insertResource(OCResource *resource)
+{
+    if (!g_resourceIndexSize)
+    {
+        if (!resizeResourceIndex(RESOURCE_INDEX_INITIAL_SIZE))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate resource index");
+            return OC_STACK_NO_MEMORY;
+        }
+    }
+    else if (g_resourceCount >= g_resourceIndexSize)
+    {
+        resizeResourceIndex(g_resourceIndexSize * 2);
+    }
+
     if (!headResource)
     {
         headResource = resource;
@@ -5258,19 +5534,97 @@ void insertResource(OCResource *resource)
         tailResource = resource;
     }
     resource->next = NULL;
+
+    size_t bucket = hashResourceHandle(resource) & (g_resourceIndexSize - 1);
+    resource->handleNext = g_resourceHandleIndex[bucket];
+    g_resourceHandleIndex[bucket] = resource;
+    g_resourceCount++;
+    return OC_STACK_OK;
+}
+
+void indexResourceUri(OCResource *resource)
+{
+    size_t bucket = hashResourceUri(resource->uri) & (g_resourceIndexSize - 1);
+    resource->uriNext = g_resourceUriIndex[bucket];
+    g_resourceUriIndex[bucket] = resource;
+}
+
+void unindexResource(OCResource *resource)
+{
+    if (!g_resourceIndexSize)
+    {
+        return;
+    }
+
+    if (resource->uri)
+    {
+        OCResource **uriLink = &g_resourceUriIndex[hashResourceUri(resource->uri)
+                                                   & (g_resourceIndexSize - 1)];
+        for (; *uriLink; uriLink = &(*uriLink)->uriNext)
+        {
+            if (*uriLink == resource)
+            {
+                *uriLink = resource->uriNext;
+                break;
+            }
+        }
+    }
+
+    OCResource **link = &g_resourceHandleIndex[hashResourceHandle(resource)
+                                               & (g_resourceIndexSize - 1)];
+    for (; *link; link = &(*link)->handleNext)
+    {
+        if (*link == resource)
+        {
+            *link = resource->handleNext;
+            g_resourceCount--;
+            break;
+        }
+    }
+    resource->uriNext = NULL;
+    resource->handleNext = NULL;
+}
+
+static OCResource *findResourceInUriIndex(const char *uri, size_t length)
+{
+    if (!uri || !g_resourceIndexSize)
+    {
+        return NULL;
+    }
+
+    OCResource *pointer = g_resourceUriIndex[hashResourceUri(uri) & (g_resourceIndexSize - 1)];
+    while (pointer)
+    {
+        if (strncmp(uri, pointer->uri, length) == 0)
+        {
+            return pointer;
+        }
+        pointer = pointer->uriNext;
+    }
+    return NULL;
+}
+
+OCResource *GetResourceFromUriIndex(const char *uri)
+{
+    return findResourceInUriIndex(uri, SIZE_MAX);
 }
 
 OCResource *findResource(OCResource *resource)
 {
-    OCResource *pointer = headResource;
+    if (!resource || !g_resourceIndexSize)
+    {
+        return NULL;
+    }
 
+    OCResource *pointer = g_resourceHandleIndex[hashResourceHandle(resource)
+                                                & (g_resourceIndexSize - 1)];
     while (pointer)
     {
         if (pointer == resource)
         {
             return resource;
         }
-        pointer = pointer->next;
+        pointer = pointer->handleNext;
     }
     return NULL;
 }
@@ -5308,6 +5662,8 @@ void deleteAllResources(void)
     deleteResource((OCResource *) presenceResource.handle);
     memset(&presenceResource, 0, sizeof(presenceResource));
 #endif // WITH_PRESENCE
+
+    freeResourceIndex();
 }
 
 OCStackResult deleteResource(OCResource *resource)
@@ -5365,6 +5721,7 @@ OCStackResult deleteResource(OCResource *resource)
                 prev->next = temp->next;
             }
 
+            unindexResource(temp);
             deleteResourceElements(temp);
             OICFree(temp);
             temp = NULL;
@@ -5902,10 +6259,21 @@ OCStackResult OCUpdateResourceInsWithResponse(const char *requestUri,
             {
                 if (response->payload)
                 {
-                    OCRepPayload *rdPayload = (OCRepPayload *) response->payload;
+                    OCRepPayload *rdPayload = NULL;
+                    if (PAYLOAD_TYPE_REPRESENTATION == response->payload->type)
+                    {
+                        rdPayload = (OCRepPayload *) response->payload;
+                    }
+                    else if (PAYLOAD_TYPE_REPRESENTATION_VIEW == response->payload->type)
+                    {
+                        // The links are nested objects, which views don't read.
+                        rdPayload = OCRepPayloadViewGetPayload(
+                                (OCRepPayloadView *) response->payload);
+                    }
                     OCRepPayload **links = NULL;
                     size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 0 };
-                    if (OCRepPayloadGetPropObjectArray(rdPayload, OC_RSRVD_LINKS,
+                    if (rdPayload &&
+                        OCRepPayloadGetPropObjectArray(rdPayload, OC_RSRVD_LINKS,
                                                        &links, dimensions))
                     {
                         size_t i = 0;
@@ -6023,18 +6391,12 @@ OCResourceHandle OC_CALL OCGetResourceHandleAtUri(const char *uri)
         return NULL;
     }
 
-    OCResource *pointer = headResource;
-
-    while (pointer)
+    OCResource *pointer = findResourceInUriIndex(uri, MAX_URI_LENGTH);
+    if (pointer)
     {
-        if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-        {
-            OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
     }
-    return NULL;
+    return pointer;
 }
 
 static OCStackResult SetHeaderOption(CAHeaderOption_t *caHdrOpt, size_t numOptions,
@@ -25,8 +25,10 @@ extern "C"
     #include "ocstack.h"
     #include "ocpayload.h"
     #include "ocpayloadcbor.h"
+    #include "ocstackinternal.h"
     #include "experimental/logger.h"
     #include "oic_malloc.h"
+    #include "oic_string.h"
 }
 
 #include <gtest/gtest.h>
@@ -46,6 +48,7 @@ extern "C"
 #include <string.h>
 
 #include <iostream>
+#include <string>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -432,3 +435,328 @@ TEST(CborEmptyArrayTest, EmptyArrayArraySetGetTest)
     OCRepPayloadDestroy(payload_in);
 }
 
+
+TEST(CborSizeEstimateTest, EstimateCoversEncodedSize)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+
+    OCRepPayloadSetUri(payload_in, "/a/large_sensor");
+    EXPECT_TRUE(OCRepPayloadAddResourceType(payload_in, "core.sensor"));
+    EXPECT_TRUE(OCRepPayloadAddInterface(payload_in, "oic.if.baseline"));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "small", 4));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "large", INT64_MIN));
+    EXPECT_TRUE(OCRepPayloadSetPropDouble(payload_in, "double", 1.5));
+    EXPECT_TRUE(OCRepPayloadSetPropBool(payload_in, "bool", true));
+    EXPECT_TRUE(OCRepPayloadSetNull(payload_in, "null"));
+
+    std::string longString(70000, 'x');
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "long", longString.c_str()));
+
+    int64_t ints[2 * 3 * 4];
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); ++i)
+    {
+        ints[i] = (int64_t) i * 1000003;
+    }
+    size_t dim3[MAX_REP_ARRAY_DEPTH] = { 2, 3, 4 };
+    EXPECT_TRUE(OCRepPayloadSetIntArray(payload_in, "cube", ints, dim3));
+
+    const char *strArray[] = { "a", "bb", "ccc" };
+    size_t dim1[MAX_REP_ARRAY_DEPTH] = { 3, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetStringArray(payload_in, "strings", strArray, dim1));
+
+    OCRepPayload *child = OCRepPayloadCreate();
+    ASSERT_TRUE(child != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropString(child, "member", "value"));
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload_in, "child", child));
+
+    uint8_t *payload_cbor = NULL;
+    size_t payload_cbor_size = 0;
+    EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*) payload_in, OC_FORMAT_CBOR,
+            &payload_cbor, &payload_cbor_size));
+
+    size_t estimate = OCEstimatePayloadSize((OCPayload*) payload_in, OC_FORMAT_CBOR);
+    EXPECT_LE(payload_cbor_size, estimate);
+    // Heads and integers are estimated at their largest encoding only.
+    EXPECT_LT(estimate, payload_cbor_size + 256);
+
+    OICFree(payload_cbor);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborConvertToBufferTest, EncodeIntoCallerBuffer)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+    OCRepPayloadSetUri(payload_in, "/a/light");
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "brightness", 42));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "state", "on"));
+
+    uint8_t *payload_cbor = NULL;
+    size_t payload_cbor_size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*) payload_in, OC_FORMAT_CBOR,
+            &payload_cbor, &payload_cbor_size));
+
+    // Too small: the required size is reported back.
+    uint8_t buffer[256];
+    size_t size = 4;
+    EXPECT_EQ(OC_STACK_NO_MEMORY, OCConvertPayloadToBuffer((OCPayload*) payload_in,
+            OC_FORMAT_CBOR, buffer, &size));
+    EXPECT_EQ(payload_cbor_size, size);
+
+    // Measuring without a buffer works the same way.
+    size = 0;
+    EXPECT_EQ(OC_STACK_NO_MEMORY, OCConvertPayloadToBuffer((OCPayload*) payload_in,
+            OC_FORMAT_CBOR, NULL, &size));
+    EXPECT_EQ(payload_cbor_size, size);
+
+    size = payload_cbor_size;
+    EXPECT_EQ(OC_STACK_OK, OCConvertPayloadToBuffer((OCPayload*) payload_in,
+            OC_FORMAT_CBOR, buffer, &size));
+    ASSERT_EQ(payload_cbor_size, size);
+    EXPECT_EQ(0, memcmp(payload_cbor, buffer, size));
+
+    OICFree(payload_cbor);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborArenaPayloadTest, ManyPropertiesSetGetTest)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreateWithArena(0);
+    ASSERT_TRUE(payload_in != NULL);
+    EXPECT_TRUE(OCRepPayloadHasArena(payload_in));
+
+    char name[32];
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        snprintf(name, sizeof(name), "int%d", (int) i);
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, name, i));
+        snprintf(name, sizeof(name), "string%d", (int) i);
+        EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, name, name));
+    }
+    // Values handed over from the heap are freed with the payload.
+    EXPECT_TRUE(OCRepPayloadSetPropStringAsOwner(payload_in, "string7", OICStrdup("owned")));
+    EXPECT_TRUE(OCRepPayloadHasIndex(payload_in));
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        int64_t value = -1;
+        snprintf(name, sizeof(name), "int%d", (int) i);
+        EXPECT_TRUE(OCRepPayloadGetPropInt(payload_in, name, &value));
+        EXPECT_EQ(i, value);
+    }
+
+    char* str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload_in, "string7", &str));
+    EXPECT_STREQ("owned", str);
+    OICFree(str);
+    EXPECT_TRUE(OCRepPayloadIsNull(payload_in, "missing"));
+
+    // Values keep the order they were first set in.
+    ASSERT_TRUE(payload_in->values != NULL);
+    EXPECT_STREQ("int0", payload_in->values->name);
+
+    OCRepPayload* clone = OCRepPayloadClone(payload_in);
+    ASSERT_TRUE(clone != NULL);
+    EXPECT_FALSE(OCRepPayloadHasArena(clone));
+    EXPECT_TRUE(OCRepPayloadGetPropString(clone, "string99", &str));
+    EXPECT_STREQ("string99", str);
+    OICFree(str);
+
+    OCRepPayloadDestroy(clone);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborArenaPayloadTest, ParsedPayloadUsesArena)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+
+    char name[32];
+    for (int64_t i = 0; i < 20; ++i)
+    {
+        snprintf(name, sizeof(name), "property%d", (int) i);
+        EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, name, name));
+    }
+    const char *strArray[] = { "a", "bb", "ccc" };
+    size_t dim1[MAX_REP_ARRAY_DEPTH] = { 3, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetStringArray(payload_in, "strings", strArray, dim1));
+
+    uint8_t *payload_cbor = NULL;
+    size_t payload_cbor_size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*) payload_in, OC_FORMAT_CBOR,
+            &payload_cbor, &payload_cbor_size));
+
+    OCPayload* payload_out = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCParsePayload(&payload_out, OC_FORMAT_CBOR,
+            PAYLOAD_TYPE_REPRESENTATION, payload_cbor, payload_cbor_size));
+    OCRepPayload* rep_out = (OCRepPayload*) payload_out;
+    EXPECT_TRUE(OCRepPayloadHasArena(rep_out));
+    EXPECT_TRUE(OCRepPayloadHasIndex(rep_out));
+
+    char* str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(rep_out, "property13", &str));
+    EXPECT_STREQ("property13", str);
+    OICFree(str);
+
+    char** strings = NULL;
+    size_t dimensions_out[MAX_REP_ARRAY_DEPTH] = {0};
+    ASSERT_TRUE(OCRepPayloadGetStringArray(rep_out, "strings", &strings, dimensions_out));
+    ASSERT_EQ(3u, dimensions_out[0]);
+    EXPECT_STREQ("ccc", strings[2]);
+    for (size_t i = 0; i < dimensions_out[0]; ++i)
+    {
+        OICFree(strings[i]);
+    }
+    OICFree(strings);
+
+    // Parsed payloads can still be modified.
+    EXPECT_TRUE(OCRepPayloadSetPropString(rep_out, "property13", "changed"));
+    EXPECT_TRUE(OCRepPayloadGetPropString(rep_out, "property13", &str));
+    EXPECT_STREQ("changed", str);
+    OICFree(str);
+
+    OICFree(payload_cbor);
+    OCPayloadDestroy(payload_out);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborPayloadViewTest, GetPropsWithoutParsing)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+    OCRepPayloadSetUri(payload_in, "/a/light");
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "power", 42));
+    EXPECT_TRUE(OCRepPayloadSetPropDouble(payload_in, "level", 0.5));
+    EXPECT_TRUE(OCRepPayloadSetPropBool(payload_in, "state", true));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "name", "light"));
+    EXPECT_TRUE(OCRepPayloadSetNull(payload_in, "nothing"));
+    uint8_t binval[] = {0x01, 0x02, 0x03};
+    OCByteString bytes = { binval, sizeof(binval) };
+    EXPECT_TRUE(OCRepPayloadSetPropByteString(payload_in, "bytes", bytes));
+
+    uint8_t *payload_cbor = NULL;
+    size_t payload_cbor_size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*) payload_in, OC_FORMAT_CBOR,
+            &payload_cbor, &payload_cbor_size));
+
+    OCRepPayloadView* view = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCRepPayloadViewCreate(payload_cbor, payload_cbor_size, &view));
+
+    int64_t power = 0;
+    EXPECT_TRUE(OCRepPayloadViewGetPropInt(view, "power", &power));
+    EXPECT_EQ(42, power);
+    double level = 0;
+    EXPECT_TRUE(OCRepPayloadViewGetPropDouble(view, "level", &level));
+    EXPECT_EQ(0.5, level);
+    EXPECT_TRUE(OCRepPayloadViewGetPropDouble(view, "power", &level));
+    EXPECT_EQ(42.0, level);
+    bool state = false;
+    EXPECT_TRUE(OCRepPayloadViewGetPropBool(view, "state", &state));
+    EXPECT_TRUE(state);
+    EXPECT_FALSE(OCRepPayloadViewGetPropBool(view, "power", &state));
+
+    char* str = NULL;
+    EXPECT_TRUE(OCRepPayloadViewGetPropString(view, "name", &str));
+    EXPECT_STREQ("light", str);
+    OICFree(str);
+
+    // References point into the encoded buffer.
+    const char* ref = NULL;
+    size_t len = 0;
+    EXPECT_TRUE(OCRepPayloadViewGetPropStringRef(view, "name", &ref, &len));
+    EXPECT_EQ(std::string("light"), std::string(ref, len));
+    EXPECT_TRUE((const uint8_t*) ref > payload_cbor);
+    EXPECT_TRUE((const uint8_t*) ref + len <= payload_cbor + payload_cbor_size);
+    const uint8_t* byteRef = NULL;
+    EXPECT_TRUE(OCRepPayloadViewGetPropByteStringRef(view, "bytes", &byteRef, &len));
+    ASSERT_EQ(sizeof(binval), len);
+    EXPECT_EQ(0, memcmp(binval, byteRef, len));
+    EXPECT_FALSE(OCRepPayloadViewGetPropStringRef(view, "bytes", &ref, &len));
+
+    EXPECT_TRUE(OCRepPayloadViewIsNull(view, "nothing"));
+    EXPECT_TRUE(OCRepPayloadViewIsNull(view, "missing"));
+    EXPECT_FALSE(OCRepPayloadViewIsNull(view, "power"));
+    // Like in a parsed payload, the uri is not a property.
+    EXPECT_FALSE(OCRepPayloadViewGetPropString(view, OC_RSRVD_HREF, &str));
+
+    OCPayloadDestroy((OCPayload*) view);
+    OICFree(payload_cbor);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborPayloadViewTest, GetPayloadForModification)
+{
+    OCRepPayload* payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "power", 42));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "name", "light"));
+    OCRepPayload* child = OCRepPayloadCreate();
+    ASSERT_TRUE(child != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(child, "x", 1));
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload_in, "child", child));
+
+    uint8_t *payload_cbor = NULL;
+    size_t payload_cbor_size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*) payload_in, OC_FORMAT_CBOR,
+            &payload_cbor, &payload_cbor_size));
+
+    OCRepPayloadView* view = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCRepPayloadViewCreate(payload_cbor, payload_cbor_size, &view));
+
+    OCRepPayload* rep = OCRepPayloadViewGetPayload(view);
+    ASSERT_TRUE(rep != NULL);
+    EXPECT_EQ(rep, OCRepPayloadViewGetPayload(view));
+
+    OCRepPayload* child_out = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(rep, "child", &child_out));
+    int64_t x = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(child_out, "x", &x));
+    EXPECT_EQ(1, x);
+    OCRepPayloadDestroy(child_out);
+
+    // The getters of the view read the modified payload.
+    EXPECT_TRUE(OCRepPayloadSetPropInt(rep, "power", 7));
+    EXPECT_TRUE(OCRepPayloadSetPropString(rep, "name", "lamp"));
+    int64_t power = 0;
+    EXPECT_TRUE(OCRepPayloadViewGetPropInt(view, "power", &power));
+    EXPECT_EQ(7, power);
+    const char* ref = NULL;
+    size_t len = 0;
+    EXPECT_TRUE(OCRepPayloadViewGetPropStringRef(view, "name", &ref, &len));
+    EXPECT_EQ(std::string("lamp"), std::string(ref, len));
+
+    OCRepPayloadViewDestroy(view);
+    OICFree(payload_cbor);
+    OCRepPayloadDestroy(payload_in);
+}
+
+TEST(CborPayloadViewTest, RejectsBatchAndMalformedPayloads)
+{
+    OCRepPayloadView* view = NULL;
+    const uint8_t notMap[] = { 0x01 };
+    EXPECT_EQ(OC_STACK_MALFORMED_RESPONSE, OCRepPayloadViewCreate(notMap, sizeof(notMap), &view));
+    // [{}]
+    const uint8_t batch[] = { 0x81, 0xa0 };
+    EXPECT_EQ(OC_STACK_MALFORMED_RESPONSE, OCRepPayloadViewCreate(batch, sizeof(batch), &view));
+    EXPECT_TRUE(view == NULL);
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCRepPayloadViewCreate(NULL, 0, &view));
+
+    // {"a": <truncated string>}
+    const uint8_t truncated[] = { 0xa1, 0x61, 'a', 0x65, 'x' };
+    EXPECT_EQ(OC_STACK_MALFORMED_RESPONSE,
+              OCRepPayloadViewCreate(truncated, sizeof(truncated), &view));
+    // {"a": 1, <missing pair>}
+    const uint8_t missingPair[] = { 0xa2, 0x61, 'a', 0x01 };
+    EXPECT_EQ(OC_STACK_MALFORMED_RESPONSE,
+              OCRepPayloadViewCreate(missingPair, sizeof(missingPair), &view));
+    // {} 1
+    const uint8_t trailing[] = { 0xa0, 0x01 };
+    EXPECT_EQ(OC_STACK_MALFORMED_RESPONSE,
+              OCRepPayloadViewCreate(trailing, sizeof(trailing), &view));
+    EXPECT_TRUE(view == NULL);
+
+    const uint8_t empty[] = { 0xa0 };
+    ASSERT_EQ(OC_STACK_OK, OCRepPayloadViewCreate(empty, sizeof(empty), &view));
+    OCRepPayloadViewDestroy(view);
+}
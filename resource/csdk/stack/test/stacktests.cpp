@@ -30,6 +30,9 @@ extern "C"
     #include "oic_time.h"
     #include "ocresourcehandler.h"
     #include "occollection.h"
+    #include "occlientcb.h"
+    #include "ocobserve.h"
+    #include "ocpayloadcbor.h"
     #include "mbedtls/ssl_ciphersuites.h"
     #include "octypes.h"
 #if defined (WITH_POSIX) && (defined (__WITH_DTLS__) || defined(__WITH_TLS__))
@@ -46,6 +49,12 @@ extern "C"
 #include <unistd.h>
 #endif
 #include <stdlib.h>
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
 
 //-----------------------------------------------------------------------------
 // Includes
@@ -54,6 +63,7 @@ extern "C"
 #include <string.h>
 
 #include <iostream>
+#include <vector>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -2326,6 +2336,49 @@ TEST(StackResourceAccess, DeleteMiddleResource)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackResourceAccess, FindResourceByUriIndex)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting FindResourceByUriIndex test");
+    InitStack(OC_SERVER);
+
+    const int count = 5000;
+    std::vector<OCResourceHandle> handles;
+    char uri[MAX_URI_LENGTH];
+
+    for (int i = 0; i < count; ++i)
+    {
+        OCResourceHandle handle;
+        snprintf(uri, sizeof(uri), "/a/bridged/%d", i);
+        ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.led", "core.rw", uri,
+                                                0, NULL, OC_DISCOVERABLE));
+        handles.push_back(handle);
+    }
+
+    // Every resource is found by its uri and by its handle, also once the index has grown.
+    for (int i = 0; i < count; ++i)
+    {
+        snprintf(uri, sizeof(uri), "/a/bridged/%d", i);
+        ASSERT_EQ(handles[i], (OCResourceHandle) FindResourceByUri(uri));
+        ASSERT_EQ(handles[i], OCGetResourceHandleAtUri(uri));
+        ASSERT_STREQ(uri, OCGetResourceUri(handles[i]));
+    }
+    EXPECT_TRUE(NULL == FindResourceByUri("/a/bridged/"));
+    EXPECT_TRUE(NULL == FindResourceByUri("/a/bridged/50000"));
+    EXPECT_TRUE(NULL == OCGetResourceHandleAtUri("/a/bridged"));
+
+    OCResourceHandle duplicate;
+    snprintf(uri, sizeof(uri), "/a/bridged/%d", 42);
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCCreateResource(&duplicate, "core.led", "core.rw",
+                                                       uri, 0, NULL, OC_DISCOVERABLE));
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handles[42]));
+    EXPECT_TRUE(NULL == FindResourceByUri(uri));
+    EXPECT_TRUE(NULL == OCGetResourceUri(handles[42]));
+    EXPECT_EQ(handles[43], OCGetResourceHandleAtUri("/a/bridged/43"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
 // Visual Studio versions earlier than 2015 have bugs in is_pod and report the wrong answer.
 #if !defined(_MSC_VER) || (_MSC_VER >= 1900)
 TEST(PODTests, OCHeaderOption)
@@ -3444,3 +3497,474 @@ TEST(SelectCipherSuite,SelectPositiveAdapter)
 
 }
 #endif
+
+//-----------------------------------------------------------------------------
+// Client callback index
+//-----------------------------------------------------------------------------
+extern "C" OCStackApplicationResult clientCBTestCallback(void* /*ctx*/,
+        OCDoHandle /*handle*/, OCClientResponse * /*clientResponse*/)
+{
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+/**
+ * Add a client callback the way OCDoRequest does and keep a copy of its token.
+ */
+static ClientCB *addTestClientCB(OCMethod method, uint32_t ttl, std::vector<uint8_t> &token)
+{
+    CAToken_t caToken = NULL;
+    if (CA_STATUS_OK != CAGenerateToken(&caToken, CA_MAX_TOKEN_LEN))
+    {
+        return NULL;
+    }
+    token.assign((uint8_t *)caToken, (uint8_t *)caToken + CA_MAX_TOKEN_LEN);
+
+    OCDoHandle handle = (OCDoHandle)OICMalloc(sizeof(uint8_t[CA_MAX_TOKEN_LEN]));
+    char *uri = OICStrdup("/a/light");
+    OCCallbackData cbData = { NULL, clientCBTestCallback, NULL };
+    ClientCB *cbNode = NULL;
+    if (!handle || !uri
+        || OC_STACK_OK != AddClientCB(&cbNode, &cbData, CA_MSG_CONFIRM, caToken,
+                                      CA_MAX_TOKEN_LEN, NULL, 0, NULL, 0, CA_FORMAT_UNDEFINED,
+                                      &handle, method, NULL, uri, NULL, ttl, false))
+    {
+        CADestroyToken(caToken);
+        OICFree(handle);
+        OICFree(uri);
+        return NULL;
+    }
+    return cbNode;
+}
+
+static ClientCB *findClientCB(const std::vector<uint8_t> &token)
+{
+    return GetClientCBUsingToken((CAToken_t)&token[0], (uint8_t)token.size());
+}
+
+TEST(StackClientCB, LookupByTokenAndHandle)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    // Several times the initial index capacity, so the indexes have to grow.
+    const size_t count = 100;
+    const uint32_t ttl = GetTicks(MAX_CB_TIMEOUT_SECONDS * MILLISECONDS_PER_SECOND);
+    std::vector<ClientCB *> nodes(count);
+    std::vector<std::vector<uint8_t> > tokens(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        nodes[i] = addTestClientCB(OC_REST_GET, ttl, tokens[i]);
+        ASSERT_TRUE(NULL != nodes[i]);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(nodes[i], findClientCB(tokens[i]));
+        EXPECT_EQ(nodes[i], GetClientCBUsingHandle(nodes[i]->handle));
+    }
+
+    std::vector<uint8_t> unknown(tokens[0]);
+    unknown[0] ^= 0xFF;
+    EXPECT_TRUE(NULL == findClientCB(unknown));
+    std::vector<uint8_t> prefix(tokens[0].begin(), tokens[0].end() - 1);
+    EXPECT_TRUE(NULL == findClientCB(prefix));
+    uint8_t unknownHandle[CA_MAX_TOKEN_LEN] = { 0 };
+    EXPECT_TRUE(NULL == GetClientCBUsingHandle((OCDoHandle)unknownHandle));
+
+    // The callbacks left behind stay reachable past the slots of the deleted ones.
+    for (size_t i = 0; i < count; i += 2)
+    {
+        DeleteClientCB(nodes[i]);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i % 2)
+        {
+            EXPECT_EQ(nodes[i], findClientCB(tokens[i]));
+            EXPECT_EQ(nodes[i], GetClientCBUsingHandle(nodes[i]->handle));
+        }
+        else
+        {
+            EXPECT_TRUE(NULL == findClientCB(tokens[i]));
+        }
+    }
+
+    DeleteClientCBList();
+    for (size_t i = 1; i < count; i += 2)
+    {
+        EXPECT_TRUE(NULL == findClientCB(tokens[i]));
+    }
+}
+
+TEST(StackClientCB, TimedOutCallbacksAreDeleted)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    const uint32_t soon = GetTicks(1);
+    std::vector<uint8_t> expiredToken;
+    std::vector<uint8_t> keptToken;
+    std::vector<uint8_t> liveToken;
+    std::vector<uint8_t> observeToken;
+    ClientCB *expired = addTestClientCB(OC_REST_GET, soon, expiredToken);
+    ClientCB *kept = addTestClientCB(OC_REST_GET, soon, keptToken);
+    ClientCB *live = addTestClientCB(OC_REST_GET,
+                                     GetTicks(MAX_CB_TIMEOUT_SECONDS * MILLISECONDS_PER_SECOND),
+                                     liveToken);
+    ClientCB *observe = addTestClientCB(OC_REST_OBSERVE, soon, observeToken);
+    ASSERT_TRUE(NULL != expired);
+    ASSERT_TRUE(NULL != kept);
+    ASSERT_TRUE(NULL != live);
+    ASSERT_TRUE(NULL != observe);
+    // Observe callbacks never time out.
+    EXPECT_EQ(0u, observe->TTL);
+
+    while (GetTicks(0) <= soon)
+    {
+    }
+
+    // The callback looked up is returned even though it expired, the other one is deleted.
+    EXPECT_EQ(kept, findClientCB(keptToken));
+    EXPECT_TRUE(NULL == findClientCB(expiredToken));
+    EXPECT_TRUE(NULL == findClientCB(keptToken));
+    EXPECT_EQ(live, findClientCB(liveToken));
+    EXPECT_EQ(observe, GetClientCBUsingHandle(observe->handle));
+
+    // A changed time to live takes effect on the next lookup.
+    UpdateClientCBTTL(live, soon);
+    EXPECT_EQ(observe, findClientCB(observeToken));
+    EXPECT_TRUE(NULL == findClientCB(liveToken));
+
+    UpdateClientCBTTL(observe, soon);
+    EXPECT_TRUE(NULL == findClientCB(expiredToken));
+    EXPECT_TRUE(NULL == findClientCB(observeToken));
+
+    DeleteClientCBList();
+}
+
+//-----------------------------------------------------------------------------
+// Responses delivered as payload views
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int calls;
+    OCStackResult result;
+    OCPayloadType type;
+    int64_t power;
+} ViewResponse;
+
+extern "C" OCStackApplicationResult viewResponseCallback(void* ctx,
+        OCDoHandle /*handle*/, OCClientResponse * clientResponse)
+{
+    ViewResponse *response = (ViewResponse *)ctx;
+    response->calls++;
+    response->result = clientResponse->result;
+    response->type = PAYLOAD_TYPE_INVALID;
+    if (clientResponse->payload)
+    {
+        response->type = clientResponse->payload->type;
+        if (PAYLOAD_TYPE_REPRESENTATION_VIEW == response->type)
+        {
+            OCRepPayloadViewGetPropInt((OCRepPayloadView *)clientResponse->payload, "power",
+                                       &response->power);
+        }
+    }
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+/**
+ * Hand the stack a response to the request of 'handle', as if CA had received it.
+ */
+static void deliverResponse(OCDoHandle handle, CAResponseResult_t result,
+                            OCRepPayload *payload, const char *uri)
+{
+    uint8_t *cbor = NULL;
+    size_t size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)payload, OC_FORMAT_CBOR, &cbor, &size));
+
+    ClientCB *cbNode = GetClientCBUsingHandle(handle);
+    ASSERT_TRUE(NULL != cbNode);
+
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_IP;
+    endpoint.flags = CA_IPV4;
+    endpoint.port = 5683;
+    OICStrcpy(endpoint.addr, sizeof(endpoint.addr), "127.0.0.1");
+
+    CAResponseInfo_t responseInfo;
+    memset(&responseInfo, 0, sizeof(responseInfo));
+    responseInfo.result = result;
+    responseInfo.info.type = CA_MSG_NONCONFIRM;
+    responseInfo.info.token = cbNode->token;
+    responseInfo.info.tokenLength = cbNode->tokenLength;
+    responseInfo.info.payload = cbor;
+    responseInfo.info.payloadSize = size;
+    responseInfo.info.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+    responseInfo.info.resourceUri = (CAURI_t)uri;
+    OCHandleResponse(&endpoint, &responseInfo);
+
+    OICFree(cbor);
+}
+
+static OCDevAddr localAddr()
+{
+    OCDevAddr addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.adapter = OC_ADAPTER_IP;
+    addr.flags = OC_IP_USE_V4;
+    addr.port = 5683;
+    OICStrcpy(addr.addr, sizeof(addr.addr), "127.0.0.1");
+    return addr;
+}
+
+TEST(StackPayloadView, ResponseIsDeliveredAsView)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT));
+
+    ViewResponse response = ViewResponse();
+    OCCallbackData cbData = { &response, viewResponseCallback, NULL };
+    OCDevAddr dest = localAddr();
+    OCDoHandle handle = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCDoRequestWithPayloadView(&handle, OC_REST_GET, "/a/light", &dest,
+                                                      NULL, CT_ADAPTER_IP, OC_LOW_QOS, &cbData,
+                                                      NULL, 0));
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != payload);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "power", 42));
+    deliverResponse(handle, CA_CONTENT, payload, "/a/light");
+    OCRepPayloadDestroy(payload);
+
+    EXPECT_EQ(1, response.calls);
+    EXPECT_EQ(OC_STACK_OK, response.result);
+    EXPECT_EQ(PAYLOAD_TYPE_REPRESENTATION_VIEW, response.type);
+    EXPECT_EQ(42, response.power);
+    EXPECT_TRUE(NULL == GetClientCBUsingHandle(handle));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#ifdef RD_CLIENT
+TEST(StackPayloadView, PublishResponseAsViewUpdatesIns)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", OC_RSRVD_INTERFACE_DEFAULT,
+                                            "/a/light", entityHandler, NULL, OC_DISCOVERABLE));
+
+    ViewResponse response = ViewResponse();
+    OCCallbackData cbData = { &response, viewResponseCallback, NULL };
+    OCDevAddr dest = localAddr();
+    OCDoHandle handle = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCDoRequestWithPayloadView(&handle, OC_REST_POST, OC_RSRVD_RD_URI,
+                                                      &dest, NULL, CT_ADAPTER_IP, OC_LOW_QOS,
+                                                      &cbData, NULL, 0));
+
+    OCRepPayload *link = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != link);
+    EXPECT_TRUE(OCRepPayloadSetPropString(link, OC_RSRVD_HREF, "/a/light"));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(link, OC_RSRVD_INS, 7));
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != payload);
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 1, 0, 0 };
+    const OCRepPayload *links[] = { link };
+    EXPECT_TRUE(OCRepPayloadSetPropObjectArray(payload, OC_RSRVD_LINKS, links, dimensions));
+    deliverResponse(handle, CA_CHANGED, payload, OC_RSRVD_RD_URI);
+    OCRepPayloadDestroy(payload);
+    OCRepPayloadDestroy(link);
+
+    EXPECT_EQ(1, response.calls);
+    EXPECT_EQ(OC_STACK_RESOURCE_CHANGED, response.result);
+    EXPECT_EQ(PAYLOAD_TYPE_REPRESENTATION_VIEW, response.type);
+    int64_t ins = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetResourceIns(light, &ins));
+    EXPECT_EQ(7, ins);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
+
+#if OBSERVE_FANOUT && !defined(_WIN32)
+/**
+ * UDP socket on the loopback interface standing in for a remote observer.
+ */
+class ObserverSocket
+{
+public:
+    ObserverSocket() : m_fd(socket(AF_INET, SOCK_DGRAM, 0)), m_port(0)
+    {
+        struct sockaddr_in sin;
+        memset(&sin, 0, sizeof(sin));
+        sin.sin_family = AF_INET;
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(sin);
+        struct timeval timeout = { 2, 0 };
+        if (0 <= m_fd
+            && 0 == bind(m_fd, (struct sockaddr *)&sin, sizeof(sin))
+            && 0 == setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))
+            && 0 == getsockname(m_fd, (struct sockaddr *)&sin, &len))
+        {
+            m_port = ntohs(sin.sin_port);
+        }
+    }
+
+    ~ObserverSocket()
+    {
+        if (0 <= m_fd)
+        {
+            close(m_fd);
+        }
+    }
+
+    int fd() const { return m_fd; }
+    uint16_t port() const { return m_port; }
+
+private:
+    ObserverSocket(const ObserverSocket &);
+    ObserverSocket &operator=(const ObserverSocket &);
+
+    int m_fd;
+    uint16_t m_port;
+};
+
+static bool readOptionField(const uint8_t *pdu, size_t size, size_t &pos, uint32_t &value)
+{
+    if (13 == value)
+    {
+        if (pos + 1 > size)
+        {
+            return false;
+        }
+        value = pdu[pos] + 13;
+        pos += 1;
+    }
+    else if (14 == value)
+    {
+        if (pos + 2 > size)
+        {
+            return false;
+        }
+        value = ((pdu[pos] << 8) | pdu[pos + 1]) + 269;
+        pos += 2;
+    }
+    return 15 != value;
+}
+
+/**
+ * Extract the token and the observe option of a CoAP over UDP message.
+ */
+static bool parseNotification(const uint8_t *pdu, size_t size, std::vector<uint8_t> &token,
+                              uint32_t &observe)
+{
+    const uint32_t observeOption = 6;
+
+    size_t tokenLength = pdu[0] & 0x0F;
+    if (size < 4 + tokenLength)
+    {
+        return false;
+    }
+    token.assign(pdu + 4, pdu + 4 + tokenLength);
+
+    size_t pos = 4 + tokenLength;
+    uint32_t number = 0;
+    while (pos < size && 0xFF != pdu[pos])
+    {
+        uint32_t delta = pdu[pos] >> 4;
+        uint32_t length = pdu[pos] & 0x0F;
+        pos++;
+        if (!readOptionField(pdu, size, pos, delta) || !readOptionField(pdu, size, pos, length)
+            || pos + length > size)
+        {
+            return false;
+        }
+        number += delta;
+        if (observeOption == number)
+        {
+            observe = 0;
+            for (size_t i = 0; i < length; i++)
+            {
+                observe = (observe << 8) | pdu[pos + i];
+            }
+            return true;
+        }
+        pos += length;
+    }
+    return false;
+}
+
+static OCEntityHandlerResult observedEntityHandler(OCEntityHandlerFlag /*flag*/,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    (*(int *)ctx)++;
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    EXPECT_TRUE(NULL != payload);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "power", 42));
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.resourceHandle = request->resource;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload *)payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+TEST(StackObserve, GroupedNotificationKeepsTokenAndSequence)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_SERVER));
+
+    int calls = 0;
+    OCResourceHandle handle = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", OC_RSRVD_INTERFACE_DEFAULT,
+                                            "/a/observed", observedEntityHandler, &calls,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    OCResource *resource = (OCResource *)handle;
+
+    const size_t numObservers = 3;
+    ObserverSocket observers[numObservers];
+    std::vector<uint8_t> tokens[numObservers];
+    for (size_t i = 0; i < numObservers; i++)
+    {
+        ASSERT_NE(0, observers[i].port());
+        OCDevAddr addr = localAddr();
+        addr.port = observers[i].port();
+
+        uint8_t token[] = { 0x0b, 0x5e, 0x4e, (uint8_t)(i + 1) };
+        tokens[i].assign(token, token + sizeof(token));
+
+        OCObservationId id = 0;
+        EXPECT_EQ(OC_STACK_OK, GenerateObserverId(&id));
+        EXPECT_EQ(OC_STACK_OK, AddObserver("/a/observed", NULL, id, (CAToken_t)token,
+                                           sizeof(token), resource, OC_LOW_QOS,
+                                           OC_FORMAT_CBOR, 0, &addr));
+    }
+
+    for (int round = 1; round <= 2; round++)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+        // Observers that receive the same representation share one entity handler call.
+        EXPECT_EQ(round, calls);
+
+        for (size_t i = 0; i < numObservers; i++)
+        {
+            uint8_t pdu[COAP_MAX_PDU_SIZE];
+            ssize_t size = recv(observers[i].fd(), pdu, sizeof(pdu), 0);
+            ASSERT_LT(0, size);
+
+            std::vector<uint8_t> token;
+            uint32_t observe = 0;
+            ASSERT_TRUE(parseNotification(pdu, (size_t)size, token, observe));
+            EXPECT_EQ(tokens[i], token);
+            EXPECT_EQ(resource->sequenceNum, observe);
+        }
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
@@ -0,0 +1,86 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the declaration of the executor running the application
+ * callbacks of the client wrapper.
+ */
+
+#ifndef OC_CALLBACK_EXECUTOR_H_
+#define OC_CALLBACK_EXECUTOR_H_
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace OC
+{
+    /**
+     * Runs application callbacks off the thread that processes the stack.
+     *
+     * Callbacks posted with the same key run one at a time and in the order
+     * they were posted, so e.g. the notifications of one observation are
+     * delivered in sequence. Callbacks with different keys run concurrently on
+     * a fixed number of worker threads.
+     */
+    class CallbackExecutor
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        /**
+         * @param workerCount  Number of worker threads. 0 starts a new detached
+         *                     thread for every callback, without any ordering.
+         */
+        explicit CallbackExecutor(unsigned int workerCount);
+
+        /**
+         * Runs the callbacks still queued, then stops the workers.
+         */
+        ~CallbackExecutor();
+
+        CallbackExecutor(const CallbackExecutor&) = delete;
+        CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+        /**
+         * Queue a callback.
+         *
+         * @param key   Callbacks with the same key are serialized. Only compared,
+         *              never dereferenced.
+         * @param task  Callback to run.
+         */
+        void post(const void* key, Task task);
+
+    private:
+        struct State;
+
+        static void workerFunc(std::shared_ptr<State> state);
+
+        // Shared with the workers, which may outlive the executor when it is
+        // destroyed from one of its own callbacks.
+        std::shared_ptr<State> m_state;
+        std::vector<std::thread> m_workers;
+    };
+}
+
+#endif // OC_CALLBACK_EXECUTOR_H_
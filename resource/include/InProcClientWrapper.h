@@ -28,6 +28,7 @@
 
 #include <OCApi.h>
 #include <IClientWrapper.h>
+#include <CallbackExecutor.h>
 #include <InitializeException.h>
 #include <ResourceInitException.h>
 
@@ -38,22 +39,28 @@ namespace OC
         struct GetContext
         {
             GetCallback callback;
-            GetContext(GetCallback cb) : callback(cb){}
+            std::shared_ptr<CallbackExecutor> executor;
+            GetContext(GetCallback cb, std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), executor(ex){}
         };
 
         struct SetContext
         {
             PutCallback callback;
-            SetContext(PutCallback cb) : callback(cb){}
+            std::shared_ptr<CallbackExecutor> executor;
+            SetContext(PutCallback cb, std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), executor(ex){}
         };
 
         struct ListenContext
         {
             FindCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::shared_ptr<CallbackExecutor> executor;
 
-            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw,
+                          std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenErrorContext
@@ -61,19 +68,23 @@ namespace OC
             FindCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::shared_ptr<CallbackExecutor> executor;
 
             ListenErrorContext(FindCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw,
+                               std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenResListContext
         {
             FindResListCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::shared_ptr<CallbackExecutor> executor;
 
-            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw,
+                                 std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenResListWithErrorContext
@@ -81,36 +92,46 @@ namespace OC
             FindResListCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::shared_ptr<CallbackExecutor> executor;
 
             ListenResListWithErrorContext(FindResListCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw,
+                               std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), executor(ex){}
         };
 
         struct DeviceListenContext
         {
             FindDeviceCallback callback;
             IClientWrapper::Ptr clientWrapper;
-            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw)
-                    : callback(cb), clientWrapper(cw){}
+            std::shared_ptr<CallbackExecutor> executor;
+            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw,
+                                std::shared_ptr<CallbackExecutor> ex)
+                    : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct SubscribePresenceContext
         {
             SubscribeCallback callback;
-            SubscribePresenceContext(SubscribeCallback cb) : callback(cb){}
+            std::shared_ptr<CallbackExecutor> executor;
+            SubscribePresenceContext(SubscribeCallback cb, std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), executor(ex){}
         };
 
         struct DeleteContext
         {
             DeleteCallback callback;
-            DeleteContext(DeleteCallback cb) : callback(cb){}
+            std::shared_ptr<CallbackExecutor> executor;
+            DeleteContext(DeleteCallback cb, std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), executor(ex){}
         };
 
         struct ObserveContext
         {
             ObserveCallback callback;
-            ObserveContext(ObserveCallback cb) : callback(cb){}
+            std::shared_ptr<CallbackExecutor> executor;
+            ObserveContext(ObserveCallback cb, std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), executor(ex){}
         };
 
 #ifdef WITH_MQ
@@ -118,8 +139,10 @@ namespace OC
         {
             MQTopicCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
-            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            std::shared_ptr<CallbackExecutor> executor;
+            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw,
+                           std::shared_ptr<CallbackExecutor> ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 #endif
     }
@@ -241,6 +264,8 @@ namespace OC
         std::thread m_listeningThread;
         bool m_threadRun;
         std::weak_ptr<std::recursive_mutex> m_csdkLock;
+        // runs the application callbacks; shared with the callback contexts
+        std::shared_ptr<CallbackExecutor> m_callbackExecutor;
 
     private:
         PlatformConfig  m_cfg;
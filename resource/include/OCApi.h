@@ -131,6 +131,9 @@ namespace OC
         NaQos       = OC_NA_QOS
     };
 
+    /** Default number of threads running client callbacks. */
+    const unsigned int DefaultCallbackThreadCount = 4;
+
     /**
      *  Data structure to provide the configuration.
      */
@@ -175,6 +178,13 @@ namespace OC
          */
         bool                       useLegacyCleanup;
 
+        /**
+         * Number of threads running client callbacks (responses, discovery results,
+         * observe notifications). Callbacks of one request or observation run in
+         * order. Set to 0 to run each callback on its own new thread, unordered.
+         */
+        unsigned int               callbackThreadCount;
+
         public:
             PlatformConfig(const ServiceType serviceType_,
             const ModeType mode_,
@@ -188,7 +198,8 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(ps_),
-                useLegacyCleanup(false)
+                useLegacyCleanup(false),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             /// @deprecated this constructor is deprecated (since 2014.10).
             OC_DEPRECATED_MSG(
@@ -204,7 +215,8 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(nullptr),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -225,7 +237,8 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -246,7 +259,8 @@ namespace OC
                 port(port_),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -267,7 +281,8 @@ namespace OC
                 ipAddress(ipAddress_),
                 port(port_),
                 QoS(QoS_),
-                ps(ps_)
+                ps(ps_),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             PlatformConfig(const ServiceType serviceType_,
                            const ModeType mode_,
@@ -283,7 +298,8 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -305,7 +321,8 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackThreadCount(DefaultCallbackThreadCount)
         {}
 
     };
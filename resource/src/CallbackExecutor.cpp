@@ -0,0 +1,142 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "CallbackExecutor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace OC
+{
+    struct CallbackExecutor::State
+    {
+        struct KeyQueue
+        {
+            std::deque<Task> tasks;
+            // a worker is running one of the tasks of this key
+            bool running = false;
+        };
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::unordered_map<const void*, KeyQueue> pending;
+        // keys with queued tasks and no running one, in the order they became ready
+        std::deque<const void*> ready;
+        bool stopping = false;
+    };
+
+    CallbackExecutor::CallbackExecutor(unsigned int workerCount)
+        : m_state(std::make_shared<State>())
+    {
+        for (unsigned int i = 0; i < workerCount; ++i)
+        {
+            m_workers.emplace_back(&CallbackExecutor::workerFunc, m_state);
+        }
+    }
+
+    CallbackExecutor::~CallbackExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->stopping = true;
+        }
+        m_state->cond.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            // The last owner may let go of the executor inside a callback.
+            if (worker.get_id() == std::this_thread::get_id())
+            {
+                worker.detach();
+            }
+            else
+            {
+                worker.join();
+            }
+        }
+    }
+
+    void CallbackExecutor::post(const void* key, Task task)
+    {
+        if (m_workers.empty())
+        {
+            std::thread exec(std::move(task));
+            exec.detach();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            State::KeyQueue& queue = m_state->pending[key];
+            queue.tasks.push_back(std::move(task));
+            if (!queue.running && 1 == queue.tasks.size())
+            {
+                m_state->ready.push_back(key);
+            }
+        }
+        m_state->cond.notify_one();
+    }
+
+    void CallbackExecutor::workerFunc(std::shared_ptr<State> state)
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        for (;;)
+        {
+            state->cond.wait(lock, [&state]()
+                    {
+                        return state->stopping || !state->ready.empty();
+                    });
+            if (state->ready.empty())
+            {
+                // stopping and everything has been run
+                return;
+            }
+
+            const void* key = state->ready.front();
+            state->ready.pop_front();
+
+            auto it = state->pending.find(key);
+            Task task = std::move(it->second.tasks.front());
+            it->second.tasks.pop_front();
+            it->second.running = true;
+
+            lock.unlock();
+            task();
+            task = nullptr;
+            lock.lock();
+
+            // the map may have been rehashed while unlocked
+            it = state->pending.find(key);
+            it->second.running = false;
+            if (it->second.tasks.empty())
+            {
+                state->pending.erase(it);
+            }
+            else
+            {
+                // back of the line so one busy key can't starve the others
+                state->ready.push_back(key);
+                state->cond.notify_one();
+            }
+        }
+    }
+}
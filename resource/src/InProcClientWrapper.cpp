@@ -38,6 +38,7 @@ namespace OC
     InProcClientWrapper::InProcClientWrapper(
         std::weak_ptr<std::recursive_mutex> csdkLock, PlatformConfig cfg)
             : m_threadRun(false), m_csdkLock(csdkLock),
+              m_callbackExecutor(std::make_shared<CallbackExecutor>(cfg.callbackThreadCount)),
               m_cfg { cfg }
     {
         // if the config type is server, we ought to never get called.  If the config type
@@ -79,6 +80,7 @@ namespace OC
         if (m_threadRun && m_listeningThread.joinable())
         {
             m_threadRun = false;
+            OCProcessWakeUp();
             m_listeningThread.join();
         }
         return OC_STACK_OK;
@@ -86,6 +88,8 @@ namespace OC
 
     void InProcClientWrapper::listeningFunc()
     {
+        // Wake-ups this thread has seen, so it can't miss the one from stop().
+        uint32_t wakeUps = 0;
         while(m_threadRun)
         {
             OCStackResult result;
@@ -105,8 +109,12 @@ namespace OC
                 // TODO: do something with result if failed?
             }
 
-            // To minimize CPU utilization we may wish to do this with sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Sleep without holding the lock until there is something to process
+            // or stop() wakes us up. Fall back to polling if the stack can't wait.
+            if (m_threadRun && OC_STACK_ERROR == OCProcessWait(0, &wakeUps))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -215,8 +223,7 @@ namespace OC
 
             for(auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->executor->post(context, std::bind(context->callback, resource));
             }
         }
         catch (std::exception &e)
@@ -267,16 +274,15 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->executor->post(context, std::bind(context->callback, resource));
             }
             return OC_STACK_KEEP_TRANSACTION;
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
         std::string resourceURI = clientResponse->resourceUri;
-        std::thread exec(context->errorCallback, resourceURI, result);
-        exec.detach();
+        context->executor->post(context,
+                std::bind(context->errorCallback, resourceURI, result));
         return OC_STACK_KEEP_TRANSACTION;
     }
 
@@ -296,7 +302,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenContext* context =
-            new ClientCallbackContext::ListenContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenContext(callback, shared_from_this(),
+                                                     m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenCallback;
@@ -338,7 +345,8 @@ namespace OC
 
         ClientCallbackContext::ListenErrorContext* context =
             new ClientCallbackContext::ListenErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(),
+                                                          m_callbackExecutor);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -415,8 +423,8 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->executor->post(context,
+                    std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -443,7 +451,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenResListContext* context =
-            new ClientCallbackContext::ListenResListContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenResListContext(callback, shared_from_this(),
+                                                            m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenResListCallback;
@@ -487,8 +496,7 @@ namespace OC
 
             //send the error callback
             std::string uri = clientResponse->resourceUri;
-            std::thread exec(context->errorCallback, uri, result);
-            exec.detach();
+            context->executor->post(context, std::bind(context->errorCallback, uri, result));
             return OC_STACK_KEEP_TRANSACTION;
         }
 
@@ -517,8 +525,8 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->executor->post(context,
+                    std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -547,7 +555,8 @@ namespace OC
 
         ClientCallbackContext::ListenResListWithErrorContext* context =
             new ClientCallbackContext::ListenResListWithErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(),
+                                                          m_callbackExecutor);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -596,9 +605,8 @@ namespace OC
                     << clientResponse->result
                     << std::flush;
 
-            std::thread exec(context->callback, clientResponse->result,
-                             resourceURI, nullptr);
-            exec.detach();
+            context->executor->post(context, std::bind(context->callback, clientResponse->result,
+                                                       resourceURI, nullptr));
 
             return OC_STACK_DELETE_TRANSACTION;
         }
@@ -619,9 +627,8 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, clientResponse->result,
-                                 resourceURI, resource);
-                exec.detach();
+                context->executor->post(context, std::bind(context->callback,
+                            clientResponse->result, resourceURI, resource));
             }
         }
         catch (std::exception &e)
@@ -648,7 +655,8 @@ namespace OC
         }
 
         ClientCallbackContext::MQTopicContext* context =
-            new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+            new ClientCallbackContext::MQTopicContext(callback, shared_from_this(),
+                                                      m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenMQCallback;
@@ -692,8 +700,7 @@ namespace OC
         {
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
             OCRepresentation rep = parseGetSetCallback(clientResponse);
-            std::thread exec(context->callback, rep);
-            exec.detach();
+            context->executor->post(context, std::bind(context->callback, rep));
         }
         catch(OC::OCException& e)
         {
@@ -720,7 +727,8 @@ namespace OC
         deviceUri << serviceUrl << deviceURI;
 
         ClientCallbackContext::DeviceListenContext* context =
-            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this());
+            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this(),
+                                                           m_callbackExecutor);
         OCCallbackData cbdata;
 
         cbdata.context = static_cast<void*>(context),
@@ -804,19 +812,17 @@ namespace OC
                                             createdUri);
                 for (auto resource : container.Resources())
                 {
-                    std::thread exec(context->callback, result,
-                                     createdUri,
-                                     resource);
-                    exec.detach();
+                    context->executor->post(context, std::bind(context->callback, result,
+                                                               createdUri,
+                                                               resource));
                 }
             }
             else
             {
                 OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-                std::thread exec(context->callback, result,
-                                 createdUri,
-                                 nullptr);
-                exec.detach();
+                context->executor->post(context, std::bind(context->callback, result,
+                                                           createdUri,
+                                                           nullptr));
             }
         }
         catch (std::exception &e)
@@ -840,7 +846,8 @@ namespace OC
         }
         OCStackResult result;
         ClientCallbackContext::MQTopicContext* ctx =
-                new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+                new ClientCallbackContext::MQTopicContext(callback, shared_from_this(),
+                                                          m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = createMQTopicCallback;
@@ -894,8 +901,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, rep, result);
-        exec.detach();
+        context->executor->post(context,
+                std::bind(context->callback, serverHeaderOptions, rep, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -913,7 +920,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::GetContext* ctx =
-            new ClientCallbackContext::GetContext(callback);
+            new ClientCallbackContext::GetContext(callback, m_callbackExecutor);
 
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx);
@@ -970,8 +977,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs, result);
-        exec.detach();
+        context->executor->post(context,
+                std::bind(context->callback, serverHeaderOptions, attrs, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1080,7 +1087,8 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx =
+            new ClientCallbackContext::SetContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1127,7 +1135,8 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx =
+            new ClientCallbackContext::SetContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1173,8 +1182,8 @@ namespace OC
         parseServerHeaderOptions(clientResponse, serverHeaderOptions);
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, clientResponse->result);
-        exec.detach();
+        context->executor->post(context,
+                std::bind(context->callback, serverHeaderOptions, clientResponse->result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1193,7 +1202,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::DeleteContext* ctx =
-            new ClientCallbackContext::DeleteContext(callback);
+            new ClientCallbackContext::DeleteContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = deleteResourceCallback;
@@ -1248,9 +1257,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs,
-                    result, sequenceNumber);
-        exec.detach();
+        context->executor->post(context, std::bind(context->callback, serverHeaderOptions, attrs,
+                                                   result, sequenceNumber));
         if (sequenceNumber == MAX_SEQUENCE_NUMBER + 1)
         {
             return OC_STACK_DELETE_TRANSACTION;
@@ -1273,7 +1281,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
@@ -1366,10 +1374,8 @@ namespace OC
         std::string url = clientResponse->devAddr.addr;
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, clientResponse->result,
-                    clientResponse->sequenceNumber, url);
-
-        exec.detach();
+        context->executor->post(context, std::bind(context->callback, clientResponse->result,
+                                                   clientResponse->sequenceNumber, url));
 
         return OC_STACK_KEEP_TRANSACTION;
     }
@@ -1384,7 +1390,8 @@ namespace OC
         }
 
         ClientCallbackContext::SubscribePresenceContext* ctx =
-            new ClientCallbackContext::SubscribePresenceContext(presenceHandler);
+            new ClientCallbackContext::SubscribePresenceContext(presenceHandler,
+                                                                m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = subscribePresenceCallback;
@@ -1445,7 +1452,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
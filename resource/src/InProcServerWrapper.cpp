@@ -284,6 +284,7 @@ namespace OC
         if(m_processThread.joinable())
         {
             m_threadRun = false;
+            OCProcessWakeUp();
             m_processThread.join();
         }
 
@@ -293,6 +294,8 @@ namespace OC
     void InProcServerWrapper::processFunc()
     {
         auto cLock = m_csdkLock.lock();
+        // Wake-ups this thread has seen, so it can't miss the one from stop().
+        uint32_t wakeUps = 0;
         while(cLock && m_threadRun)
         {
             OCStackResult result;
@@ -308,7 +311,12 @@ namespace OC
                 // ...the value of variable result is simply ignored for now.
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Sleep without holding the lock until there is something to process
+            // or stop() wakes us up. Fall back to polling if the stack can't wait.
+            if (m_threadRun && OC_STACK_ERROR == OCProcessWait(0, &wakeUps))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -0,0 +1,148 @@
+//******************************************************************
+//
+// Copyright 2026 The IoTivity Authors All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <CallbackExecutor.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace OC
+{
+    namespace test
+    {
+        namespace CallbackExecutorTests
+        {
+            using namespace OC;
+
+            TEST(CallbackExecutorTest, RunsAllCallbacksBeforeDestruction)
+            {
+                std::atomic<int> count(0);
+                {
+                    CallbackExecutor executor(4);
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        executor.post(reinterpret_cast<const void*>(i % 7), [&count]()
+                                {
+                                    ++count;
+                                });
+                    }
+                }
+                EXPECT_EQ(1000, count);
+            }
+
+            TEST(CallbackExecutorTest, KeepsOrderPerKey)
+            {
+                const int keys = 8;
+                const int perKey = 500;
+                std::vector<std::vector<int>> seen(keys);
+                std::atomic<int> running[keys];
+                for (auto& r : running)
+                {
+                    r = 0;
+                }
+                std::atomic<bool> overlapped(false);
+                {
+                    CallbackExecutor executor(4);
+                    for (int i = 0; i < perKey; ++i)
+                    {
+                        for (int k = 0; k < keys; ++k)
+                        {
+                            executor.post(&seen[k], [&, i, k]()
+                                    {
+                                        if (running[k]++ != 0)
+                                        {
+                                            overlapped = true;
+                                        }
+                                        seen[k].push_back(i);
+                                        running[k]--;
+                                    });
+                        }
+                    }
+                }
+
+                EXPECT_FALSE(overlapped);
+                for (int k = 0; k < keys; ++k)
+                {
+                    ASSERT_EQ(static_cast<size_t>(perKey), seen[k].size());
+                    for (int i = 0; i < perKey; ++i)
+                    {
+                        EXPECT_EQ(i, seen[k][i]);
+                    }
+                }
+            }
+
+            TEST(CallbackExecutorTest, OtherKeysRunWhileOneIsBlocked)
+            {
+                std::mutex mutex;
+                std::condition_variable cond;
+                bool release = false;
+                std::atomic<bool> otherRan(false);
+
+                CallbackExecutor executor(2);
+                executor.post(&mutex, [&]()
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            cond.wait(lock, [&release]() { return release; });
+                        });
+                executor.post(&cond, [&otherRan]()
+                        {
+                            otherRan = true;
+                        });
+
+                for (int i = 0; i < 500 && !otherRan; ++i)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                EXPECT_TRUE(otherRan);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    release = true;
+                }
+                cond.notify_all();
+            }
+
+            TEST(CallbackExecutorTest, ThreadPerCallbackWithoutWorkers)
+            {
+                std::mutex mutex;
+                std::condition_variable cond;
+                int count = 0;
+
+                CallbackExecutor executor(0);
+                for (int i = 0; i < 10; ++i)
+                {
+                    executor.post(nullptr, [&]()
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                ++count;
+                                cond.notify_all();
+                            });
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                EXPECT_TRUE(cond.wait_for(lock, std::chrono::seconds(5),
+                                          [&count]() { return 10 == count; }));
+            }
+        }
+    }
+}